@@ -1,7 +1,6 @@
 
 #include "common/dnnl_thread.hpp"
 #include "common/dnnl_thread_parallel_nd.hpp"
-#include "common/ve/dnnl_thread_parallel_nd_vec.hpp"
 #include "common/dnnl_optimize.h"
 
 #include <iostream>
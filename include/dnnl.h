@@ -3733,6 +3733,72 @@ dnnl_status_t DNNL_API dnnl_set_primitive_cache_capacity(int capacity);
 
 /// @} dnnl_api_primitive_cache
 
+/// @addtogroup dnnl_api_exec_graph
+/// @{
+
+/// Creates an empty execution graph.
+///
+/// @param graph Output execution graph.
+/// @param engine Engine of the primitives the graph executes.
+/// @returns #dnnl_success on success and a status describing the error
+///     otherwise.
+dnnl_status_t DNNL_API dnnl_exec_graph_create(
+        dnnl_exec_graph_t *graph, dnnl_engine_t engine);
+
+/// Appends an execution of a primitive to an execution graph that is not
+/// finalized yet. The arguments are those dnnl_primitive_execute() takes.
+///
+/// The graph keeps the data handles the memory objects have at the time of
+/// the call. A later dnnl_memory_set_data_handle() on one of them is not seen
+/// by the graph: pass the new buffer to dnnl_exec_graph_replay() instead.
+/// The memory objects may be destroyed after the call, their buffers may
+/// not. The primitive must outlive the graph.
+///
+/// @param graph Execution graph.
+/// @param primitive Primitive to execute.
+/// @param nargs Number of arguments.
+/// @param args Array of arguments. Each argument is an
+///     <index, #dnnl_memory_t> pair.
+/// @returns #dnnl_success on success and a status describing the error
+///     otherwise.
+dnnl_status_t DNNL_API dnnl_exec_graph_append(dnnl_exec_graph_t graph,
+        const_dnnl_primitive_t primitive, int nargs,
+        const dnnl_exec_arg_t *args);
+
+/// Ends the capture. The steps that use a library-managed scratchpad are
+/// given parts of one scratchpad the graph allocates here.
+///
+/// @param graph Execution graph.
+/// @returns #dnnl_success on success and a status describing the error
+///     otherwise.
+dnnl_status_t DNNL_API dnnl_exec_graph_finalize(dnnl_exec_graph_t graph);
+
+/// Executes the steps of a finalized execution graph in order, on the
+/// calling thread and after the primitives already submitted to the stream.
+/// A graph may be replayed by one thread at a time.
+///
+/// @param graph Execution graph.
+/// @param stream Execution stream on the engine of the graph.
+/// @param nbindings Number of bindings.
+/// @param bindings Buffers for captured memory objects, used by this replay
+///     and the following ones. A captured memory object that has never been
+///     bound uses its buffer at capture time. The memory objects passed to
+///     the replay are left untouched.
+/// @returns #dnnl_success on success and a status describing the error
+///     otherwise.
+dnnl_status_t DNNL_API dnnl_exec_graph_replay(dnnl_exec_graph_t graph,
+        dnnl_stream_t stream, int nbindings,
+        const dnnl_exec_graph_binding_t *bindings);
+
+/// Destroys an execution graph.
+///
+/// @param graph Execution graph to destroy.
+/// @returns #dnnl_success on success and a status describing the error
+///     otherwise.
+dnnl_status_t DNNL_API dnnl_exec_graph_destroy(dnnl_exec_graph_t graph);
+
+/// @} dnnl_api_exec_graph
+
 /// @addtogroup dnnl_api_service
 /// @{
 
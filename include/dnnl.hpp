@@ -10540,6 +10540,90 @@ inline void set_primitive_cache_capacity(int capacity) {
 
 /// @} dnnl_api_primitive_cache
 
+/// @addtogroup dnnl_api_exec_graph Execution Graph
+///
+/// A sequence of primitive executions captured once and replayed with a
+/// single call, for pipelines that execute the same primitives on the same
+/// memory objects over and over.
+///
+/// @sa @ref dev_guide_performance_settings
+///
+/// @{
+
+/// @cond DO_NOT_DOCUMENT_THIS
+template <>
+struct handle_traits<dnnl_exec_graph_t> {
+    static dnnl_status_t destructor(dnnl_exec_graph_t p) {
+        return dnnl_exec_graph_destroy(p);
+    }
+};
+/// @endcond
+
+/// An execution graph.
+struct exec_graph : public handle<dnnl_exec_graph_t> {
+    using handle::handle;
+
+    /// A buffer for a captured memory object.
+    using binding = std::pair<memory, void *>;
+
+    /// Constructs an empty execution graph handle.
+    exec_graph() = default;
+
+    /// Constructs an empty execution graph for the primitives of an engine.
+    ///
+    /// @param engine Engine of the primitives the graph executes.
+    exec_graph(const engine &engine) {
+        dnnl_exec_graph_t result;
+        error::wrap_c_api(dnnl_exec_graph_create(&result, engine.get()),
+                "could not create an execution graph");
+        reset(result);
+    }
+
+    /// Appends an execution of a primitive, with the arguments
+    /// primitive::execute() takes. The graph keeps the data handles the
+    /// memory objects have now: a later memory::set_data_handle() is not
+    /// seen by the graph, bind the new buffer at replay instead.
+    ///
+    /// @param primitive Primitive to execute, which must outlive the graph.
+    /// @param args Arguments map.
+    void append(const primitive &primitive,
+            const std::unordered_map<int, memory> &args) {
+        std::vector<dnnl_exec_arg_t> c_args;
+        c_args.reserve(args.size());
+        for (const auto &a : args)
+            c_args.push_back({a.first, a.second.get(true)});
+
+        error::wrap_c_api(dnnl_exec_graph_append(get(), primitive.get(),
+                                  (int)c_args.size(), c_args.data()),
+                "could not append to an execution graph");
+    }
+
+    /// Ends the capture.
+    void finalize() {
+        error::wrap_c_api(dnnl_exec_graph_finalize(get()),
+                "could not finalize an execution graph");
+    }
+
+    /// Executes the steps of the graph in order on the calling thread.
+    ///
+    /// @param stream Stream to execute on.
+    /// @param bindings Buffers for captured memory objects, used by this
+    ///     replay and the following ones.
+    void replay(const stream &stream,
+            const std::vector<binding> &bindings = {}) {
+        std::vector<dnnl_exec_graph_binding_t> c_bindings;
+        c_bindings.reserve(bindings.size());
+        for (const auto &b : bindings)
+            c_bindings.push_back({b.first.get(), b.second});
+
+        error::wrap_c_api(dnnl_exec_graph_replay(get(), stream.get(),
+                                  (int)c_bindings.size(), c_bindings.data()),
+                "could not replay an execution graph");
+    }
+};
+
+/// @} dnnl_api_exec_graph
+
 /// @addtogroup dnnl_api_blas BLAS functions
 ///
 /// A subset of Basic Linear ALgebra (BLAS) functions that perform
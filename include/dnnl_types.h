@@ -973,7 +973,8 @@ typedef enum {
     dnnl_wino_wei_aaOio, ///< Internal weights format for 2x3 Winograd
     dnnl_wino_wei_aaOBiOo, ///< Internal weights format for 2x3 Winograd
     // Tensor of weights for 4x3 convolution.
-    dnnl_wino_wei_OBaaIBOIio ///< Internal weights format for 4x3 Winograd
+    dnnl_wino_wei_OBaaIBOIio, ///< Internal weights format for 4x3 Winograd
+    dnnl_wino_wei_aaOI, ///< Internal weights format for 4x3 Winograd (generic)
 } dnnl_wino_memory_format_t;
 
 /// Description of tensor of weights for winograd 2x3 convolution.
@@ -2094,6 +2095,28 @@ typedef const struct dnnl_stream_attr *const_dnnl_stream_attr_t;
 
 /// @} dnnl_api_stream
 
+/// @addtogroup dnnl_api_exec_graph
+/// @{
+
+/// @struct dnnl_exec_graph
+/// An opaque structure to describe a captured sequence of primitive
+/// executions.
+struct dnnl_exec_graph;
+/// An execution graph handle.
+typedef struct dnnl_exec_graph *dnnl_exec_graph_t;
+/// A constant execution graph handle.
+typedef const struct dnnl_exec_graph *const_dnnl_exec_graph_t;
+
+/// A buffer to bind to a captured memory object at replay.
+typedef struct {
+    /// Memory object as passed to dnnl_exec_graph_append().
+    const_dnnl_memory_t memory;
+    /// Data handle the graph uses for the memory object from then on.
+    void *handle;
+} dnnl_exec_graph_binding_t;
+
+/// @} dnnl_api_exec_graph
+
 /// @addtogroup dnnl_api_service
 /// @{
 
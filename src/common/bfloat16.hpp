@@ -61,6 +61,18 @@ void add_floats_and_cvt_to_bfloat16(
 // out[:] = (float)inp[:] + add[:]
 void cvt_bfloat16_and_add_to_float(
         float *out, const bfloat16_t *inp, const float *add, size_t size);
+
+// out[:] = scale * (float)inp[:]
+void cvt_bfloat16_and_scale_to_float(
+        float *out, const bfloat16_t *inp, float scale, size_t nelems);
+
+// acc[:] += scale * (float)inp[:]
+void cvt_bfloat16_scale_and_accumulate_to_float(
+        float *acc, const bfloat16_t *inp, float scale, size_t nelems);
+
+// out[:] = (bfloat16_t)(scale * inp[:])
+void scale_floats_and_cvt_to_bfloat16(
+        bfloat16_t *out, const float *inp, float scale, size_t nelems);
 } // namespace impl
 } // namespace dnnl
 
@@ -734,6 +734,7 @@ const stream_flags_t default_flags = dnnl_stream_default_flags;
 } // namespace stream_flags
 using stream_t = dnnl_stream;
 using stream_attr_t = dnnl_stream_attr;
+using exec_graph_t = dnnl_exec_graph;
 
 /* forward declaration of the internal primitive_desc types */
 struct batch_normalization_bwd_pd_t;
@@ -0,0 +1,210 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "dnnl_thread.hpp"
+#include "utils.hpp"
+
+#if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_OMP
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace dnnl {
+namespace impl {
+
+namespace {
+// Elementary operations a thread should get before another one is added.
+// Starting a parallel region costs a few microseconds on x86 and tens of
+// microseconds on VE, i.e. many thousand scalar operations.
+setting_t<size_t> parallel_min_cost {16384};
+
+size_t get_parallel_min_cost() {
+    if (!parallel_min_cost.initialized()) {
+        const int v = getenv_int(
+                "DNNL_PARALLEL_MIN_COST", (int)parallel_min_cost.get());
+        parallel_min_cost.set(v > 0 ? (size_t)v : 1);
+    }
+    return parallel_min_cost.get();
+}
+} // namespace
+
+int nthr_for_cost(int nthr, size_t work_amount, size_t item_cost) {
+    if (nthr == 0) nthr = dnnl_get_max_threads();
+    if (item_cost == 0) item_cost = 1;
+    const size_t min_cost = get_parallel_min_cost();
+    // cost / min_cost, saturated instead of overflowing
+    const size_t max_nthr = work_amount > SIZE_MAX / item_cost
+            ? SIZE_MAX
+            : work_amount * item_cost / min_cost;
+    return (int)nstl::max((size_t)1, nstl::min((size_t)nthr, max_nthr));
+}
+
+#if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_OMP
+namespace thread_team_utils {
+
+namespace {
+thread_local bool in_team_job = false;
+
+// Busy-wait step; gives the core away now and then, in case the thread we
+// wait for shares it.
+inline void spin_pause(unsigned i) {
+    if (i % 64 == 0) {
+        std::this_thread::yield();
+        return;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Workers spin on the job generation for spin_time after each job, then
+// sleep on a condition variable until the next one, so an idle team costs
+// no CPU.
+struct team_t {
+    team_t(int size) : size_(size) {
+        for (int ithr = 1; ithr < size_; ++ithr)
+            workers_.emplace_back(&team_t::worker, this, ithr);
+    }
+
+    int size() const { return size_; }
+
+    bool run(int nthr, void (*fn)(void *, int, int), void *ctx) {
+        if (busy_.test_and_set(std::memory_order_acquire)) return false;
+        fn_ = fn;
+        ctx_ = ctx;
+        nthr_ = nthr;
+        bar_count_.store(0, std::memory_order_relaxed);
+        pending_.store(size_ - 1, std::memory_order_relaxed);
+        gen_.fetch_add(1);
+        if (sleepers_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+
+        in_team_job = true;
+        fn(ctx, 0, nthr);
+        in_team_job = false;
+
+        for (unsigned i = 1; pending_.load(std::memory_order_acquire) != 0;
+                ++i)
+            spin_pause(i);
+        busy_.clear(std::memory_order_release);
+        return true;
+    }
+
+    void barrier() {
+        const size_t gen = bar_gen_.load(std::memory_order_acquire);
+        if (bar_count_.fetch_add(1, std::memory_order_acq_rel) == nthr_ - 1) {
+            bar_count_.store(0, std::memory_order_relaxed);
+            bar_gen_.fetch_add(1, std::memory_order_release);
+        } else {
+            for (unsigned i = 1;
+                    bar_gen_.load(std::memory_order_acquire) == gen; ++i)
+                spin_pause(i);
+        }
+    }
+
+private:
+    void worker(int ithr) {
+        size_t seen = 0;
+        for (;;) {
+            wait_for_job(seen);
+            seen = gen_.load(std::memory_order_acquire);
+            if (ithr < nthr_) {
+                in_team_job = true;
+                fn_(ctx_, ithr, nthr_);
+                in_team_job = false;
+            }
+            pending_.fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+    void wait_for_job(size_t seen) {
+        const auto spin_time = std::chrono::microseconds(100);
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 1; gen_.load(std::memory_order_acquire) == seen;
+                ++i) {
+            spin_pause(i);
+            if (i % 1024 == 0
+                    && std::chrono::steady_clock::now() - start > spin_time) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ++sleepers_;
+                cv_.wait(lock, [&] { return gen_.load() != seen; });
+                --sleepers_;
+                return;
+            }
+        }
+    }
+
+    const int size_;
+    std::vector<std::thread> workers_;
+
+    std::atomic_flag busy_ = ATOMIC_FLAG_INIT;
+    std::atomic<size_t> gen_ {0};
+    std::atomic<int> pending_ {0};
+    std::atomic<int> sleepers_ {0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    // current job, published by the gen_ increment
+    void (*fn_)(void *, int, int) = nullptr;
+    void *ctx_ = nullptr;
+    int nthr_ = 0;
+
+    std::atomic<int> bar_count_ {0};
+    std::atomic<size_t> bar_gen_ {0};
+};
+
+team_t *get_team() {
+    // Never destroyed: the workers sleep until the process exits.
+    static team_t *team = [] {
+        const int size = nstl::min(
+                getenv_int("DNNL_SPIN_TEAM", 0), omp_get_max_threads());
+        return size > 1 ? new team_t(size) : nullptr;
+    }();
+    return team;
+}
+} // namespace
+
+int team_size() {
+    team_t *team = get_team();
+    return team ? team->size() : 0;
+}
+
+bool in_team() {
+    return in_team_job;
+}
+
+bool run(int nthr, void (*fn)(void *, int, int), void *ctx) {
+    team_t *team = get_team();
+    if (!team || nthr > team->size()) return false;
+    return team->run(nthr, fn, ctx);
+}
+
+void barrier() {
+    assert(in_team_job);
+    get_team()->barrier();
+}
+
+} // namespace thread_team_utils
+#endif
+
+} // namespace impl
+} // namespace dnnl
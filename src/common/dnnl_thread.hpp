@@ -36,13 +36,60 @@ inline void dnnl_thr_barrier() {}
 #elif DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_OMP
 #include "omp.h"
 #define DNNL_THR_SYNC 1
+
+// The spinning team is internal to the library. Code built against the
+// shared library (e.g. the tests) includes this header as well and goes
+// straight to OMP.
+#if !defined(DNNL_DLL) || defined(DNNL_DLL_EXPORTS)
+#define DNNL_THR_TEAM 1
+
+namespace dnnl {
+namespace impl {
+namespace thread_team_utils {
+
+// Optional persistent team of spinning threads (DNNL_SPIN_TEAM=<nthr>, off by
+// default). parallel() hands it jobs of at most team_size() threads instead
+// of opening an OMP parallel region, which saves the region entry cost for
+// back-to-back small primitives.
+
+// Returns the number of team threads, including the dispatching one, or 0
+// if there is no team.
+int team_size();
+
+// Returns true while the calling thread runs a team job.
+bool in_team();
+
+// Runs fn(ctx, ithr, nthr) for all ithr in [0, nthr) on the team, the
+// calling thread taking ithr = 0. Returns false (and runs nothing) if the
+// team is busy with a job of another application thread.
+bool run(int nthr, void (*fn)(void *, int, int), void *ctx);
+
+// Barrier for the threads of the current team job.
+void barrier();
+
+} // namespace thread_team_utils
+} // namespace impl
+} // namespace dnnl
+#else
+#define DNNL_THR_TEAM 0
+#endif
+
 inline int dnnl_get_max_threads() {
     return omp_get_max_threads();
 }
 inline int dnnl_in_parallel() {
+#if DNNL_THR_TEAM
+    if (dnnl::impl::thread_team_utils::in_team()) return 1;
+#endif
     return omp_in_parallel();
 }
 inline void dnnl_thr_barrier() {
+#if DNNL_THR_TEAM
+    if (dnnl::impl::thread_team_utils::in_team()) {
+        dnnl::impl::thread_team_utils::barrier();
+        return;
+    }
+#endif
 #pragma omp barrier
 }
 
@@ -152,6 +199,12 @@ inline bool dnnl_thr_syncable() {
     return DNNL_THR_SYNC == 1;
 }
 
+/* Number of threads worth using for work_amount items of about item_cost
+ * elementary operations each: at most nthr (0 means dnnl_get_max_threads()),
+ * and no more than gives every thread DNNL_PARALLEL_MIN_COST operations.
+ * Returns 1 for work too small to amortize starting a parallel region. */
+int nthr_for_cost(int nthr, size_t work_amount, size_t item_cost = 1);
+
 template <typename T, typename U>
 inline void balance211(T n, U team, U tid, T &n_start, T &n_end) {
     T n_min = 1;
@@ -36,6 +36,19 @@
  *  - parallel_nd_in_omp(dims..., f)     - queries current nthr and ithr and
  *                                         then calls for_nd (mostly for
  *                                         convenience)
+ *  - for_nd_vec(ithr, nthr, dims..., f) - for_nd that splits the work in
+ *                                         whole batches of nd_vec_len and
+ *                                         calls f(v0, v1, ..., vl) once per
+ *                                         batch, vi[0..vl) holding the
+ *                                         coordinates of vl consecutive
+ *                                         points (vl < nd_vec_len only for
+ *                                         the last batch)
+ *  - parallel_nd_vec(dims..., f)        - creates a parallel section and then
+ *                                         calls for_nd_vec
+ *  - parallel_nd_cost(cost, dims..., f) - parallel_nd for items of about
+ *                                         cost elementary operations each:
+ *                                         uses nthr_for_cost() threads, so
+ *                                         small work runs inline
  */
 
 #if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_THREADPOOL
@@ -49,11 +62,28 @@ namespace {
 inline int adjust_num_threads(int nthr, size_t work_amount) {
     if (nthr == 0) nthr = dnnl_get_max_threads();
 #if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_OMP
-    return (work_amount == 1 || omp_in_parallel()) ? 1 : nthr;
+    return (work_amount == 1 || dnnl_in_parallel()) ? 1 : nthr;
 #else
     return (int)std::min((size_t)nthr, work_amount);
 #endif
 }
+
+// batch length of for_nd_vec: one full vector register on VE
+#if defined(__ve)
+constexpr size_t nd_vec_len = 256;
+#else
+constexpr size_t nd_vec_len = 32;
+#endif
+
+// balance211 over whole batches, so that only the last thread may get a
+// partial one
+inline void balance211_vec(size_t work_amount, int nthr, int ithr,
+        size_t &start, size_t &end) {
+    const size_t n_batches = utils::div_up(work_amount, nd_vec_len);
+    balance211(n_batches, nthr, ithr, start, end);
+    start = start * nd_vec_len;
+    end = nstl::min(end * nd_vec_len, work_amount);
+}
 } // namespace
 
 /* general parallelization */
@@ -75,7 +105,13 @@ void parallel(int nthr, F f) {
         f(0, 1);
         return;
     }
-#if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_OMP
+#if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_OMP && DNNL_THR_TEAM
+    if (nthr <= thread_team_utils::team_size()) {
+        auto call_f = [](void *ctx, int ithr_, int nthr_) {
+            (*static_cast<F *>(ctx))(ithr_, nthr_);
+        };
+        if (thread_team_utils::run(nthr, call_f, &f)) return;
+    }
 #if 1 && !defined(NDEBUG) && defined(__ve)
     if (omp_in_parallel()){
         printf(" warning: nested parallelism - pre-existing nthr=%d"
@@ -490,6 +526,309 @@ void parallel_nd(const T0 &D0, const T1 &D1, const T2 &D2, const T3 &D3,
         });
 }
 
+/* for_nd_vec section */
+
+template <typename T0, typename F>
+void for_nd_vec(const int ithr, const int nthr, const T0 &D0, F f) {
+    const size_t work_amount = (size_t)D0;
+    if (work_amount == 0) return;
+    size_t start {0}, end {0};
+    balance211_vec(work_amount, nthr, ithr, start, end);
+
+    T0 v0[nd_vec_len];
+    for (size_t iwork = start; iwork < end; iwork += nd_vec_len) {
+        const int vl = (int)nstl::min(end - iwork, (size_t)nd_vec_len);
+        for (int i = 0; i < vl; ++i)
+            v0[i] = (T0)(iwork + i);
+        f(v0, vl);
+    }
+}
+
+template <typename T0, typename T1, typename F>
+void for_nd_vec(const int ithr, const int nthr, const T0 &D0, const T1 &D1,
+        F f) {
+    const size_t work_amount = (size_t)D0 * D1;
+    if (work_amount == 0) return;
+    size_t start {0}, end {0};
+    balance211_vec(work_amount, nthr, ithr, start, end);
+
+    T0 d0 {0};
+    T1 d1 {0};
+    utils::nd_iterator_init(start, d0, D0, d1, D1);
+    T0 v0[nd_vec_len];
+    T1 v1[nd_vec_len];
+    for (size_t iwork = start; iwork < end; iwork += nd_vec_len) {
+        const int vl = (int)nstl::min(end - iwork, (size_t)nd_vec_len);
+        for (int i = 0, run = 0; i < vl; i += run) {
+            run = (int)nstl::min((size_t)(vl - i), (size_t)(D1 - d1));
+            for (int j = 0; j < run; ++j) {
+                v0[i + j] = d0;
+                v1[i + j] = (T1)(d1 + j);
+            }
+            d1 += run;
+            if (d1 == D1) {
+                d1 = 0;
+                utils::nd_iterator_step(d0, D0);
+            }
+        }
+        f(v0, v1, vl);
+    }
+}
+
+template <typename T0, typename T1, typename T2, typename F>
+void for_nd_vec(const int ithr, const int nthr, const T0 &D0, const T1 &D1,
+        const T2 &D2, F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2;
+    if (work_amount == 0) return;
+    size_t start {0}, end {0};
+    balance211_vec(work_amount, nthr, ithr, start, end);
+
+    T0 d0 {0};
+    T1 d1 {0};
+    T2 d2 {0};
+    utils::nd_iterator_init(start, d0, D0, d1, D1, d2, D2);
+    T0 v0[nd_vec_len];
+    T1 v1[nd_vec_len];
+    T2 v2[nd_vec_len];
+    for (size_t iwork = start; iwork < end; iwork += nd_vec_len) {
+        const int vl = (int)nstl::min(end - iwork, (size_t)nd_vec_len);
+        for (int i = 0, run = 0; i < vl; i += run) {
+            run = (int)nstl::min((size_t)(vl - i), (size_t)(D2 - d2));
+            for (int j = 0; j < run; ++j) {
+                v0[i + j] = d0;
+                v1[i + j] = d1;
+                v2[i + j] = (T2)(d2 + j);
+            }
+            d2 += run;
+            if (d2 == D2) {
+                d2 = 0;
+                utils::nd_iterator_step(d0, D0, d1, D1);
+            }
+        }
+        f(v0, v1, v2, vl);
+    }
+}
+
+template <typename T0, typename T1, typename T2, typename T3, typename F>
+void for_nd_vec(const int ithr, const int nthr, const T0 &D0, const T1 &D1,
+        const T2 &D2, const T3 &D3, F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2 * D3;
+    if (work_amount == 0) return;
+    size_t start {0}, end {0};
+    balance211_vec(work_amount, nthr, ithr, start, end);
+
+    T0 d0 {0};
+    T1 d1 {0};
+    T2 d2 {0};
+    T3 d3 {0};
+    utils::nd_iterator_init(start, d0, D0, d1, D1, d2, D2, d3, D3);
+    T0 v0[nd_vec_len];
+    T1 v1[nd_vec_len];
+    T2 v2[nd_vec_len];
+    T3 v3[nd_vec_len];
+    for (size_t iwork = start; iwork < end; iwork += nd_vec_len) {
+        const int vl = (int)nstl::min(end - iwork, (size_t)nd_vec_len);
+        for (int i = 0, run = 0; i < vl; i += run) {
+            run = (int)nstl::min((size_t)(vl - i), (size_t)(D3 - d3));
+            for (int j = 0; j < run; ++j) {
+                v0[i + j] = d0;
+                v1[i + j] = d1;
+                v2[i + j] = d2;
+                v3[i + j] = (T3)(d3 + j);
+            }
+            d3 += run;
+            if (d3 == D3) {
+                d3 = 0;
+                utils::nd_iterator_step(d0, D0, d1, D1, d2, D2);
+            }
+        }
+        f(v0, v1, v2, v3, vl);
+    }
+}
+
+template <typename T0, typename T1, typename T2, typename T3, typename T4,
+        typename F>
+void for_nd_vec(const int ithr, const int nthr, const T0 &D0, const T1 &D1,
+        const T2 &D2, const T3 &D3, const T4 &D4, F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2 * D3 * D4;
+    if (work_amount == 0) return;
+    size_t start {0}, end {0};
+    balance211_vec(work_amount, nthr, ithr, start, end);
+
+    T0 d0 {0};
+    T1 d1 {0};
+    T2 d2 {0};
+    T3 d3 {0};
+    T4 d4 {0};
+    utils::nd_iterator_init(start, d0, D0, d1, D1, d2, D2, d3, D3, d4, D4);
+    T0 v0[nd_vec_len];
+    T1 v1[nd_vec_len];
+    T2 v2[nd_vec_len];
+    T3 v3[nd_vec_len];
+    T4 v4[nd_vec_len];
+    for (size_t iwork = start; iwork < end; iwork += nd_vec_len) {
+        const int vl = (int)nstl::min(end - iwork, (size_t)nd_vec_len);
+        for (int i = 0, run = 0; i < vl; i += run) {
+            run = (int)nstl::min((size_t)(vl - i), (size_t)(D4 - d4));
+            for (int j = 0; j < run; ++j) {
+                v0[i + j] = d0;
+                v1[i + j] = d1;
+                v2[i + j] = d2;
+                v3[i + j] = d3;
+                v4[i + j] = (T4)(d4 + j);
+            }
+            d4 += run;
+            if (d4 == D4) {
+                d4 = 0;
+                utils::nd_iterator_step(d0, D0, d1, D1, d2, D2, d3, D3);
+            }
+        }
+        f(v0, v1, v2, v3, v4, vl);
+    }
+}
+
+template <typename T0, typename T1, typename T2, typename T3, typename T4,
+        typename T5, typename F>
+void for_nd_vec(const int ithr, const int nthr, const T0 &D0, const T1 &D1,
+        const T2 &D2, const T3 &D3, const T4 &D4, const T5 &D5, F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2 * D3 * D4 * D5;
+    if (work_amount == 0) return;
+    size_t start {0}, end {0};
+    balance211_vec(work_amount, nthr, ithr, start, end);
+
+    T0 d0 {0};
+    T1 d1 {0};
+    T2 d2 {0};
+    T3 d3 {0};
+    T4 d4 {0};
+    T5 d5 {0};
+    utils::nd_iterator_init(
+            start, d0, D0, d1, D1, d2, D2, d3, D3, d4, D4, d5, D5);
+    T0 v0[nd_vec_len];
+    T1 v1[nd_vec_len];
+    T2 v2[nd_vec_len];
+    T3 v3[nd_vec_len];
+    T4 v4[nd_vec_len];
+    T5 v5[nd_vec_len];
+    for (size_t iwork = start; iwork < end; iwork += nd_vec_len) {
+        const int vl = (int)nstl::min(end - iwork, (size_t)nd_vec_len);
+        for (int i = 0, run = 0; i < vl; i += run) {
+            run = (int)nstl::min((size_t)(vl - i), (size_t)(D5 - d5));
+            for (int j = 0; j < run; ++j) {
+                v0[i + j] = d0;
+                v1[i + j] = d1;
+                v2[i + j] = d2;
+                v3[i + j] = d3;
+                v4[i + j] = d4;
+                v5[i + j] = (T5)(d5 + j);
+            }
+            d5 += run;
+            if (d5 == D5) {
+                d5 = 0;
+                utils::nd_iterator_step(d0, D0, d1, D1, d2, D2, d3, D3, d4, D4);
+            }
+        }
+        f(v0, v1, v2, v3, v4, v5, vl);
+    }
+}
+
+/* parallel_nd_vec section */
+
+template <typename T0, typename F>
+void parallel_nd_vec(const T0 &D0, F f) {
+    const size_t work_amount = (size_t)D0;
+    int nthr = adjust_num_threads(
+            dnnl_get_max_threads(), utils::div_up(work_amount, nd_vec_len));
+    if (nthr)
+        parallel(nthr, [&](int ithr, int nthr) {
+            for_nd_vec(ithr, nthr, D0, f);
+        });
+}
+
+template <typename T0, typename T1, typename F>
+void parallel_nd_vec(const T0 &D0, const T1 &D1, F f) {
+    const size_t work_amount = (size_t)D0 * D1;
+    int nthr = adjust_num_threads(
+            dnnl_get_max_threads(), utils::div_up(work_amount, nd_vec_len));
+    if (nthr)
+        parallel(nthr, [&](int ithr, int nthr) {
+            for_nd_vec(ithr, nthr, D0, D1, f);
+        });
+}
+
+template <typename T0, typename T1, typename T2, typename F>
+void parallel_nd_vec(const T0 &D0, const T1 &D1, const T2 &D2, F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2;
+    int nthr = adjust_num_threads(
+            dnnl_get_max_threads(), utils::div_up(work_amount, nd_vec_len));
+    if (nthr)
+        parallel(nthr, [&](int ithr, int nthr) {
+            for_nd_vec(ithr, nthr, D0, D1, D2, f);
+        });
+}
+
+template <typename T0, typename T1, typename T2, typename T3, typename F>
+void parallel_nd_vec(const T0 &D0, const T1 &D1, const T2 &D2, const T3 &D3,
+        F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2 * D3;
+    int nthr = adjust_num_threads(
+            dnnl_get_max_threads(), utils::div_up(work_amount, nd_vec_len));
+    if (nthr)
+        parallel(nthr, [&](int ithr, int nthr) {
+            for_nd_vec(ithr, nthr, D0, D1, D2, D3, f);
+        });
+}
+
+template <typename T0, typename T1, typename T2, typename T3, typename T4,
+        typename F>
+void parallel_nd_vec(const T0 &D0, const T1 &D1, const T2 &D2, const T3 &D3,
+        const T4 &D4, F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2 * D3 * D4;
+    int nthr = adjust_num_threads(
+            dnnl_get_max_threads(), utils::div_up(work_amount, nd_vec_len));
+    if (nthr)
+        parallel(nthr, [&](int ithr, int nthr) {
+            for_nd_vec(ithr, nthr, D0, D1, D2, D3, D4, f);
+        });
+}
+
+template <typename T0, typename T1, typename T2, typename T3, typename T4,
+        typename T5, typename F>
+void parallel_nd_vec(const T0 &D0, const T1 &D1, const T2 &D2, const T3 &D3,
+        const T4 &D4, const T5 &D5, F f) {
+    const size_t work_amount = (size_t)D0 * D1 * D2 * D3 * D4 * D5;
+    int nthr = adjust_num_threads(
+            dnnl_get_max_threads(), utils::div_up(work_amount, nd_vec_len));
+    if (nthr)
+        parallel(nthr, [&](int ithr, int nthr) {
+            for_nd_vec(ithr, nthr, D0, D1, D2, D3, D4, D5, f);
+        });
+}
+/* parallel_nd_cost section */
+
+namespace {
+template <typename F>
+size_t nd_work_amount(const F &) {
+    return 1;
+}
+template <typename T, typename... Args>
+size_t nd_work_amount(const T &D, const Args &... args) {
+    return (size_t)D * nd_work_amount(args...);
+}
+} // namespace
+
+/* Rough cost, in elementary operations, of one element of the dense
+ * element-wise reference kernels (eltwise, binary) */
+constexpr size_t elementwise_item_cost = 8;
+
+template <typename... Args>
+void parallel_nd_cost(size_t item_cost, const Args &... args) {
+    const size_t work_amount = nd_work_amount(args...);
+    if (work_amount == 0) return;
+    const int nthr = nthr_for_cost(0, work_amount, item_cost);
+    parallel(nthr, [&](int ithr, int nthr) { for_nd(ithr, nthr, args...); });
+}
+
 /* parallel_nd_in_omp section */
 
 template <typename... Args>
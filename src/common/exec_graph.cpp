@@ -0,0 +1,196 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "dnnl.h"
+
+#include "c_types_map.hpp"
+#include "engine.hpp"
+#include "memory.hpp"
+#include "memory_tracking.hpp"
+#include "primitive.hpp"
+#include "primitive_exec_types.hpp"
+#include "scratchpad.hpp"
+#include "stream.hpp"
+#include "utils.hpp"
+
+#include "exec_graph.hpp"
+
+using namespace dnnl::impl;
+using namespace dnnl::impl::status;
+using namespace dnnl::impl::utils;
+
+struct dnnl_exec_graph : public c_compatible {
+    dnnl_exec_graph(engine_t *engine) : engine(engine) {}
+
+    struct step_t {
+        const primitive_iface_t *primitive_iface;
+        exec_args_t args;
+        // built by finalize
+        std::unique_ptr<memory_tracking::grantor_t> grantor;
+        // built by the first replay on a stream
+        std::unique_ptr<exec_ctx_t> ctx;
+    };
+
+    memory_t *proxy(memory_t *mem) {
+        auto it = proxies.find(mem);
+        if (it != proxies.end()) return it->second.get();
+        void *handle = nullptr;
+        mem->get_data_handle(&handle);
+        std::unique_ptr<memory_t> p(new memory_t(engine, mem->md(),
+                memory_flags_t::use_runtime_ptr | memory_flags_t::omit_zero_pad,
+                handle));
+        if (p->memory_storage() == nullptr) return nullptr;
+        return (proxies[mem] = std::move(p)).get();
+    }
+
+    // The scratchpad of a step holds nothing past the execution of the
+    // step, and the steps run one after another, so the live ranges of the
+    // step scratchpads never overlap: all of them start at the beginning of
+    // one buffer of the size of the largest.
+    status_t plan_scratchpad() {
+        size_t size = 0;
+        for (const auto &step : steps)
+            size = nstl::max(size,
+                    (size_t)step.primitive_iface->impl()->pd()->scratchpad_size(
+                            scratchpad_mode::library));
+        if (size) {
+            scratchpad.reset(create_scratchpad(engine, size, false));
+            if (scratchpad == nullptr
+                    || scratchpad->get_memory_storage() == nullptr
+                    || scratchpad->size() < size)
+                return out_of_memory;
+        }
+        scratchpad_size = size;
+
+        for (auto &step : steps) {
+            const auto *pd = step.primitive_iface->impl()->pd().get();
+            const memory_storage_t *mem_storage = nullptr;
+            if (pd->attr()->scratchpad_mode_ == scratchpad_mode::user) {
+                auto it = step.args.find(DNNL_ARG_SCRATCHPAD);
+                if (it != step.args.end())
+                    mem_storage = it->second.mem->memory_storage();
+            } else if (pd->scratchpad_size(scratchpad_mode::library)) {
+                mem_storage = scratchpad->get_memory_storage();
+            }
+            step.grantor.reset(new memory_tracking::grantor_t(
+                    pd->scratchpad_registry().grantor(mem_storage)));
+        }
+        return success;
+    }
+
+    void bind_stream(stream_t *s) {
+        for (auto &step : steps) {
+            step.ctx.reset(new exec_ctx_t(s, exec_args_t(step.args)));
+            step.ctx->set_scratchpad_grantor(step.grantor.get());
+            step.ctx->set_resource_mapper(
+                    step.primitive_iface->resource_mapper());
+        }
+        stream = s;
+    }
+
+    engine_t *engine;
+    bool finalized = false;
+    stream_t *stream = nullptr;
+    std::vector<step_t> steps;
+    std::unordered_map<const memory_t *, std::unique_ptr<memory_t>> proxies;
+    std::unique_ptr<scratchpad_t> scratchpad;
+    size_t scratchpad_size = 0;
+};
+
+status_t dnnl::impl::exec_graph_get_info(
+        const exec_graph_t *graph, exec_graph_info_t *info) {
+    if (any_null(graph, info)) return invalid_arguments;
+    info->n_steps = graph->steps.size();
+    info->n_memories = graph->proxies.size();
+    info->scratchpad_size = graph->scratchpad_size;
+    return success;
+}
+
+/* API */
+
+status_t dnnl_exec_graph_create(exec_graph_t **graph, engine_t *engine) {
+    if (any_null(graph, engine)) return invalid_arguments;
+    *graph = new exec_graph_t(engine);
+    return success;
+}
+
+status_t dnnl_exec_graph_append(exec_graph_t *graph,
+        const primitive_iface_t *primitive_iface, int nargs,
+        const dnnl_exec_arg_t *c_args) {
+    bool ok = !any_null(graph, primitive_iface) && !graph->finalized
+            && primitive_iface->engine() == graph->engine
+            && IMPLICATION(nargs > 0, c_args != nullptr);
+    if (!ok) return invalid_arguments;
+
+    exec_args_t args;
+    CHECK(cvt_primtive_args(
+            primitive_iface->pd()->impl().get(), nargs, c_args, args));
+    for (auto &arg : args) {
+        arg.second.mem = graph->proxy(arg.second.mem);
+        if (arg.second.mem == nullptr) return out_of_memory;
+    }
+
+    graph->steps.emplace_back();
+    auto &step = graph->steps.back();
+    step.primitive_iface = primitive_iface;
+    step.args = std::move(args);
+    return success;
+}
+
+status_t dnnl_exec_graph_finalize(exec_graph_t *graph) {
+    if (graph == nullptr || graph->finalized) return invalid_arguments;
+    CHECK(graph->plan_scratchpad());
+    graph->finalized = true;
+    return success;
+}
+
+status_t dnnl_exec_graph_replay(exec_graph_t *graph, stream_t *stream,
+        int nbindings, const dnnl_exec_graph_binding_t *bindings) {
+    bool ok = !any_null(graph, stream) && graph->finalized
+            && stream->engine() == graph->engine
+            && IMPLICATION(nbindings > 0, bindings != nullptr);
+    if (!ok) return invalid_arguments;
+
+    for (int i = 0; i < nbindings; ++i) {
+        auto it = graph->proxies.find(bindings[i].memory);
+        if (it == graph->proxies.end()) return invalid_arguments;
+        CHECK(it->second->set_data_handle(bindings[i].handle));
+    }
+
+    // steps run on the calling thread, after what is pending on the stream
+    if (stream->flags() & stream_flags::out_of_order) CHECK(stream->wait());
+    if (stream != graph->stream) graph->bind_stream(stream);
+
+    status_t status = success;
+    stream->before_exec_hook();
+    for (auto &step : graph->steps) {
+        status = execute_primitive(step.primitive_iface, *step.ctx, false);
+        if (status != success) break;
+    }
+    stream->after_exec_hook();
+    return status;
+}
+
+status_t dnnl_exec_graph_destroy(exec_graph_t *graph) {
+    delete graph;
+    return success;
+}
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
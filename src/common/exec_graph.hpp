@@ -0,0 +1,55 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef COMMON_EXEC_GRAPH_HPP
+#define COMMON_EXEC_GRAPH_HPP
+
+#include <stddef.h>
+
+#include "dnnl_types.h"
+
+#include "c_types_map.hpp"
+
+namespace dnnl {
+namespace impl {
+
+// Captured sequence of primitive executions (dnnl_exec_graph_*() in dnnl.h).
+//
+// Appending converts the arguments once and points them to proxies: memory
+// objects of the graph that copy the descriptor and the data handle of the
+// captured ones, so a binding at replay changes the proxy only. Finalizing
+// plans the scratchpad of the steps and builds the grantor of every step.
+// The execution contexts need a stream: they are built at the first replay
+// on a stream, with the grantors and resource mappers set, and rebuilt only
+// when a replay comes on another stream. A step then runs the primitive
+// implementation on its prebuilt context directly.
+
+struct exec_graph_info_t {
+    size_t n_steps;
+    /** distinct memory objects captured */
+    size_t n_memories;
+    /** scratchpad the graph allocated for its steps */
+    size_t scratchpad_size;
+};
+
+// undocumented API, for testing only
+status_t DNNL_API exec_graph_get_info(
+        const exec_graph_t *graph, exec_graph_info_t *info);
+
+} // namespace impl
+} // namespace dnnl
+
+#endif
@@ -0,0 +1,165 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef COMMON_FAST_DIV_HPP
+#define COMMON_FAST_DIV_HPP
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "c_types_map.hpp"
+
+namespace dnnl {
+namespace impl {
+
+/** Unsigned division by a run-time invariant divisor as multiply-add-shift.
+ *
+ * Set up once (one hardware division), then \c n/d and \c n%d cost a
+ * multiply, an add and a shift (plus a multiply-subtract for the remainder),
+ * which vectorizes where a hardware divide does not or is slow (VE).
+ * Same magic numbers as vednn_fastdiv() in ve/ve_fastdiv.h.
+ *
+ * \pre 0 < d <= UINT32_MAX, and numerators n <= UINT32_MAX, so that all
+ *      intermediates fit in 64 bits. Use ok_for() to check a range once.
+ */
+struct fast_div_t {
+    fast_div_t() : fast_div_t(1) {}
+    fast_div_t(dim_t d) : d_((uint32_t)d) {
+        assert(d > 0 && (uint64_t)d <= UINT32_MAX);
+        uint32_t l = 0;
+        while ((d_ >> l) > 1)
+            ++l;
+        if (d_ & (d_ - 1)) {
+            const uint64_t m = (uint64_t)1 << (l + 32);
+            mul_ = (uint32_t)(m / d_);
+            const uint32_t r = (uint32_t)(m - mul_ * d_);
+            if (d_ - r < ((uint64_t)1 << l)) {
+                ++mul_;
+                add_ = 0;
+            } else {
+                add_ = mul_;
+            }
+            shr_ = 32 + l;
+        } else {
+            mul_ = 1;
+            add_ = 0;
+            shr_ = l;
+        }
+    }
+
+    /** whether numerators up to \c max_n are supported */
+    static constexpr bool ok_for(uint64_t max_n) { return max_n <= UINT32_MAX; }
+
+    dim_t divisor() const { return d_; }
+    uint64_t div(uint64_t n) const { return (n * mul_ + add_) >> shr_; }
+    uint64_t mod(uint64_t n) const { return n - div(n) * d_; }
+
+private:
+    uint64_t mul_;
+    uint64_t add_;
+    uint32_t shr_;
+    uint32_t d_;
+};
+
+/* With these a fast_div_t can stand in for a dimension in
+ * utils::nd_iterator_init(), nd_iterator_step() and nd_iterator_jump(). */
+inline uint64_t operator/(uint64_t n, const fast_div_t &d) {
+    return d.div(n);
+}
+inline uint64_t operator%(uint64_t n, const fast_div_t &d) {
+    return d.mod(n);
+}
+template <typename T>
+inline bool operator>=(const T &x, const fast_div_t &d) {
+    return (dim_t)x >= d.divisor();
+}
+template <typename T>
+inline T operator-(const fast_div_t &d, const T &x) {
+    return (T)d.divisor() - x;
+}
+
+/** Divisors for the dims of a (row-major, outermost first) N-d index space.
+ *
+ * Built once (e.g. in pd_t::init()) when the space has at most UINT32_MAX
+ * points, after which linear indices map to coordinates without hardware
+ * division. ok() is false for larger spaces; callers then keep the plain
+ * `/` and `%` path.
+ */
+struct dims_fast_div_t {
+    dims_fast_div_t() = default;
+    dims_fast_div_t(int ndims, const dims_t dims) { init(ndims, dims); }
+
+    void init(int ndims, const dims_t dims) {
+        ndims_ = ndims;
+        uint64_t nelems = 1;
+        for (int d = 0; d < ndims; ++d) {
+            if (dims[d] <= 0 || !fast_div_t::ok_for(nelems * dims[d])) {
+                ok_ = false;
+                return;
+            }
+            nelems *= dims[d];
+        }
+        for (int d = 0; d < ndims; ++d)
+            div_[d] = fast_div_t(dims[d]);
+        ok_ = true;
+    }
+
+    bool ok() const { return ok_; }
+    int ndims() const { return ndims_; }
+    const fast_div_t &operator[](int d) const { return div_[d]; }
+
+    /** coordinates \c pos[0..ndims) of linear index \c l */
+    void coords(uint64_t l, dim_t *pos) const {
+        assert(ok_);
+        for (int d = ndims_ - 1; d > 0; --d) {
+            const uint64_t q = div_[d].div(l);
+            pos[d] = (dim_t)(l - q * div_[d].divisor());
+            l = q;
+        }
+        pos[0] = (dim_t)l;
+    }
+
+    /** coordinates of \c n linear indices: \c pos[d][i] for \c l[i].
+     * \c pos[0] may alias \c l. Each loop over \c i vectorizes. */
+    template <typename L, typename P>
+    void vec_coords(const L *l, int n, P *const *pos) const {
+        assert(ok_);
+        P *rem = pos[0];
+        if ((const void *)rem != (const void *)l)
+            for (int i = 0; i < n; ++i)
+                rem[i] = (P)l[i];
+        for (int d = ndims_ - 1; d > 0; --d) {
+            const fast_div_t &fd = div_[d];
+            const P D = (P)fd.divisor();
+            P *p = pos[d];
+            for (int i = 0; i < n; ++i) {
+                const P q = (P)fd.div((uint64_t)rem[i]);
+                p[i] = rem[i] - q * D;
+                rem[i] = q;
+            }
+        }
+    }
+
+private:
+    int ndims_ = 0;
+    bool ok_ = false;
+    fast_div_t div_[DNNL_MAX_NDIMS];
+};
+
+} // namespace impl
+} // namespace dnnl
+
+#endif
@@ -20,6 +20,7 @@
 #include <math.h>
 #include <stdint.h>
 
+#include "bit_cast.hpp"
 #include "dnnl_traits.hpp"
 #include "nstl.hpp"
 #include "utils.hpp"
@@ -242,6 +243,63 @@ inline U logistic_bwd_use_dst(T dd, T d) {
     return (U)(dd * d * (1 - d));
 }
 
+/* c ? a : b through a bit mask. Compilers that keep floating-point compares
+ * trapping (gcc by default) do not if-convert the plain ternary when its
+ * result feeds more arithmetic, which leaves the loop scalar. */
+inline float fast_select(bool c, float a, float b) {
+    const uint32_t m = (uint32_t)0 - (uint32_t)c;
+    return utils::bit_cast<float>((utils::bit_cast<uint32_t>(a) & m)
+            | (utils::bit_cast<uint32_t>(b) & ~m));
+}
+
+/* Branch-free exp, logistic and tanh that vectorize inside simd loops, unlike
+ * the libm calls above. exp reduces to r = s - n * ln2 with |r| <= ln2 / 2,
+ * takes a degree 6 Taylor polynomial of r and scales it by 2^n through the
+ * exponent bits; the relative error stays below 3e-7 for s in
+ * [-87.3, 88.3], and s is clamped to that range. A NaN is replaced by 0
+ * before the conversion to int, which would be undefined for it, and is
+ * returned as is. */
+inline float fast_exp_fwd(float s) {
+    const float log2e = 1.44269504f;
+    const float ln2_hi = 0.693359375f, ln2_lo = -2.12194440e-4f;
+    const bool is_nan = s != s;
+    float x = fast_select(is_nan, 0.f, s);
+    x = fast_select(x < -87.3365f, -87.3365f, x);
+    x = fast_select(x > 88.3762f, 88.3762f, x);
+    const float fn = x * log2e;
+    const int n = (int)(fn + fast_select(fn < 0.f, -0.5f, 0.5f));
+    const float r = (x - n * ln2_hi) - n * ln2_lo;
+    float p = 1.f / 720;
+    p = p * r + 1.f / 120;
+    p = p * r + 1.f / 24;
+    p = p * r + 1.f / 6;
+    p = p * r + 0.5f;
+    p = p * r + 1.f;
+    p = p * r + 1.f;
+    const float e = p * utils::bit_cast<float>((uint32_t)(n + 127) << 23);
+    return fast_select(is_nan, s, e);
+}
+
+inline float fast_logistic_fwd(float s) {
+    return 1.f / (1.f + fast_exp_fwd(-s));
+}
+
+/* (1 - e) / (1 + e) with e = exp(-2|s|) cancels for small |s|, where an odd
+ * Taylor polynomial takes over. */
+inline float fast_tanh_fwd(float s) {
+    const float a = fast_select(s < 0.f, -s, s);
+    const float e = fast_exp_fwd(-2.f * a);
+    const float big = (1.f - e) / (1.f + e);
+    const float a2 = a * a;
+    const float small = a
+            * (1.f
+                    + a2
+                            * (-1.f / 3
+                                    + a2 * (2.f / 15 + a2 * (-17.f / 315))));
+    const float t = fast_select(a < 0.125f, small, big);
+    return fast_select(s < 0.f, -t, t);
+}
+
 template <typename T, typename U = typename utils::remove_reference<T>::type>
 inline U exp_fwd(T s) {
     return (U)(::expf((float)s));
@@ -0,0 +1,200 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "dnnl.h"
+
+#include "dnnl_thread.hpp"
+#include "engine.hpp"
+#include "persistent_pd_cache.hpp"
+#include "primitive_desc.hpp"
+#include "primitive_hashing.hpp"
+#include "utils.hpp"
+
+#include "cpu/platform.hpp"
+
+namespace dnnl {
+namespace impl {
+
+using namespace primitive_hashing;
+
+namespace {
+
+// Records are only valid for the library build that wrote them: the
+// implementation lists change between versions and configurations, and
+// what an entry accepts depends on the CPU ISA it may use.
+size_t get_build_id() {
+    const dnnl_version_t *v = dnnl_version();
+    size_t seed = 0;
+    seed = hash_combine(seed, v->major);
+    seed = hash_combine(seed, v->minor);
+    seed = hash_combine(seed, v->patch);
+    seed = hash_combine(seed, std::string(v->hash ? v->hash : ""));
+    seed = hash_combine(seed, v->cpu_runtime);
+    seed = hash_combine(seed, v->gpu_runtime);
+    seed = hash_combine(seed, sizeof(void *));
+    // the ISA dispatch uses, DNNL_MAX_CPU_ISA applied
+    seed = hash_combine(seed, std::string(cpu::platform::get_isa_info()));
+    return seed;
+}
+
+size_t get_key(const op_desc_t *op_desc, const primitive_attr_t *attr,
+        engine_t *engine, const primitive_desc_t *hint_fwd_pd) {
+    const primitive_attr_t default_attr;
+    size_t seed = 0;
+    seed = hash_combine(seed, static_cast<size_t>(op_desc->kind));
+    seed = get_op_desc_hash(seed, op_desc->kind, op_desc);
+    seed = hash_combine(seed, get_attr_hash(attr ? attr : &default_attr));
+    seed = hash_combine(seed, static_cast<size_t>(engine->kind()));
+    seed = hash_combine(seed, static_cast<size_t>(engine->runtime_kind()));
+    seed = hash_combine(seed, dnnl_get_max_threads());
+    if (hint_fwd_pd) {
+        seed = hash_combine(seed, std::string(hint_fwd_pd->name()));
+        for (int i = 0; i < hint_fwd_pd->n_outputs(); ++i)
+            seed = hash_combine(
+                    seed, get_md_hash(*hint_fwd_pd->output_md(i)));
+        seed = hash_combine(
+                seed, get_md_hash(*hint_fwd_pd->workspace_md()));
+    }
+    return seed;
+}
+
+// What the walk resolved: all memory descriptors (including formats chosen
+// for `any`) and the scratchpad size.
+size_t get_pd_hash(const primitive_desc_t *pd) {
+    size_t seed = 0;
+    for (int i = 0; i < pd->n_inputs(); ++i)
+        seed = hash_combine(seed, get_md_hash(*pd->input_md(i)));
+    for (int i = 0; i < pd->n_outputs(); ++i)
+        seed = hash_combine(seed, get_md_hash(*pd->output_md(i)));
+    seed = hash_combine(seed, get_md_hash(*pd->workspace_md()));
+    seed = hash_combine(seed, pd->scratchpad_registry().size());
+    return seed;
+}
+
+} // namespace
+
+persistent_pd_cache_t::persistent_pd_cache_t() : build_id_(get_build_id()) {
+    char path[1024];
+    if (getenv("DNNL_PD_CACHE_FILE", path, sizeof(path)) > 0) path_ = path;
+}
+
+void persistent_pd_cache_t::load() {
+    loaded_ = true;
+    FILE *f = fopen(path_.c_str(), "r");
+    if (!f) return;
+
+    char name[256];
+    size_t build_id, key, pd_hash;
+    int impl_idx;
+    while (fscanf(f, "%zx %zx %d %zx %255s", &build_id, &key, &impl_idx,
+                   &pd_hash, name)
+            == 5) {
+        if (build_id != build_id_ || impl_idx < 0) continue;
+        entries_[key] = {impl_idx, pd_hash, name};
+    }
+    fclose(f);
+}
+
+primitive_desc_t *persistent_pd_cache_t::replay(const op_desc_t *op_desc,
+        const primitive_attr_t *attr, engine_t *engine,
+        const primitive_desc_t *hint_fwd_pd) {
+    const size_t key = get_key(op_desc, attr, engine, hint_fwd_pd);
+
+    entry_t e;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!loaded_) load();
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return nullptr;
+        e = it->second;
+    }
+
+    // the recorded index must still point inside the implementation list
+    auto impl_list = engine->get_implementation_list(op_desc);
+    for (int i = 0; i <= e.impl_idx; ++i)
+        if (impl_list[i] == nullptr) return nullptr;
+
+    const primitive_attr_t pd_attr = attr ? *attr : primitive_attr_t();
+    primitive_desc_t *pd = nullptr;
+    status_t s = impl_list[e.impl_idx](
+            &pd, op_desc, &pd_attr, engine, hint_fwd_pd);
+    if (s != status::success || pd == nullptr) return nullptr;
+
+    if (e.impl_name != pd->name() || e.pd_hash != get_pd_hash(pd)) {
+        delete pd;
+        return nullptr;
+    }
+    ++replays_;
+    return pd;
+}
+
+void persistent_pd_cache_t::record(const op_desc_t *op_desc,
+        const primitive_attr_t *attr, engine_t *engine,
+        const primitive_desc_t *hint_fwd_pd, int impl_idx,
+        const primitive_desc_t *pd) {
+    const size_t key = get_key(op_desc, attr, engine, hint_fwd_pd);
+    entry_t e = {impl_idx, get_pd_hash(pd), pd->name()};
+    // names are whitespace-free in this tree; anything else can not be
+    // read back
+    if (e.impl_name.empty()
+            || e.impl_name.find_first_of(" \t\n") != std::string::npos)
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded_) load();
+    auto it = entries_.find(key);
+    if (it != entries_.end() && it->second.impl_idx == e.impl_idx
+            && it->second.pd_hash == e.pd_hash
+            && it->second.impl_name == e.impl_name)
+        return;
+    entries_[key] = e;
+
+    FILE *f = fopen(path_.c_str(), "a");
+    if (!f) return;
+    fprintf(f, "%zx %zx %d %zx %s\n", build_id_, key, e.impl_idx, e.pd_hash,
+            e.impl_name.c_str());
+    fflush(f);
+    fclose(f);
+}
+
+void persistent_pd_cache_t::reload() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    loaded_ = false;
+}
+
+persistent_pd_cache_t &persistent_pd_cache() {
+    static persistent_pd_cache_t cache;
+    return cache;
+}
+
+// undocumented API, for testing only
+status_t reload_persistent_pd_cache() {
+    persistent_pd_cache().reload();
+    return status::success;
+}
+
+status_t get_persistent_pd_cache_replays(int *replays) {
+    if (replays == nullptr) return status::invalid_arguments;
+    *replays = persistent_pd_cache().replays();
+    return status::success;
+}
+
+} // namespace impl
+} // namespace dnnl
@@ -0,0 +1,96 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef COMMON_PERSISTENT_PD_CACHE_HPP
+#define COMMON_PERSISTENT_PD_CACHE_HPP
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "c_types_map.hpp"
+#include "primitive_attr.hpp"
+
+namespace dnnl {
+namespace impl {
+
+struct primitive_desc_t;
+
+/** Opt-in on-disk record of implementation dispatch decisions.
+ *
+ * Enabled by DNNL_PD_CACHE_FILE=<path>. For every primitive descriptor made
+ * by dnnl_primitive_desc_create() the cache appends one line with a hash of
+ * the creation arguments (op descriptor, attributes, engine, thread count,
+ * forward hint), the position of the accepting entry in the engine
+ * implementation list, its name and a hash of the memory descriptors and
+ * scratchpad size it resolved. The next process creates the pd straight from
+ * that list entry, skipping the walk over all entries before it, and keeps
+ * the result only if name and hash match the record; otherwise it falls
+ * back to the regular walk.
+ *
+ * pd_t::init() of the chosen implementation still runs: it is what sets up
+ * the implementation state. Records carry an id of the library build and of
+ * the CPU ISA it dispatches for (after DNNL_MAX_CPU_ISA); records of another
+ * id are ignored, since the walk there may prefer another implementation.
+ */
+struct persistent_pd_cache_t {
+    persistent_pd_cache_t();
+
+    bool enabled() const { return !path_.empty(); }
+
+    /** Recreate the recorded pd, or return nullptr (no or stale record) */
+    primitive_desc_t *replay(const op_desc_t *op_desc,
+            const primitive_attr_t *attr, engine_t *engine,
+            const primitive_desc_t *hint_fwd_pd);
+
+    /** Record that entry \c impl_idx of the implementation list made \c pd */
+    void record(const op_desc_t *op_desc, const primitive_attr_t *attr,
+            engine_t *engine, const primitive_desc_t *hint_fwd_pd,
+            int impl_idx, const primitive_desc_t *pd);
+
+    /** Forget the records read so far; the next lookup reads the file */
+    void reload();
+    /** Number of pds created from a record */
+    int replays() const { return replays_; }
+
+private:
+    struct entry_t {
+        int impl_idx;
+        size_t pd_hash;
+        std::string impl_name;
+    };
+
+    void load();
+
+    std::string path_;
+    size_t build_id_;
+    bool loaded_ = false;
+    std::mutex mutex_;
+    std::unordered_map<size_t, entry_t> entries_;
+    std::atomic<int> replays_ {0};
+};
+
+persistent_pd_cache_t &persistent_pd_cache();
+
+// undocumented API, for testing only
+status_t DNNL_API reload_persistent_pd_cache();
+status_t DNNL_API get_persistent_pd_cache_replays(int *replays);
+
+} // namespace impl
+} // namespace dnnl
+
+#endif
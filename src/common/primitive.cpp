@@ -72,6 +72,33 @@ nested_scratchpad_t::~nested_scratchpad_t() {
 #endif
 }
 
+status_t execute_primitive(const primitive_iface_t *primitive_iface,
+        exec_ctx_t &ctx, bool enqueue) {
+    stream_t *stream = ctx.stream();
+    auto execute = [&]() {
+        return enqueue ? stream->enqueue_primitive(primitive_iface, ctx)
+                       : primitive_iface->impl()->execute(ctx);
+    };
+
+    const bool verbose = get_verbose();
+    const bool profiling = profiler::enabled();
+    if (!verbose && !profiling) return execute();
+
+    const uint64_t start = profiler::now_ns();
+    status_t status = execute();
+    const status_t wait_status = stream->wait();
+    if (status == status::success) status = wait_status;
+    const uint64_t duration = profiler::now_ns() - start;
+    if (profiling)
+        profiler::record(primitive_iface->profile_entry(), start, duration);
+    if (verbose) {
+        printf("dnnl_verbose,exec,%s,%g\n", primitive_iface->pd()->info(),
+                1e-6 * duration);
+        fflush(0);
+    }
+    return status;
+}
+
 } // namespace impl
 } // namespace dnnl
 
@@ -104,17 +131,7 @@ status_t dnnl_primitive_execute(const primitive_iface_t *primitive_iface,
     stream->before_exec_hook();
 
     exec_ctx_t ctx(stream, std::move(args));
-
-    if (get_verbose()) {
-        double ms = get_msec();
-        status = primitive_iface->execute(ctx);
-        stream->wait();
-        ms = get_msec() - ms;
-        printf("dnnl_verbose,exec,%s,%g\n", primitive_iface->pd()->info(), ms);
-        fflush(0);
-    } else {
-        status = primitive_iface->execute(ctx);
-    }
+    status = execute_primitive(primitive_iface, ctx, true);
 
     stream->after_exec_hook();
 
@@ -142,7 +159,8 @@ dnnl_primitive::dnnl_primitive(
         const std::shared_ptr<primitive_t> &primitive, engine_t *engine)
     : primitive_(primitive)
     , pd_(utils::make_unique<primitive_desc_iface_t>(
-              primitive_->pd(), engine)) {}
+              primitive_->pd(), engine))
+    , profile_entry_(nullptr) {}
 
 dnnl_primitive::~dnnl_primitive() {
     if (scratchpad_debug::is_protect_scratchpad() && scratchpad_ != nullptr
@@ -191,13 +209,18 @@ const primitive_desc_iface_t *dnnl_primitive::pd() const {
 }
 
 status_t dnnl_primitive::execute(exec_ctx_t &ctx) const {
+    return execute(ctx, scratchpad_.get());
+}
+
+status_t dnnl_primitive::execute(
+        exec_ctx_t &ctx, const scratchpad_t *scratchpad) const {
     const memory_storage_t *mem_storage = nullptr;
     if (primitive_->pd()->attr()->scratchpad_mode_ == scratchpad_mode::user) {
         memory_t *scratchpad_memory = ctx.output(DNNL_ARG_SCRATCHPAD);
         mem_storage = scratchpad_memory ? scratchpad_memory->memory_storage()
                                         : nullptr;
-    } else if (scratchpad_) {
-        mem_storage = scratchpad_->get_memory_storage();
+    } else if (scratchpad) {
+        mem_storage = scratchpad->get_memory_storage();
     }
 
     auto scratchpad_grantor
@@ -209,4 +232,14 @@ status_t dnnl_primitive::execute(exec_ctx_t &ctx) const {
     return status;
 }
 
+profiler::entry_t *dnnl_primitive::profile_entry() const {
+    // racing threads intern the same entry
+    auto *entry = profile_entry_.load(std::memory_order_acquire);
+    if (entry == nullptr) {
+        entry = profiler::intern(primitive_->pd().get(), engine());
+        profile_entry_.store(entry, std::memory_order_release);
+    }
+    return entry;
+}
+
 // vim: et ts=4 sw=4 cindent cino^=l0,\:0,N-s
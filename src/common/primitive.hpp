@@ -19,6 +19,8 @@
 
 #include <assert.h>
 
+#include <atomic>
+
 #include "dnnl.h"
 
 #include "c_types_map.hpp"
@@ -29,6 +31,7 @@
 #endif
 #include "primitive_desc.hpp"
 #include "primitive_exec_types.hpp"
+#include "profiler.hpp"
 #include "rw_mutex.hpp"
 #include "scratchpad.hpp"
 
@@ -84,49 +87,32 @@ protected:
         int nthreads = dnnl_get_max_threads();
         primitive_hashing::key_t key_to_lookup(pd, engine, nthreads);
 
-        if (!is_primitive_nested) primitive_cache_t::rw_mutex().lock_read();
-
-        auto p = global_primitive_cache.get(key_to_lookup);
-        auto status = status::success;
-        bool cache_hit = false;
-        if (p) {
-            if (!is_primitive_nested)
-                primitive_cache_t::rw_mutex().unlock_read();
-            cache_hit = true;
-        } else {
-            if (!is_primitive_nested) {
-                primitive_cache_t::rw_mutex().unlock_read();
-                primitive_cache_t::rw_mutex().lock_write();
-                // double check to workaround the ABA problem
-                p = global_primitive_cache.get(key_to_lookup);
-            }
-
-            if (!p) {
-                // the requested primitive hasn't been added to the cache yet
-                p = std::make_shared<impl_type>(pd);
-                status = p->init(engine, use_global_scratchpad);
-                if (status != status::success) {
-                    if (!is_primitive_nested)
-                        primitive_cache_t::rw_mutex().unlock_write();
-                    return status;
-                }
-                primitive_hashing::key_t key_to_cache(
-                        p->pd().get(), engine, nthreads);
-                global_primitive_cache.add(key_to_cache, p);
-                if (!is_primitive_nested)
-                    primitive_cache_t::rw_mutex().unlock_write();
-                cache_hit = false;
-            } else {
-                // another thread added the requested primitive
-                if (!is_primitive_nested)
-                    primitive_cache_t::rw_mutex().unlock_write();
-                cache_hit = true;
+        // The cache locks only the shard of the key and only for the lookup
+        // itself, so creation runs unlocked and nested primitives need no
+        // special handling. A miss reserves the key: other threads asking
+        // for the same primitive wait for this creation instead of
+        // repeating it.
+        MAYBE_UNUSED(is_primitive_nested);
+        auto p = global_primitive_cache.get_or_reserve(key_to_lookup);
+        bool cache_hit = p != nullptr;
+        if (!p) {
+            double create_ms = get_msec();
+            p = std::make_shared<impl_type>(pd);
+            status_t status = p->init(engine, use_global_scratchpad);
+            if (status != status::success) {
+                global_primitive_cache.cancel(key_to_lookup);
+                return status;
             }
+            global_primitive_cache.add_creation_time(get_msec() - create_ms);
+            // the key of the cache has to outlive pd
+            primitive_hashing::key_t key_to_cache(
+                    p->pd().get(), engine, nthreads);
+            global_primitive_cache.add(key_to_cache, p);
         }
         primitive = p;
         ms = get_msec() - ms;
         print_verbose(get_verbose(), cache_hit, p->pd()->info(engine), ms);
-        return status;
+        return status::success;
     }
 
     std::shared_ptr<primitive_desc_t> pd_;
@@ -153,6 +139,15 @@ private:
     std::unique_ptr<memory_tracking::grantor_t> grantor_;
 };
 
+// Executes the primitive the way the stream of \c ctx runs primitives or,
+// without \c enqueue, runs its implementation on the calling thread with the
+// scratchpad grantor and the resource mapper \c ctx already carries. With
+// verbose output or profiling enabled it waits for the stream and reports
+// the execution time; the first error of the execution and the wait is
+// returned.
+status_t execute_primitive(const primitive_iface_t *primitive_iface,
+        exec_ctx_t &ctx, bool enqueue);
+
 // The resource_t abstraction is a base class for all resource classes.
 // Those are responsible for holding a part of a primitive implementation that
 // cannot be stored in the primitive cache as part of the implementation.
@@ -249,12 +244,27 @@ struct dnnl_primitive : public dnnl::impl::c_compatible {
     dnnl::impl::engine_t *engine() const;
     const primitive_desc_iface_t *pd() const;
     dnnl::impl::status_t execute(dnnl::impl::exec_ctx_t &ctx) const;
+    /** executes with @p scratchpad instead of the library-managed
+     * scratchpad of the primitive, for a caller running the primitive on
+     * another thread than the one owning the global scratchpad */
+    dnnl::impl::status_t execute(dnnl::impl::exec_ctx_t &ctx,
+            const dnnl::impl::scratchpad_t *scratchpad) const;
+    dnnl::impl::profiler::entry_t *profile_entry() const;
+    /** implementation and its resources, for callers that prepare the
+     * execution context themselves */
+    const std::shared_ptr<dnnl::impl::primitive_t> &impl() const {
+        return primitive_;
+    }
+    const dnnl::impl::resource_mapper_t *resource_mapper() const {
+        return &resource_mapper_;
+    }
 
 private:
     std::shared_ptr<dnnl::impl::primitive_t> primitive_;
     std::unique_ptr<dnnl::impl::scratchpad_t> scratchpad_;
     std::unique_ptr<primitive_desc_iface_t> pd_;
     dnnl::impl::resource_mapper_t resource_mapper_;
+    mutable std::atomic<dnnl::impl::profiler::entry_t *> profile_entry_;
 
     dnnl_primitive() = delete;
     DNNL_DISALLOW_COPY_AND_ASSIGN(dnnl_primitive);
@@ -16,20 +16,131 @@
 
 #include "primitive_cache.hpp"
 #include "primitive.hpp"
-#include "rw_mutex.hpp"
 
 namespace dnnl {
 namespace impl {
 
+sharded_lru_primitive_cache_t::sharded_lru_primitive_cache_t(int capacity)
+    : capacity_(capacity)
+    , size_(0)
+    , clock_(0)
+    , hits_(0)
+    , misses_(0)
+    , evictions_(0)
+    , creations_(0)
+    , creation_ns_(0) {}
+
+status_t sharded_lru_primitive_cache_t::set_capacity(int capacity) {
+    capacity_ = capacity;
+    evict_excess();
+    return status::success;
+}
+
+primitive_cache_t::value_t sharded_lru_primitive_cache_t::get_or_reserve(
+        const key_t &key) {
+    // cache is disabled
+    if (capacity_ == 0) return nullptr;
+
+    auto &s = shard(key);
+    std::unique_lock<std::mutex> lock(s.mutex);
+    s.in_flight_cv.wait(lock, [&] { return s.in_flight.count(key) == 0; });
+    auto it = s.cache_mapper.find(key);
+    if (it == s.cache_mapper.end()) {
+        ++misses_;
+        s.in_flight.insert(key);
+        return nullptr;
+    }
+    ++hits_;
+    // move 1 cache_list node to the front of the cache_list
+    s.cache_list.splice(s.cache_list.begin(), s.cache_list, it->second);
+    s.cache_list.front().tick = ++clock_;
+    return s.cache_list.front().value;
+}
+
+void sharded_lru_primitive_cache_t::add(
+        const key_t &key, const value_t &impl) {
+    auto &s = shard(key);
+    {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        s.in_flight.erase(key);
+        // cache is disabled, possibly since the reservation
+        if (capacity_ != 0 && s.cache_mapper.count(key) == 0) {
+            // place a new entry to cache_list and update cache_mapper
+            s.cache_list.push_front({key, impl, ++clock_});
+            s.cache_mapper.insert(std::make_pair(key, s.cache_list.begin()));
+            ++size_;
+        }
+    }
+    s.in_flight_cv.notify_all();
+    evict_excess();
+}
+
+void sharded_lru_primitive_cache_t::cancel(const key_t &key) {
+    auto &s = shard(key);
+    {
+        std::lock_guard<std::mutex> guard(s.mutex);
+        s.in_flight.erase(key);
+    }
+    // a waiter misses in turn and retries the creation
+    s.in_flight_cv.notify_all();
+}
+
+void sharded_lru_primitive_cache_t::evict_excess() {
+    // concurrent calls may evict one entry too many, never too few
+    while (size_ > capacity_) {
+        int victim = -1;
+        size_t oldest = 0;
+        for (int i = 0; i < nshards; ++i) {
+            auto &s = shards_[i];
+            std::lock_guard<std::mutex> guard(s.mutex);
+            if (s.cache_list.empty()) continue;
+            const size_t tick = s.cache_list.back().tick;
+            if (victim < 0 || tick < oldest) {
+                victim = i;
+                oldest = tick;
+            }
+        }
+        if (victim < 0) break;
+
+        auto &s = shards_[victim];
+        std::lock_guard<std::mutex> guard(s.mutex);
+        // the tail was used or evicted meanwhile, look again
+        if (s.cache_list.empty() || s.cache_list.back().tick != oldest)
+            continue;
+        s.cache_mapper.erase(s.cache_list.back().key);
+        s.cache_list.pop_back();
+        --size_;
+        ++evictions_;
+    }
+}
+
+void sharded_lru_primitive_cache_t::get_stats(
+        primitive_cache_stats_t *stats) const {
+    stats->hits = hits_;
+    stats->misses = misses_;
+    stats->evictions = evictions_;
+    stats->creations = creations_;
+    stats->creation_ms = creation_ns_ * 1e-6;
+}
+
+void sharded_lru_primitive_cache_t::reset_stats() {
+    hits_ = misses_ = evictions_ = creations_ = creation_ns_ = 0;
+}
+
+void sharded_lru_primitive_cache_t::add_creation_time(double ms) {
+    ++creations_;
+    creation_ns_ += (size_t)(ms * 1e6);
+}
+
 // XXX primitive_cache() is not in public API, remove entirely if disabled?
-lru_primitive_cache_t &primitive_cache() {
+primitive_cache_t &primitive_cache() {
 #ifdef DNNL_ENABLE_PRIMITIVE_CACHE
     static const int capacity
             = getenv_int("DNNL_PRIMITIVE_CACHE_CAPACITY", 1024);
 #else
     static const int capacity = 0;
 #endif
-    static lru_primitive_cache_t cache(capacity);
+    static sharded_lru_primitive_cache_t cache(capacity);
     return cache;
 }
 
@@ -38,12 +149,27 @@ status_t get_primitive_cache_size(int *size) {
     if (size == nullptr) return dnnl::impl::status::invalid_arguments;
     *size = 0;
 #ifdef DNNL_ENABLE_PRIMITIVE_CACHE
-    utils::lock_read_t lock_r(primitive_cache_t::rw_mutex());
     *size = primitive_cache().get_size();
 #endif
     return dnnl::impl::status::success;
 }
 
+status_t get_primitive_cache_stats(primitive_cache_stats_t *stats) {
+    if (stats == nullptr) return dnnl::impl::status::invalid_arguments;
+    *stats = primitive_cache_stats_t();
+#ifdef DNNL_ENABLE_PRIMITIVE_CACHE
+    primitive_cache().get_stats(stats);
+#endif
+    return dnnl::impl::status::success;
+}
+
+status_t reset_primitive_cache_stats() {
+#ifdef DNNL_ENABLE_PRIMITIVE_CACHE
+    primitive_cache().reset_stats();
+#endif
+    return dnnl::impl::status::success;
+}
+
 } // namespace impl
 } // namespace dnnl
 
@@ -52,8 +178,6 @@ dnnl::impl::status_t dnnl_get_primitive_cache_capacity(int *capacity) {
     if (capacity == nullptr) return dnnl::impl::status::invalid_arguments;
     *capacity = 0;
 #ifdef DNNL_ENABLE_PRIMITIVE_CACHE
-    dnnl::impl::utils::lock_read_t lock_r(
-            dnnl::impl::primitive_cache_t::rw_mutex());
     *capacity = dnnl::impl::primitive_cache().get_capacity();
 #endif
     return dnnl::impl::status::success;
@@ -62,8 +186,6 @@ dnnl::impl::status_t dnnl_get_primitive_cache_capacity(int *capacity) {
 dnnl::impl::status_t dnnl_set_primitive_cache_capacity(int capacity) {
     if (capacity < 0) return dnnl::impl::status::invalid_arguments;
 #ifdef DNNL_ENABLE_PRIMITIVE_CACHE
-    dnnl::impl::utils::lock_write_t lock_w(
-            dnnl::impl::primitive_cache_t::rw_mutex());
     return dnnl::impl::primitive_cache().set_capacity(capacity);
 #endif
     return dnnl::impl::status::success;
@@ -23,19 +23,31 @@
 //      dnnl_set_primitive_cache_capacity
 //      dnnl_get_primitive_cache_capacity
 
+#include <atomic>
+#include <condition_variable>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "c_types_map.hpp"
 #include "dnnl.h"
 #include "primitive_hashing.hpp"
-#include "rw_mutex.hpp"
 #include "type_helpers.hpp"
 
 namespace dnnl {
 namespace impl {
 
+/** Counters of the primitive cache since start-up (or the last reset) */
+struct primitive_cache_stats_t {
+    size_t hits;
+    size_t misses;
+    size_t evictions;
+    size_t creations; // primitives created on a miss
+    double creation_ms; // total time spent creating them
+};
+
 struct primitive_t;
 struct primitive_cache_t : public c_compatible {
     using key_t = primitive_hashing::key_t;
@@ -47,84 +59,91 @@ struct primitive_cache_t : public c_compatible {
     // for undocumented API
     virtual int get_size() const = 0;
 
+    // Returns the cached entry for \c key, waiting while another thread
+    // creates it. On a miss the key is reserved for the caller, which has to
+    // create the primitive and either add() it or cancel() the reservation.
+    virtual value_t get_or_reserve(const key_t &key) = 0;
     virtual void add(const key_t &key, const value_t &impl) = 0;
-    virtual value_t get(const key_t &key) = 0;
+    virtual void cancel(const key_t &key) = 0;
 
-    virtual ~primitive_cache_t() = default;
+    // for undocumented API
+    virtual void get_stats(primitive_cache_stats_t *stats) const = 0;
+    virtual void reset_stats() = 0;
+    virtual void add_creation_time(double ms) = 0;
 
-    static utils::rw_mutex_t &rw_mutex() {
-        static utils::rw_mutex_t mutex;
-        return mutex;
-    }
+    virtual ~primitive_cache_t() = default;
 };
 
-// The cache uses LRU replacement policy
-struct lru_primitive_cache_t : public primitive_cache_t {
-    lru_primitive_cache_t(int capacity) : capacity_(capacity) {}
-
-    virtual int get_capacity() const override { return (int)capacity_; }
-
-    virtual status_t set_capacity(int capacity) override {
-        capacity_ = (size_t)capacity;
-        // Check if number of entries exceeds the new capacity
-        if (cache_list_.size() > capacity_) {
-            // Evict excess entries
-            size_t n_excess_entries = cache_list_.size() - capacity_;
-            evict(n_excess_entries);
-        }
-        return status::success;
-    }
+// The cache is split into shards selected by the key hash, each with its own
+// lock and LRU list, so concurrent lookups of different primitives do not
+// serialize. Capacity is global: every entry carries the tick of its last
+// use and, when the capacity is exceeded, the oldest of the shard tails, the
+// least recently used entry of the whole cache, is evicted.
+// All members are thread safe.
+struct sharded_lru_primitive_cache_t : public primitive_cache_t {
+    sharded_lru_primitive_cache_t(int capacity);
 
-    // for undocumented API
-    virtual int get_size() const override { return (int)cache_list_.size(); }
-
-    virtual void add(const key_t &key, const value_t &impl) override {
-        // cache is disabled
-        if (capacity_ == 0) return;
-
-        if (cache_list_.size() >= capacity_) {
-            // evict the least recently used entry
-            evict(1);
-        }
-        // place a new entry to cache_list_ and update cache_mapper_
-        cache_list_.emplace_front(key, impl);
-        cache_mapper_.insert(std::make_pair(key, cache_list_.begin()));
-    }
+    virtual int get_capacity() const override { return capacity_; }
+    virtual status_t set_capacity(int capacity) override;
 
-    virtual value_t get(const key_t &key) override {
-        // cache is disabled
-        if (capacity_ == 0) return nullptr;
+    virtual int get_size() const override { return (int)size_; }
 
-        auto it = cache_mapper_.find(key);
-        if (it == cache_mapper_.end()) { return nullptr; }
-        // move 1 cache_list_ node to the front of the cache_list_
-        cache_list_.splice(cache_list_.begin(), cache_list_, it->second);
-        return cache_list_.front().second;
-    }
-    DNNL_DISALLOW_COPY_AND_ASSIGN(lru_primitive_cache_t);
+    virtual value_t get_or_reserve(const key_t &key) override;
+    virtual void add(const key_t &key, const value_t &impl) override;
+    virtual void cancel(const key_t &key) override;
+
+    virtual void get_stats(primitive_cache_stats_t *stats) const override;
+    virtual void reset_stats() override;
+    virtual void add_creation_time(double ms) override;
+
+    DNNL_DISALLOW_COPY_AND_ASSIGN(sharded_lru_primitive_cache_t);
 
 private:
-    // an aux member function for evicting n the least recently used entries
-    void evict(size_t n) {
-        for (size_t e = 0; e < n; e++) {
-            cache_mapper_.erase(cache_list_.back().first);
-            cache_list_.pop_back();
-        }
+    static constexpr int nshards = 16;
+
+    struct entry_t {
+        key_t key;
+        value_t value;
+        size_t tick; // of the last use
+    };
+
+    struct shard_t {
+        using cache_list_t = std::list<entry_t>;
+        std::mutex mutex;
+        cache_list_t cache_list;
+        std::unordered_map<key_t, cache_list_t::iterator> cache_mapper;
+        // keys being created, other threads wait on in_flight_cv for them
+        std::unordered_set<key_t> in_flight;
+        std::condition_variable in_flight_cv;
+    };
+
+    shard_t &shard(const key_t &key) {
+        size_t h = std::hash<key_t>()(key);
+        return shards_[(h ^ (h >> 17)) % nshards];
     }
+    // evict the least recently used entries until size_ fits capacity_
+    void evict_excess();
+
+    std::atomic<int> capacity_;
+    std::atomic<int> size_;
+    std::atomic<size_t> clock_;
+    shard_t shards_[nshards];
 
-    size_t capacity_;
-    using cache_list_t = std::list<std::pair<key_t, value_t>>;
-    cache_list_t cache_list_;
-    std::unordered_map<key_t, cache_list_t::iterator> cache_mapper_;
+    std::atomic<size_t> hits_, misses_, evictions_, creations_;
+    std::atomic<size_t> creation_ns_;
 };
 
 //#ifdef DNNL_ENABLE_PRIMITIVE_CACHE
-lru_primitive_cache_t &primitive_cache();
+primitive_cache_t &primitive_cache();
 //#endif
 
 // undocumented API, for testing only
 status_t DNNL_API get_primitive_cache_size(int *size);
 
+// undocumented API: hit/miss/eviction counters and creation time
+status_t DNNL_API get_primitive_cache_stats(primitive_cache_stats_t *stats);
+status_t DNNL_API reset_primitive_cache_stats();
+
 } // namespace impl
 } // namespace dnnl
 //#endif // DNNL_ENABLE_PRIMITIVE_CACHE
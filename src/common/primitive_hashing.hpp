@@ -615,6 +615,79 @@ size_t get_desc_hash<sum_desc_t>(const op_desc_t *op_desc) {
     return seed;
 }
 
+// Combine seed with the hash of op_desc of the given kind
+static inline size_t get_op_desc_hash(
+        size_t seed, primitive_kind_t kind, const op_desc_t *op_desc) {
+    switch (kind) {
+        case primitive_kind::batch_normalization:
+            seed = hash_combine(
+                    seed, get_desc_hash<batch_normalization_desc_t>(op_desc));
+            break;
+        case primitive_kind::binary:
+            seed = hash_combine(seed, get_desc_hash<binary_desc_t>(op_desc));
+            break;
+        case primitive_kind::concat:
+            seed = hash_combine(seed, get_desc_hash<concat_desc_t>(op_desc));
+            break;
+        case primitive_kind::convolution:
+            seed = hash_combine(
+                    seed, get_desc_hash<convolution_desc_t>(op_desc));
+            break;
+        case primitive_kind::deconvolution:
+            seed = hash_combine(
+                    seed, get_desc_hash<deconvolution_desc_t>(op_desc));
+            break;
+        case primitive_kind::eltwise:
+            seed = hash_combine(seed, get_desc_hash<eltwise_desc_t>(op_desc));
+            break;
+        case primitive_kind::gemm:
+            seed = hash_combine(seed, get_desc_hash<gemm_desc_t>(op_desc));
+            break;
+        case primitive_kind::inner_product:
+            seed = hash_combine(
+                    seed, get_desc_hash<inner_product_desc_t>(op_desc));
+            break;
+        case primitive_kind::layer_normalization:
+            seed = hash_combine(
+                    seed, get_desc_hash<layer_normalization_desc_t>(op_desc));
+            break;
+        case primitive_kind::logsoftmax:
+            seed = hash_combine(
+                    seed, get_desc_hash<logsoftmax_desc_t>(op_desc));
+            break;
+        case primitive_kind::lrn:
+            seed = hash_combine(seed, get_desc_hash<lrn_desc_t>(op_desc));
+            break;
+        case primitive_kind::matmul:
+            seed = hash_combine(seed, get_desc_hash<matmul_desc_t>(op_desc));
+            break;
+        case primitive_kind::pooling:
+            seed = hash_combine(seed, get_desc_hash<pooling_desc_t>(op_desc));
+            break;
+        case primitive_kind::reorder:
+            seed = hash_combine(seed, get_desc_hash<reorder_desc_t>(op_desc));
+            break;
+        case primitive_kind::resampling:
+            seed = hash_combine(
+                    seed, get_desc_hash<resampling_desc_t>(op_desc));
+            break;
+        case primitive_kind::rnn:
+            seed = hash_combine(seed, get_desc_hash<rnn_desc_t>(op_desc));
+            break;
+        case primitive_kind::shuffle:
+            seed = hash_combine(seed, get_desc_hash<shuffle_desc_t>(op_desc));
+            break;
+        case primitive_kind::softmax:
+            seed = hash_combine(seed, get_desc_hash<softmax_desc_t>(op_desc));
+            break;
+        case primitive_kind::sum:
+            seed = hash_combine(seed, get_desc_hash<sum_desc_t>(op_desc));
+            break;
+        default: assert(!"unknown primitive_kind");
+    }
+    return seed;
+}
+
 } // namespace primitive_hashing
 } // namespace impl
 } // namespace dnnl
@@ -642,87 +715,7 @@ struct hash<dnnl::impl::primitive_hashing::key_t> {
         seed = hash_combine(
                 seed, hash_combine(0, static_cast<size_t>(key.device_id_)));
         // Combine hash for op_desc with the computed hash
-        switch (key.primitive_kind_) {
-            case primitive_kind::batch_normalization:
-                seed = hash_combine(seed,
-                        get_desc_hash<batch_normalization_desc_t>(
-                                key.op_desc_));
-                break;
-            case primitive_kind::binary:
-                seed = hash_combine(
-                        seed, get_desc_hash<binary_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::concat:
-                seed = hash_combine(
-                        seed, get_desc_hash<concat_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::convolution:
-                seed = hash_combine(
-                        seed, get_desc_hash<convolution_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::deconvolution:
-                seed = hash_combine(seed,
-                        get_desc_hash<deconvolution_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::eltwise:
-                seed = hash_combine(
-                        seed, get_desc_hash<eltwise_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::gemm:
-                seed = hash_combine(
-                        seed, get_desc_hash<gemm_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::inner_product:
-                seed = hash_combine(seed,
-                        get_desc_hash<inner_product_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::layer_normalization:
-                seed = hash_combine(seed,
-                        get_desc_hash<layer_normalization_desc_t>(
-                                key.op_desc_));
-                break;
-            case primitive_kind::logsoftmax:
-                seed = hash_combine(
-                        seed, get_desc_hash<logsoftmax_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::lrn:
-                seed = hash_combine(
-                        seed, get_desc_hash<lrn_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::matmul:
-                seed = hash_combine(
-                        seed, get_desc_hash<matmul_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::pooling:
-                seed = hash_combine(
-                        seed, get_desc_hash<pooling_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::reorder:
-                seed = hash_combine(
-                        seed, get_desc_hash<reorder_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::resampling:
-                seed = hash_combine(
-                        seed, get_desc_hash<resampling_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::rnn:
-                seed = hash_combine(
-                        seed, get_desc_hash<rnn_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::shuffle:
-                seed = hash_combine(
-                        seed, get_desc_hash<shuffle_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::softmax:
-                seed = hash_combine(
-                        seed, get_desc_hash<softmax_desc_t>(key.op_desc_));
-                break;
-            case primitive_kind::sum:
-                seed = hash_combine(
-                        seed, get_desc_hash<sum_desc_t>(key.op_desc_));
-                break;
-            default: assert(!"unknown primitive_kind");
-        }
+        seed = get_op_desc_hash(seed, key.primitive_kind_, key.op_desc_);
 
         seed = get_array_hash(seed, key.mds.data(), (int)key.mds.size());
 
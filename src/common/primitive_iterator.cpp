@@ -20,6 +20,7 @@
 
 #include "c_types_map.hpp"
 #include "engine.hpp"
+#include "persistent_pd_cache.hpp"
 #include "primitive_desc.hpp"
 #include "primitive_iterator.hpp"
 #include "type_helpers.hpp"
@@ -27,19 +28,23 @@
 using namespace dnnl::impl;
 using namespace dnnl::impl::status;
 
+namespace {
+bool is_known_primitive_kind(primitive_kind_t kind) {
+    using namespace primitive_kind;
+    return utils::one_of(kind, batch_normalization, binary, convolution,
+            deconvolution, eltwise, gemm, inner_product, layer_normalization,
+            lrn, logsoftmax, matmul, pooling, resampling, rnn, shuffle,
+            softmax);
+}
+} // namespace
+
 status_t dnnl_primitive_desc_iterator_create(
         primitive_desc_iterator_t **iterator, const_c_op_desc_t c_op_desc,
         const primitive_attr_t *attr, engine_t *engine,
         const primitive_desc_iface_t *hint_fwd_pd) {
     const op_desc_t *op_desc = (const op_desc_t *)c_op_desc;
     if (utils::any_null(iterator, op_desc, engine)) return invalid_arguments;
-
-    using namespace primitive_kind;
-    bool known_primitive_kind = utils::one_of(op_desc->kind,
-            batch_normalization, binary, convolution, deconvolution, eltwise,
-            gemm, inner_product, layer_normalization, lrn, logsoftmax, matmul,
-            pooling, resampling, rnn, shuffle, softmax);
-    if (!known_primitive_kind) return invalid_arguments;
+    if (!is_known_primitive_kind(op_desc->kind)) return invalid_arguments;
 
     auto it = new primitive_desc_iterator_t(engine, op_desc, attr,
             hint_fwd_pd ? hint_fwd_pd->impl().get() : nullptr);
@@ -92,6 +97,23 @@ status_t dnnl_primitive_desc_create(
         primitive_desc_iface_t **primitive_desc_iface,
         const_c_op_desc_t c_op_desc, const primitive_attr_t *attr,
         engine_t *engine, const primitive_desc_iface_t *hint_fwd_pd) {
+    const op_desc_t *op_desc = (const op_desc_t *)c_op_desc;
+    auto &pd_cache = persistent_pd_cache();
+    const bool use_pd_cache = pd_cache.enabled() && primitive_desc_iface
+            && op_desc && engine && is_known_primitive_kind(op_desc->kind);
+    const primitive_desc_t *hint_pd
+            = hint_fwd_pd ? hint_fwd_pd->impl().get() : nullptr;
+
+    if (use_pd_cache) {
+        primitive_desc_t *pd
+                = pd_cache.replay(op_desc, attr, engine, hint_pd);
+        if (pd) {
+            return safe_ptr_assign<primitive_desc_iface_t>(
+                    *primitive_desc_iface,
+                    new primitive_desc_iface_t(pd, engine));
+        }
+    }
+
     primitive_desc_iterator_t *it;
     status_t status = dnnl_primitive_desc_iterator_create(
             &it, c_op_desc, attr, engine, hint_fwd_pd);
@@ -101,8 +123,11 @@ status_t dnnl_primitive_desc_create(
 #endif
     if (status != status::success) return status;
 
-    primitive_desc_iface_t *pd_iface
-            = new primitive_desc_iface_t(it->fetch_once(), engine);
+    primitive_desc_t *pd = it->fetch_once();
+    if (use_pd_cache)
+        pd_cache.record(op_desc, attr, engine, hint_pd, it->impl_index(), pd);
+
+    primitive_desc_iface_t *pd_iface = new primitive_desc_iface_t(pd, engine);
     //printf(" primitive_desc_iface @%p\n",(void*)pd_iface); // XXX REMOVE!
 #if 0 && defined(__ve)
     asm("### VE: tentative light optimization barrier\n\t" :::"memory");
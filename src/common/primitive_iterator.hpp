@@ -88,6 +88,10 @@ struct dnnl_primitive_desc_iterator : public dnnl::impl::c_compatible {
         return return_pd;
     }
 
+    // Position of the current implementation in the engine implementation
+    // list (as used by the persistent pd cache).
+    int impl_index() const { return idx_; }
+
 protected:
     int idx_;
     dnnl::impl::engine_t *engine_;
@@ -0,0 +1,383 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dnnl_debug.h"
+
+#include "c_types_map.hpp"
+#include "primitive_desc.hpp"
+#include "utils.hpp"
+
+#include "profiler.hpp"
+
+namespace dnnl {
+namespace impl {
+
+namespace profiler {
+// bucket b > 0 counts durations in [2^(b-1), 2^b) us, bucket 0 below 1 us;
+// the last bucket takes everything longer
+constexpr int n_buckets = 24;
+
+struct entry_t {
+    entry_t(const char *kind, const char *impl, const char *desc)
+        : kind(kind), impl(impl), desc(desc) {
+        reset();
+    }
+
+    void reset() {
+        count = 0;
+        total_ns = 0;
+        min_ns = UINT64_MAX;
+        max_ns = 0;
+        for (auto &h : hist)
+            h = 0;
+    }
+
+    const std::string kind, impl, desc;
+    std::atomic<uint64_t> count, total_ns, min_ns, max_ns;
+    std::atomic<uint64_t> hist[n_buckets];
+};
+
+struct event_t {
+    const entry_t *entry;
+    uint64_t start_ns, duration_ns;
+};
+
+// A ring slot, published seqlock style: seq is i + 1 once event i is
+// complete in it and 0 while the writer is filling it. The fields are
+// relaxed atomics so that a reader racing with the writer is well defined;
+// it keeps what it read only if seq was the same before and after.
+struct slot_t {
+    slot_t() : seq(0), entry(nullptr), start_ns(0), duration_ns(0) {}
+
+    std::atomic<uint64_t> seq;
+    std::atomic<const entry_t *> entry;
+    std::atomic<uint64_t> start_ns, duration_ns;
+};
+
+// Written by its thread only. A reader takes the events in [base, head)
+// whose slots still hold them.
+struct ring_t {
+    ring_t(size_t capacity, int tid) : slots(capacity), tid(tid) {
+        head = base = 0;
+    }
+
+    void push(const event_t &ev) {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        slot_t &s = slots[h % slots.size()];
+        s.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        s.entry.store(ev.entry, std::memory_order_relaxed);
+        s.start_ns.store(ev.start_ns, std::memory_order_relaxed);
+        s.duration_ns.store(ev.duration_ns, std::memory_order_relaxed);
+        s.seq.store(h + 1, std::memory_order_release);
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    // false if event i is not in its slot (overwritten or being written)
+    bool get(uint64_t i, event_t &ev) const {
+        const slot_t &s = slots[i % slots.size()];
+        if (s.seq.load(std::memory_order_acquire) != i + 1) return false;
+        ev.entry = s.entry.load(std::memory_order_relaxed);
+        ev.start_ns = s.start_ns.load(std::memory_order_relaxed);
+        ev.duration_ns = s.duration_ns.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return s.seq.load(std::memory_order_relaxed) == i + 1;
+    }
+
+    std::vector<slot_t> slots;
+    std::atomic<uint64_t> head, base;
+    const int tid;
+};
+
+namespace {
+size_t ring_capacity() {
+    static const size_t capacity = nstl::max(
+            (size_t)1, getenv_size("DNNL_PROFILE_EVENTS", 16384));
+    return capacity;
+}
+
+// Never destroyed: primitives keep pointers to the entries, and events may
+// be recorded during static destruction.
+struct registry_t {
+    std::mutex mutex;
+    std::unordered_map<std::string, entry_t *> index;
+    std::deque<std::unique_ptr<entry_t>> entries;
+    std::deque<std::unique_ptr<ring_t>> rings;
+    uint64_t epoch_ns = 0;
+};
+
+registry_t &registry() {
+    static registry_t *r = new registry_t();
+    return *r;
+}
+
+std::atomic<bool> &enabled_flag() {
+    static std::atomic<bool> flag(false);
+    return flag;
+}
+
+// The ring is owned by the registry, so that the events of finished
+// threads can still be dumped.
+ring_t *this_thread_ring() {
+    static thread_local ring_t *ring = nullptr;
+    if (ring == nullptr) {
+        auto &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.rings.emplace_back(new ring_t(ring_capacity(), (int)r.rings.size()));
+        ring = r.rings.back().get();
+    }
+    return ring;
+}
+
+int bucket(uint64_t duration_ns) {
+    uint64_t us = duration_ns / 1000;
+    int b = 0;
+    while (us && b < n_buckets - 1) {
+        us >>= 1;
+        ++b;
+    }
+    return b;
+}
+
+std::string json_str(const std::string &s) {
+    std::string r = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
+std::string csv_str(const std::string &s) {
+    std::string r = "\"";
+    for (char c : s) {
+        if (c == '"') r += '"';
+        r += c;
+    }
+    return r + "\"";
+}
+
+void write_json(FILE *f, const registry_t &r) {
+    fprintf(f, "[");
+    const char *sep = "\n";
+    for (const auto &e : r.entries) {
+        const uint64_t count = e->count;
+        if (count == 0) continue;
+        fprintf(f, "%s{\"kind\":%s,\"impl\":%s,\"desc\":%s,", sep,
+                json_str(e->kind).c_str(), json_str(e->impl).c_str(),
+                json_str(e->desc).c_str());
+        fprintf(f,
+                "\"count\":%llu,\"total_ms\":%g,\"min_ms\":%g,\"max_ms\":%g,"
+                "\"hist_log2_us\":[",
+                (unsigned long long)count, 1e-6 * e->total_ns,
+                1e-6 * e->min_ns, 1e-6 * e->max_ns);
+        for (int b = 0; b < n_buckets; ++b)
+            fprintf(f, "%s%llu", b ? "," : "",
+                    (unsigned long long)e->hist[b].load());
+        fprintf(f, "]}");
+        sep = ",\n";
+    }
+    fprintf(f, "\n]\n");
+}
+
+void write_csv(FILE *f, const registry_t &r) {
+    fprintf(f, "kind,impl,desc,count,total_ms,min_ms,max_ms");
+    for (int b = 0; b < n_buckets; ++b)
+        fprintf(f, ",hist%d", b);
+    fprintf(f, "\n");
+    for (const auto &e : r.entries) {
+        const uint64_t count = e->count;
+        if (count == 0) continue;
+        fprintf(f, "%s,%s,%s,%llu,%g,%g,%g", e->kind.c_str(),
+                e->impl.c_str(), csv_str(e->desc).c_str(),
+                (unsigned long long)count, 1e-6 * e->total_ns,
+                1e-6 * e->min_ns, 1e-6 * e->max_ns);
+        for (int b = 0; b < n_buckets; ++b)
+            fprintf(f, ",%llu", (unsigned long long)e->hist[b].load());
+        fprintf(f, "\n");
+    }
+}
+
+void write_chrome_trace(FILE *f, const registry_t &r) {
+    fprintf(f, "{\"traceEvents\":[");
+    const char *sep = "\n";
+    for (const auto &ring : r.rings) {
+        const uint64_t cap = ring->slots.size();
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t first = nstl::max(
+                ring->base.load(), head > cap ? head - cap : (uint64_t)0);
+        for (uint64_t i = first; i < head; ++i) {
+            event_t ev;
+            // the writer may have overwritten it since head was read
+            if (!ring->get(i, ev)) continue;
+            fprintf(f,
+                    "%s{\"name\":%s,\"cat\":%s,\"ph\":\"X\",\"pid\":0,"
+                    "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                    "\"args\":{\"desc\":%s}}",
+                    sep, json_str(ev.entry->impl).c_str(),
+                    json_str(ev.entry->kind).c_str(), ring->tid,
+                    1e-3 * (ev.start_ns - r.epoch_ns), 1e-3 * ev.duration_ns,
+                    json_str(ev.entry->desc).c_str());
+            sep = ",\n";
+        }
+    }
+    fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+bool parse_format(const char *s, profile_format_t &format) {
+    if (strcmp(s, "1") == 0 || strcmp(s, "json") == 0)
+        format = profile_json;
+    else if (strcmp(s, "csv") == 0)
+        format = profile_csv;
+    else if (strcmp(s, "trace") == 0)
+        format = profile_chrome_trace;
+    else
+        return false;
+    return true;
+}
+
+profile_format_t exit_format;
+char exit_path[1024];
+
+void dump_at_exit() {
+    dump_profile(exit_format, exit_path[0] ? exit_path : nullptr);
+}
+
+// DNNL_PROFILE is read once, when the library is loaded.
+const bool env_initialized = [] {
+    char value[16];
+    if (getenv("DNNL_PROFILE", value, sizeof(value)) <= 0) return true;
+    if (!parse_format(value, exit_format)) return true;
+    if (getenv("DNNL_PROFILE_FILE", exit_path, sizeof(exit_path)) <= 0)
+        exit_path[0] = '\0';
+    set_profiling(true);
+    atexit(dump_at_exit);
+    return true;
+}();
+} // namespace
+
+bool enabled() {
+    return enabled_flag().load(std::memory_order_relaxed);
+}
+
+uint64_t now_ns() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(
+            steady_clock::now().time_since_epoch())
+            .count();
+}
+
+entry_t *intern(const primitive_desc_t *pd, engine_t *engine) {
+    const char *kind = dnnl_prim_kind2str(pd->kind());
+    const char *impl = pd->name();
+    const char *desc = pd->info(engine);
+    std::string key = std::string(kind) + "," + impl + "," + desc;
+
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.index.find(key);
+    if (it != r.index.end()) return it->second;
+    r.entries.emplace_back(new entry_t(kind, impl, desc));
+    entry_t *e = r.entries.back().get();
+    r.index.emplace(std::move(key), e);
+    return e;
+}
+
+void record(entry_t *entry, uint64_t start_ns, uint64_t duration_ns) {
+    entry->count.fetch_add(1, std::memory_order_relaxed);
+    entry->total_ns.fetch_add(duration_ns, std::memory_order_relaxed);
+    entry->hist[bucket(duration_ns)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t cur = entry->min_ns.load(std::memory_order_relaxed);
+    while (duration_ns < cur
+            && !entry->min_ns.compare_exchange_weak(cur, duration_ns))
+        ;
+    cur = entry->max_ns.load(std::memory_order_relaxed);
+    while (duration_ns > cur
+            && !entry->max_ns.compare_exchange_weak(cur, duration_ns))
+        ;
+
+    this_thread_ring()->push({entry, start_ns, duration_ns});
+}
+} // namespace profiler
+
+status_t set_profiling(bool enable) {
+    using namespace profiler;
+    if (enable && !enabled()) {
+        auto &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (r.epoch_ns == 0) r.epoch_ns = now_ns();
+    }
+    enabled_flag().store(enable, std::memory_order_relaxed);
+    return status::success;
+}
+
+bool get_profiling() {
+    return profiler::enabled();
+}
+
+status_t reset_profile() {
+    using namespace profiler;
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto &e : r.entries)
+        e->reset();
+    for (auto &ring : r.rings)
+        ring->base.store(ring->head.load());
+    r.epoch_ns = now_ns();
+    return status::success;
+}
+
+status_t dump_profile(profile_format_t format, const char *path) {
+    using namespace profiler;
+    if (!utils::one_of(format, profile_json, profile_csv, profile_chrome_trace))
+        return status::invalid_arguments;
+    FILE *f = path ? fopen(path, "w") : stdout;
+    if (!f) return status::invalid_arguments;
+
+    auto &r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        switch (format) {
+            case profile_json: write_json(f, r); break;
+            case profile_csv: write_csv(f, r); break;
+            case profile_chrome_trace: write_chrome_trace(f, r); break;
+        }
+    }
+
+    if (path)
+        fclose(f);
+    else
+        fflush(f);
+    return status::success;
+}
+
+} // namespace impl
+} // namespace dnnl
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
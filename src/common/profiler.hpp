@@ -0,0 +1,71 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef COMMON_PROFILER_HPP
+#define COMMON_PROFILER_HPP
+
+#include <stdint.h>
+
+#include "c_types_map.hpp"
+
+namespace dnnl {
+namespace impl {
+
+struct primitive_desc_t;
+
+/** In-process execution profiler.
+ *
+ * Every primitive execution is timed and recorded twice: in the statistics
+ * of its entry, one per distinct (primitive kind, implementation, problem)
+ * with count, total/min/max time and a log2 histogram, and as an event in a
+ * ring buffer of the executing thread. Recording takes no locks: statistics
+ * are atomic counters and a ring has a single writer. A ring keeps the last
+ * DNNL_PROFILE_EVENTS events (16384 by default) of its thread.
+ *
+ * DNNL_PROFILE=1|json|csv|trace turns the profiler on at start up and dumps
+ * the profile in that format (1 is json) at exit, to DNNL_PROFILE_FILE or to
+ * stdout. */
+namespace profiler {
+struct entry_t;
+
+bool enabled();
+uint64_t now_ns();
+/** Entry of the problem of \c pd, created on first use. Entries live as
+ * long as the process. */
+entry_t *intern(const primitive_desc_t *pd, engine_t *engine);
+void record(entry_t *entry, uint64_t start_ns, uint64_t duration_ns);
+} // namespace profiler
+
+enum profile_format_t {
+    /** entries with their statistics, as a JSON array */
+    profile_json,
+    /** entries with their statistics, one per line */
+    profile_csv,
+    /** buffered events in the Chrome trace event format */
+    profile_chrome_trace,
+};
+
+status_t DNNL_API set_profiling(bool enable);
+bool DNNL_API get_profiling();
+/** Zeroes the statistics and drops the buffered events. */
+status_t DNNL_API reset_profile();
+/** Writes the profile to the file \c path, or to stdout if it is nullptr. */
+status_t DNNL_API dump_profile(profile_format_t format, const char *path);
+
+} // namespace impl
+} // namespace dnnl
+
+#endif
@@ -14,8 +14,16 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
 
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#include "dnnl_thread.hpp"
 #include "engine.hpp"
 #include "utils.hpp"
 
@@ -26,14 +34,108 @@ namespace impl {
 
 namespace {
 
+// Counters of scratchpad_stats_t. Atomics of integral type have trivial
+// destructors, so they stay usable while globals are being destroyed.
+std::atomic<size_t> current_bytes {0};
+std::atomic<size_t> peak_bytes {0};
+std::atomic<size_t> retained_bytes {0};
+std::atomic<size_t> allocations {0};
+std::atomic<size_t> reuses {0};
+
+std::atomic<size_t> &retention() {
+    static std::atomic<size_t> bytes {
+            getenv_size("DNNL_SCRATCHPAD_RETAIN", 0)};
+    return bytes;
+}
+
+// DNNL_SCRATCHPAD_PREFAULT=1: new CPU buffers are touched page by page
+// right away, by the threads of a parallel section, so that the page faults
+// are taken at primitive creation instead of the first execution.
+bool prefault_enabled() {
+    static const bool enabled = getenv_int("DNNL_SCRATCHPAD_PREFAULT", 0);
+    return enabled;
+}
+
+void prefault(const memory_storage_t *mem_storage, size_t size) {
+    void *ptr = nullptr;
+    mem_storage->get_data_handle(&ptr);
+    if (ptr == nullptr) return;
+    // the library's wrapper, GetSystemInfo() on Windows and sysconf()
+    // elsewhere
+    const dim_t page = impl::getpagesize();
+    char *p = static_cast<char *>(ptr);
+    parallel_nd((dim_t)utils::div_up(size, page),
+            [&](dim_t i) { p[i * page] = 0; });
+}
+
 memory_storage_t *create_scratchpad_memory_storage(
         engine_t *engine, size_t size) {
     memory_storage_t *mem_storage = nullptr;
     auto status = engine->create_memory_storage(&mem_storage, size);
     UNUSED(status);
+    if (mem_storage == nullptr) return nullptr;
+
+    allocations++;
+    const size_t cur = current_bytes += size;
+    size_t peak = peak_bytes.load();
+    while (cur > peak && !peak_bytes.compare_exchange_weak(peak, cur)) {}
+
+    if (prefault_enabled() && engine->kind() == engine_kind_t::dnnl_cpu)
+        prefault(mem_storage, size);
     return mem_storage;
 }
 
+void destroy_scratchpad_memory_storage(
+        memory_storage_t *mem_storage, size_t size) {
+    if (mem_storage == nullptr) return;
+    current_bytes -= size;
+    delete mem_storage;
+}
+
+/*
+  Idle CPU buffers of concurrent scratchpads, best fit by size. Never
+  destroyed, so that primitives destroyed at exit can still return theirs.
+*/
+struct scratchpad_pool_t {
+    // a buffer of at least \c size and at most twice as large, or nullptr
+    memory_storage_t *get(size_t size, size_t &capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = buffers_.lower_bound(size);
+        if (it == buffers_.end() || it->first > 2 * size) return nullptr;
+        capacity = it->first;
+        memory_storage_t *mem_storage = it->second;
+        buffers_.erase(it);
+        bytes_ -= capacity;
+        retained_bytes -= capacity;
+        reuses++;
+        return mem_storage;
+    }
+
+    // keeps the buffer while the pool stays within the retention
+    void put(memory_storage_t *mem_storage, size_t capacity) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (bytes_ + capacity <= retention()) {
+                buffers_.emplace(capacity, mem_storage);
+                bytes_ += capacity;
+                retained_bytes += capacity;
+                return;
+            }
+        }
+        destroy_scratchpad_memory_storage(mem_storage, capacity);
+    }
+
+private:
+    std::mutex mutex_;
+    std::multimap<size_t, memory_storage_t *> buffers_;
+    size_t bytes_ = 0;
+};
+
+scratchpad_pool_t &scratchpad_pool() {
+    static scratchpad_pool_t *pool = new scratchpad_pool_t();
+    return *pool;
+}
+
 } // namespace
 
 /*
@@ -41,14 +143,31 @@ memory_storage_t *create_scratchpad_memory_storage(
   a concurrent execution
 */
 struct concurrent_scratchpad_t : public scratchpad_t {
-    concurrent_scratchpad_t(engine_t *engine, size_t size) {
-        auto *mem_storage = create_scratchpad_memory_storage(engine, size);
+    concurrent_scratchpad_t(engine_t *engine, size_t size)
+        : pooled_(engine->kind() == engine_kind_t::dnnl_cpu
+                && retention() > 0) {
+        memory_storage_t *mem_storage = pooled_
+                ? scratchpad_pool().get(size, capacity_)
+                : nullptr;
+        if (mem_storage == nullptr) {
+            mem_storage = create_scratchpad_memory_storage(engine, size);
+            capacity_ = size;
+        }
         size_ = size;
-        if (mem_storage == nullptr) size_ = 0;
+        if (mem_storage == nullptr) size_ = capacity_ = 0;
 
         mem_storage_.reset(mem_storage);
     }
 
+    ~concurrent_scratchpad_t() {
+        memory_storage_t *mem_storage = mem_storage_.release();
+        if (mem_storage == nullptr) return;
+        if (pooled_)
+            scratchpad_pool().put(mem_storage, capacity_);
+        else
+            destroy_scratchpad_memory_storage(mem_storage, capacity_);
+    }
+
     virtual const memory_storage_t *get_memory_storage() const override {
         return mem_storage_.get();
     }
@@ -58,6 +177,8 @@ struct concurrent_scratchpad_t : public scratchpad_t {
 private:
     std::unique_ptr<memory_storage_t> mem_storage_;
     size_t size_;
+    size_t capacity_; // of the buffer, which may be a larger pooled one
+    bool pooled_;
 
     DNNL_DISALLOW_COPY_AND_ASSIGN(concurrent_scratchpad_t);
 };
@@ -70,8 +191,12 @@ private:
 struct global_scratchpad_t : public scratchpad_t {
     global_scratchpad_t(engine_t *engine, size_t size) {
         UNUSED(engine);
+        if (retained_) {
+            retained_ = false;
+            retained_bytes -= size_;
+        }
         if (size > size_) {
-            delete mem_storage_;
+            destroy_scratchpad_memory_storage(mem_storage_, size_);
             // Try to expand the global scratchpad to the necessary size
             mem_storage_ = create_scratchpad_memory_storage(engine, size);
             if (mem_storage_ == nullptr) {
@@ -80,14 +205,22 @@ struct global_scratchpad_t : public scratchpad_t {
                 if (mem_storage_ == nullptr) size_ = 0;
             } else
                 size_ = size;
-        }
+        } else if (mem_storage_ != nullptr)
+            reuses++;
         reference_count_++;
     }
 
     ~global_scratchpad_t() {
         reference_count_--;
         if (reference_count_ == 0) {
-            delete mem_storage_;
+            // keep a buffer within the retention for the next primitive
+            if (mem_storage_ != nullptr && size_ <= retention()
+                    && release_at_thread_exit()) {
+                retained_ = true;
+                retained_bytes += size_;
+                return;
+            }
+            destroy_scratchpad_memory_storage(mem_storage_, size_);
             mem_storage_ = nullptr;
             size_ = 0;
         }
@@ -100,9 +233,39 @@ struct global_scratchpad_t : public scratchpad_t {
     virtual size_t size() const override { return size_; }
 
 private:
+    // Frees the buffer a thread still retains when the thread exits. Only
+    // an idle buffer is freed, which no primitive can reach any longer.
+    static void release_retained(void *) {
+        if (reference_count_ != 0 || !retained_) return;
+        retained_ = false;
+        retained_bytes -= size_;
+        destroy_scratchpad_memory_storage(mem_storage_, size_);
+        mem_storage_ = nullptr;
+        size_ = 0;
+    }
+
+    // Schedules release_retained() for the exit of the calling thread. A
+    // pthread key destructor needs no thread-local object with a destructor
+    // (see the CAVEAT below) and, unlike one, still runs for a buffer
+    // retained while the thread-local objects of the thread are destroyed.
+    // Returns false where the buffer cannot be released at thread exit, so
+    // that it is not retained.
+    static bool release_at_thread_exit() {
+#ifdef _WIN32
+        return false;
+#else
+        static pthread_key_t key;
+        static const bool key_ok
+                = pthread_key_create(&key, release_retained) == 0;
+        // any non-null value makes the key destructor run
+        return key_ok && pthread_setspecific(key, &key) == 0;
+#endif
+    }
+
     thread_local static memory_storage_t *mem_storage_;
     thread_local static size_t size_;
     thread_local static unsigned int reference_count_;
+    thread_local static bool retained_;
 };
 
 // CAVEAT: avoid having non-trivially-constructed thread-local objects. Their
@@ -113,6 +276,7 @@ private:
 thread_local memory_storage_t *global_scratchpad_t::mem_storage_ = nullptr;
 thread_local size_t global_scratchpad_t::size_ = 0;
 thread_local unsigned int global_scratchpad_t::reference_count_ = 0;
+thread_local bool global_scratchpad_t::retained_ = false;
 
 /*
    Scratchpad creation routine
@@ -135,5 +299,31 @@ scratchpad_t *create_scratchpad(
 #endif
 }
 
+status_t get_scratchpad_stats(scratchpad_stats_t *stats) {
+    if (stats == nullptr) return status::invalid_arguments;
+    stats->current_bytes = current_bytes;
+    stats->peak_bytes = peak_bytes;
+    stats->retained_bytes = retained_bytes;
+    stats->allocations = allocations;
+    stats->reuses = reuses;
+    return status::success;
+}
+
+status_t reset_scratchpad_stats() {
+    peak_bytes = current_bytes.load();
+    allocations = 0;
+    reuses = 0;
+    return status::success;
+}
+
+status_t set_scratchpad_retention(size_t bytes) {
+    retention() = bytes;
+    return status::success;
+}
+
+size_t get_scratchpad_retention() {
+    return retention();
+}
+
 } // namespace impl
 } // namespace dnnl
@@ -32,6 +32,26 @@ struct scratchpad_t {
 scratchpad_t *create_scratchpad(
         engine_t *engine, size_t size, bool use_global_scratchpad);
 
+/** Library-managed CPU scratchpad buffers since start-up (or the last reset
+ * of the counters). Buffers are either in use by primitives or retained for
+ * reuse after their last primitive is gone, see set_scratchpad_retention(). */
+struct scratchpad_stats_t {
+    size_t current_bytes; // held now, in use or retained
+    size_t peak_bytes; // high-water mark of current_bytes
+    size_t retained_bytes; // held now with no primitive using them
+    size_t allocations; // buffers allocated
+    size_t reuses; // requests served by a buffer already held
+};
+
+// for undocumented API
+status_t DNNL_API get_scratchpad_stats(scratchpad_stats_t *stats);
+status_t DNNL_API reset_scratchpad_stats();
+/** Idle buffers of up to \c bytes are kept: one per thread for the global
+ * scratchpad, \c bytes in total for the per-primitive ones. Defaults to
+ * DNNL_SCRATCHPAD_RETAIN (0: buffers are freed with their last user). */
+status_t DNNL_API set_scratchpad_retention(size_t bytes);
+size_t DNNL_API get_scratchpad_retention();
+
 } // namespace impl
 } // namespace dnnl
 #endif
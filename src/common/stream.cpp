@@ -19,6 +19,8 @@
 
 #include "c_types_map.hpp"
 #include "engine.hpp"
+#include "primitive.hpp"
+#include "primitive_exec_types.hpp"
 #include "stream.hpp"
 #include "utils.hpp"
 
@@ -26,12 +28,18 @@ using namespace dnnl::impl;
 using namespace dnnl::impl::status;
 using namespace dnnl::impl::utils;
 
+status_t dnnl_stream::enqueue_primitive(
+        const primitive_iface_t *primitive_iface, exec_ctx_t &ctx) {
+    return primitive_iface->execute(ctx);
+}
+
 /* API */
 
 status_t dnnl_stream_create_v2(stream_t **stream, engine_t *engine,
         unsigned flags, const stream_attr_t *attr) {
     bool args_ok = true && !utils::any_null(stream, engine)
-            && flags == stream_flags::default_flags;
+            && one_of(flags, stream_flags::default_order,
+                    stream_flags::in_order, stream_flags::out_of_order);
     if (!args_ok) return invalid_arguments;
 
     return engine->create_stream(stream, flags, attr);
@@ -25,6 +25,12 @@
 #include "stream_attr.hpp"
 #include "utils.hpp"
 
+namespace dnnl {
+namespace impl {
+struct exec_ctx_t;
+} // namespace impl
+} // namespace dnnl
+
 struct dnnl_stream : public dnnl::impl::c_compatible {
     dnnl_stream(dnnl::impl::engine_t *engine, unsigned flags,
             const dnnl::impl::stream_attr_t *attr)
@@ -46,6 +52,12 @@ struct dnnl_stream : public dnnl::impl::c_compatible {
     /** blocks until all submitted primitives to the stream are completed */
     virtual dnnl::impl::status_t wait() = 0;
 
+    /** submits the execution of a primitive; executes it right away unless
+     * the stream runs primitives asynchronously */
+    virtual dnnl::impl::status_t enqueue_primitive(
+            const primitive_iface_t *primitive_iface,
+            dnnl::impl::exec_ctx_t &ctx);
+
     const dnnl::impl::stream_attr_t *attr() const { return &attr_; }
 
     virtual void before_exec_hook() {}
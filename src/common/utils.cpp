@@ -87,6 +87,17 @@ int getenv_int(const char *name, int default_value) {
     return value;
 }
 
+size_t getenv_size(const char *name, size_t default_value) {
+    char value_str[32];
+    if (getenv(name, value_str, sizeof(value_str)) > 0) {
+        // an explicit 0 is a valid setting, a malformed value is not
+        if (strspn(value_str, "0") == strlen(value_str)) return 0;
+        const size_t value = parse_size(value_str);
+        if (value > 0) return value;
+    }
+    return default_value;
+}
+
 FILE *fopen(const char *filename, const char *mode) {
 #ifdef _WIN32
     FILE *fp = NULL;
@@ -102,7 +113,7 @@ int getpagesize() {
     GetSystemInfo(&info);
     return info.dwPageSize;
 #else
-    return ::getpagesize();
+    return (int)sysconf(_SC_PAGESIZE);
 #endif
 }
 
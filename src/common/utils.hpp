@@ -344,6 +344,8 @@ inline typename remove_reference<U>::type this_block_size(
         return block_size;
 }
 
+/* The dims X may also be fast_div_t (fast_div.hpp), so that
+ * nd_iterator_init() and nd_iterator_jump() avoid hardware division */
 template <typename T>
 inline T nd_iterator_init(T start) {
     return start;
@@ -522,6 +524,24 @@ inline void yield_thread() {}
 int getenv(const char *name, char *buffer, int buffer_size);
 // Reads an integer from the environment
 int getenv_int(const char *name, int default_value = 0);
+// "48K", "1280K", "30M", "2G" or plain bytes; 0 if malformed
+inline size_t parse_size(const char *s) {
+    char *end = nullptr;
+    unsigned long long v = strtoull(s, &end, 10);
+    if (end == s) return 0;
+    switch (*end) {
+        case 'k':
+        case 'K': v <<= 10; break;
+        case 'm':
+        case 'M': v <<= 20; break;
+        case 'g':
+        case 'G': v <<= 30; break;
+        default: break;
+    }
+    return (size_t)v;
+}
+// Reads a size in parse_size() format from the environment
+size_t getenv_size(const char *name, size_t default_value = 0);
 bool get_jit_dump();
 unsigned get_jit_profiling_flags();
 std::string get_jit_profiling_jitdumpdir();
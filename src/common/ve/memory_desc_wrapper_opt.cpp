@@ -30,7 +30,7 @@ wo::DimsFastDivVec wo::init_fastdiv_vec(dims_t const d, int const len){
         ret.mul[i] = f.mul;
         ret.add[i] = f.add;
         ret.shr[i] = f.shift;
-        ret.div[i] = f.shift;
+        ret.div[i] = (uint32_t)d[i];
     }
     return ret;
 }
@@ -42,6 +42,7 @@ wo::memory_desc_wrapper_opt(const memory_desc_t *md)
           // if offset_u32, also set
           , blk_strides32()
           , padded_offsets32()
+          , has_padded_offsets(false)
 #if VEC_U32
           , ibs32()
           , ib_strides32()
@@ -79,15 +80,24 @@ void wo::set_ib_info() {
             for (int iblk = 0; iblk < ibs; ++iblk) {
                 ib_strides32[iblk] = (uint32_t)ib_strides[iblk];
                 ibs32[iblk] = (uint32_t)blk.inner_blks[iblk];
+#if FD_VEC
+                ibs_fd[iblk] = fast_div_t(blk.inner_blks[iblk]);
+#endif
             }
         }
 #endif
     }
+    for (int d = 0; d < ndims(); ++d)
+        if (padded_offsets()[d] != 0) has_padded_offsets = true;
     if (offsets_u32) { // not really inner info, here anyway.
         for (int d = 0; d < ndims(); ++d) {
             blk_strides32[d] = (uint32_t)blk.strides[d];
             padded_offsets32[d] = (uint32_t)padded_offsets()[d];
         }
+#if FD_VEC
+        dims_fd.init(ndims(), dims());
+        padded_dims_fd.init(ndims(), padded_dims());
+#endif
     }
 #if VEC_U32
     if (dims_small) { // always true?
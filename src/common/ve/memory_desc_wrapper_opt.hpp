@@ -20,6 +20,7 @@
 #include <array>
 
 #include "common/memory_desc_wrapper.hpp"
+#include "common/fast_div.hpp"
 #include "common/dnnl_optimize.h" // VREG, ...
 #include <sstream>
 #ifndef NDEBUG
@@ -311,7 +312,7 @@ struct CoordsForNd : public CoordRegs<Crd,MaxDims> {
         assert( nd <= MaxDims );
         static_assert(MaxDims <= DNNL_MAX_NDIMS, "unexpectedly large number dims");
         sz = Pos{1};
-        ShortLoop() for(int i=0; i<dim; ++i){
+        ShortLoop() for(unsigned i=0; i<dim; ++i){
             ilo[i] = Crd{0};
             ihi[i] = d[i];
             sz *= d[i];
@@ -344,7 +345,7 @@ struct CoordsForNd : public CoordRegs<Crd,MaxDims> {
         assert( nd <= MaxDims );
         static_assert(MaxDims <= DNNL_MAX_NDIMS, "unexpectedly large number dims");
         sz = Pos{1};
-        ShortLoop() for(int i=0; i<dim; ++i){
+        ShortLoop() for(unsigned i=0; i<dim; ++i){
             ilo[i] = Crd{0};
             ihi[i] = d[i];
             sz *= d[i];
@@ -357,7 +358,7 @@ struct CoordsForNd : public CoordRegs<Crd,MaxDims> {
         assert( (unsigned)nd <= MaxDims );
         static_assert(MaxDims <= DNNL_MAX_NDIMS, "unexpectedly large number dims");
         sz = Pos{1};
-        ShortLoop() for(int i=0; i<dim; ++i){
+        ShortLoop() for(unsigned i=0; i<dim; ++i){
             ilo[i] = Crd{0};
             ihi[i] = d[i];
             sz *= d[i];
@@ -371,7 +372,7 @@ struct CoordsForNd : public CoordRegs<Crd,MaxDims> {
      * full/sub-range. */
     void finalize() {
         sz = Pos{1};
-        ShortLoop() for(int i=0; i<dim; ++i){
+        ShortLoop() for(unsigned i=0; i<dim; ++i){
             sz *= ihi[i] - ilo[i];
         }
     }
@@ -666,11 +667,19 @@ struct CoordsForNd : public CoordRegs<Crd,MaxDims> {
 // fast-division option -- need to see if it is a real speedup
 //  -- removed -- see memory_desc_wrapper_opt_dev.* to try it
 
-//#define FD_VEC 0   /* try vectorizing fastdiv for vec_off_l routines */
+/* vectorize fastdiv (fast_div.hpp) in the VEC_U32 vec_off_* routines */
 // results: for 'noff' in vec_off_l <= 256, fastdiv is bad. (tried it in VEC_U32 section)
 //          for vec_off_l >= 512, small improvement (not worth additional complexity)
 // ** at best ** 4% speedup, but can be quite bad.
-// LEAVE THIS OFF
+// LEAVE THIS OFF on VE.  Elsewhere u32 division does not vectorize at all,
+// while mul-add-shr does, so default it on.
+#ifndef FD_VEC
+#if defined(__ve)
+#define FD_VEC 0
+#else
+#define FD_VEC 1
+#endif
+#endif
 
 #define VEC_U32 1 // check for u32 arithmetic in vec_off_* routines
 // results: on VE, u32 and u64 arithmetic is essentially same speed
@@ -850,6 +859,20 @@ public:
                     _Pragma("_NEC vreg(off)");
                     SHORT_ for(int l=0; l<llen; ++l) off[l] = l_offsets[lb+l]; // VLD
                     // convert to coords [up to 12=DNNL_MAX_NDIMS]
+#if FD_VEC
+                    const auto &fdm = is_pos_padded ? padded_dims_fd: dims_fd;
+                    if (fdm.ok()) {
+                        NOVEC_ for (int d = 0; d < nd; ++d) {
+                            const int rd = nd - 1 - d;
+                            const fast_div_t &f = fdm[rd];
+                            SHORT_ for(int l=0; l<llen; ++l) {
+                                uint32_t const q = (uint32_t)f.div(off[l]);
+                                vp32.vp[rd][l] = off[l] - q * dm32[rd];
+                                off[l] = q;
+                            }
+                        }
+                    } else
+#endif
                     NOVEC_ for (int d = 0; d < nd; ++d) { // reverse
                         const int rd = nd - 1 - d;        // dims
                         SHORT_ for(int l=0; l<llen; ++l) {   // l ~ logical offset
@@ -926,7 +949,7 @@ public:
         //assert( nd <= 6 ); // can be equal to 6, as in gtests
         // Weights_3d_CPU/reorder_simple_test_f32_f32.TestsReorder/13
         VecPos vp;
-        if (is_pos_padded) {
+        if (!is_pos_padded) { // as off_v: pos is relative to padded_offsets()
             NOVEC_ ShortLoop() PragmaQuote(_NEC nounroll) PragmaQuote(_NEC loop_count(6))//;
             for (int d = 0; d < nd; ++d) {
                VEC_ for(int l = 0; l < noff; ++l) {
@@ -1004,7 +1027,7 @@ public:
 #define Short_ PragmaQuote(_NEC vector) PragmaQuote(_NEC nounroll)
         const int nd = ndims();
         assert( nd <= 6 );
-        if (is_pos_padded) {
+        if (!is_pos_padded && has_padded_offsets) {
             NOVEC_ ShortLoop() PragmaQuote(_NEC nounroll) PragmaQuote(_NEC loop_count(6))//;
             for (int d = 0; d < nd; ++d) {
                VEC_ for(int l = 0; l < noff; ++l) {
@@ -1069,7 +1092,7 @@ public:
         const int nd = ndims();
         assert( nd <= 6 );
         VecPos32 vp32;
-        if (is_pos_padded) {
+        if (!is_pos_padded) {
             NOVEC_ ShortLoop() PragmaQuote(_NEC nounroll) PragmaQuote(_NEC loop_count(6))//;
             for (int d = 0; d < nd; ++d) {
                VEC_ for(int l = 0; l < noff; ++l) {
@@ -1095,12 +1118,22 @@ public:
         if (blk.inner_nblks > 0) {
             NOVEC_ for (int iblk = blk.inner_nblks - 1; iblk >= 0; --iblk) {
                 const int d = blk.inner_idxs[iblk];
+#if FD_VEC
+                const fast_div_t &f = ibs_fd[iblk];
+                VEC_ for(int l=0; l<noff; ++l) {
+                    uint32_t const q = (uint32_t)f.div(vp32.vp[d][l]);
+                    uint32_t const p = vp32.vp[d][l] - q * ibs32[iblk];
+                    vp32.vp[d][l] = q;
+                    phys[l] += p * ib_strides32[iblk];
+                }
+#else
                 VEC_ for(int l=0; l<noff; ++l) {
                     // ibs32 ~ blk.inner_blocks
                     uint32_t const p = vp32.vp[d][l] % ibs32[iblk];
                     vp32.vp[d][l] /= ibs32[iblk];
                     phys[l] += p * ib_strides32[iblk];
                 }
+#endif
             }
         }
 
@@ -1141,7 +1174,7 @@ public:
 #define Short_ PragmaQuote(_NEC vector) PragmaQuote(_NEC nounroll)
         const int nd = ndims();
         assert( nd <= 6 );
-        if (is_pos_padded) {
+        if (!is_pos_padded && has_padded_offsets) {
             NOVEC_ ShortLoop() PragmaQuote(_NEC nounroll) PragmaQuote(_NEC loop_count(6))//;
             for (int d = 0; d < nd; ++d) {
                VEC_ for(int l = 0; l < noff; ++l) {
@@ -1160,12 +1193,22 @@ public:
         if (blk.inner_nblks > 0) {
             NOVEC_ for (int iblk = blk.inner_nblks - 1; iblk >= 0; --iblk) {
                 const int d = blk.inner_idxs[iblk];
+#if FD_VEC
+                const fast_div_t &f = ibs_fd[iblk];
+                VEC_ for(int l=0; l<noff; ++l) {
+                    uint32_t const q = (uint32_t)f.div(vp32.vp[d][l]);
+                    uint32_t const p = vp32.vp[d][l] - q * ibs32[iblk];
+                    vp32.vp[d][l] = q;
+                    phys[l] += p * ib_strides32[iblk];
+                }
+#else
                 VEC_ for(int l=0; l<noff; ++l) {
                     // ibs32 ~ blk.inner_blocks
                     uint32_t const p = vp32.vp[d][l] % ibs32[iblk];
                     vp32.vp[d][l] /= ibs32[iblk];
                     phys[l] += p * ib_strides32[iblk];
                 }
+#endif
             }
         }
 
@@ -1302,7 +1345,8 @@ private:
     /** quick test for uint32_t offset arithmetic */
     bool const offsets_u32;
     uint32_t blk_strides32[DNNL_MAX_NDIMS];     ///< blk.strides
-    uint32_t padded_offsets32[DNNL_MAX_NDIMS];  ///< if is_pos_padded, padded_offset()[]
+    uint32_t padded_offsets32[DNNL_MAX_NDIMS];  ///< if !is_pos_padded, padded_offset()[]
+    bool has_padded_offsets; ///< any padded_offsets()[d] != 0 (views)
 
 #if VEC_U32
     uint32_t ibs32[DNNL_MAX_NDIMS]; ///< inner blocking (always u32)
@@ -1315,6 +1359,12 @@ private:
     uint32_t padded_dims32[DNNL_MAX_NDIMS];
     uint32_t dims32[DNNL_MAX_NDIMS];
 #endif
+#if FD_VEC
+    // u32 divisors for the VEC_U32 paths; !ok() unless offsets_u32
+    dims_fast_div_t dims_fd;
+    dims_fast_div_t padded_dims_fd;
+    fast_div_t ibs_fd[DNNL_MAX_NDIMS]; ///< ibs32
+#endif
 };
 
 // support functions
@@ -1329,6 +1379,91 @@ inline constexpr uint64_t operator/(uint64_t top, memory_desc_wrapper_opt::Magic
 #endif
 }
 
+/** Batched physical offsets of a blocked memory descriptor.
+ *
+ * Walks a nested-for-loop range of logical coordinates of \c md in MVL-long
+ * chunks (as CoordsForNd) and converts every chunk to physical offsets with
+ * memory_desc_wrapper_opt::vec_off_v, so inner blocking, padding and strides
+ * of any blocked layout cost a few vector ops per chunk instead of a scalar
+ * off_v per element:
+ * ```
+ * for (VecOffsetsFor it(src_d, start, end); it; ++it) {  // [start,end) of nelems
+ *     dim_t const* const off = it.off();
+ *     it.off_of(dst_d, dst_off);                      // same coords, other md
+ *     for (int i = 0; i < it.get_vl(); ++i)
+ *         dst[dst_off[i]] = f(src[off[i]]);
+ * }
+ * ```
+ * \c vp / \c base() hold the current coordinates.  Derived coordinates
+ * (broadcast, shuffled axis, pooling windows, ...) go through \c off_of
+ * with a mask, or a modified CoordsForNd::Base copy and
+ * memory_desc_wrapper_opt::vec_off_vtmp.
+ *
+ * \pre \c ok(md): blocking desc with at most 6 dims (otherwise use off_l).
+ */
+struct VecOffsetsFor : public CoordsForNd<6, uint64_t, uint64_t> {
+    typedef CoordsForNd<6, uint64_t, uint64_t> Coords;
+    typedef memory_desc_wrapper_opt::VecPos VecPos; // same as Coords::Base
+
+    /** can \c md be iterated by VecOffsetsFor? */
+    static bool ok(memory_desc_wrapper const& md) {
+        return md.is_blocking_desc() && md.ndims() > 0 && md.ndims() <= 6;
+    }
+
+    /** linear positions [start,end) of the dense loop nest over md.dims() */
+    VecOffsetsFor(memory_desc_wrapper_opt const& md, dim_t start, dim_t end)
+        : Coords(md.dims(), md.ndims(), (pos_t)start, (pos_t)end), md_(md) {
+        calc();
+    }
+
+    /** all coordinates of the box lo[d] <= x[d] < hi[d], d < md.ndims() */
+    VecOffsetsFor(memory_desc_wrapper_opt const& md, dim_t const* lo,
+            dim_t const* hi)
+        : Coords(), md_(md) {
+        for (int d = 0; d < md.ndims(); ++d) // empty if any hi <= lo
+            fix_coord(d, (crd_t)lo[d], (crd_t)nstl::max(lo[d], hi[d]));
+        finalize(md.ndims());
+        init_nd(0);
+        calc();
+    }
+
+    VecOffsetsFor& operator++() {
+        Coords::step();
+        calc();
+        return *this;
+    }
+
+    /** physical offsets in \c md of the current \c get_vl() coordinates */
+    dim_t const* off() const { return off_; }
+
+    /** physical offsets of the current coordinates in \c md2, a tensor with
+     * the same logical dims (\c vl-long output) */
+    void off_of(memory_desc_wrapper_opt const& md2, dim_t* p_off) const {
+        md2.vec_off_v(base(), p_off, get_vl());
+    }
+
+    /** as above, with coordinate \c d zeroed where \c bcast[d] != 0
+     * (\c md2 is broadcast along \c d, its dims[d] == 1) */
+    void off_of(memory_desc_wrapper_opt const& md2, dim_t* p_off,
+            dims_t const bcast) const {
+        VecPos vp2;
+        unsigned const vl = get_vl();
+        NOVEC_ for (unsigned d = 0; d < get_dim(); ++d) {
+            uint64_t const keep = bcast[d] ? 0 : 1;
+            ShortLoop() for (unsigned i = 0; i < vl; ++i)
+                vp2.vp[d][i] = vp[d][i] * keep;
+        }
+        md2.vec_off_vtmp(vp2, p_off, vl);
+    }
+
+private:
+    void calc() {
+        if (get_vl()) md_.vec_off_v(base(), off_, get_vl());
+    }
+    memory_desc_wrapper_opt const& md_;
+    dim_t off_[MVL];
+};
+
 } // namespace impl
 } // namespace dnnl
 
@@ -14,7 +14,6 @@
 * limitations under the License.
 *******************************************************************************/
 
-#include <array>
 #include <memory>
 
 #include "common/bfloat16.hpp"
@@ -31,6 +30,27 @@
 namespace dnnl {
 namespace impl {
 
+namespace {
+// Branch-free conversions on raw bits, so that the bulk loops below
+// vectorize instead of calling bfloat16_t operators element by element.
+inline uint16_t f32_to_bf16_bits(float f) {
+    const uint32_t u = utils::bit_cast<uint32_t>(f);
+    const uint32_t exp = u & 0x7f800000u;
+    const uint32_t mant = u & 0x007fffffu;
+    // normal: round to nearest even and truncate
+    const uint32_t rne = (u + 0x7fffu + ((u >> 16) & 0x1u)) >> 16;
+    // zero and denormal: sign preserving zero
+    const uint32_t zero = (u >> 16) & 0x8000u;
+    // infinity: truncate; nan: truncate and force QNAN
+    const uint32_t inf_nan = (u >> 16) | (mant ? 0x40u : 0x0u);
+    return (uint16_t)(exp == 0 ? zero : exp == 0x7f800000u ? inf_nan : rne);
+}
+
+inline float bf16_bits_to_f32(uint16_t b) {
+    return utils::bit_cast<float>((uint32_t)b << 16);
+}
+} // namespace
+
 bfloat16_t &bfloat16_t::operator=(float f) {
 #if DNNL_X64
     if (cpu::x64::mayiuse(cpu::x64::cpu_isa_t::avx512_core)) {
@@ -44,36 +64,12 @@ bfloat16_t &bfloat16_t::operator=(float f) {
     }
 #endif
 
-    auto iraw = utils::bit_cast<std::array<uint16_t, 2>>(f);
-    switch (std::fpclassify(f)) {
-        case FP_SUBNORMAL:
-        case FP_ZERO:
-            // sign preserving zero (denormal go to zero)
-            raw_bits_ = iraw[1];
-            raw_bits_ &= 0x8000;
-            break;
-        case FP_INFINITE: raw_bits_ = iraw[1]; break;
-        case FP_NAN:
-            // truncate and set MSB of the mantissa force QNAN
-            raw_bits_ = iraw[1];
-            raw_bits_ |= 1 << 6;
-            break;
-        case FP_NORMAL:
-            // round to nearest even and truncate
-            const uint32_t rounding_bias = 0x00007FFF + (iraw[1] & 0x1);
-            const uint32_t int_raw
-                    = utils::bit_cast<uint32_t>(f) + rounding_bias;
-            iraw = utils::bit_cast<std::array<uint16_t, 2>>(int_raw);
-            raw_bits_ = iraw[1];
-            break;
-    }
-
+    raw_bits_ = f32_to_bf16_bits(f);
     return *this;
 }
 
 bfloat16_t::operator float() const {
-    std::array<uint16_t, 2> iraw = {{0, raw_bits_}};
-    return utils::bit_cast<float>(iraw);
+    return bf16_bits_to_f32(raw_bits_);
 }
 
 void cvt_float_to_bfloat16(bfloat16_t *out, const float *inp, size_t nelems) {
@@ -91,7 +87,7 @@ void cvt_float_to_bfloat16(bfloat16_t *out, const float *inp, size_t nelems) {
 
     PRAGMA_OMP_SIMD()
     for (size_t i = 0; i < nelems; ++i)
-        out[i] = inp[i];
+        out[i].raw_bits_ = f32_to_bf16_bits(inp[i]);
 }
 
 void cvt_bfloat16_to_float(float *out, const bfloat16_t *inp, size_t nelems) {
@@ -109,7 +105,7 @@ void cvt_bfloat16_to_float(float *out, const bfloat16_t *inp, size_t nelems) {
 
     PRAGMA_OMP_SIMD()
     for (size_t i = 0; i < nelems; ++i)
-        out[i] = inp[i];
+        out[i] = bf16_bits_to_f32(inp[i].raw_bits_);
 }
 
 void cvt_bfloat16_and_add_to_float(
@@ -130,7 +126,28 @@ void cvt_bfloat16_and_add_to_float(
 
     PRAGMA_OMP_SIMD()
     for (size_t i = 0; i < nelems; ++i)
-        out[i] = (float)inp[i] + add[i];
+        out[i] = bf16_bits_to_f32(inp[i].raw_bits_) + add[i];
+}
+
+void cvt_bfloat16_and_scale_to_float(
+        float *out, const bfloat16_t *inp, float scale, size_t nelems) {
+    PRAGMA_OMP_SIMD()
+    for (size_t i = 0; i < nelems; ++i)
+        out[i] = scale * bf16_bits_to_f32(inp[i].raw_bits_);
+}
+
+void cvt_bfloat16_scale_and_accumulate_to_float(
+        float *acc, const bfloat16_t *inp, float scale, size_t nelems) {
+    PRAGMA_OMP_SIMD()
+    for (size_t i = 0; i < nelems; ++i)
+        acc[i] += scale * bf16_bits_to_f32(inp[i].raw_bits_);
+}
+
+void scale_floats_and_cvt_to_bfloat16(
+        bfloat16_t *out, const float *inp, float scale, size_t nelems) {
+    PRAGMA_OMP_SIMD()
+    for (size_t i = 0; i < nelems; ++i)
+        out[i].raw_bits_ = f32_to_bf16_bits(scale * inp[i]);
 }
 
 void add_floats_and_cvt_to_bfloat16(
@@ -151,7 +168,7 @@ void add_floats_and_cvt_to_bfloat16(
 
     PRAGMA_OMP_SIMD()
     for (size_t i = 0; i < nelems; ++i)
-        out[i] = inp0[i] + inp1[i];
+        out[i].raw_bits_ = f32_to_bf16_bits(inp0[i] + inp1[i]);
 }
 
 } // namespace impl
@@ -26,6 +26,8 @@
 #include "cpu/gemm_x8s8s32x_convolution.hpp"
 #include "cpu/ref_convolution.hpp"
 #include "cpu/ref_fused_convolution.hpp"
+#include "cpu/simple_dw_convolution.hpp"
+#include "cpu/simple_wino_convolution.hpp"
 
 #if DNNL_X64
 #include "cpu/x64/gemm_bf16_convolution.hpp"
@@ -53,6 +55,16 @@ using namespace dnnl::impl::cpu::x64;
 #define CPU_INSTANCE_GEMM(...) CPU_INSTANCE(__VA_ARGS__)
 //#define CPU_INSTANCE_GEMM(...)
 
+// simple_wino goes after gemm where the jit sgemm makes gemm faster, and
+// serves explicit winograd requests that no jit winograd takes there
+#if DNNL_X64
+#define CPU_INSTANCE_SIMPLE_WINO_BEFORE_GEMM(...)
+#define CPU_INSTANCE_SIMPLE_WINO_AFTER_GEMM(...) CPU_INSTANCE(__VA_ARGS__)
+#else
+#define CPU_INSTANCE_SIMPLE_WINO_BEFORE_GEMM(...) CPU_INSTANCE(__VA_ARGS__)
+#define CPU_INSTANCE_SIMPLE_WINO_AFTER_GEMM(...)
+#endif
+
 namespace dnnl {
 namespace impl {
 namespace cpu {
@@ -97,7 +109,10 @@ static const std::map<conv_impl_key_t, std::vector<pd_create_f>> impl_list_map {
         CPU_INSTANCE_X64(jit_sse41_1x1_convolution_fwd_t)
         CPU_INSTANCE_X64(jit_avx2_convolution_fwd_t)
         CPU_INSTANCE_X64(jit_sse41_convolution_fwd_t)
+        CPU_INSTANCE(simple_dw_convolution_fwd_t)
+        CPU_INSTANCE_SIMPLE_WINO_BEFORE_GEMM(simple_wino_convolution_fwd_t)
         CPU_INSTANCE_GEMM(gemm_convolution_fwd_t)
+        CPU_INSTANCE_SIMPLE_WINO_AFTER_GEMM(simple_wino_convolution_fwd_t)
         CPU_INSTANCE(ref_convolution_fwd_t<f32>)
         CPU_INSTANCE(ref_fused_convolution_fwd_t)
         nullptr,
@@ -128,6 +143,7 @@ static const std::map<conv_impl_key_t, std::vector<pd_create_f>> impl_list_map {
         CPU_INSTANCE_X64(jit_avx2_1x1_convolution_bwd_data_t)
         CPU_INSTANCE_X64(jit_sse41_dw_convolution_bwd_data_t)
         CPU_INSTANCE_X64(jit_avx2_convolution_bwd_data_t)
+        CPU_INSTANCE(simple_dw_convolution_bwd_data_t)
         CPU_INSTANCE_GEMM(gemm_convolution_bwd_data_t)
         CPU_INSTANCE(ref_convolution_bwd_data_t<f32, f32, f32, f32>)
         nullptr,
@@ -157,6 +173,7 @@ static const std::map<conv_impl_key_t, std::vector<pd_create_f>> impl_list_map {
         CPU_INSTANCE_X64(jit_avx2_1x1_convolution_bwd_weights_t)
         CPU_INSTANCE_X64(jit_sse41_dw_convolution_bwd_weights_t)
         CPU_INSTANCE_X64(jit_avx2_convolution_bwd_weights_t)
+        CPU_INSTANCE(simple_dw_convolution_bwd_weights_t)
         CPU_INSTANCE_GEMM(gemm_convolution_bwd_weights_t)
         CPU_INSTANCE(ref_convolution_bwd_weights_t<f32, f32, f32, f32>)
         nullptr,
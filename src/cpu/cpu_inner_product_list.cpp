@@ -16,15 +16,11 @@
 
 #include "cpu/cpu_engine.hpp"
 
+#include "cpu/gemm_bf16_inner_product.hpp"
 #include "cpu/gemm_inner_product.hpp"
 #include "cpu/gemm_x8s8s32x_inner_product.hpp"
 #include "cpu/ref_inner_product.hpp"
 
-#if DNNL_X64
-#include "cpu/x64/gemm_bf16_inner_product.hpp"
-using namespace dnnl::impl::cpu::x64;
-#endif
-
 namespace dnnl {
 namespace impl {
 namespace cpu {
@@ -44,12 +40,12 @@ static const pd_create_f impl_list[] = {
         CPU_INSTANCE(ref_inner_product_bwd_data_t<f32, f32, f32, f32>)
         CPU_INSTANCE(ref_inner_product_bwd_weights_t<f32>)
         /* bfloat16 */
-        CPU_INSTANCE_X64(gemm_bf16_inner_product_fwd_t<f32>)
-        CPU_INSTANCE_X64(gemm_bf16_inner_product_fwd_t<bf16>)
-        CPU_INSTANCE_X64(gemm_bf16_inner_product_bwd_data_t<f32>)
-        CPU_INSTANCE_X64(gemm_bf16_inner_product_bwd_data_t<bf16>)
-        CPU_INSTANCE_X64(gemm_bf16_inner_product_bwd_weights_t<f32>)
-        CPU_INSTANCE_X64(gemm_bf16_inner_product_bwd_weights_t<bf16>)
+        CPU_INSTANCE(gemm_bf16_inner_product_fwd_t<f32>)
+        CPU_INSTANCE(gemm_bf16_inner_product_fwd_t<bf16>)
+        CPU_INSTANCE(gemm_bf16_inner_product_bwd_data_t<f32>)
+        CPU_INSTANCE(gemm_bf16_inner_product_bwd_data_t<bf16>)
+        CPU_INSTANCE(gemm_bf16_inner_product_bwd_weights_t<f32>)
+        CPU_INSTANCE(gemm_bf16_inner_product_bwd_weights_t<bf16>)
         /* int */
         CPU_INSTANCE(gemm_x8s8s32x_inner_product_fwd_t<u8, u8>)
         CPU_INSTANCE(gemm_x8s8s32x_inner_product_fwd_t<u8, s8>)
@@ -0,0 +1,414 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/memory_debug.hpp"
+#include "common/nstl.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/cpu_memory_allocator.hpp"
+#include "cpu/platform.hpp"
+
+#if defined(__linux__)
+#define DNNL_CPU_MAPPED_ALLOC 1
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#define DNNL_CPU_MAPPED_ALLOC 0
+#endif
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+namespace {
+constexpr size_t default_threshold = (size_t)2 << 20;
+constexpr size_t default_huge_page_size = (size_t)2 << 20;
+
+bool is_default(const cpu_alloc_policy_t &p) {
+    return p.huge_pages == cpu_alloc_policy_t::huge_pages_none
+            && p.numa == cpu_alloc_policy_t::numa_default
+            && p.pool_limit == 0;
+}
+
+bool is_valid(const cpu_alloc_policy_t &p) {
+    using policy_t = cpu_alloc_policy_t;
+    return utils::one_of(p.huge_pages, policy_t::huge_pages_none,
+                   policy_t::huge_pages_transparent,
+                   policy_t::huge_pages_explicit)
+            && utils::one_of(p.numa, policy_t::numa_default,
+                    policy_t::numa_interleave, policy_t::numa_bind,
+                    policy_t::numa_preferred)
+            && IMPLICATION(utils::one_of(p.numa, policy_t::numa_bind,
+                                   policy_t::numa_preferred),
+                    p.numa_node >= 0);
+}
+
+cpu_alloc_policy_t policy_from_env() {
+    using policy_t = cpu_alloc_policy_t;
+    policy_t p;
+    p.huge_pages = policy_t::huge_pages_none;
+    p.numa = policy_t::numa_default;
+    p.numa_node = 0;
+
+    char buf[64];
+    if (getenv("DNNL_CPU_HUGE_PAGES", buf, sizeof(buf)) > 0) {
+        if (strcmp(buf, "transparent") == 0)
+            p.huge_pages = policy_t::huge_pages_transparent;
+        else if (strcmp(buf, "explicit") == 0)
+            p.huge_pages = policy_t::huge_pages_explicit;
+    }
+    if (getenv("DNNL_CPU_NUMA", buf, sizeof(buf)) > 0) {
+        if (strcmp(buf, "interleave") == 0) {
+            p.numa = policy_t::numa_interleave;
+        } else if (strncmp(buf, "bind:", 5) == 0) {
+            p.numa = policy_t::numa_bind;
+            p.numa_node = atoi(buf + 5);
+        } else if (strncmp(buf, "preferred:", 10) == 0) {
+            p.numa = policy_t::numa_preferred;
+            p.numa_node = atoi(buf + 10);
+        }
+    }
+    p.threshold = getenv_size("DNNL_CPU_ALLOC_THRESHOLD", default_threshold);
+    p.pool_limit = getenv_size("DNNL_CPU_ALLOC_POOL", 0);
+
+    if (!is_valid(p)) p.numa = policy_t::numa_default;
+    return p;
+}
+
+// Rounds size up to a multiple of the larger of granule and a quarter of
+// the highest power of two not above size: at most 4 classes per octave.
+size_t size_class(size_t size, size_t granule) {
+    size_t top = 1;
+    while (top <= size / 2)
+        top <<= 1;
+    return utils::rnd_up(size, nstl::max(granule, top / 4));
+}
+
+#if DNNL_CPU_MAPPED_ALLOC
+size_t os_page_size() {
+    static const size_t page = (size_t)getpagesize();
+    return page;
+}
+
+// default huge page size of the kernel, e.g. "Hugepagesize:    2048 kB"
+size_t huge_page_size() {
+    static const size_t size = [] {
+        size_t kb = 0;
+        FILE *f = fopen("/proc/meminfo", "r");
+        if (f) {
+            char line[128];
+            while (fgets(line, sizeof(line), f))
+                if (sscanf(line, "Hugepagesize: %zu kB", &kb) == 1) break;
+            fclose(f);
+        }
+        return kb ? kb << 10 : default_huge_page_size;
+    }();
+    return size;
+}
+
+#if defined(SYS_mbind)
+constexpr int mpol_preferred = 1;
+constexpr int mpol_bind = 2;
+constexpr int mpol_interleave = 3;
+constexpr int max_numa_nodes = 1024;
+constexpr int mask_bits = 8 * sizeof(unsigned long);
+typedef std::vector<unsigned long> node_mask_t;
+
+void set_node(node_mask_t &mask, long node) {
+    if (node >= 0 && node < max_numa_nodes)
+        mask[node / mask_bits] |= 1UL << (node % mask_bits);
+}
+
+// online nodes from a list like "0-1,3"
+bool online_nodes(node_mask_t &mask) {
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    if (!f) return false;
+    char buf[256];
+    const bool ok = fgets(buf, sizeof(buf), f) != nullptr;
+    fclose(f);
+    if (!ok) return false;
+    return platform::for_each_cpulist_entry(
+                   buf, [&](long node) { set_node(mask, node); })
+            > 0;
+}
+
+// Placement is best effort: a failed mbind leaves first touch.
+void numa_place(void *ptr, size_t size, const cpu_alloc_policy_t &p) {
+    node_mask_t mask(max_numa_nodes / mask_bits, 0);
+    int mode = 0;
+    switch (p.numa) {
+        case cpu_alloc_policy_t::numa_interleave:
+            if (!online_nodes(mask)) return;
+            mode = mpol_interleave;
+            break;
+        case cpu_alloc_policy_t::numa_bind:
+            set_node(mask, p.numa_node);
+            mode = mpol_bind;
+            break;
+        case cpu_alloc_policy_t::numa_preferred:
+            set_node(mask, p.numa_node);
+            mode = mpol_preferred;
+            break;
+        default: return;
+    }
+    // the kernel takes the mask size in bits plus one
+    syscall(SYS_mbind, ptr, size, mode, mask.data(),
+            (unsigned long)max_numa_nodes + 1, 0U);
+}
+#else
+void numa_place(void *ptr, size_t size, const cpu_alloc_policy_t &p) {}
+#endif
+
+// Maps size bytes (a multiple of the page size in use), aligned to a huge
+// page when huge pages are asked for.
+void *map_block(size_t size, const cpu_alloc_policy_t &p, bool &huge) {
+    const int prot = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void *ptr = MAP_FAILED;
+    huge = false;
+
+#if defined(MAP_HUGETLB)
+    if (p.huge_pages == cpu_alloc_policy_t::huge_pages_explicit) {
+        ptr = mmap(nullptr, size, prot, flags | MAP_HUGETLB, -1, 0);
+        huge = ptr != MAP_FAILED;
+    }
+#endif
+
+    if (ptr == MAP_FAILED) {
+        const bool thp = p.huge_pages != cpu_alloc_policy_t::huge_pages_none;
+        const size_t page = os_page_size();
+        const size_t align = thp ? huge_page_size() : page;
+        // over-map and trim to get the alignment mmap does not promise
+        const size_t len = size + align - page;
+        void *raw = mmap(nullptr, len, prot, flags, -1, 0);
+        if (raw == MAP_FAILED) return nullptr;
+        const uintptr_t start = utils::rnd_up((uintptr_t)raw, align);
+        const size_t head = start - (uintptr_t)raw;
+        const size_t tail = len - head - size;
+        if (head) munmap(raw, head);
+        if (tail) munmap((void *)(start + size), tail);
+        ptr = (void *)start;
+#if defined(MADV_HUGEPAGE)
+        if (thp) huge = madvise(ptr, size, MADV_HUGEPAGE) == 0;
+#endif
+    }
+
+    numa_place(ptr, size, p);
+    return ptr;
+}
+
+void unmap_block(void *ptr, size_t size) {
+    munmap(ptr, size);
+}
+#else
+size_t os_page_size() {
+    return 4096;
+}
+size_t huge_page_size() {
+    return default_huge_page_size;
+}
+void *map_block(size_t size, const cpu_alloc_policy_t &p, bool &huge) {
+    return nullptr;
+}
+void unmap_block(void *ptr, size_t size) {}
+#endif
+
+class mapped_allocator_t {
+public:
+    // Never destroyed: memory objects may be released during static
+    // destruction.
+    static mapped_allocator_t &instance() {
+        static mapped_allocator_t *allocator = new mapped_allocator_t();
+        return *allocator;
+    }
+
+    bool use_mapped(size_t size) const {
+        return size >= threshold_.load(std::memory_order_relaxed);
+    }
+
+    void *alloc(size_t size) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        const cpu_alloc_policy_t policy = policy_;
+        const size_t granule
+                = policy.huge_pages != cpu_alloc_policy_t::huge_pages_none
+                ? huge_page_size()
+                : os_page_size();
+        const size_t sz = size_class(nstl::max(size, (size_t)1), granule);
+
+        auto it = pool_.find(sz);
+        if (it != pool_.end()) {
+            const block_t b = it->second;
+            pool_.erase(it);
+            stats_.pooled_bytes -= sz;
+            stats_.reuses++;
+            live_[b.ptr] = b;
+            return b.ptr;
+        }
+        lock.unlock();
+
+        bool huge = false;
+        void *ptr = map_block(sz, policy, huge);
+        if (!ptr) {
+            // the pool may hold the memory needed
+            drop_pool();
+            ptr = map_block(sz, policy, huge);
+            if (!ptr) return nullptr;
+        }
+
+        lock.lock();
+        live_[ptr] = {ptr, sz, huge};
+        stats_.mapped_bytes += sz;
+        if (huge) stats_.huge_page_bytes += sz;
+        stats_.allocations++;
+        return ptr;
+    }
+
+    void free(void *ptr) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = live_.find(ptr);
+        assert(it != live_.end());
+        if (it == live_.end()) return;
+        const block_t b = it->second;
+        live_.erase(it);
+        if (stats_.pooled_bytes + b.size <= policy_.pool_limit) {
+            pool_.insert(std::make_pair(b.size, b));
+            stats_.pooled_bytes += b.size;
+            return;
+        }
+        forget(b);
+        lock.unlock();
+        unmap_block(b.ptr, b.size);
+    }
+
+    cpu_alloc_policy_t policy() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return policy_;
+    }
+
+    void set_policy(const cpu_alloc_policy_t &policy) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            policy_ = policy;
+            update_threshold();
+        }
+        drop_pool();
+    }
+
+    cpu_alloc_stats_t stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct block_t {
+        void *ptr;
+        size_t size;
+        bool huge;
+    };
+
+    mapped_allocator_t() : policy_(policy_from_env()) {
+        stats_.mapped_bytes = stats_.pooled_bytes = stats_.huge_page_bytes
+                = 0;
+        stats_.allocations = stats_.reuses = 0;
+        update_threshold();
+    }
+
+    void update_threshold() {
+        const bool enabled = DNNL_CPU_MAPPED_ALLOC
+                && !memory_debug::is_mem_debug() && !is_default(policy_);
+        threshold_.store(enabled ? nstl::max(policy_.threshold, (size_t)1)
+                                 : SIZE_MAX,
+                std::memory_order_relaxed);
+    }
+
+    void forget(const block_t &b) {
+        stats_.mapped_bytes -= b.size;
+        if (b.huge) stats_.huge_page_bytes -= b.size;
+    }
+
+    void drop_pool() {
+        std::multimap<size_t, block_t> pool;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pool.swap(pool_);
+            for (const auto &e : pool)
+                forget(e.second);
+            stats_.pooled_bytes = 0;
+        }
+        for (const auto &e : pool)
+            unmap_block(e.second.ptr, e.second.size);
+    }
+
+    std::mutex mutex_;
+    cpu_alloc_policy_t policy_;
+    std::atomic<size_t> threshold_;
+    std::unordered_map<void *, block_t> live_;
+    std::multimap<size_t, block_t> pool_;
+    cpu_alloc_stats_t stats_;
+};
+} // namespace
+
+namespace cpu_allocator {
+bool use_mapped(size_t size) {
+    return mapped_allocator_t::instance().use_mapped(size);
+}
+
+void *alloc_mapped(size_t size) {
+    return mapped_allocator_t::instance().alloc(size);
+}
+
+void free_mapped(void *ptr) {
+    if (ptr) mapped_allocator_t::instance().free(ptr);
+}
+} // namespace cpu_allocator
+
+status_t get_cpu_alloc_policy(cpu_alloc_policy_t *policy) {
+    if (policy == nullptr) return status::invalid_arguments;
+    *policy = mapped_allocator_t::instance().policy();
+    return status::success;
+}
+
+status_t set_cpu_alloc_policy(const cpu_alloc_policy_t *policy) {
+    if (policy == nullptr || !is_valid(*policy))
+        return status::invalid_arguments;
+    mapped_allocator_t::instance().set_policy(*policy);
+    return status::success;
+}
+
+status_t get_cpu_alloc_stats(cpu_alloc_stats_t *stats) {
+    if (stats == nullptr) return status::invalid_arguments;
+    *stats = mapped_allocator_t::instance().stats();
+    return status::success;
+}
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
@@ -0,0 +1,106 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_CPU_MEMORY_ALLOCATOR_HPP
+#define CPU_CPU_MEMORY_ALLOCATOR_HPP
+
+#include <stddef.h>
+
+#include "common/c_types_map.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+/** Placement policy for the buffers of large CPU memory objects (including
+ * library-managed scratchpads).
+ *
+ * Buffers of at least \c threshold bytes are mapped directly from the OS
+ * when any of the fields below differ from their defaults; smaller buffers
+ * and all buffers under the default policy come from utils::malloc. Mapped
+ * buffers are rounded up to a size class (at most 25% larger than asked)
+ * and, once freed, kept in a pool of up to \c pool_limit bytes for the next
+ * buffer of the same class.
+ *
+ * The initial policy is read from the environment:
+ * - DNNL_CPU_HUGE_PAGES=none|transparent|explicit
+ * - DNNL_CPU_NUMA=default|interleave|bind:<node>|preferred:<node>
+ * - DNNL_CPU_ALLOC_THRESHOLD=<size> (default 2M)
+ * - DNNL_CPU_ALLOC_POOL=<size> (default 0)
+ *
+ * Mapping is available on Linux only; elsewhere the policy is ignored. */
+struct cpu_alloc_policy_t {
+    enum huge_pages_t {
+        huge_pages_none,
+        /** 2 MB aligned mapping advised with MADV_HUGEPAGE */
+        huge_pages_transparent,
+        /** MAP_HUGETLB from the reserved pool, transparent if that fails */
+        huge_pages_explicit,
+    };
+    enum numa_t {
+        /** first touch */
+        numa_default,
+        /** pages spread over all online nodes */
+        numa_interleave,
+        /** pages only on \c numa_node */
+        numa_bind,
+        /** pages on \c numa_node while it has free memory */
+        numa_preferred,
+    };
+
+    huge_pages_t huge_pages;
+    numa_t numa;
+    int numa_node;
+    size_t threshold;
+    size_t pool_limit;
+};
+
+/** Accounting of the mapped buffers. */
+struct cpu_alloc_stats_t {
+    /** bytes mapped now, in use or pooled */
+    size_t mapped_bytes;
+    /** part of mapped_bytes idle in the pool */
+    size_t pooled_bytes;
+    /** part of mapped_bytes on (or advised to use) huge pages */
+    size_t huge_page_bytes;
+    /** buffers mapped from the OS */
+    size_t allocations;
+    /** buffers served from the pool */
+    size_t reuses;
+};
+
+status_t DNNL_API get_cpu_alloc_policy(cpu_alloc_policy_t *policy);
+/** Sets the policy for subsequent allocations and unmaps the pooled buffers,
+ * which were placed under the previous one. */
+status_t DNNL_API set_cpu_alloc_policy(const cpu_alloc_policy_t *policy);
+status_t DNNL_API get_cpu_alloc_stats(cpu_alloc_stats_t *stats);
+
+namespace cpu_allocator {
+/** Whether a buffer of \c size bytes is to be mapped under the current
+ * policy. */
+bool use_mapped(size_t size);
+/** Maps a buffer of at least \c size bytes, aligned to at least a page,
+ * or returns nullptr. */
+void *alloc_mapped(size_t size);
+/** Releases a buffer of alloc_mapped to the pool or to the OS. */
+void free_mapped(void *ptr);
+} // namespace cpu_allocator
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+#endif
@@ -24,6 +24,7 @@
 #include "common/memory_storage.hpp"
 #include "common/utils.hpp"
 
+#include "cpu/cpu_memory_allocator.hpp"
 #include "cpu/platform.hpp"
 
 namespace dnnl {
@@ -55,6 +56,12 @@ public:
 
 protected:
     virtual status_t init_allocate(size_t size) override {
+        if (cpu_allocator::use_mapped(size)) {
+            void *ptr = cpu_allocator::alloc_mapped(size);
+            if (!ptr) return status::out_of_memory;
+            data_ = decltype(data_)(ptr, cpu_allocator::free_mapped);
+            return status::success;
+        }
         void *ptr = malloc(size, platform::get_cache_line_size());
         if (!ptr) return status::out_of_memory;
         data_ = decltype(data_)(ptr, destroy);
@@ -26,6 +26,7 @@
 
 #include "cpu/rnn/rnn_reorders.hpp"
 #include "cpu/simple_reorder.hpp"
+#include "cpu/simple_wino_reorder.hpp"
 
 #if DNNL_X64
 #include "cpu/x64/jit_uni_reorder.hpp"
@@ -162,6 +163,7 @@ static const impl_list_map_t regular_impl_list_map {
     }},
     {{f32, f32, 4}, {
         DNNL_X64_ONLY(x64::wino_reorder_t<f32, f32>::pd_t::create,)
+        simple_wino_reorder_t::pd_t::create,
 
         REG_FAST_DIRECT_COPY_F32_F32_COMMA
 
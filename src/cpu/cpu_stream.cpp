@@ -0,0 +1,226 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/c_types_map.hpp"
+#include "common/dnnl_thread.hpp"
+#include "common/memory.hpp"
+#include "common/memory_desc_wrapper.hpp"
+#include "common/primitive.hpp"
+#include "common/primitive_exec_types.hpp"
+#include "common/scratchpad.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/cpu_stream.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+namespace {
+struct range_t {
+    uintptr_t begin, end;
+    bool write;
+};
+
+bool conflict(const std::vector<range_t> &a, const std::vector<range_t> &b) {
+    for (const auto &x : a)
+        for (const auto &y : b)
+            if ((x.write || y.write) && x.begin < y.end && y.begin < x.end)
+                return true;
+    return false;
+}
+
+// The buffer of a memory with an offset or runtime dimensions is taken as
+// reaching up to the end of the address space.
+void add_range(std::vector<range_t> &ranges, const memory_t *mem, bool write) {
+    void *handle = nullptr;
+    mem->get_data_handle(&handle);
+    if (handle == nullptr) return;
+
+    const memory_desc_wrapper mdw(mem->md());
+    if (mdw.has_zero_dim()) return;
+    size_t size = mdw.has_runtime_dims_or_strides() ? 0 : mdw.size();
+    const uintptr_t begin = (uintptr_t)handle;
+    const uintptr_t end = size ? begin + size : UINTPTR_MAX;
+    ranges.push_back({begin, end, write});
+}
+} // namespace
+
+struct async_executor_t {
+    async_executor_t(int n_workers) : nthr_(dnnl_get_max_threads()) {
+        for (int i = 0; i < n_workers; ++i)
+            workers_.emplace_back(&async_executor_t::worker, this);
+    }
+
+    ~async_executor_t() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        ready_cv_.notify_all();
+        for (auto &w : workers_)
+            w.join();
+    }
+
+    status_t submit(const primitive_iface_t *primitive_iface,
+            const exec_ctx_t &ctx) {
+        std::unique_ptr<task_t> task(new task_t(primitive_iface, ctx));
+        for (const auto &arg : ctx.args())
+            if (arg.second.mem)
+                add_range(task->ranges, arg.second.mem, !arg.second.is_const);
+
+        // The scratchpad of the primitive may be the global one of the
+        // calling thread, which neither the worker can reach nor tasks
+        // running at the same time can share: every task gets its own.
+        const size_t scratchpad_size
+                = primitive_iface->impl()->pd()->scratchpad_size(
+                        scratchpad_mode::library);
+        if (scratchpad_size) {
+            task->scratchpad.reset(create_scratchpad(
+                    primitive_iface->engine(), scratchpad_size, false));
+            if (task->scratchpad == nullptr
+                    || task->scratchpad->get_memory_storage() == nullptr
+                    || task->scratchpad->size() < scratchpad_size)
+                return status::out_of_memory;
+        }
+
+        task_t *t = task.get();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto &other : inflight_)
+            if (conflict(other->ranges, t->ranges)) {
+                other->dependents.push_back(t);
+                ++t->deps;
+            }
+        inflight_.push_back(std::move(task));
+        t->self = std::prev(inflight_.end());
+        if (t->deps == 0) {
+            ready_.push_back(t);
+            ready_cv_.notify_one();
+        }
+        return status::success;
+    }
+
+    /** Returns the first error since the last wait. */
+    status_t wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [&] { return inflight_.empty(); });
+        status_t status = status_;
+        status_ = status::success;
+        return status;
+    }
+
+private:
+    struct task_t {
+        task_t(const primitive_iface_t *primitive_iface, const exec_ctx_t &ctx)
+            : primitive_iface(primitive_iface), ctx(ctx), deps(0) {}
+
+        const primitive_iface_t *primitive_iface;
+        exec_ctx_t ctx;
+        std::unique_ptr<scratchpad_t> scratchpad;
+        std::vector<range_t> ranges;
+        // unfinished tasks it waits for, and tasks waiting for it
+        int deps;
+        std::vector<task_t *> dependents;
+        std::list<std::unique_ptr<task_t>>::iterator self;
+    };
+
+    void worker() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            ready_cv_.wait(lock, [&] { return stop_ || !ready_.empty(); });
+            if (ready_.empty()) return;
+            task_t *t = ready_.front();
+            ready_.pop_front();
+
+            // the idle threads go in equal parts to this task and the ones
+            // ready behind it
+            const int nthr = nstl::max(
+                    1, (nthr_ - busy_thr_) / (1 + (int)ready_.size()));
+            busy_thr_ += nthr;
+            lock.unlock();
+#if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_OMP
+            omp_set_num_threads(nthr);
+#endif
+            const status_t status = t->primitive_iface->execute(
+                    t->ctx, t->scratchpad.get());
+            lock.lock();
+            busy_thr_ -= nthr;
+
+            if (status != status::success && status_ == status::success)
+                status_ = status;
+            for (task_t *d : t->dependents)
+                if (--d->deps == 0) {
+                    ready_.push_back(d);
+                    ready_cv_.notify_one();
+                }
+            inflight_.erase(t->self);
+            if (inflight_.empty()) done_cv_.notify_all();
+        }
+    }
+
+    const int nthr_;
+    int busy_thr_ = 0;
+    bool stop_ = false;
+    status_t status_ = status::success;
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_, done_cv_;
+    // submitted and not finished, in the order of submission
+    std::list<std::unique_ptr<task_t>> inflight_;
+    std::deque<task_t *> ready_;
+    std::vector<std::thread> workers_;
+};
+
+cpu_stream_t::cpu_stream_t(
+        engine_t *engine, unsigned flags, const stream_attr_t *attr)
+    : stream_t(engine, flags, attr) {
+#if DNNL_CPU_RUNTIME != DNNL_RUNTIME_THREADPOOL
+    if (flags & stream_flags::out_of_order) {
+        const int n_workers
+                = nstl::max(1, getenv_int("DNNL_STREAM_WORKERS", 4));
+        executor_.reset(new async_executor_t(n_workers));
+    }
+#endif
+}
+
+cpu_stream_t::~cpu_stream_t() = default;
+
+status_t cpu_stream_t::wait() {
+    // in-order execution is synchronous so return immediately
+    return executor_ ? executor_->wait() : status::success;
+}
+
+status_t cpu_stream_t::enqueue_primitive(
+        const primitive_iface_t *primitive_iface, exec_ctx_t &ctx) {
+    if (executor_) return executor_->submit(primitive_iface, ctx);
+    return primitive_iface->execute(ctx);
+}
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
@@ -21,6 +21,8 @@
 #include "dnnl_threadpool_iface.hpp"
 #endif
 
+#include <memory>
+
 #include "common/c_types_map.hpp"
 #include "common/dnnl_thread.hpp"
 #include "common/stream.hpp"
@@ -29,15 +31,28 @@ namespace dnnl {
 namespace impl {
 namespace cpu {
 
+struct async_executor_t;
+
+/** CPU stream.
+ *
+ * In-order streams execute primitives synchronously. Out-of-order streams
+ * (except with the threadpool runtime, where they are in-order too) hand
+ * primitives to a few worker threads, DNNL_STREAM_WORKERS (4 by default):
+ * a primitive starts once every primitive submitted before it whose buffers
+ * overlap its own ones, with at least one of the two writing, has finished.
+ * The outputs of a primitive are the buffers it writes. Every execution gets
+ * its own library-managed scratchpad, allocated when it is submitted.
+ * Primitives running at the same time share the threads of the library.
+ * Memory objects and primitives must stay alive until wait() returns. */
 struct cpu_stream_t : public stream_t {
-    cpu_stream_t(engine_t *engine, unsigned flags, const stream_attr_t *attr)
-        : stream_t(engine, flags, attr) {}
-    virtual ~cpu_stream_t() = default;
+    cpu_stream_t(engine_t *engine, unsigned flags, const stream_attr_t *attr);
+    virtual ~cpu_stream_t();
 
-    virtual dnnl::impl::status_t wait() override {
-        // CPU execution is synchronous so return immediately
-        return dnnl::impl::status::success;
-    }
+    virtual dnnl::impl::status_t wait() override;
+
+    virtual dnnl::impl::status_t enqueue_primitive(
+            const primitive_iface_t *primitive_iface,
+            exec_ctx_t &ctx) override;
 
 #if DNNL_CPU_RUNTIME == DNNL_RUNTIME_THREADPOOL
     virtual void before_exec_hook() override {
@@ -50,6 +65,9 @@ struct cpu_stream_t : public stream_t {
         threadpool_utils::deactivate_threadpool();
     }
 #endif
+
+private:
+    std::unique_ptr<async_executor_t> executor_;
 };
 
 } // namespace cpu
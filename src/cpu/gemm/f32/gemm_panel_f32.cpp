@@ -0,0 +1,238 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "common/bfloat16.hpp"
+#include "common/bit_cast.hpp"
+#include "common/dnnl_thread.hpp"
+#include "common/nstl.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/platform.hpp"
+
+#include "cpu/gemm/f32/gemm_panel_f32.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+namespace gemm_utils {
+
+using namespace dnnl::impl::utils;
+
+namespace {
+
+// Widen one source element while packing. bf16 -> f32 is a shift, which
+// vectorizes where the out-of-line bfloat16_t::operator float() does not.
+template <typename acc_t, typename src_t>
+inline acc_t to_acc(src_t x) {
+    return static_cast<acc_t>(x);
+}
+template <>
+inline float to_acc<float, bfloat16_t>(bfloat16_t x) {
+    return bit_cast<float>((uint32_t)x.raw_bits_ << 16);
+}
+
+// Register-blocked microkernel: accumulate a full m_tile x n_tile block of
+// packed A * packed B (zero padding makes tails free), then write back only
+// the m x n valid part of C. The i loops are one long vector.
+template <typename acc_t>
+void kernel_mxn(dim_t m, dim_t n, dim_t k, acc_t alpha, const acc_t *ap,
+        const acc_t *bp, acc_t beta, acc_t *C, dim_t ldc, const acc_t *bias) {
+    constexpr dim_t m_tile = gemm_traits<acc_t>::m;
+    constexpr dim_t n_tile = gemm_traits<acc_t>::n;
+
+    acc_t c[n_tile][m_tile];
+    for (dim_t j = 0; j < n_tile; ++j) {
+        PRAGMA_OMP_SIMD()
+        for (dim_t i = 0; i < m_tile; ++i)
+            c[j][i] = static_cast<acc_t>(0);
+    }
+
+    for (dim_t p = 0; p < k; ++p) {
+        const acc_t *a = ap + p * m_tile;
+        const acc_t *b = bp + p * n_tile;
+        for (dim_t j = 0; j < n_tile; ++j) {
+            const acc_t b_j = b[j];
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < m_tile; ++i)
+                c[j][i] += a[i] * b_j;
+        }
+    }
+
+    for (dim_t j = 0; j < n; ++j) {
+        acc_t *c_j = C + j * ldc;
+        if (beta == static_cast<acc_t>(0)) {
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < m; ++i)
+                c_j[i] = alpha * c[j][i];
+        } else {
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < m; ++i)
+                c_j[i] = alpha * c[j][i] + beta * c_j[i];
+        }
+        if (bias) {
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < m; ++i)
+                c_j[i] += bias[i];
+        }
+    }
+}
+
+} // namespace
+
+template <typename acc_t>
+panel_blocking_t get_panel_blocking(dim_t M, dim_t N, dim_t K) {
+    constexpr dim_t m_tile = gemm_traits<acc_t>::m;
+    constexpr dim_t n_tile = gemm_traits<acc_t>::n;
+    const dim_t sz = sizeof(acc_t);
+
+    const dim_t l1 = platform::get_per_core_cache_size(1);
+    const dim_t l2 = platform::get_per_core_cache_size(2);
+    dim_t l3 = platform::get_per_core_cache_size(3);
+    if (l3 < l2) l3 = l2;
+
+    panel_blocking_t blk;
+    // half of L1 keeps the kc x n_tile B sliver resident in the microkernel
+    blk.kc = rnd_dn(l1 / 2 / (n_tile * sz), 16);
+    blk.kc = nstl::max(dim_t(64), nstl::min(dim_t(512), blk.kc));
+    blk.kc = nstl::max(dim_t(1), nstl::min(K, blk.kc));
+    // half of L2 for the mc x kc A panel
+    blk.mc = nstl::max(m_tile, rnd_dn(l2 / 2 / (blk.kc * sz), m_tile));
+    blk.mc = nstl::min(rnd_up(nstl::max(M, dim_t(1)), m_tile), blk.mc);
+    // half of L3 for the kc x nc B panel
+    blk.nc = nstl::max(n_tile, rnd_dn(l3 / 2 / (blk.kc * sz), n_tile));
+    blk.nc = nstl::min(rnd_up(nstl::max(N, dim_t(1)), n_tile), blk.nc);
+    return blk;
+}
+
+template <typename acc_t>
+dim_t panel_a_size(const panel_blocking_t &blk) {
+    return rnd_up(blk.mc, gemm_traits<acc_t>::m) * blk.kc;
+}
+
+template <typename acc_t>
+dim_t panel_b_size(const panel_blocking_t &blk) {
+    return rnd_up(blk.nc, gemm_traits<acc_t>::n) * blk.kc;
+}
+
+template <typename src_t, typename acc_t>
+void pack_a_panel(bool trans, dim_t m, dim_t k, const src_t *A, dim_t lda,
+        acc_t *ap) {
+    constexpr dim_t m_tile = gemm_traits<acc_t>::m;
+    for (dim_t i0 = 0; i0 < m; i0 += m_tile) {
+        const dim_t mr = nstl::min(m_tile, m - i0);
+        acc_t *dst = ap + i0 * k;
+        if (!trans) {
+            for (dim_t p = 0; p < k; ++p) {
+                const src_t *a = A + i0 + p * lda;
+                acc_t *d = dst + p * m_tile;
+                PRAGMA_OMP_SIMD()
+                for (dim_t i = 0; i < mr; ++i)
+                    d[i] = to_acc<acc_t>(a[i]);
+                for (dim_t i = mr; i < m_tile; ++i)
+                    d[i] = static_cast<acc_t>(0);
+            }
+        } else {
+            for (dim_t i = 0; i < mr; ++i) {
+                const src_t *a = A + (i0 + i) * lda;
+                PRAGMA_OMP_SIMD()
+                for (dim_t p = 0; p < k; ++p)
+                    dst[p * m_tile + i] = to_acc<acc_t>(a[p]);
+            }
+            for (dim_t i = mr; i < m_tile; ++i) {
+                PRAGMA_OMP_SIMD()
+                for (dim_t p = 0; p < k; ++p)
+                    dst[p * m_tile + i] = static_cast<acc_t>(0);
+            }
+        }
+    }
+}
+
+template <typename src_t, typename acc_t>
+void pack_b_panel(bool trans, dim_t k, dim_t n, const src_t *B, dim_t ldb,
+        acc_t *bp) {
+    constexpr dim_t n_tile = gemm_traits<acc_t>::n;
+    for (dim_t j0 = 0; j0 < n; j0 += n_tile) {
+        const dim_t nr = nstl::min(n_tile, n - j0);
+        acc_t *dst = bp + j0 * k;
+        if (!trans) {
+            for (dim_t j = 0; j < nr; ++j) {
+                const src_t *b = B + (j0 + j) * ldb;
+                PRAGMA_OMP_SIMD()
+                for (dim_t p = 0; p < k; ++p)
+                    dst[p * n_tile + j] = to_acc<acc_t>(b[p]);
+            }
+        } else {
+            for (dim_t p = 0; p < k; ++p) {
+                const src_t *b = B + j0 + p * ldb;
+                acc_t *d = dst + p * n_tile;
+                for (dim_t j = 0; j < nr; ++j)
+                    d[j] = to_acc<acc_t>(b[j]);
+            }
+        }
+        for (dim_t j = nr; j < n_tile; ++j) {
+            PRAGMA_OMP_SIMD()
+            for (dim_t p = 0; p < k; ++p)
+                dst[p * n_tile + j] = static_cast<acc_t>(0);
+        }
+    }
+}
+
+template <typename acc_t>
+void panel_kernel(dim_t m, dim_t n, dim_t k, acc_t alpha, const acc_t *ap,
+        const acc_t *bp, acc_t beta, acc_t *C, dim_t ldc, const acc_t *bias) {
+    constexpr dim_t m_tile = gemm_traits<acc_t>::m;
+    constexpr dim_t n_tile = gemm_traits<acc_t>::n;
+    // B sliver stays in L1 while the A slivers stream from L2
+    for (dim_t j0 = 0; j0 < n; j0 += n_tile) {
+        const dim_t nr = nstl::min(n_tile, n - j0);
+        for (dim_t i0 = 0; i0 < m; i0 += m_tile) {
+            const dim_t mr = nstl::min(m_tile, m - i0);
+            kernel_mxn<acc_t>(mr, nr, k, alpha, ap + i0 * k, bp + j0 * k, beta,
+                    C + i0 + j0 * ldc, ldc, bias ? bias + i0 : nullptr);
+        }
+    }
+}
+
+#define INST_ACC(acc_t) \
+    template panel_blocking_t get_panel_blocking<acc_t>( \
+            dim_t M, dim_t N, dim_t K); \
+    template dim_t panel_a_size<acc_t>(const panel_blocking_t &blk); \
+    template dim_t panel_b_size<acc_t>(const panel_blocking_t &blk); \
+    template void panel_kernel<acc_t>(dim_t m, dim_t n, dim_t k, acc_t alpha, \
+            const acc_t *ap, const acc_t *bp, acc_t beta, acc_t *C, \
+            dim_t ldc, const acc_t *bias);
+#define INST_PACK(src_t, acc_t) \
+    template void pack_a_panel<src_t, acc_t>(bool trans, dim_t m, dim_t k, \
+            const src_t *A, dim_t lda, acc_t *ap); \
+    template void pack_b_panel<src_t, acc_t>(bool trans, dim_t k, dim_t n, \
+            const src_t *B, dim_t ldb, acc_t *bp);
+
+INST_ACC(float)
+INST_ACC(double)
+INST_PACK(float, float)
+INST_PACK(double, double)
+INST_PACK(bfloat16_t, float)
+INST_ACC(int32_t)
+INST_PACK(int8_t, int32_t)
+INST_PACK(uint8_t, int32_t)
+
+#undef INST_ACC
+#undef INST_PACK
+
+} // namespace gemm_utils
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
@@ -0,0 +1,93 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_GEMM_F32_GEMM_PANEL_F32_HPP
+#define CPU_GEMM_F32_GEMM_PANEL_F32_HPP
+
+#include "common/c_types_map.hpp"
+
+#include "cpu/gemm/f32/gemm_utils_f32.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+namespace gemm_utils {
+
+/** Cache blocking of the packed-panel engine, in elements.
+ *
+ * A kc x nc panel of op(B) is packed once and reused for all mc x kc panels
+ * of op(A); both are split into register-tile slivers of
+ * gemm_traits<acc_t>::m rows (A) and gemm_traits<acc_t>::n columns (B).
+ */
+struct panel_blocking_t {
+    dim_t mc, nc, kc;
+};
+
+/** Pick mc/nc/kc for an M x N x K problem from the cache hierarchy:
+ * one kc x n B sliver in L1, the A panel in L2, the B panel in L3. */
+template <typename acc_t>
+panel_blocking_t get_panel_blocking(dim_t M, dim_t N, dim_t K);
+
+/** Header of a matrix pre-packed by ref_gemm_pack().
+ *
+ * op(A) (op(B)) is stored as K-blocks of depth kc; block \c Bk holds all
+ * \c ld = rnd_up(M, m_tile) rows (N columns) as register-tile slivers, so
+ * the panel for rows [Bm, Bm + mb) starts at data + Bk * ld + Bm * kb for any
+ * tile-aligned Bm. Packed data follows the header at panel_pack_data_offset.
+ */
+struct panel_pack_header_t {
+    dim_t mn; // M for A, N for B
+    dim_t k;
+    dim_t kc;
+    dim_t ld;
+};
+constexpr size_t panel_pack_data_offset = 64;
+
+/** Elements needed for packed A (mc x kc) and B (kc x nc) panels. */
+template <typename acc_t>
+dim_t panel_a_size(const panel_blocking_t &blk);
+template <typename acc_t>
+dim_t panel_b_size(const panel_blocking_t &blk);
+
+/** Pack the m x k block of op(A) into m-row slivers, zero padding the last
+ * sliver to a full register tile. Sliver \c s starts at ap + s * m_tile * k
+ * and stores element (i, p) at [p * m_tile + i]. Narrower \c src_t (int8,
+ * bf16) is widened to \c acc_t on the way. */
+template <typename src_t, typename acc_t>
+void pack_a_panel(bool trans, dim_t m, dim_t k, const src_t *A, dim_t lda,
+        acc_t *ap);
+
+/** Pack the k x n block of op(B) into n-column slivers, zero padding the
+ * last sliver. Sliver \c s starts at bp + s * n_tile * k and stores element
+ * (p, j) at [p * n_tile + j]. */
+template <typename src_t, typename acc_t>
+void pack_b_panel(bool trans, dim_t k, dim_t n, const src_t *B, dim_t ldb,
+        acc_t *bp);
+
+/** C[m x n] = alpha * ap * bp + beta * C (+ bias[i] if bias != nullptr)
+ * for packed panels of depth k. \c beta == 0 does not read C. */
+template <typename acc_t>
+void panel_kernel(dim_t m, dim_t n, dim_t k, acc_t alpha, const acc_t *ap,
+        const acc_t *bp, acc_t beta, acc_t *C, dim_t ldc, const acc_t *bias);
+
+} // namespace gemm_utils
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+#endif // CPU_GEMM_F32_GEMM_PANEL_F32_HPP
@@ -19,35 +19,30 @@
 
 #include <cstddef>
 
+#include "common/c_types_map.hpp"
+
+#include "cpu/platform.hpp"
+
 namespace dnnl {
 namespace impl {
 namespace cpu {
 
 namespace gemm_utils {
-template <typename T, bool isTransA, bool isTransB>
-struct gemm_traits {};
-
-template <bool isTransA, bool isTransB>
-struct gemm_traits<double, isTransA, isTransB> {
-    static constexpr dim_t m = 8;
-    static constexpr dim_t n = 6;
-    static constexpr dim_t BM = 4032;
-    static constexpr dim_t BN = isTransA ? 96 : 192;
-    static constexpr dim_t BK = isTransB ? 96 : 512;
-};
-
-template <bool isTransA, bool isTransB>
-struct gemm_traits<float, isTransA, isTransB> {
-    static constexpr dim_t m = 16;
+// Register block of the packed-panel microkernel: C is updated in m x n
+// tiles whose m (unit-stride) dimension is one long vector.
+template <typename T>
+struct gemm_traits {
+#if defined(__ve)
+    // VE vector registers hold the same number of elements of any width
+    static constexpr dim_t m = platform::get_max_vector_length();
+    static constexpr dim_t n = 8;
+#else
+    static constexpr dim_t m
+            = platform::get_max_vector_length() * sizeof(float) / sizeof(T);
     static constexpr dim_t n = 6;
-    static constexpr dim_t BM = 4032;
-    static constexpr dim_t BN = isTransA ? 96 : 48;
-    static constexpr dim_t BK = isTransB ? 96 : 256;
+#endif
 };
 
-template <typename T>
-using unroll_factor = gemm_traits<T, false, false>;
-
 template <typename data_t>
 void sum_two_matrices(dim_t m, dim_t n, data_t *__restrict p_src, dim_t ld_src,
         data_t *__restrict p_dst, dim_t ld_dst);
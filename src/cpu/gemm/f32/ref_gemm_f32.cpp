@@ -16,12 +16,16 @@
 
 #include "dnnl_types.h"
 
+#include "common/bfloat16.hpp"
 #include "common/dnnl_thread.hpp"
 #include "common/nstl.hpp"
 #include "common/utils.hpp"
 
 #include "cpu/platform.hpp"
 
+#include "cpu/gemm/gemm.hpp"
+
+#include "cpu/gemm/f32/gemm_panel_f32.hpp"
 #include "cpu/gemm/f32/gemm_utils_f32.hpp"
 #include "cpu/gemm/f32/ref_gemm_f32.hpp"
 
@@ -34,161 +38,161 @@ using namespace gemm_utils;
 
 namespace {
 
+// op(A) or op(B) as seen by one thread: either a plain (sub)matrix of
+// src_t, the data_t panels of a matrix pre-packed by ref_gemm_pack(), or
+// (A only) a generator of panels
+template <typename src_t, typename data_t>
+struct operand_t {
+    const src_t *ptr; // matrix, if !is_packed
+    const data_t *packed; // packed data, if is_packed
+    dim_t ld; // leading dimension, or packed panel width
+    bool trans;
+    bool is_packed;
+    dim_t off; // first packed or generated row (A) / column (B) of this thread
+    const gemm_a_source_t *gen; // A panels, if not null
+    dim_t k_off; // first generated column of this thread
+};
+
+const panel_pack_header_t *pack_header(const void *p) {
+    return reinterpret_cast<const panel_pack_header_t *>(p);
+}
+
+// packed panels hold data_t whatever the source type was
 template <typename data_t>
-void copy_A(
-        bool isTransA, dim_t K, const data_t *A, const dim_t lda, data_t *ws) {
-    for (dim_t k = 0; k < K; k++) {
-        PRAGMA_OMP_SIMD()
-        for (dim_t i = 0; i < unroll_factor<data_t>::m; i++) {
-            ws[i] = isTransA ? A[i * lda + k] : A[i + k * lda];
-        }
-        ws += unroll_factor<data_t>::m;
-    }
+const data_t *pack_data(const void *p) {
+    return reinterpret_cast<const data_t *>(
+            reinterpret_cast<const char *>(p) + panel_pack_data_offset);
 }
 
-template <typename data_t, bool isTransA, bool isTransB>
-void kernel_mxn(dim_t K, const data_t *A, const dim_t lda, const data_t *B,
-        const dim_t ldb, data_t *C, const dim_t ldc, const data_t alpha,
-        const data_t beta) {
-    data_t c[unroll_factor<data_t>::m * unroll_factor<data_t>::n]
-            = {static_cast<data_t>(0.)};
-    for (dim_t k = 0; k < K; k++) {
-        for (dim_t j = 0; j < unroll_factor<data_t>::n; j++) {
-            data_t b = isTransB ? B[j + k * ldb] : B[k + j * ldb];
-            PRAGMA_OMP_SIMD()
-            for (dim_t i = 0; i < unroll_factor<data_t>::m; i++) {
-                data_t a = isTransA ? A[i * lda + k] : A[i + lda * k];
-                c[i + unroll_factor<data_t>::m * j] += a * b;
-            }
-        }
-    }
-    for (dim_t j = 0; j < unroll_factor<data_t>::n; j++) {
-        PRAGMA_OMP_SIMD()
-        for (dim_t i = 0; i < unroll_factor<data_t>::m; i++) {
-            C[i + j * ldc] = (beta == static_cast<data_t>(0.))
-                    ? alpha * c[i + unroll_factor<data_t>::m * j]
-                    : alpha * c[i + unroll_factor<data_t>::m * j]
-                            + beta * C[i + j * ldc];
-        }
-    }
+// the epilogue interface is f32 only, ref_gemm<double> never gets one
+void apply_epilogue(const gemm_epilogue_t *epilogue, float *c, dim_t ldc,
+        dim_t m_off, dim_t m, dim_t n) {
+    (*epilogue)(c, ldc, m_off, m, n);
 }
 
-template <typename data_t, bool isTransA, bool isTransB>
-void block_ker(const dim_t M, const dim_t N, const dim_t K, const data_t *A,
-        const dim_t lda, const data_t *B, const dim_t ldb, data_t *C,
-        const dim_t ldc, const data_t alpha, const data_t beta, data_t *ws,
-        bool do_copy) {
-    dim_t Nu = rnd_dn(N, unroll_factor<data_t>::n);
-    dim_t Mu = rnd_dn(M, unroll_factor<data_t>::m);
-    for (dim_t i = 0; i < Mu; i += unroll_factor<data_t>::m) {
-        for (dim_t j = 0; j < Nu; j += unroll_factor<data_t>::n) {
-            const data_t *b = isTransB ? &B[j] : &B[j * ldb];
-            const data_t *a = isTransA ? &A[i * lda] : &A[i];
-            if (do_copy) {
-                if (j == 0) { copy_A<data_t>(isTransA, K, a, lda, ws); }
-                kernel_mxn<data_t, false, isTransB>(K, ws,
-                        unroll_factor<data_t>::m, b, ldb, &C[i + j * ldc], ldc,
-                        alpha, beta);
-            } else {
-                kernel_mxn<data_t, isTransA, isTransB>(
-                        K, a, lda, b, ldb, &C[i + j * ldc], ldc, alpha, beta);
-            }
-        }
-    }
-    // tail processing
-    for (dim_t i = 0; i < M; i++) {
-        for (dim_t j = Nu; j < N; j++) {
-            data_t c = beta == static_cast<data_t>(0.) ? static_cast<data_t>(0.)
-                                                       : beta * C[i + j * ldc];
-            for (dim_t p = 0; p < K; p++) {
-                data_t b = isTransB ? B[j + p * ldb] : B[p + j * ldb];
-                data_t a = isTransA ? A[p + i * lda] : A[i + p * lda];
-                c += alpha * a * b;
-            }
-            C[i + j * ldc] = c;
-        }
-    }
-    for (dim_t i = Mu; i < M; i++) {
-        for (dim_t j = 0; j < Nu; j++) {
-            data_t c = beta == static_cast<data_t>(0.) ? static_cast<data_t>(0.)
-                                                       : beta * C[i + j * ldc];
-            for (dim_t p = 0; p < K; p++) {
-                data_t b = isTransB ? B[j + p * ldb] : B[p + j * ldb];
-                data_t a = isTransA ? A[p + i * lda] : A[i + p * lda];
-                c += alpha * a * b;
-            }
-            C[i + j * ldc] = c;
-        }
-    }
+void apply_epilogue(const gemm_epilogue_t *epilogue, double *c, dim_t ldc,
+        dim_t m_off, dim_t m, dim_t n) {
+    assert(!"f64 gemm epilogue is not supported");
 }
 
-template <typename data_t, bool isTransA, bool isTransB>
-void gemm_ithr(const dim_t M, const dim_t N, const dim_t K, const data_t alpha,
-        const data_t *A, const dim_t lda, const data_t *B, const dim_t ldb,
-        const data_t beta, data_t *C, const dim_t ldc, bool do_copy,
-        data_t *ws) {
-    constexpr dim_t BM = gemm_traits<data_t, isTransA, isTransB>::BM;
-    constexpr dim_t BN = gemm_traits<data_t, isTransA, isTransB>::BN;
-    constexpr dim_t BK = gemm_traits<data_t, isTransA, isTransB>::BK;
+// likewise generated A panels are f32 only
+void gen_a_panel(const gemm_a_source_t *gen, dim_t i0, dim_t m, dim_t p0,
+        dim_t k, float *ap) {
+    constexpr dim_t m_tile = gemm_traits<float>::m;
+    gen->pack(i0, m, p0, k, m_tile, ap);
+    const dim_t mr = m % m_tile;
+    if (mr == 0) return;
+    float *last = ap + (m - mr) * k;
+    for (dim_t p = 0; p < k; ++p)
+        for (dim_t i = mr; i < m_tile; ++i)
+            last[p * m_tile + i] = 0.f;
+}
 
-    const data_t *curA;
-    const data_t *curB;
-    data_t *curC;
+void gen_a_panel(const gemm_a_source_t *gen, dim_t i0, dim_t m, dim_t p0,
+        dim_t k, double *ap) {
+    assert(!"f64 implicit gemm is not supported");
+}
 
+// m_off is the row of C[0] in the full problem, as seen by the epilogue
+template <typename a_t, typename b_t, typename data_t>
+void gemm_ithr(const dim_t M, const dim_t N, const dim_t K, const data_t alpha,
+        const operand_t<a_t, data_t> &a, const operand_t<b_t, data_t> &b,
+        const data_t beta, data_t *C, const dim_t ldc, const data_t *bias,
+        const gemm_epilogue_t *epilogue, const dim_t m_off,
+        const panel_blocking_t &blk, data_t *ws) {
     if ((M <= 0) || (N <= 0)) return;
 
     if ((K <= 0) || (alpha == static_cast<data_t>(0))) {
-        dim_t MN = N * M;
-        if (beta == static_cast<data_t>(0.)) {
-            for (dim_t j = 0; j < MN; j++)
-                C[j] = static_cast<data_t>(0.);
-        } else if (beta != static_cast<data_t>(1.)) {
-            for (dim_t j = 0; j < MN; j++)
-                C[j] *= beta;
+        for (dim_t j = 0; j < N; j++) {
+            data_t *c = C + j * ldc;
+            if (beta == static_cast<data_t>(0.)) {
+                for (dim_t i = 0; i < M; i++)
+                    c[i] = static_cast<data_t>(0.);
+            } else if (beta != static_cast<data_t>(1.)) {
+                for (dim_t i = 0; i < M; i++)
+                    c[i] *= beta;
+            }
+            if (bias)
+                for (dim_t i = 0; i < M; i++)
+                    c[i] += bias[i];
         }
+        if (epilogue) apply_epilogue(epilogue, C, ldc, m_off, M, N);
         return;
     }
 
-    for (dim_t Bk = 0; Bk < K; Bk += BK) {
-        dim_t kb = nstl::min(K - Bk, BK);
-        for (dim_t Bm = 0; Bm < M; Bm += BM) {
-            dim_t mb = nstl::min(M - Bm, BM);
-            for (dim_t Bn = 0; Bn < N; Bn += BN) {
-                dim_t nb = nstl::min(N - Bn, BN);
-                curA = isTransA ? A + Bk + Bm * lda : A + Bm + Bk * lda;
-                curB = isTransB ? B + Bn + Bk * ldb : B + Bk + Bn * ldb;
-                curC = C + Bm + Bn * ldc;
-                if (Bk == 0) {
-                    block_ker<data_t, isTransA, isTransB>(mb, nb, kb, curA, lda,
-                            curB, ldb, curC, ldc, alpha, beta, ws, do_copy);
-                } else {
-                    block_ker<data_t, isTransA, isTransB>(mb, nb, kb, curA, lda,
-                            curB, ldb, curC, ldc, alpha,
-                            static_cast<data_t>(1.0), ws, do_copy);
-                }
+    data_t *ap = ws;
+    data_t *bp = ws + panel_a_size<data_t>(blk);
+
+    auto get_a_panel = [&](dim_t Bm, dim_t Bk, dim_t mb, dim_t kb) {
+        if (a.is_packed) return a.packed + Bk * a.ld + (a.off + Bm) * kb;
+        if (a.gen) {
+            gen_a_panel(a.gen, a.off + Bm, mb, a.k_off + Bk, kb, ap);
+            return (const data_t *)ap;
+        }
+        pack_a_panel(a.trans, mb, kb,
+                a.trans ? a.ptr + Bk + Bm * a.ld : a.ptr + Bm + Bk * a.ld,
+                a.ld, ap);
+        return (const data_t *)ap;
+    };
+    auto get_b_panel = [&](dim_t Bn, dim_t Bk, dim_t nb, dim_t kb) {
+        if (b.is_packed) return b.packed + Bk * b.ld + (b.off + Bn) * kb;
+        pack_b_panel(b.trans, kb, nb,
+                b.trans ? b.ptr + Bn + Bk * b.ld : b.ptr + Bk + Bn * b.ld,
+                b.ld, bp);
+        return (const data_t *)bp;
+    };
+
+    // B panel is packed once per (Bn, Bk) and shared by all A panels
+    for (dim_t Bn = 0; Bn < N; Bn += blk.nc) {
+        const dim_t nb = nstl::min(N - Bn, blk.nc);
+        for (dim_t Bk = 0; Bk < K; Bk += blk.kc) {
+            const dim_t kb = nstl::min(K - Bk, blk.kc);
+            const data_t *curB = get_b_panel(Bn, Bk, nb, kb);
+
+            const data_t myBeta = Bk == 0 ? beta : static_cast<data_t>(1.);
+            const bool last_k = Bk + kb == K;
+            for (dim_t Bm = 0; Bm < M; Bm += blk.mc) {
+                const dim_t mb = nstl::min(M - Bm, blk.mc);
+                const data_t *curA = get_a_panel(Bm, Bk, mb, kb);
+
+                data_t *curC = C + Bm + Bn * ldc;
+                panel_kernel(mb, nb, kb, alpha, curA, curB, myBeta, curC, ldc,
+                        (bias && last_k) ? bias + Bm : nullptr);
+                // the block is final and still hot in L2
+                if (epilogue && last_k)
+                    apply_epilogue(epilogue, curC, ldc, m_off + Bm, mb, nb);
             }
         }
     }
 }
 
-} // namespace
-
-template <typename data_t>
-dnnl_status_t ref_gemm(const char *transa_, const char *transb_,
+// A and B may be narrower than data_t; they are widened while packing
+template <typename a_t, typename b_t, typename data_t>
+dnnl_status_t ref_gemm_impl(const char *transa_, const char *transb_,
         const dim_t *M_, const dim_t *N_, const dim_t *K_, const data_t *alpha_,
-        const data_t *A, const dim_t *lda_, const data_t *B, const dim_t *ldb_,
-        const data_t *beta_, data_t *C, const dim_t *ldc_, const data_t *bias) {
+        const a_t *A, const dim_t *lda_, const b_t *B, const dim_t *ldb_,
+        const data_t *beta_, data_t *C, const dim_t *ldc_, const data_t *bias,
+        const gemm_epilogue_t *epilogue, const gemm_a_source_t *a_src) {
 
-    if (!(utils::one_of(*transa_, 'n', 'N', 't', 'T')
-                && utils::one_of(*transb_, 'n', 'N', 't', 'T')))
+    if (!(utils::one_of(*transa_, 'n', 'N', 't', 'T', 'p', 'P')
+                && utils::one_of(*transb_, 'n', 'N', 't', 'T', 'p', 'P')))
         return dnnl_unimplemented;
 
     bool isTransA = (*transa_ == 'T' || *transa_ == 't');
     bool isTransB = (*transb_ == 'T' || *transb_ == 't');
+    bool isPackedA = (*transa_ == 'P' || *transa_ == 'p');
+    bool isPackedB = (*transb_ == 'P' || *transb_ == 'p');
     const dim_t M = *M_, N = *N_, K = *K_;
     const dim_t lda = *lda_, ldb = *ldb_, ldc = *ldc_;
     const data_t alpha = *alpha_, beta = *beta_;
 
+    const panel_pack_header_t *hdr_a = isPackedA ? pack_header(A) : nullptr;
+    const panel_pack_header_t *hdr_b = isPackedB ? pack_header(B) : nullptr;
+    if ((hdr_a && (hdr_a->mn != M || hdr_a->k != K))
+            || (hdr_b && (hdr_b->mn != N || hdr_b->k != K))
+            || (hdr_a && hdr_b && hdr_a->kc != hdr_b->kc))
+        return dnnl_invalid_arguments;
+
     int max_nthr = dnnl_in_parallel() ? 1 : dnnl_get_max_threads();
     int nthr_m, nthr_n, nthr_k;
     dim_t MB, NB, KB;
@@ -197,6 +201,16 @@ dnnl_status_t ref_gemm(const char *transa_, const char *transb_,
             M, N, K, max_nthr, &nthr_m, &nthr_n, &nthr_k, &MB, &NB, &KB);
     assert(IMPLICATION(!dnnl_thr_syncable(), nthr_k == 1));
 
+    // packed panels are only addressable at tile and K-block granularity
+    if (isPackedA || isPackedB) {
+        nthr_k = 1;
+        KB = K;
+        if (isPackedA) MB = rnd_up(MB, gemm_traits<data_t>::m);
+        if (isPackedB) NB = rnd_up(NB, gemm_traits<data_t>::n);
+        nthr_m = MB > 0 ? (int)div_up(M, MB) : 1;
+        nthr_n = NB > 0 ? (int)div_up(N, NB) : 1;
+    }
+
     data_t *c_buffers = nullptr;
     data_t *ws_buffers = nullptr;
     if (nthr_k > 1) {
@@ -209,15 +223,19 @@ dnnl_status_t ref_gemm(const char *transa_, const char *transb_,
         }
     }
 
-    bool do_copy = (NB / unroll_factor<data_t>::n > 3);
     const int nthr_mn = nthr_m * nthr_n;
     const int nthr_to_use = nthr_mn * nthr_k;
-    const size_t ws_elems_per_thr = K * unroll_factor<data_t>::m;
+    panel_blocking_t blk = get_panel_blocking<data_t>(MB, NB, KB);
+    if (hdr_a) blk.kc = hdr_a->kc;
+    if (hdr_b) blk.kc = hdr_b->kc;
+    const size_t ws_elems_per_thr
+            = panel_a_size<data_t>(blk) + panel_b_size<data_t>(blk);
     const size_t ws_size_per_thr
             = rnd_up(ws_elems_per_thr * sizeof(data_t), PAGE_4K);
-    if (do_copy) {
-        ws_buffers = (data_t *)malloc(nthr_to_use * ws_size_per_thr, PAGE_4K);
-        if (!ws_buffers) do_copy = false;
+    ws_buffers = (data_t *)malloc(nthr_to_use * ws_size_per_thr, PAGE_4K);
+    if (!ws_buffers) {
+        free(c_buffers);
+        return dnnl_out_of_memory;
     }
 
     auto get_thr_block = [&](dim_t &from, dim_t &to, dim_t &myN, dim_t NB,
@@ -239,9 +257,7 @@ dnnl_status_t ref_gemm(const char *transa_, const char *transb_,
 
         int cbase = (ithr_m + nthr_m * ithr_n) * (nthr_k - 1);
 
-        data_t *ws = do_copy
-                ? ws_buffers + ithr * ws_size_per_thr / sizeof(data_t)
-                : nullptr;
+        data_t *ws = ws_buffers + ithr * ws_size_per_thr / sizeof(data_t);
 
         dim_t m_from = 0, m_to = 0, myM = 0, n_from = 0, n_to = 0, myN = 0,
               k_from = 0, k_to = 0, myK = 0;
@@ -262,28 +278,35 @@ dnnl_status_t ref_gemm(const char *transa_, const char *transb_,
                 myBeta = 0.0f;
                 ld = MB;
             }
-            const data_t *myA = isTransA ? &(A[k_from + m_from * lda])
-                                         : &(A[m_from + k_from * lda]);
-            const data_t *myB = isTransB ? &(B[n_from + k_from * ldb])
-                                         : &(B[k_from + n_from * ldb]);
-
-            if (!isTransA) {
-                if (!isTransB) {
-                    gemm_ithr<data_t, false, false>(myM, myN, myK, alpha, myA,
-                            lda, myB, ldb, myBeta, myC, ld, do_copy, ws);
-                } else {
-                    gemm_ithr<data_t, false, true>(myM, myN, myK, alpha, myA,
-                            lda, myB, ldb, myBeta, myC, ld, do_copy, ws);
-                }
-            } else {
-                if (!isTransB) {
-                    gemm_ithr<data_t, true, false>(myM, myN, myK, alpha, myA,
-                            lda, myB, ldb, myBeta, myC, ld, do_copy, ws);
-                } else {
-                    gemm_ithr<data_t, true, true>(myM, myN, myK, alpha, myA,
-                            lda, myB, ldb, myBeta, myC, ld, do_copy, ws);
-                }
-            }
+            operand_t<a_t, data_t> myA;
+            operand_t<b_t, data_t> myB;
+            if (a_src)
+                myA = {nullptr, nullptr, 0, false, false, m_from, a_src,
+                        k_from};
+            else if (isPackedA)
+                myA = {nullptr, pack_data<data_t>(A), hdr_a->ld, false, true,
+                        m_from, nullptr, 0};
+            else
+                myA = {isTransA ? &(A[k_from + m_from * lda])
+                                : &(A[m_from + k_from * lda]),
+                        nullptr, lda, isTransA, false, 0, nullptr, 0};
+            if (isPackedB)
+                myB = {nullptr, pack_data<data_t>(B), hdr_b->ld, false, true,
+                        n_from, nullptr, 0};
+            else
+                myB = {isTransB ? &(B[n_from + k_from * ldb])
+                                : &(B[k_from + n_from * ldb]),
+                        nullptr, ldb, isTransB, false, 0, nullptr, 0};
+
+            // partial sums are reduced into C below, so only the
+            // ithr_k == 0 part carries the bias, and the epilogue waits for
+            // the reduction
+            const data_t *myBias
+                    = (bias && ithr_k == 0) ? bias + m_from : nullptr;
+            const gemm_epilogue_t *myEpilogue
+                    = nthr_k == 1 ? epilogue : nullptr;
+            gemm_ithr(myM, myN, myK, alpha, myA, myB, myBeta, myC, ld, myBias,
+                    myEpilogue, m_from, blk, ws);
         }
     });
 
@@ -316,29 +339,144 @@ dnnl_status_t ref_gemm(const char *transa_, const char *transb_,
                 gemm_utils::sum_two_matrices(myM, block, myC, MB,
                         &C[m_from + (n_from + offset) * ldc], ldc);
             }
+            if (epilogue && myM > 0 && block > 0)
+                apply_epilogue(epilogue, &C[m_from + (n_from + offset) * ldc],
+                        ldc, m_from, myM, block);
         });
     }
 
-    if (bias) {
-        parallel_nd(N, M, [&](dim_t i, dim_t j) { C[i * ldc + j] += bias[j]; });
-    }
-
     free(ws_buffers);
     free(c_buffers);
 
     return dnnl_success;
 }
 
+} // namespace
+
+template <typename data_t>
+dnnl_status_t ref_gemm(const char *transa, const char *transb, const dim_t *M,
+        const dim_t *N, const dim_t *K, const data_t *alpha, const data_t *A,
+        const dim_t *lda, const data_t *B, const dim_t *ldb, const data_t *beta,
+        data_t *C, const dim_t *ldc, const data_t *bias,
+        const gemm_epilogue_t *epilogue) {
+    return ref_gemm_impl(transa, transb, M, N, K, alpha, A, lda, B, ldb, beta,
+            C, ldc, bias, epilogue, nullptr);
+}
+
+dnnl_status_t ref_gemm_bf16bf16f32(const char *transa, const char *transb,
+        const dim_t *M, const dim_t *N, const dim_t *K, const float *alpha,
+        const bfloat16_t *A, const dim_t *lda, const bfloat16_t *B,
+        const dim_t *ldb, const float *beta, float *C, const dim_t *ldc) {
+    return ref_gemm_impl(transa, transb, M, N, K, alpha, A, lda, B, ldb, beta,
+            C, ldc, (const float *)nullptr, nullptr, nullptr);
+}
+
+dnnl_status_t ref_gemm_implicit_a(const char *transb, const dim_t *M,
+        const dim_t *N, const dim_t *K, const float *alpha,
+        const gemm_a_source_t *A, const float *B, const dim_t *ldb,
+        const float *beta, float *C, const dim_t *ldc, const float *bias) {
+    const dim_t lda = *M;
+    return ref_gemm_impl("N", transb, M, N, K, alpha, (const float *)nullptr,
+            &lda, B, ldb, beta, C, ldc, bias, nullptr, A);
+}
+
+template <typename data_t>
+dnnl_status_t ref_gemm_pack_get_size(const char *identifier,
+        const char *transa, const char *transb, const dim_t *M, const dim_t *N,
+        const dim_t *K, const dim_t *lda, const dim_t *ldb, size_t *size,
+        bool *pack) {
+    if (utils::any_null(identifier, transa, transb, M, N, K, lda, ldb, size))
+        return dnnl_invalid_arguments;
+    if (!utils::one_of(*identifier, 'A', 'a', 'B', 'b'))
+        return dnnl_invalid_arguments;
+
+    const bool is_a = utils::one_of(*identifier, 'A', 'a');
+    const panel_blocking_t blk = get_panel_blocking<data_t>(*M, *N, *K);
+    const dim_t ld = is_a ? rnd_up(*M, gemm_traits<data_t>::m)
+                          : rnd_up(*N, gemm_traits<data_t>::n);
+    // each K block stores all ld rows (columns) at its own depth
+    *size = panel_pack_data_offset
+            + rnd_up(ld * nstl::max(*K, blk.kc) * sizeof(data_t),
+                    (size_t)panel_pack_data_offset);
+    if (pack) *pack = true;
+    return dnnl_success;
+}
+
+template <typename src_t, typename data_t>
+dnnl_status_t ref_gemm_pack(const char *identifier, const char *transa,
+        const char *transb, const dim_t *M, const dim_t *N, const dim_t *K,
+        const dim_t *lda, const dim_t *ldb, const src_t *src, data_t *dst) {
+    if (utils::any_null(identifier, transa, transb, M, N, K, lda, ldb, src, dst))
+        return dnnl_invalid_arguments;
+    if (!(utils::one_of(*identifier, 'A', 'a', 'B', 'b')
+                && utils::one_of(*transa, 'n', 'N', 't', 'T')
+                && utils::one_of(*transb, 'n', 'N', 't', 'T')))
+        return dnnl_invalid_arguments;
+
+    const bool is_a = utils::one_of(*identifier, 'A', 'a');
+    const bool trans = utils::one_of(is_a ? *transa : *transb, 't', 'T');
+    const dim_t mn = is_a ? *M : *N;
+    const dim_t k = *K;
+    const dim_t ld_src = is_a ? *lda : *ldb;
+    const dim_t tile = is_a ? gemm_traits<data_t>::m : gemm_traits<data_t>::n;
+    const panel_blocking_t blk = get_panel_blocking<data_t>(*M, *N, *K);
+
+    auto *hdr = reinterpret_cast<panel_pack_header_t *>(dst);
+    hdr->mn = mn;
+    hdr->k = k;
+    hdr->kc = blk.kc;
+    hdr->ld = rnd_up(mn, tile);
+    data_t *data = reinterpret_cast<data_t *>(
+            reinterpret_cast<char *>(dst) + panel_pack_data_offset);
+
+    // one task per (K block, register-tile sliver)
+    const dim_t nkb = div_up(k, blk.kc);
+    const dim_t nslivers = div_up(mn, tile);
+    parallel_nd(nkb, nslivers, [&](dim_t ikb, dim_t is) {
+        const dim_t Bk = ikb * blk.kc;
+        const dim_t kb = nstl::min(k - Bk, blk.kc);
+        const dim_t i0 = is * tile;
+        const dim_t len = nstl::min(tile, mn - i0);
+        data_t *d = data + Bk * hdr->ld + i0 * kb;
+        // op(A) rows (op(B) columns) i0.. are contiguous iff not transposed
+        const bool contiguous = is_a ? !trans : trans;
+        const src_t *s = contiguous ? src + i0 + Bk * ld_src
+                                    : src + Bk + i0 * ld_src;
+        if (is_a)
+            pack_a_panel(trans, len, kb, s, ld_src, d);
+        else
+            pack_b_panel(trans, kb, len, s, ld_src, d);
+    });
+    return dnnl_success;
+}
+
 template dnnl_status_t ref_gemm<float>(const char *transa_, const char *transb_,
         const dim_t *M_, const dim_t *N_, const dim_t *K_, const float *alpha_,
         const float *A, const dim_t *lda_, const float *B, const dim_t *ldb_,
-        const float *beta_, float *C, const dim_t *ldc_, const float *bias);
+        const float *beta_, float *C, const dim_t *ldc_, const float *bias,
+        const gemm_epilogue_t *epilogue);
 
 template dnnl_status_t ref_gemm<double>(const char *transa_,
         const char *transb_, const dim_t *M_, const dim_t *N_, const dim_t *K_,
         const double *alpha_, const double *A, const dim_t *lda_,
         const double *B, const dim_t *ldb_, const double *beta_, double *C,
-        const dim_t *ldc_, const double *bias);
+        const dim_t *ldc_, const double *bias,
+        const gemm_epilogue_t *epilogue);
+
+template dnnl_status_t ref_gemm_pack_get_size<float>(const char *identifier,
+        const char *transa, const char *transb, const dim_t *M, const dim_t *N,
+        const dim_t *K, const dim_t *lda, const dim_t *ldb, size_t *size,
+        bool *pack);
+
+template dnnl_status_t ref_gemm_pack<float, float>(const char *identifier,
+        const char *transa, const char *transb, const dim_t *M, const dim_t *N,
+        const dim_t *K, const dim_t *lda, const dim_t *ldb, const float *src,
+        float *dst);
+
+template dnnl_status_t ref_gemm_pack<bfloat16_t, float>(
+        const char *identifier, const char *transa, const char *transb,
+        const dim_t *M, const dim_t *N, const dim_t *K, const dim_t *lda,
+        const dim_t *ldb, const bfloat16_t *src, float *dst);
 } // namespace cpu
 } // namespace impl
 } // namespace dnnl
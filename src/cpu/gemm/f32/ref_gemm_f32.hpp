@@ -19,18 +19,50 @@
 
 #include "dnnl_types.h"
 
+#include "common/bfloat16.hpp"
 #include "common/c_types_map.hpp"
 
 namespace dnnl {
 namespace impl {
 namespace cpu {
 
+struct gemm_a_source_t;
+struct gemm_epilogue_t;
+
+// \c epilogue (f32 only) is applied to each finished block of C, after bias
 template <typename data_t>
 dnnl_status_t ref_gemm(const char *transa, const char *transb, const dim_t *M,
         const dim_t *N, const dim_t *K, const data_t *alpha, const data_t *A,
         const dim_t *lda, const data_t *B, const dim_t *ldb, const data_t *beta,
-        data_t *C, const dim_t *ldc, const data_t *bias);
-}
+        data_t *C, const dim_t *ldc, const data_t *bias,
+        const gemm_epilogue_t *epilogue = nullptr);
+
+// bf16 A and B are widened to f32 while packing; ref_gemm otherwise
+dnnl_status_t ref_gemm_bf16bf16f32(const char *transa, const char *transb,
+        const dim_t *M, const dim_t *N, const dim_t *K, const float *alpha,
+        const bfloat16_t *A, const dim_t *lda, const bfloat16_t *B,
+        const dim_t *ldb, const float *beta, float *C, const dim_t *ldc);
+
+// A is not stored but generated panel by panel by \c A
+dnnl_status_t ref_gemm_implicit_a(const char *transb, const dim_t *M,
+        const dim_t *N, const dim_t *K, const float *alpha,
+        const gemm_a_source_t *A, const float *B, const dim_t *ldb,
+        const float *beta, float *C, const dim_t *ldc, const float *bias);
+
+// Pre-pack op(A) (identifier "A") or op(B) ("B") into the panel layout of the
+// ref_gemm microkernel; ref_gemm then takes the packed matrix with trans 'P'.
+template <typename data_t>
+dnnl_status_t ref_gemm_pack_get_size(const char *identifier,
+        const char *transa, const char *transb, const dim_t *M, const dim_t *N,
+        const dim_t *K, const dim_t *lda, const dim_t *ldb, size_t *size,
+        bool *pack);
+
+// A bf16 \c src is packed into f32 panels (sized by the f32 get_size).
+template <typename src_t, typename data_t>
+dnnl_status_t ref_gemm_pack(const char *identifier, const char *transa,
+        const char *transb, const dim_t *M, const dim_t *N, const dim_t *K,
+        const dim_t *lda, const dim_t *ldb, const src_t *src, data_t *dst);
+} // namespace cpu
 } // namespace impl
 } // namespace dnnl
 
@@ -92,11 +92,33 @@ dnnl_status_t check_gemm_x8x8x32_input(const char *offsetc, const char *transa,
             alpha, beta, with_bias);
 }
 
+#if defined(USE_CBLAS) || DNNL_X64
+namespace {
+// Separate epilogue pass for backends that cannot apply it per C block.
+// Rows are chunked as well so that small N (e.g. inner product with MB = 1)
+// still spreads over the threads.
+void apply_gemm_epilogue(const gemm_epilogue_t *epilogue, dim_t M, dim_t N,
+        float *C, dim_t ldc) {
+    if (M <= 0 || N <= 0) return;
+    if (dnnl_in_parallel()) {
+        (*epilogue)(C, ldc, 0, M, N);
+        return;
+    }
+    const dim_t m_blk = 1024;
+    parallel_nd(N, utils::div_up(M, m_blk), [&](dim_t j, dim_t ib) {
+        const dim_t m_off = ib * m_blk;
+        (*epilogue)(C + m_off + j * ldc, ldc, m_off,
+                nstl::min(m_blk, M - m_off), 1);
+    });
+}
+} // namespace
+#endif
+
 dnnl_status_t extended_sgemm(const char *transa, const char *transb,
         const dim_t *M, const dim_t *N, const dim_t *K, const float *alpha,
         const float *A, const dim_t *lda, const float *B, const dim_t *ldb,
         const float *beta, float *C, const dim_t *ldc, const float *bias,
-        const bool force_jit_nocopy_gemm) {
+        const bool force_jit_nocopy_gemm, const gemm_epilogue_t *epilogue) {
     dnnl_status_t status = check_gemm_input(transa, transb, M, N, K, A, lda, B,
             ldb, C, ldc, alpha, beta, bias != nullptr);
     if (status != dnnl_success) return status;
@@ -126,6 +148,7 @@ dnnl_status_t extended_sgemm(const char *transa, const char *transb,
         if (*N > 0) {
             msan_unpoison_matrix(C, *M, *N, *ldc, sizeof(*C));
         }
+        if (epilogue) apply_gemm_epilogue(epilogue, *M, *N, C, *ldc);
         return dnnl_success;
     }
 #endif
@@ -134,14 +157,32 @@ dnnl_status_t extended_sgemm(const char *transa, const char *transb,
     if (mayiuse(sse41)) {
         float *dummy_ao = NULL;
         float *dummy_bo = NULL;
-        return gemm_driver(transa, transb, bias ? "C" : NULL, M, N, K, alpha, A,
-                lda, dummy_ao, B, ldb, dummy_bo, beta, C, ldc, bias,
+        status = gemm_driver(transa, transb, bias ? "C" : NULL, M, N, K,
+                alpha, A, lda, dummy_ao, B, ldb, dummy_bo, beta, C, ldc, bias,
                 force_jit_nocopy_gemm);
+        if (status == dnnl_success && epilogue)
+            apply_gemm_epilogue(epilogue, *M, *N, C, *ldc);
+        return status;
     }
 #endif
 
-    return ref_gemm<float>(
-            transa, transb, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc, bias);
+    return ref_gemm<float>(transa, transb, M, N, K, alpha, A, lda, B, ldb,
+            beta, C, ldc, bias, epilogue);
+}
+
+dnnl_status_t implicit_sgemm(const char *transb, const dim_t *M,
+        const dim_t *N, const dim_t *K, const float *alpha,
+        const gemm_a_source_t *A, const float *B, const dim_t *ldb,
+        const float *beta, float *C, const dim_t *ldc, const float *bias) {
+    // A has no leading dimension, any valid one passes the checks
+    const dim_t lda = M ? nstl::max(dim_t(1), *M) : 1;
+    dnnl_status_t status = check_gemm_input("N", transb, M, N, K, A, &lda, B,
+            ldb, C, ldc, alpha, beta, bias != nullptr);
+    if (status != dnnl_success) return status;
+    if (utils::one_of(*transb, 'P', 'p')) return dnnl_unimplemented;
+
+    return ref_gemm_implicit_a(
+            transb, M, N, K, alpha, A, B, ldb, beta, C, ldc, bias);
 }
 
 // Tries calling Intel MKL cblas_gemm_s8u8s32 if applicable and available
@@ -256,7 +297,8 @@ dnnl_status_t gemm_bf16bf16f32(const char *transa, const char *transb,
                 ldb, dummy_bo, beta, (float *)C, ldc, dummy_co, false);
 #endif
 
-    return dnnl_unimplemented;
+    return ref_gemm_bf16bf16f32(
+            transa, transb, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
 }
 
 } // namespace cpu
@@ -33,11 +33,61 @@ namespace dnnl {
 namespace impl {
 namespace cpu {
 
+/** Post-processing of finished blocks of an f32 GEMM result.
+ *
+ * Rows of C are output channels (OC of inner product, N of matmul), so the
+ * epilogue sees an m x n column-major block together with the index
+ * \c m_off of its first row. The reference GEMM applies it to every C block
+ * right after the last K panel while the block is still in cache; the other
+ * backends apply it in a separate pass over C.
+ */
+struct gemm_epilogue_t {
+    virtual ~gemm_epilogue_t() = default;
+    virtual void operator()(
+            float *c, dim_t ldc, dim_t m_off, dim_t m, dim_t n) const = 0;
+};
+
+/** Column-major sgemm with an optional per-row \c bias and an optional
+ * \c epilogue applied to C after bias. */
 dnnl_status_t extended_sgemm(const char *transa, const char *transb,
         const dim_t *M, const dim_t *N, const dim_t *K, const float *alpha,
         const float *A, const dim_t *lda, const float *B, const dim_t *ldb,
         const float *beta, float *C, const dim_t *ldc,
-        const float *bias = nullptr, bool force_jit_gemm = false);
+        const float *bias = nullptr, bool force_jit_gemm = false,
+        const gemm_epilogue_t *epilogue = nullptr);
+
+/** Generator of the A operand of an implicit GEMM.
+ *
+ * Instead of reading a stored M x K matrix the reference GEMM asks for each
+ * cache-sized A panel as it needs it: \c pack writes rows [i0, i0 + m) and
+ * columns [p0, p0 + k) of A in the packed-panel layout, i.e. element (i, p)
+ * of the panel goes to ap[(i / m_tile) * m_tile * k + p * m_tile + i % m_tile].
+ * Rows of the last sliver past \c m are zeroed by the caller. \c pack is
+ * called concurrently by the GEMM threads.
+ */
+struct gemm_a_source_t {
+    virtual ~gemm_a_source_t() = default;
+    virtual void pack(dim_t i0, dim_t m, dim_t p0, dim_t k, dim_t m_tile,
+            float *ap) const = 0;
+};
+
+/** C = alpha * A * op(B) + beta * C (+ bias) with A supplied panel by panel
+ * by \c A. Always runs on the reference GEMM engine. */
+dnnl_status_t implicit_sgemm(const char *transb, const dim_t *M,
+        const dim_t *N, const dim_t *K, const float *alpha,
+        const gemm_a_source_t *A, const float *B, const dim_t *ldb,
+        const float *beta, float *C, const dim_t *ldc,
+        const float *bias = nullptr);
+
+/** Whether extended_sgemm runs on the reference engine anyway, so that an
+ * implicit GEMM costs no speed against an explicit one. */
+inline bool implicit_sgemm_preferred() {
+#if defined(USE_CBLAS) || DNNL_X64
+    return false;
+#else
+    return true;
+#endif
+}
 
 template <typename b_dt>
 dnnl_status_t gemm_s8x8s32(const char *transa, const char *transb,
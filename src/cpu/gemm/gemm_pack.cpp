@@ -18,6 +18,8 @@
 
 #include "cpu/gemm/gemm_pack.hpp"
 
+#include "cpu/gemm/f32/ref_gemm_f32.hpp"
+
 #if DNNL_X64
 #include "cpu/x64/gemm/gemm_pack.hpp"
 #endif
@@ -26,27 +28,16 @@ namespace dnnl {
 namespace impl {
 namespace cpu {
 
-bool pack_sgemm_supported() {
-#if DNNL_X64
-    return x64::pack_sgemm_supported();
-#endif
-    return false;
-}
-bool pack_gemm_bf16bf16f32_supported() {
-#if DNNL_X64
-    return x64::pack_gemm_bf16bf16f32_supported();
-#endif
-    return false;
-}
-
 dnnl_status_t sgemm_pack_get_size(const char *identifier, const char *transa,
         const char *transb, const dim_t *M, const dim_t *N, const dim_t *K,
         const dim_t *lda, const dim_t *ldb, size_t *size, bool *pack) {
 #if DNNL_X64
-    return x64::sgemm_pack_get_size(
-            identifier, transa, transb, M, N, K, lda, ldb, size, pack);
+    if (x64::pack_sgemm_supported())
+        return x64::sgemm_pack_get_size(
+                identifier, transa, transb, M, N, K, lda, ldb, size, pack);
 #endif
-    return dnnl_unimplemented;
+    return ref_gemm_pack_get_size<float>(
+            identifier, transa, transb, M, N, K, lda, ldb, size, pack);
 }
 
 dnnl_status_t gemm_bf16bf16f32_pack_get_size(const char *identifier,
@@ -54,10 +45,12 @@ dnnl_status_t gemm_bf16bf16f32_pack_get_size(const char *identifier,
         const dim_t *K, const dim_t *lda, const dim_t *ldb, size_t *size,
         bool *pack) {
 #if DNNL_X64
-    return x64::gemm_bf16bf16f32_pack_get_size(
-            identifier, transa, transb, M, N, K, lda, ldb, size, pack);
+    if (x64::pack_gemm_bf16bf16f32_supported())
+        return x64::gemm_bf16bf16f32_pack_get_size(
+                identifier, transa, transb, M, N, K, lda, ldb, size, pack);
 #endif
-    return dnnl_unimplemented;
+    return ref_gemm_pack_get_size<float>(
+            identifier, transa, transb, M, N, K, lda, ldb, size, pack);
 }
 
 dnnl_status_t gemm_s8u8s32_pack_get_size(const char *identifier,
@@ -86,10 +79,12 @@ dnnl_status_t sgemm_pack(const char *identifier, const char *transa,
         const char *transb, const dim_t *M, const dim_t *N, const dim_t *K,
         const dim_t *lda, const dim_t *ldb, const float *src, float *dst) {
 #if DNNL_X64
-    return x64::sgemm_pack(
-            identifier, transa, transb, M, N, K, lda, ldb, src, dst);
+    if (x64::pack_sgemm_supported())
+        return x64::sgemm_pack(
+                identifier, transa, transb, M, N, K, lda, ldb, src, dst);
 #endif
-    return dnnl_unimplemented;
+    return ref_gemm_pack<float>(
+            identifier, transa, transb, M, N, K, lda, ldb, src, dst);
 }
 
 dnnl_status_t gemm_bf16bf16f32_pack(const char *identifier, const char *transa,
@@ -97,10 +92,12 @@ dnnl_status_t gemm_bf16bf16f32_pack(const char *identifier, const char *transa,
         const dim_t *lda, const dim_t *ldb, const bfloat16_t *src,
         bfloat16_t *dst) {
 #if DNNL_X64
-    return x64::gemm_bf16bf16f32_pack(
-            identifier, transa, transb, M, N, K, lda, ldb, src, dst);
+    if (x64::pack_gemm_bf16bf16f32_supported())
+        return x64::gemm_bf16bf16f32_pack(
+                identifier, transa, transb, M, N, K, lda, ldb, src, dst);
 #endif
-    return dnnl_unimplemented;
+    return ref_gemm_pack(identifier, transa, transb, M, N, K, lda, ldb, src,
+            reinterpret_cast<float *>(dst));
 }
 
 dnnl_status_t gemm_s8u8s32_pack(const char *identifier, const char *transa,
@@ -128,10 +125,13 @@ dnnl_status_t sgemm_compute(const char *transa, const char *transb,
         const dim_t *lda, const float *B, const dim_t *ldb, const float *beta,
         float *C, const dim_t *ldc) {
 #if DNNL_X64
-    return x64::sgemm_compute(
-            transa, transb, M, N, K, A, lda, B, ldb, beta, C, ldc);
+    if (x64::pack_sgemm_supported())
+        return x64::sgemm_compute(
+                transa, transb, M, N, K, A, lda, B, ldb, beta, C, ldc);
 #endif
-    return dnnl_unimplemented;
+    float one = 1.0f;
+    return ref_gemm<float>(transa, transb, M, N, K, &one, A, lda, B, ldb, beta,
+            C, ldc, nullptr);
 }
 
 dnnl_status_t gemm_bf16bf16f32_compute(const char *transa, const char *transb,
@@ -139,10 +139,13 @@ dnnl_status_t gemm_bf16bf16f32_compute(const char *transa, const char *transb,
         const dim_t *lda, const bfloat16_t *B, const dim_t *ldb,
         const float *beta, float *C, const dim_t *ldc) {
 #if DNNL_X64
-    return x64::gemm_bf16bf16f32_compute(
-            transa, transb, M, N, K, A, lda, B, ldb, beta, C, ldc);
+    if (x64::pack_gemm_bf16bf16f32_supported())
+        return x64::gemm_bf16bf16f32_compute(
+                transa, transb, M, N, K, A, lda, B, ldb, beta, C, ldc);
 #endif
-    return dnnl_unimplemented;
+    float one = 1.0f;
+    return ref_gemm_bf16bf16f32(
+            transa, transb, M, N, K, &one, A, lda, B, ldb, beta, C, ldc);
 }
 
 dnnl_status_t gemm_s8u8s32_compute(const char *transa, const char *transb,
@@ -26,8 +26,8 @@ namespace dnnl {
 namespace impl {
 namespace cpu {
 
-bool pack_sgemm_supported();
-bool pack_gemm_bf16bf16f32_supported();
+/* The packed GEMM API is available on every build: it runs on the x64 packed
+ * GEMM when the CPU has it and on the ref_gemm panel format otherwise. */
 
 dnnl_status_t DNNL_API sgemm_pack_get_size(const char *identifier,
         const char *transa, const char *transb, const dim_t *M, const dim_t *N,
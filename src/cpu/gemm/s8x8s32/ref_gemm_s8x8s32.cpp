@@ -19,12 +19,14 @@
 #include "dnnl_types.h"
 
 #include "common/dnnl_thread.hpp"
+#include "common/nstl.hpp"
 #include "common/utils.hpp"
 
 #include "cpu/platform.hpp"
 #include "cpu/simple_q10n.hpp"
 
-#include "cpu/gemm/f32/ref_gemm_f32.hpp"
+#include "cpu/gemm/f32/gemm_panel_f32.hpp"
+#include "cpu/gemm/f32/gemm_utils_f32.hpp"
 
 #include "cpu/gemm/s8x8s32/ref_gemm_s8x8s32.hpp"
 
@@ -32,6 +34,53 @@ namespace dnnl {
 namespace impl {
 namespace cpu {
 
+using namespace dnnl::impl::utils;
+using namespace gemm_utils;
+
+namespace {
+
+// sum[i] = sum_p x(i, p) for an mn x k matrix stored with unit stride
+// along k (k_contiguous) or along mn
+template <typename data_t>
+void sum_over_k(bool k_contiguous, dim_t mn, dim_t k, const data_t *x,
+        dim_t ld, int32_t *sum) {
+    parallel(0, [&](int ithr, int nthr) {
+        dim_t start {0}, end {0};
+        balance211(mn, nthr, ithr, start, end);
+        if (k_contiguous) {
+            for (dim_t i = start; i < end; ++i) {
+                const data_t *xi = x + i * ld;
+                int32_t s = 0;
+                PRAGMA_OMP_SIMD(reduction(+ : s))
+                for (dim_t p = 0; p < k; ++p)
+                    s += xi[p];
+                sum[i] = s;
+            }
+        } else {
+            for (dim_t i = start; i < end; ++i)
+                sum[i] = 0;
+            for (dim_t p = 0; p < k; ++p) {
+                const data_t *xp = x + p * ld;
+                PRAGMA_OMP_SIMD()
+                for (dim_t i = start; i < end; ++i)
+                    sum[i] += xp[i];
+            }
+        }
+    });
+}
+
+} // namespace
+
+/** Blocked integer GEMM on the packed-panel engine of ref_gemm.
+ *
+ * op(A) and op(B) are widened to int32 once, while packing, and multiplied
+ * by the int32 panel microkernel. With
+ * (A - ao)(B - bo) = AB - bo * rowsum(A) - ao * colsum(B) + K * ao * bo
+ * the offsets never touch the inner loop: per-row and per-column terms are
+ * precomputed, together with the offsetc (F/C/R) vector, and added when a
+ * finished C block is written back. The write-back stays in int32 for
+ * alpha == 1 and beta in {0, 1}.
+ */
 template <typename b_dt>
 dnnl_status_t ref_gemm_s8x8s32(const char *transa, const char *transb,
         const char *offsetc, const dim_t *M, const dim_t *N, const dim_t *K,
@@ -45,65 +94,137 @@ dnnl_status_t ref_gemm_s8x8s32(const char *transa, const char *transb,
                 && utils::one_of(*transb, 'n', 'N', 't', 'T')))
         return dnnl_unimplemented;
 
-    bool OCisR = (*offsetc == 'R' || *offsetc == 'r');
-    bool OCisC = (*offsetc == 'C' || *offsetc == 'c');
-    bool AisN = (*transa == 'N' || *transa == 'n');
-    bool BisN = (*transb == 'N' || *transb == 'n');
-
-    dim_t m = *M, n = *N, k = *K, lda = *LDA, ldb = *LDB, ldc = *LDC;
-    size_t sizeA = AisN ? lda * k : lda * m;
-    size_t sizeB = BisN ? ldb * n : ldb * k;
-    size_t sizeC = ldc * n;
-
-    double *dA = (double *)malloc(sizeA * sizeof(double), PAGE_4K);
-    double *dB = (double *)malloc(sizeB * sizeof(double), PAGE_4K);
-    double *dC = (double *)malloc(sizeC * sizeof(double), PAGE_4K);
-
-    if (utils::any_null(dA, dB, dC)) {
-        free(dA);
-        free(dB);
-        free(dC);
+    const bool OCisR = (*offsetc == 'R' || *offsetc == 'r');
+    const bool OCisC = (*offsetc == 'C' || *offsetc == 'c');
+    const bool AisN = (*transa == 'N' || *transa == 'n');
+    const bool BisN = (*transb == 'N' || *transb == 'n');
+
+    const dim_t m = *M, n = *N, k = *K, lda = *LDA, ldb = *LDB, ldc = *LDC;
+    const float alpha_ = *alpha, beta_ = *beta;
+    const int32_t a_off = ao[0], b_off = bo[0];
+    const bool int_path = alpha_ == 1.0f && utils::one_of(beta_, 0.0f, 1.0f);
+
+    int nthr_m, nthr_n, nthr_k;
+    dim_t MB, NB, KB;
+    // no split along K: the write-back needs complete sums
+    calc_nthr_nocopy_avx(m, n, 1,
+            dnnl_in_parallel() ? 1 : dnnl_get_max_threads(), &nthr_m, &nthr_n,
+            &nthr_k, &MB, &NB, &KB);
+    const int nthr = nthr_m * nthr_n;
+
+    const panel_blocking_t blk = get_panel_blocking<int32_t>(MB, NB, k);
+    // with beta != 0 the old C is still needed, so accumulate elsewhere
+    const size_t acc_elems = beta_ == 0.0f ? 0 : MB * NB;
+    const size_t ws_size_per_thr = rnd_up(
+            (panel_a_size<int32_t>(blk) + panel_b_size<int32_t>(blk)
+                    + acc_elems)
+                    * sizeof(int32_t),
+            PAGE_4K);
+
+    // row terms: -bo * rowsum(op(A)) + K * ao * bo, offsetc 'F' or 'C'
+    // column terms: -ao * colsum(op(B)), offsetc 'R'
+    int32_t *comp = (int32_t *)malloc(
+            sizeof(int32_t) * 2 * (m + n), platform::get_cache_line_size());
+    char *ws_buffers = (char *)malloc(nthr * ws_size_per_thr, PAGE_4K);
+    if (utils::any_null(comp, ws_buffers)) {
+        free(comp);
+        free(ws_buffers);
         return dnnl_out_of_memory;
     }
-
-    auto da_setter = [=](dim_t i, dim_t j, double v) { dA[j * lda + i] = v; };
-    auto db_setter = [=](dim_t i, dim_t j, double v) { dB[j * ldb + i] = v; };
-
-    auto ia_accessor = [=](dim_t i, dim_t j) { return A[j * lda + i]; };
-    auto ib_accessor = [=](dim_t i, dim_t j) { return B[j * ldb + i]; };
-
-    const int a_rows = AisN ? m : k;
-    const int a_cols = AisN ? k : m;
-    dnnl::impl::parallel_nd(a_cols, a_rows, [&](dim_t j, dim_t i) {
-        da_setter(i, j,
-                static_cast<double>(ia_accessor(i, j))
-                        - static_cast<double>(ao[0]));
-    });
-
-    const dim_t b_rows = BisN ? k : n;
-    const dim_t b_cols = BisN ? n : k;
-    dnnl::impl::parallel_nd(b_cols, b_rows, [&](dim_t j, dim_t i) {
-        db_setter(i, j,
-                static_cast<double>(ib_accessor(i, j))
-                        - static_cast<double>(bo[0]));
+    int32_t *row_comp = comp, *row_co = comp + m;
+    int32_t *col_comp = comp + 2 * m, *col_co = comp + 2 * m + n;
+
+    if (b_off != 0) {
+        sum_over_k(!AisN, m, k, A, lda, row_comp);
+        parallel_nd(m, [&](dim_t i) {
+            row_comp[i] = -b_off * row_comp[i] + (int32_t)k * a_off * b_off;
+        });
+    } else {
+        parallel_nd(m, [&](dim_t i) { row_comp[i] = 0; });
+    }
+    if (a_off != 0) {
+        sum_over_k(BisN, n, k, B, ldb, col_comp);
+        parallel_nd(n, [&](dim_t j) { col_comp[j] *= -a_off; });
+    } else {
+        parallel_nd(n, [&](dim_t j) { col_comp[j] = 0; });
+    }
+    parallel_nd(m, [&](dim_t i) {
+        row_co[i] = OCisR ? 0 : OCisC ? co[i] : co[0];
     });
-    double one = 1.0, zero = 0.0;
-    ref_gemm<double>(transa, transb, M, N, K, &one, dA, LDA, dB, LDB, &zero, dC,
-            LDC, nullptr);
-
-    auto i2d = [=](int32_t v) { return static_cast<double>(v); };
-    auto f2d = [=](float v) { return static_cast<double>(v); };
-
-    dnnl::impl::parallel_nd(n, m, [&](dim_t j, dim_t i) {
-        double coffset = OCisR ? i2d(co[j]) : OCisC ? i2d(co[i]) : i2d(co[0]);
-        double val = ((*beta == 0.0f) ? 0.0 : f2d(*beta) * i2d(C[i + j * ldc]))
-                + f2d(*alpha) * dC[i + j * ldc] + coffset;
-        C[i + j * ldc] = out_round<int32_t>(saturate<int32_t>(val));
+    parallel_nd(n, [&](dim_t j) { col_co[j] = OCisR ? co[j] : 0; });
+
+    // C(i0.., j0..) = alpha * (acc + comp) + beta * C + co for one block
+    auto write_back = [&](const int32_t *acc, dim_t ld_acc, dim_t i0,
+                              dim_t j0, dim_t mb, dim_t nb) {
+        const int32_t *rc = row_comp + i0, *rco = row_co + i0;
+        for (dim_t j = 0; j < nb; ++j) {
+            const int32_t *a = acc + j * ld_acc;
+            int32_t *c = C + i0 + (j0 + j) * ldc;
+            const int32_t cc = col_comp[j0 + j], cco = col_co[j0 + j];
+            if (int_path) {
+                // sums in int64_t, saturated to int32_t like the double path
+                const int64_t cj = (int64_t)cc + cco;
+                if (beta_ == 0.0f) {
+                    PRAGMA_OMP_SIMD()
+                    for (dim_t i = 0; i < mb; ++i)
+                        c[i] = saturate<int32_t>(
+                                (int64_t)a[i] + rc[i] + rco[i] + cj);
+                } else {
+                    PRAGMA_OMP_SIMD()
+                    for (dim_t i = 0; i < mb; ++i)
+                        c[i] = saturate<int32_t>(
+                                (int64_t)c[i] + a[i] + rc[i] + rco[i] + cj);
+                }
+            } else {
+                for (dim_t i = 0; i < mb; ++i) {
+                    const double val
+                            = (double)alpha_ * ((double)a[i] + rc[i] + cc)
+                            + (beta_ == 0.0f ? 0.0 : (double)beta_ * c[i])
+                            + ((double)rco[i] + cco);
+                    c[i] = out_round<int32_t>(saturate<int32_t>(val));
+                }
+            }
+        }
+    };
+
+    parallel(nthr, [&](int ithr, int) {
+        const int ithr_m = ithr % nthr_m, ithr_n = ithr / nthr_m;
+        const dim_t m_from = MB * ithr_m, n_from = NB * ithr_n;
+        const dim_t myM = nstl::min(MB, m - m_from);
+        const dim_t myN = nstl::min(NB, n - n_from);
+        if (myM <= 0 || myN <= 0) return;
+
+        int32_t *ap = (int32_t *)(ws_buffers + ithr * ws_size_per_thr);
+        int32_t *bp = ap + panel_a_size<int32_t>(blk);
+        int32_t *acc = acc_elems ? bp + panel_b_size<int32_t>(blk)
+                                 : C + m_from + n_from * ldc;
+        const dim_t ld_acc = acc_elems ? myM : ldc;
+
+        for (dim_t Bn = 0; Bn < myN; Bn += blk.nc) {
+            const dim_t nb = nstl::min(myN - Bn, blk.nc);
+            const dim_t j0 = n_from + Bn;
+            for (dim_t Bk = 0; Bk < k; Bk += blk.kc) {
+                const dim_t kb = nstl::min(k - Bk, blk.kc);
+                pack_b_panel(!BisN, kb, nb,
+                        BisN ? B + Bk + j0 * ldb : B + j0 + Bk * ldb, ldb, bp);
+                const bool last_k = Bk + kb == k;
+                for (dim_t Bm = 0; Bm < myM; Bm += blk.mc) {
+                    const dim_t mb = nstl::min(myM - Bm, blk.mc);
+                    const dim_t i0 = m_from + Bm;
+                    pack_a_panel(!AisN, mb, kb,
+                            AisN ? A + i0 + Bk * lda : A + Bk + i0 * lda, lda,
+                            ap);
+                    int32_t *curC = acc + Bm + Bn * ld_acc;
+                    panel_kernel<int32_t>(mb, nb, kb, 1, ap, bp,
+                            Bk == 0 ? 0 : 1, curC, ld_acc, nullptr);
+                    if (last_k) write_back(curC, ld_acc, i0, j0, mb, nb);
+                }
+            }
+        }
     });
 
-    free(dA);
-    free(dB);
-    free(dC);
+    free(comp);
+    free(ws_buffers);
     return dnnl_success;
 }
 
@@ -14,8 +14,8 @@
 * limitations under the License.
 *******************************************************************************/
 
-#ifndef CPU_X64_GEMM_BF16_INNER_PRODUCT_HPP
-#define CPU_X64_GEMM_BF16_INNER_PRODUCT_HPP
+#ifndef CPU_GEMM_BF16_INNER_PRODUCT_HPP
+#define CPU_GEMM_BF16_INNER_PRODUCT_HPP
 
 #include <assert.h>
 
@@ -30,11 +30,11 @@
 #include "cpu/cpu_engine.hpp"
 #include "cpu/gemm/gemm.hpp"
 #include "cpu/gemm_inner_product_utils.hpp"
+#include "cpu/platform.hpp"
 
 namespace dnnl {
 namespace impl {
 namespace cpu {
-namespace x64 {
 
 template <data_type_t dst_data_type>
 struct gemm_bf16_inner_product_fwd_t : public primitive_t {
@@ -47,8 +47,8 @@ struct gemm_bf16_inner_product_fwd_t : public primitive_t {
             using namespace utils;
             using namespace data_type;
 
-            bool ok = true && mayiuse(avx512_core) && is_fwd()
-                    && !has_zero_dim_memory()
+            bool ok = true && platform::has_data_type_support(data_type::bf16)
+                    && is_fwd() && !has_zero_dim_memory()
                     && everyone_is(
                             bf16, src_md()->data_type, weights_md()->data_type)
                     && dst_data_type == dst_md()->data_type
@@ -143,7 +143,7 @@ struct gemm_bf16_inner_product_bwd_data_t : public primitive_t {
         status_t init(engine_t *engine) {
             using namespace data_type;
 
-            bool ok = true && mayiuse(avx512_core)
+            bool ok = true && platform::has_data_type_support(data_type::bf16)
                     && desc()->prop_kind == prop_kind::backward_data
                     && !has_zero_dim_memory()
                     && utils::everyone_is(bf16, weights_md()->data_type,
@@ -205,7 +205,7 @@ struct gemm_bf16_inner_product_bwd_weights_t : public primitive_t {
             using namespace utils;
             using namespace data_type;
 
-            bool ok = true && mayiuse(avx512_core)
+            bool ok = true && platform::has_data_type_support(data_type::bf16)
                     && desc()->prop_kind == prop_kind::backward_weights
                     && !has_zero_dim_memory()
                     && everyone_is(
@@ -262,7 +262,6 @@ private:
     const pd_t *pd() const { return (const pd_t *)primitive_t::pd().get(); }
 };
 
-} // namespace x64
 } // namespace cpu
 } // namespace impl
 } // namespace dnnl
@@ -0,0 +1,105 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+// Kept apart from gemm_convolution_utils.cpp, which has a VE replacement,
+// so that both builds share one im2col panel generator and its switch.
+
+#include <assert.h>
+
+#include <atomic>
+
+#include "common/c_types_map.hpp"
+#include "common/nstl.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/gemm/f32/gemm_utils_f32.hpp"
+#include "cpu/gemm_convolution_utils.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+namespace {
+std::atomic<int> &implicit_im2col_override() {
+    static std::atomic<int> value {getenv_int("DNNL_GEMM_CONV_IMPLICIT", -1)};
+    return value;
+}
+} // namespace
+
+namespace jit_gemm_convolution_utils {
+
+bool use_implicit_im2col() {
+    const int value = implicit_im2col_override();
+    return value < 0 ? implicit_sgemm_preferred() : value == 1;
+}
+
+void im2col_a_source_t::pack(dim_t i0, dim_t m, dim_t p0, dim_t k,
+        dim_t m_tile, float *ap) const {
+    constexpr dim_t max_m_tile = gemm_utils::gemm_traits<float>::m;
+    assert(m_tile <= max_m_tile);
+
+    const dim_t ks = jcp_.ks;
+    const dim_t dh = 1 + jcp_.dilate_h;
+    const dim_t dw = 1 + jcp_.dilate_w;
+    const dim_t IH = jcp_.ih, IW = jcp_.iw;
+
+    // top-left input position of every output position of a sliver
+    dim_t ih0[max_m_tile], iw0[max_m_tile];
+    for (dim_t s0 = 0; s0 < m; s0 += m_tile) {
+        const dim_t mr = nstl::min(m_tile, m - s0);
+        const dim_t sp = ss_ + i0 + s0;
+        dim_t oh = sp / jcp_.ow, ow = sp % jcp_.ow;
+        for (dim_t i = 0; i < mr; ++i) {
+            ih0[i] = oh * jcp_.stride_h - jcp_.t_pad;
+            iw0[i] = ow * jcp_.stride_w - jcp_.l_pad;
+            if (++ow == jcp_.ow) {
+                ow = 0;
+                ++oh;
+            }
+        }
+
+        float *d = ap + s0 * k;
+        for (dim_t p = 0; p < k; ++p) {
+            const dim_t q = p0 + p;
+            const dim_t ic = cs_ + q / ks;
+            const dim_t kh = (q % ks) / jcp_.kw;
+            const dim_t kw = (q % ks) % jcp_.kw;
+            const float *im_ic = im_ + ic * jcp_.is;
+            const dim_t ih_k = kh * dh, iw_k = kw * dw;
+            float *d_p = d + p * m_tile;
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < mr; ++i) {
+                const dim_t ih = ih0[i] + ih_k, iw = iw0[i] + iw_k;
+                const bool ok = ih >= 0 && ih < IH && iw >= 0 && iw < IW;
+                const dim_t off = ok ? ih * IW + iw : 0;
+                d_p[i] = ok ? im_ic[off] : 0.f;
+            }
+        }
+    }
+}
+
+} // namespace jit_gemm_convolution_utils
+
+status_t set_gemm_conv_implicit_override(int implicit) {
+    if (!utils::one_of(implicit, -1, 0, 1)) return status::invalid_arguments;
+    implicit_im2col_override() = implicit;
+    return status::success;
+}
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
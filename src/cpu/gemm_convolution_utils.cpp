@@ -763,6 +763,7 @@ status_t init_conf(conv_gemm_conf_t &jcp,
     jcp.signed_input = src_d.data_type() == data_type::s8;
 
     jcp.outer_threading = false;
+    jcp.implicit_im2col = false;
 
     const bool is_bwd_d = jcp.prop_kind == backward_data;
     const bool is_bwd_w = jcp.prop_kind == backward_weights;
@@ -1248,10 +1249,15 @@ status_t init_conf(conv_gemm_conf_t &jcp,
                     && (jcp.mb != 1 || jcp.ngroups > 2);
 
         jcp.nthr = jcp.outer_threading ? max_threads : 1;
+        // with the reference GEMM engine the col matrix can be generated
+        // panel by panel while packing, instead of stored per thread
+        jcp.implicit_im2col = is_fwd && !is_bf16_conv && !is_3d
+                && jcp.im2col_sz && use_implicit_im2col();
         const size_t gemm_col_datatype_size = is_bf16_conv && !is_bwd_d
                 ? sizeof(bfloat16_t)
                 : sizeof(float);
-        scratchpad.book(key_conv_gemm_col, jcp.nthr * jcp.im2col_sz,
+        scratchpad.book(key_conv_gemm_col,
+                jcp.implicit_im2col ? 0 : jcp.nthr * jcp.im2col_sz,
                 gemm_col_datatype_size);
 
         const int sizeof_cacheline_float = 16;
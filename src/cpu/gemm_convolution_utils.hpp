@@ -22,6 +22,7 @@
 #include "common/memory_tracking.hpp"
 
 #include "cpu/cpu_convolution_pd.hpp"
+#include "cpu/gemm/gemm.hpp"
 #include "cpu/cpu_engine.hpp"
 
 namespace dnnl {
@@ -54,6 +55,9 @@ struct conv_gemm_conf_t {
     bool outer_threading;
     conv_gemm_loop_order_t loop_order;
     int nthr_oc;
+    // f32 fwd: im2col panels are generated inside the GEMM (implicit_sgemm),
+    // im2col_sz is kept but no col buffer is booked
+    bool implicit_im2col;
 };
 
 namespace jit_gemm_convolution_utils {
@@ -73,6 +77,28 @@ template <typename data_type_t>
 void im2col(const conv_gemm_conf_t &jcp, const data_type_t *__restrict im,
         data_type_t *__restrict col, int ss, int sb, int cs, int cb);
 
+/** Whether the f32 forward generates im2col panels inside the GEMM: where
+ * implicit_sgemm_preferred(), unless DNNL_GEMM_CONV_IMPLICIT=0|1 or
+ * set_gemm_conv_implicit_override() say otherwise. */
+bool use_implicit_im2col();
+
+/** The im2col matrix of one (n, g) image as the A operand of an implicit
+ * GEMM: row i is output position ss + i (2D or 1D), column p is
+ * (cs + p / ks, kh, kw). The same matrix im2col(jcp, im, col, ss, sb, cs, cb)
+ * stores, generated one packed panel at a time. */
+struct im2col_a_source_t : public gemm_a_source_t {
+    im2col_a_source_t(
+            const conv_gemm_conf_t &jcp, const float *im, int ss, int cs)
+        : jcp_(jcp), im_(im), ss_(ss), cs_(cs) {}
+    void pack(dim_t i0, dim_t m, dim_t p0, dim_t k, dim_t m_tile,
+            float *ap) const override;
+
+private:
+    const conv_gemm_conf_t &jcp_;
+    const float *im_;
+    int ss_, cs_;
+};
+
 template <typename T>
 void im2col_u8(const conv_gemm_conf_t &jcp, const T *__restrict im,
         T *__restrict imtr, uint8_t *__restrict col, int hs, int hb, int ws,
@@ -96,6 +122,11 @@ void bwd_weights_reduction_par(int ithr, int nthr, const conv_gemm_conf_t &jcp,
 
 } // namespace jit_gemm_convolution_utils
 
+// undocumented API, for testing only: -1 restores the default of
+// use_implicit_im2col(), the primitive cache may still return primitives
+// made before
+status_t DNNL_API set_gemm_conv_implicit_override(int implicit);
+
 } // namespace cpu
 } // namespace impl
 } // namespace dnnl
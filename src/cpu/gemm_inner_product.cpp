@@ -48,20 +48,20 @@ void gemm_inner_product_fwd_t<data_type>::execute_forward(
 
     const float *scales = pd()->attr()->output_scales_.scales_;
 
+    // bias and eltwise run as the GEMM epilogue on dst blocks still in
+    // cache, unless the pp kernel has to see the whole of dst at once
+    const bool fuse_pp = postops_in_ip_ && !pp_kernel_->sequential_kernel();
+    const inner_product_utils::pp_gemm_epilogue_t epilogue(
+            pp_kernel_.get(), (const char *)bias, scales, 0);
+
     float alpha = 1.;
     extended_sgemm(wei_tr ? "T" : "N", "N", &OC, &MB, &IC, &alpha, weights,
             wei_tr ? &IC : &OC, src, &IC, &beta_, dst, &OC,
-            postops_in_ip_ ? nullptr : bias);
-
-    if (postops_in_ip_) {
-        const bool force_sequential = pp_kernel_->sequential_kernel();
-        parallel(force_sequential ? 1 : 0, [&](int ithr, int nthr) {
-            size_t start, end;
-            balance211((size_t)(OC * MB), nthr, ithr, start, end);
-            (*pp_kernel_)(
-                    dst, dst, (char *)bias, scales, start, end, 0, nullptr);
-        });
-    }
+            postops_in_ip_ ? nullptr : bias, false,
+            fuse_pp ? &epilogue : nullptr);
+
+    if (postops_in_ip_ && !fuse_pp)
+        (*pp_kernel_)(dst, dst, (char *)bias, scales, 0, OC * MB, 0, nullptr);
 }
 
 template <impl::data_type_t data_type>
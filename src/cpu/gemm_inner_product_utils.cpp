@@ -16,7 +16,9 @@
 
 #include <memory>
 
+#include "common/dnnl_thread.hpp"
 #include "common/math_utils.hpp"
+#include "cpu/platform.hpp"
 #include "cpu/simple_q10n.hpp"
 
 #include "cpu/ref_eltwise.hpp"
@@ -50,6 +52,11 @@ struct ref_pp_kernel_t : public pp_kernel_t<acc_type, dst_type> {
             const char *bias, const float *scales, size_t start, size_t end,
             size_t runtime_oc, const float *dst_zero_points) const override;
 
+    virtual void compute_block(dst_data_t *dst, const acc_data_t *acc,
+            size_t ld, const char *bias, const float *scales, size_t oc_start,
+            size_t m, size_t n, size_t runtime_oc,
+            const float *dst_zero_points) const override;
+
 private:
     std::unique_ptr<ref_eltwise_scalar_fwd_t> ref_eltwise_;
 };
@@ -78,6 +85,69 @@ void ref_pp_kernel_t<acc_type, dst_type>::operator()(dst_data_t *dst,
     }
 }
 
+// Stages run over strips of a column, so each one is a plain
+// vector loop and the eltwise goes through compute_vec_reg.
+template <data_type_t acc_type, data_type_t dst_type>
+void ref_pp_kernel_t<acc_type, dst_type>::compute_block(dst_data_t *dst,
+        const acc_data_t *acc, size_t ld, const char *bias,
+        const float *scales, size_t oc_start, size_t m, size_t n,
+        size_t runtime_oc, const float *dst_zero_points) const {
+    using math::get_bias;
+    MAYBE_UNUSED(runtime_oc);
+
+    const bool f32_bias = this->bias_data_type_ == data_type::f32;
+    constexpr size_t vlen = platform::get_max_vector_length();
+    float d[vlen];
+    for (size_t j = 0; j < n; ++j) {
+        dst_data_t *dst_j = dst + j * ld;
+        const acc_data_t *acc_j = acc + j * ld;
+        for (size_t i0 = 0; i0 < m; i0 += vlen) {
+            const size_t vl = nstl::min(vlen, m - i0);
+            const size_t oc = oc_start + i0;
+            PRAGMA_OMP_SIMD()
+            for (size_t i = 0; i < vl; ++i)
+                d[i] = (float)acc_j[i0 + i];
+            if (this->do_bias()) {
+                if (f32_bias) {
+                    const float *b = (const float *)bias + oc;
+                    PRAGMA_OMP_SIMD()
+                    for (size_t i = 0; i < vl; ++i)
+                        d[i] += b[i];
+                } else {
+                    for (size_t i = 0; i < vl; ++i)
+                        d[i] += get_bias(bias, oc + i, this->bias_data_type_);
+                }
+            }
+            if (this->do_scale_) {
+                const float *s = scales + oc * this->scale_idx_mult_;
+                if (this->scale_idx_mult_) {
+                    PRAGMA_OMP_SIMD()
+                    for (size_t i = 0; i < vl; ++i)
+                        d[i] *= s[i];
+                } else {
+                    PRAGMA_OMP_SIMD()
+                    for (size_t i = 0; i < vl; ++i)
+                        d[i] *= s[0];
+                }
+            }
+            if (this->do_sum_) {
+                PRAGMA_OMP_SIMD()
+                for (size_t i = 0; i < vl; ++i)
+                    d[i] += this->sum_scale_ * (float)dst_j[i0 + i];
+            }
+            if (this->do_eltwise_) ref_eltwise_->compute_vec_reg(d, d, vl);
+            if (this->do_dst_zero_points_) {
+                PRAGMA_OMP_SIMD()
+                for (size_t i = 0; i < vl; ++i)
+                    d[i] += dst_zero_points[0];
+            }
+            PRAGMA_OMP_SIMD()
+            for (size_t i = 0; i < vl; ++i)
+                dst_j[i0 + i] = qz_a1b0<float, dst_data_t>()(d[i]);
+        }
+    }
+}
+
 // Interface section
 
 template <data_type_t acc_type, data_type_t dst_type>
@@ -23,6 +23,8 @@
 
 #include "cpu/cpu_inner_product_pd.hpp"
 
+#include "cpu/gemm/gemm.hpp"
+
 namespace dnnl {
 namespace impl {
 namespace cpu {
@@ -51,6 +53,25 @@ struct pp_kernel_t {
             const char *bias, const float *scales, size_t start, size_t end,
             size_t runtime_oc, const float *dst_zero_points) const = 0;
 
+    // m x n column-major block of dst (acc) with leading dimension ld whose
+    // rows are the channels [oc_start, oc_start + m), as seen by a GEMM
+    // epilogue. Not for sequential kernels; the default goes column-wise.
+    virtual void compute_block(dst_data_t *dst, const acc_data_t *acc,
+            size_t ld, const char *bias, const float *scales, size_t oc_start,
+            size_t m, size_t n, size_t runtime_oc,
+            const float *dst_zero_points) const {
+        assert(!sequential_kernel());
+        // the channels of the block are rebased on the bias and scales, so
+        // every column is a [0, m) range of the kernel
+        const char *bias_blk
+                = do_bias() ? bias + oc_start * bias_data_type_size_ : bias;
+        const float *scales_blk
+                = do_scale_ ? scales + oc_start * scale_idx_mult_ : scales;
+        for (size_t j = 0; j < n; ++j)
+            (*this)(dst + j * ld, acc + j * ld, bias_blk, scales_blk, 0, m,
+                    runtime_oc, dst_zero_points);
+    }
+
 protected:
     pp_kernel_t(size_t OC, size_t MB, const primitive_attr_t *attr,
             data_type_t bias_dt, bool skip_sum);
@@ -73,6 +94,25 @@ protected:
     bool runtime_mb() const { return MB_ == (size_t)DNNL_RUNTIME_DIM_VAL; }
 };
 
+// Runs an f32 pp kernel in place as the epilogue of the GEMM computing dst
+struct pp_gemm_epilogue_t : public gemm_epilogue_t {
+    pp_gemm_epilogue_t(const pp_kernel_t<data_type::f32, data_type::f32> *ker,
+            const char *bias, const float *scales, size_t runtime_oc)
+        : ker_(ker), bias_(bias), scales_(scales), runtime_oc_(runtime_oc) {}
+
+    void operator()(float *c, dim_t ldc, dim_t m_off, dim_t m,
+            dim_t n) const override {
+        ker_->compute_block(c, c, ldc, bias_, scales_, m_off, m, n,
+                runtime_oc_, nullptr);
+    }
+
+private:
+    const pp_kernel_t<data_type::f32, data_type::f32> *ker_;
+    const char *bias_;
+    const float *scales_;
+    size_t runtime_oc_;
+};
+
 } // namespace inner_product_utils
 } // namespace cpu
 } // namespace impl
@@ -160,6 +160,14 @@ status_t gemm_f32_matmul_t::execute_ref(const exec_ctx_t &ctx) const {
     const auto weights_batch_stride = weights_d.blocking_desc().strides[0];
     const auto dst_batch_stride = dst_d.blocking_desc().strides[0];
 
+    // bias, scales and eltwise run as the GEMM epilogue on C blocks still in
+    // cache, unless the pp kernel has to see the whole of dst at once
+    const bool fuse_pp
+            = params.has_pp_kernel_ && !pp_kernel_->sequential_kernel();
+    const float *pp_scales = params.get_post_processing_scales(scales);
+    const inner_product_utils::pp_gemm_epilogue_t epilogue(
+            pp_kernel_.get(), bias, pp_scales, (size_t)N);
+
     const bool parallel_over_batch = batch > 1;
     if (parallel_over_batch) {
         parallel(0, [&](int ithr, int nthr) {
@@ -173,30 +181,21 @@ status_t gemm_f32_matmul_t::execute_ref(const exec_ctx_t &ctx) const {
 
                 extended_sgemm(transB, transA, &N, &M, &K, &alpha, curr_weights,
                         &ldb, curr_src, &lda, &beta, curr_dst, &ldc, nullptr,
-                        false);
+                        false, fuse_pp ? &epilogue : nullptr);
 
-                if (params.has_pp_kernel_) {
-                    const float *pp_scales
-                            = params.get_post_processing_scales(scales);
+                if (params.has_pp_kernel_ && !fuse_pp)
                     (*pp_kernel_)(curr_dst, curr_dst, bias, pp_scales, 0, M * N,
                             (size_t)N, nullptr);
-                }
             }
         });
     } else {
         extended_sgemm(transB, transA, &N, &M, &K, &alpha, weights, &ldb, src,
-                &lda, &beta, dst, &ldc, nullptr, false);
-
-        if (params.has_pp_kernel_) {
-            const bool force_sequential = pp_kernel_->sequential_kernel();
-            const float *pp_scales = params.get_post_processing_scales(scales);
-            parallel(force_sequential ? 1 : 0, [&](int ithr, int nthr) {
-                size_t start {}, end {};
-                balance211((size_t)(M * N), nthr, ithr, start, end);
-                (*pp_kernel_)(dst, dst, bias, pp_scales, start, end, (size_t)N,
-                        nullptr);
-            });
-        }
+                &lda, &beta, dst, &ldc, nullptr, false,
+                fuse_pp ? &epilogue : nullptr);
+
+        if (params.has_pp_kernel_ && !fuse_pp)
+            (*pp_kernel_)(
+                    dst, dst, bias, pp_scales, 0, M * N, (size_t)N, nullptr);
     }
 
     return status::success;
@@ -14,6 +14,11 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/utils.hpp"
+
 #include "cpu/platform.hpp"
 
 #if DNNL_X64
@@ -22,11 +27,135 @@
 #include "cpu/ve/cpu_isa_traits.hpp"
 #endif
 
+#if defined(__linux__) && !DNNL_X64 && !defined(__ve)
+#define DNNL_CPU_TOPOLOGY_SYSFS 1
+#include <unistd.h>
+#include <set>
+#include <string>
+#include <utility>
+#else
+#define DNNL_CPU_TOPOLOGY_SYSFS 0
+#endif
+
 namespace dnnl {
 namespace impl {
 namespace cpu {
 namespace platform {
 
+namespace {
+// What is known about the host beyond the ISA; zero means unknown, in which
+// case the x64 cpuid query or the built-in guess applies.
+struct cpu_topology_t {
+    unsigned cache_size[4] = {0, 0, 0, 0}; // per core, by level 1..3
+    unsigned num_cores = 0; // physical
+};
+
+unsigned parse_cache_size(const char *s) {
+    return (unsigned)nstl::min(parse_size(s), (size_t)UINT_MAX);
+}
+
+#if DNNL_CPU_TOPOLOGY_SYSFS
+bool read_sysfs(const std::string &path, char *buf, size_t len) {
+    FILE *f = fopen(path.c_str(), "r");
+    if (!f) return false;
+    const bool ok = fgets(buf, (int)len, f) != nullptr;
+    fclose(f);
+    if (ok) buf[strcspn(buf, "\n")] = '\0';
+    return ok;
+}
+
+// (package, core) of a CPU, or (-1, -1) if sysfs does not tell
+std::pair<int, int> cpu_core(long cpu) {
+    const std::string topo = "/sys/devices/system/cpu/cpu"
+            + std::to_string(cpu) + "/topology/";
+    char buf[64];
+    if (!read_sysfs(topo + "core_id", buf, sizeof(buf)))
+        return std::make_pair(-1, -1);
+    const int core = atoi(buf);
+    const int pkg = read_sysfs(topo + "physical_package_id", buf, sizeof(buf))
+            ? atoi(buf)
+            : 0;
+    return std::make_pair(pkg, core);
+}
+
+void detect_sysfs(cpu_topology_t &t) {
+    const std::string cpu_dir = "/sys/devices/system/cpu/";
+    char buf[256];
+
+    // data and unified caches seen by cpu0, divided among the physical cores
+    // sharing them, as the SMT siblings of a core share its L1 and L2
+    for (int i = 0;; ++i) {
+        const std::string idx
+                = cpu_dir + "cpu0/cache/index" + std::to_string(i) + "/";
+        if (!read_sysfs(idx + "level", buf, sizeof(buf))) break;
+        const int level = atoi(buf);
+        if (level < 1 || level > 3) continue;
+        if (read_sysfs(idx + "type", buf, sizeof(buf))
+                && strcmp(buf, "Instruction") == 0)
+            continue;
+        if (!read_sysfs(idx + "size", buf, sizeof(buf))) continue;
+        const unsigned size = parse_cache_size(buf);
+        unsigned sharing = 1;
+        if (read_sysfs(idx + "shared_cpu_list", buf, sizeof(buf))) {
+            std::set<std::pair<int, int>> sharing_cores;
+            bool known = true;
+            const unsigned ncpus = for_each_cpulist_entry(buf, [&](long c) {
+                const auto core = cpu_core(c);
+                known = known && core.first >= 0;
+                sharing_cores.insert(core);
+            });
+            // without the topology, every CPU counts as a core
+            sharing = known ? (unsigned)sharing_cores.size() : ncpus;
+            sharing = nstl::max(1U, sharing);
+        }
+        t.cache_size[level] = size / sharing;
+    }
+
+    // physical cores are the distinct (package, core) pairs
+    std::set<std::pair<int, int>> cores;
+    const long ncpus = sysconf(_SC_NPROCESSORS_CONF);
+    for (long c = 0; c < ncpus; ++c) {
+        const auto core = cpu_core(c);
+        if (core.first >= 0) cores.insert(core);
+    }
+    if (!cores.empty())
+        t.num_cores = (unsigned)cores.size();
+    else if (sysconf(_SC_NPROCESSORS_ONLN) > 0)
+        t.num_cores = (unsigned)sysconf(_SC_NPROCESSORS_ONLN);
+}
+#endif
+
+// DNNL_CPU_CACHE_SIZES=<L1>,<L2>,<L3> (per core, e.g. "48K,1280K,1536K";
+// empty fields keep the detected value) and DNNL_CPU_NUM_CORES=<n> override
+// whatever was detected.
+void apply_env_overrides(cpu_topology_t &t) {
+    char buf[128];
+    if (getenv("DNNL_CPU_CACHE_SIZES", buf, sizeof(buf)) > 0) {
+        const char *s = buf;
+        for (int level = 1; level <= 3 && s; ++level) {
+            const unsigned size = parse_cache_size(s);
+            if (size > 0) t.cache_size[level] = size;
+            s = strchr(s, ',');
+            if (s) ++s;
+        }
+    }
+    const int num_cores = getenv_int("DNNL_CPU_NUM_CORES", 0);
+    if (num_cores > 0) t.num_cores = (unsigned)num_cores;
+}
+
+const cpu_topology_t &get_topology() {
+    static const cpu_topology_t topology = [] {
+        cpu_topology_t t;
+#if DNNL_CPU_TOPOLOGY_SYSFS
+        detect_sysfs(t);
+#endif
+        apply_env_overrides(t);
+        return t;
+    }();
+    return topology;
+}
+} // namespace
+
 const char *get_isa_info() {
 #if DNNL_X64
     return x64::get_isa_info();
@@ -49,7 +178,8 @@ bool has_data_type_support(data_type_t data_type) {
 #if DNNL_X64
             return x64::mayiuse(x64::avx512_core);
 #else
-            return false;
+            // bf16 is converted in software, gemm via ref_gemm_bf16bf16f32
+            return true;
 #endif
         case data_type::f16: return false;
         default: return true;
@@ -72,6 +202,9 @@ unsigned get_per_core_cache_size(int level) {
         }
     };
 
+    if (level >= 1 && level <= 3 && get_topology().cache_size[level] > 0)
+        return get_topology().cache_size[level];
+
 #if DNNL_X64
     using x64::cpu;
     if (cpu.getDataCacheLevels() == 0) return guess(level);
@@ -87,6 +220,7 @@ unsigned get_per_core_cache_size(int level) {
 }
 
 unsigned get_num_cores() {
+    if (get_topology().num_cores > 0) return get_topology().num_cores;
 #if DNNL_X64
     return x64::cpu.getNumCores(Xbyak::util::CoreLevel);
 #elif defined(__ve)
@@ -17,6 +17,8 @@
 #ifndef CPU_PLATFORM_HPP
 #define CPU_PLATFORM_HPP
 
+#include <stdlib.h>
+
 #include "dnnl_config.h"
 #if defined(__ve)
 #include "cpu/ve/cpu_isa_traits.hpp"
@@ -65,6 +67,29 @@ namespace impl {
 namespace cpu {
 namespace platform {
 
+// Calls f(cpu) for every CPU of a list in the Linux format, like "0-3,8-11",
+// and returns their number. Parsing stops at the first malformed entry.
+template <typename F>
+unsigned for_each_cpulist_entry(const char *s, F f) {
+    unsigned n = 0;
+    while (*s) {
+        char *end = nullptr;
+        const long lo = strtol(s, &end, 10);
+        if (end == s) break;
+        long hi = lo;
+        if (*end == '-') hi = strtol(end + 1, &end, 10);
+        for (long c = lo; c <= hi; ++c, ++n)
+            f(c);
+        s = *end == ',' ? end + 1 : end;
+        if (end == s && *s) break;
+    }
+    return n;
+}
+
+inline unsigned cpulist_count(const char *s) {
+    return for_each_cpulist_entry(s, [](long) {});
+}
+
 const char *get_isa_info();
 status_t set_max_cpu_isa(dnnl_cpu_isa_t isa);
 
@@ -79,6 +104,16 @@ constexpr int get_cache_line_size() {
 
 int get_vector_register_size();
 
+// Length of the strips the portable kernels cut their element-wise loops
+// into, so every stage of a strip stays in vector registers
+constexpr int get_max_vector_length() {
+#if defined(__ve)
+    return 256;
+#else
+    return 32;
+#endif
+}
+
 } // namespace platform
 
 // XXX: find a better place for these values?
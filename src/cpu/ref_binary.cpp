@@ -23,6 +23,7 @@
 #include "common/math_utils.hpp"
 #include "common/nstl.hpp"
 #include "common/type_helpers.hpp"
+#include "common/ve/memory_desc_wrapper_opt.hpp"
 #include "cpu/simple_q10n.hpp"
 
 #include "cpu/ref_binary.hpp"
@@ -94,8 +95,8 @@ void ref_binary_t<src0_type, src1_type, dst_type>::execute_ref(
     const auto src1 = CTX_IN_MEM(const src1_data_t *, DNNL_ARG_SRC_1);
     auto dst = CTX_OUT_MEM(dst_data_t *, DNNL_ARG_DST);
 
-    const memory_desc_wrapper src0_d(pd()->src_md(0));
-    const memory_desc_wrapper src1_d(pd()->src_md(1));
+    const memory_desc_wrapper_opt src0_d(pd()->src_md(0));
+    const memory_desc_wrapper_opt src1_d(pd()->src_md(1));
 
     const auto alg = pd()->desc()->alg_kind;
 
@@ -127,13 +128,18 @@ void ref_binary_t<src0_type, src1_type, dst_type>::execute_ref(
     params_t params {alg, do_sum, sum_scale, eltwise_ker_, scales,
             do_scale_src0, do_scale_src1};
 
+    const dims_fast_div_t &div_A = pd()->src0_dims_div();
     auto map_idx_B = [&](dim_t off) {
         dims_t dims;
-        for (int d = ndims - 1; d >= 0; --d) {
-            dims[d] = off % dims_A[d];
-            off /= dims_A[d];
+        if (div_A.ok()) {
+            div_A.coords(off, dims);
+        } else {
+            for (int d = ndims - 1; d >= 0; --d) {
+                dims[d] = off % dims_A[d];
+                off /= dims_A[d];
+            }
+            assert(off == 0);
         }
-        assert(off == 0);
 
         for (int d = 0; d < ndims; ++d) {
             dims[d] *= (!dims_bcast[d]);
@@ -142,10 +148,32 @@ void ref_binary_t<src0_type, src1_type, dst_type>::execute_ref(
         return src1_d.off_v(dims);
     };
 
-    parallel_nd(nelems_A, [&](dim_t i) {
-        auto off_A = src0_d.off_l(i);
-        auto off_B = is_tensor_op ? src1_d.off_l(i) : map_idx_B(i);
-        perform_op(&dst[off_A], src0[off_A], src1[off_B], params);
+    if (!VecOffsetsFor::ok(src0_d) || !VecOffsetsFor::ok(src1_d)) {
+        parallel_nd_cost(elementwise_item_cost, nelems_A, [&](dim_t i) {
+            auto off_A = src0_d.off_l(i);
+            auto off_B = is_tensor_op ? src1_d.off_l(i) : map_idx_B(i);
+            perform_op(&dst[off_A], src0[off_A], src1[off_B], params);
+        });
+        return;
+    }
+
+    // offsets of src0 (and dst) and src1 (broadcast coords zeroed) are
+    // produced MVL at a time from the same coordinates
+    const int nthr_max = nthr_for_cost(0, nelems_A, elementwise_item_cost);
+    parallel(nthr_max, [&](const int ithr, const int nthr) {
+        dim_t start = 0, end = 0;
+        balance211(nelems_A, nthr, ithr, start, end);
+        dim_t off_B[MVL];
+        for (VecOffsetsFor it(src0_d, start, end); it; ++it) {
+            const dim_t *off_A = it.off();
+            if (is_tensor_op)
+                it.off_of(src1_d, off_B);
+            else
+                it.off_of(src1_d, off_B, dims_bcast);
+            for (unsigned i = 0; i < it.get_vl(); ++i)
+                perform_op(&dst[off_A[i]], src0[off_A[i]], src1[off_B[i]],
+                        params);
+        }
     });
 }
 
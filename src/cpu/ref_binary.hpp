@@ -20,6 +20,7 @@
 #include <assert.h>
 
 #include "common/c_types_map.hpp"
+#include "common/fast_div.hpp"
 #include "common/primitive.hpp"
 #include "common/type_helpers.hpp"
 #include "common/utils.hpp"
@@ -62,10 +63,17 @@ struct ref_binary_t : public primitive_t {
                     && attr_post_ops_ok();
             if (!ok) return status::unimplemented;
 
+            src0_dims_div_.init(ndims(), src_md(0)->dims);
+
             return status::success;
         }
 
+        /** divisors for logical src0 offset -> coords, !ok() if too big */
+        const dims_fast_div_t &src0_dims_div() const { return src0_dims_div_; }
+
     private:
+        dims_fast_div_t src0_dims_div_;
+
         bool check_scales_mask() const {
             for (const auto &s : attr()->scales_.scales_) {
                 if (s.second.mask_ != 0) return false;
@@ -136,6 +136,12 @@ float ref_eltwise_scalar_fwd_t::compute_scalar(float s) {
     return compute_eltwise_scalar_fwd(alg_, s, alpha_, beta_) * scale_;
 }
 
+void ref_eltwise_scalar_fwd_t::compute_vec_reg(
+        float *const dst, float const *const src, int const vl) {
+    for (int i = 0; i < vl; ++i)
+        dst[i] = compute_scalar(src[i]);
+}
+
 template <impl::data_type_t data_type>
 void ref_eltwise_fwd_t<data_type>::execute_forward_nCspBc_padded(
         const exec_ctx_t &ctx) const {
@@ -192,11 +198,18 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_generic(
     const float beta = pd()->desc()->beta;
     const int ndims = pd()->desc()->data_desc.ndims;
 
-    parallel_nd(
-            MB, C, D, H, W, [&](dim_t n, dim_t c, dim_t d, dim_t h, dim_t w) {
-                auto data_off = DATA_OFF(data_d, n, c, d, h, w);
-                dst[data_off] = compute_eltwise_scalar_fwd(
-                        alg_kind, src[data_off], alpha, beta);
+    // offsets of a whole batch first, so that the per-point work is a plain
+    // loop rather than a lambda call per element
+    parallel_nd_vec(MB, C, D, H, W,
+            [&](const dim_t *n, const dim_t *c, const dim_t *d,
+                    const dim_t *h, const dim_t *w, int vl) {
+                dim_t data_off[nd_vec_len];
+                for (int i = 0; i < vl; ++i)
+                    data_off[i] = DATA_OFF(
+                            data_d, n[i], c[i], d[i], h[i], w[i]);
+                for (int i = 0; i < vl; ++i)
+                    dst[data_off[i]] = compute_eltwise_scalar_fwd(
+                            alg_kind, src[data_off[i]], alpha, beta);
             });
 }
 
@@ -218,12 +231,12 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
 
     if (alg_kind == eltwise_relu) {
         // a fast path for relu as the most popular activation
-        parallel_nd(
-                nelems, [&](ptrdiff_t e) { dst[e] = relu_fwd(src[e], alpha); });
+        parallel_nd_cost(1, nelems,
+                [&](ptrdiff_t e) { dst[e] = relu_fwd(src[e], alpha); });
         return;
     }
 
-    parallel_nd(nelems, [&](ptrdiff_t e) {
+    parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) {
         const data_t s = src[e];
         data_t &d = dst[e];
         d = compute_eltwise_scalar_fwd(alg_kind, s, alpha, beta);
@@ -254,14 +267,23 @@ void ref_eltwise_bwd_t<data_type>::execute_backward_generic(
     const float beta = pd()->desc()->beta;
     const int ndims = pd()->desc()->data_desc.ndims;
 
-    parallel_nd(
-            MB, C, D, H, W, [&](dim_t n, dim_t c, dim_t d, dim_t h, dim_t w) {
-                auto data_off = DATA_OFF(data_d, n, c, d, h, w);
-                auto diff_data_off = DATA_OFF(diff_data_d, n, c, d, h, w);
-                data_t s = src[data_off];
-                data_t dd = diff_dst[diff_data_off];
-                data_t &ds = diff_src[diff_data_off];
-                ds = compute_eltwise_scalar_bwd(alg_kind, dd, s, alpha, beta);
+    parallel_nd_vec(MB, C, D, H, W,
+            [&](const dim_t *n, const dim_t *c, const dim_t *d,
+                    const dim_t *h, const dim_t *w, int vl) {
+                dim_t data_off[nd_vec_len], diff_data_off[nd_vec_len];
+                for (int i = 0; i < vl; ++i) {
+                    data_off[i] = DATA_OFF(
+                            data_d, n[i], c[i], d[i], h[i], w[i]);
+                    diff_data_off[i] = DATA_OFF(
+                            diff_data_d, n[i], c[i], d[i], h[i], w[i]);
+                }
+                for (int i = 0; i < vl; ++i) {
+                    data_t s = src[data_off[i]];
+                    data_t dd = diff_dst[diff_data_off[i]];
+                    data_t &ds = diff_src[diff_data_off[i]];
+                    ds = compute_eltwise_scalar_bwd(
+                            alg_kind, dd, s, alpha, beta);
+                }
             });
 }
 
@@ -285,7 +307,8 @@ void ref_eltwise_bwd_t<data_type::f32>::execute_backward_dense(
     diff_dst += diff_data_d.offset0();
     diff_src += diff_data_d.offset0();
 
-    parallel(0, [&](const int ithr, const int nthr) {
+    const int nthr_max = nthr_for_cost(0, nelems, elementwise_item_cost);
+    parallel(nthr_max, [&](const int ithr, const int nthr) {
         dim_t start = 0, end = 0;
         balance211(nelems, nthr, ithr, start, end);
         if (start == end) return;
@@ -323,7 +346,8 @@ void ref_eltwise_bwd_t<data_type::bf16>::execute_backward_dense(
     diff_dst += diff_data_d.offset0();
     diff_src += diff_data_d.offset0();
 
-    parallel(0, [&](const int ithr, const int nthr) {
+    const int nthr_max = nthr_for_cost(0, nelems, elementwise_item_cost);
+    parallel(nthr_max, [&](const int ithr, const int nthr) {
         dim_t start = 0, end = 0;
         balance211(nelems, nthr, ithr, start, end);
         if (start == end) return;
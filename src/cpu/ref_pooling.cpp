@@ -21,6 +21,7 @@
 #include "common/dnnl_thread.hpp"
 #include "common/nstl.hpp"
 #include "common/type_helpers.hpp"
+#include "common/ve/memory_desc_wrapper_opt.hpp"
 
 #include "cpu/simple_q10n.hpp"
 
@@ -30,8 +31,9 @@ namespace dnnl {
 namespace impl {
 namespace cpu {
 
+template <typename mdw_t>
 static inline dim_t get_offset(
-        const memory_desc_wrapper &mdw, int n, int c, int d, int h, int w) {
+        const mdw_t &mdw, int n, int c, int d, int h, int w) {
     switch (mdw.ndims()) {
         case 3: return mdw.off(n, c, w);
         case 4: return mdw.off(n, c, h, w);
@@ -51,9 +53,9 @@ void ref_pooling_fwd_t<data_type, acc_type>::execute_forward(
     auto dst = CTX_OUT_MEM(data_t *, DNNL_ARG_DST);
     auto ws = CTX_OUT_MEM(unsigned char *, DNNL_ARG_WORKSPACE);
 
-    const memory_desc_wrapper src_d(pd()->src_md());
-    const memory_desc_wrapper dst_d(pd()->dst_md());
-    const memory_desc_wrapper ws_d(pd()->workspace_md());
+    const memory_desc_wrapper_opt src_d(pd()->src_md());
+    const memory_desc_wrapper_opt dst_d(pd()->dst_md());
+    const memory_desc_wrapper_opt ws_d(pd()->workspace_md());
 
     auto alg = pd()->desc()->alg_kind;
     const data_type_t ws_dt = ws ? ws_d.data_type() : data_type::undef;
@@ -138,6 +140,102 @@ void ref_pooling_fwd_t<data_type, acc_type>::execute_forward(
     const int OH = pd()->OH();
     const int OW = pd()->OW();
 
+    if (VecOffsetsFor::ok(src_d) && VecOffsetsFor::ok(dst_d)
+            && IMPLICATION(ws, VecOffsetsFor::ok(ws_d))) {
+        // dst (ws) offsets MVL at a time; for every kernel position the src
+        // offsets of the whole batch come from one vec_off_vtmp call. Lanes
+        // outside the input are masked, so every lane sees its window in
+        // the same order as ker_max / ker_avg.
+        const int ndims = dst_d.ndims();
+        const bool is_max = alg == alg_kind::pooling_max;
+        parallel(0, [&](const int ithr, const int nthr) {
+            dim_t start = 0, end = 0;
+            balance211(dst_d.nelems(), nthr, ithr, start, end);
+            VecOffsetsFor::VecPos vp;
+            dim_t src_off[MVL], ws_off[MVL];
+            int od[MVL], oh[MVL], ow[MVL], ws_val[MVL], num[MVL];
+            bool valid[MVL];
+            data_t d_max[MVL];
+            acc_data_t d_sum[MVL];
+            for (VecOffsetsFor it(dst_d, start, end); it; ++it) {
+                const unsigned vl = it.get_vl();
+                for (unsigned i = 0; i < vl; ++i) {
+                    od[i] = ndims == 5 ? (int)it.vp[2][i] : 0;
+                    oh[i] = ndims >= 4 ? (int)it.vp[ndims - 2][i] : 0;
+                    ow[i] = (int)it.vp[ndims - 1][i];
+                    d_max[i] = numeric_limits<data_t>::lowest();
+                    d_sum[i] = 0;
+                    ws_val[i] = 0;
+                }
+                if (!is_max) {
+                    for (unsigned i = 0; i < vl; ++i) {
+                        const int id_start = max(od[i] * SD - padF, 0);
+                        const int ih_start = max(oh[i] * SH - padT, 0);
+                        const int iw_start = max(ow[i] * SW - padL, 0);
+                        const int id_end = min(od[i] * SD - padF + KD, ID);
+                        const int ih_end = min(oh[i] * SH - padT + KH, IH);
+                        const int iw_end = min(ow[i] * SW - padL + KW, IW);
+                        num[i] = (alg == alg_kind::pooling_avg_include_padding)
+                                ? KW * KH * KD
+                                : (id_end - id_start) * (ih_end - ih_start)
+                                        * (iw_end - iw_start);
+                    }
+                }
+                for_(int kd = 0; kd < KD; ++kd)
+                for_(int kh = 0; kh < KH; ++kh)
+                for (int kw = 0; kw < KW; ++kw) {
+                    // vec_off_vtmp clobbers vp with blocked layouts: all
+                    // of the coords are set for every call
+                    for (unsigned i = 0; i < vl; ++i) {
+                        vp.vp[0][i] = it.vp[0][i];
+                        vp.vp[1][i] = it.vp[1][i];
+                        const int id = od[i] * SD - padF + kd;
+                        const int ih = oh[i] * SH - padT + kh;
+                        const int iw = ow[i] * SW - padL + kw;
+                        valid[i] = id >= 0 && id < ID && ih >= 0 && ih < IH
+                                && iw >= 0 && iw < IW;
+                        if (ndims == 5) vp.vp[2][i] = valid[i] ? id : 0;
+                        if (ndims >= 4) vp.vp[ndims - 2][i] = valid[i] ? ih : 0;
+                        vp.vp[ndims - 1][i] = valid[i] ? iw : 0;
+                    }
+                    src_d.vec_off_vtmp(vp, src_off, vl);
+                    if (is_max) {
+                        const int k_idx = (kd * KH + kh) * KW + kw;
+                        for (unsigned i = 0; i < vl; ++i) {
+                            if (!valid[i]) continue;
+                            const data_t s = src[src_off[i]];
+                            if (s > d_max[i]) {
+                                d_max[i] = s;
+                                ws_val[i] = k_idx;
+                            }
+                        }
+                    } else {
+                        for (unsigned i = 0; i < vl; ++i)
+                            if (valid[i]) d_sum[i] += src[src_off[i]];
+                    }
+                }
+                const dim_t *dst_off = it.off();
+                if (!is_max) {
+                    for (unsigned i = 0; i < vl; ++i)
+                        dst[dst_off[i]] = out_round<data_t>(
+                                (float)d_sum[i] / num[i]);
+                    continue;
+                }
+                for (unsigned i = 0; i < vl; ++i)
+                    dst[dst_off[i]] = d_max[i];
+                if (!ws) continue;
+                it.off_of(ws_d, ws_off);
+                for (unsigned i = 0; i < vl; ++i) {
+                    if (ws_dt == data_type::u8)
+                        ws[ws_off[i]] = ws_val[i];
+                    else
+                        reinterpret_cast<int *>(ws)[ws_off[i]] = ws_val[i];
+                }
+            }
+        });
+        return;
+    }
+
     if (alg == alg_kind::pooling_max) {
         parallel_nd(MB, OC, OD, OH, OW,
                 [&](int mb, int oc, int od, int oh, int ow) {
@@ -164,9 +262,9 @@ void ref_pooling_bwd_t<data_type>::execute_backward(
     auto ws = CTX_IN_MEM(const unsigned char *, DNNL_ARG_WORKSPACE);
     auto diff_src = CTX_OUT_MEM(data_t *, DNNL_ARG_DIFF_SRC);
 
-    const memory_desc_wrapper diff_dst_d(pd()->diff_dst_md());
-    const memory_desc_wrapper diff_src_d(pd()->diff_src_md());
-    const memory_desc_wrapper ws_d(pd()->workspace_md());
+    const memory_desc_wrapper_opt diff_dst_d(pd()->diff_dst_md());
+    const memory_desc_wrapper_opt diff_src_d(pd()->diff_src_md());
+    const memory_desc_wrapper_opt ws_d(pd()->workspace_md());
 
     const auto alg = pd()->desc()->alg_kind;
 
@@ -254,6 +352,74 @@ void ref_pooling_bwd_t<data_type>::execute_backward(
     int od_start = max(0, utils::div_up(padF - KD + 1, SD));
     int od_end = min(OD, 1 + (padF + ID - 1) / SD);
 
+    if (VecOffsetsFor::ok(diff_src_d) && VecOffsetsFor::ok(diff_dst_d)
+            && IMPLICATION(alg == alg_kind::pooling_max,
+                    VecOffsetsFor::ok(ws_d))) {
+        // Per (mb, oc): zero diff_src and walk diff_dst with batched
+        // offsets. Accumulation into diff_src stays in od, oh, ow order.
+        const int ndims = diff_src_d.ndims();
+        const int sp_in[3] = {ID, IH, IW};
+        const int sp_start[3] = {od_start, oh_start, ow_start};
+        const int sp_end[3] = {od_end, oh_end, ow_end};
+        parallel_nd(MB, OC, [&](int mb, int oc) {
+            dim_t lo[5] = {mb, oc}, hi[5] = {mb + 1, oc + 1};
+            for (int c = 2; c < ndims; ++c) {
+                lo[c] = 0;
+                hi[c] = sp_in[c - ndims + 3];
+            }
+            for (VecOffsetsFor it(diff_src_d, lo, hi); it; ++it) {
+                const dim_t *off = it.off();
+                for (unsigned i = 0; i < it.get_vl(); ++i)
+                    diff_src[off[i]] = data_type_t(0);
+            }
+
+            for (int c = 2; c < ndims; ++c) {
+                lo[c] = sp_start[c - ndims + 3];
+                hi[c] = sp_end[c - ndims + 3];
+            }
+            VecOffsetsFor::VecPos vp;
+            dim_t ws_off[MVL], src_off[MVL];
+            bool valid[MVL];
+            for (VecOffsetsFor it(diff_dst_d, lo, hi); it; ++it) {
+                const unsigned vl = it.get_vl();
+                const dim_t *dst_off = it.off();
+                auto od = [&](unsigned i) {
+                    return ndims == 5 ? (int)it.vp[2][i] : 0;
+                };
+                auto oh = [&](unsigned i) {
+                    return ndims >= 4 ? (int)it.vp[ndims - 2][i] : 0;
+                };
+                auto ow = [&](unsigned i) { return (int)it.vp[ndims - 1][i]; };
+                if (alg != alg_kind::pooling_max) {
+                    for (unsigned i = 0; i < vl; ++i)
+                        ker_avg(&diff_dst[dst_off[i]], mb, oc, od(i), oh(i),
+                                ow(i));
+                    continue;
+                }
+                it.off_of(ws_d, ws_off);
+                for (unsigned i = 0; i < vl; ++i) {
+                    const int index = ws_d.data_type() == data_type::u8
+                            ? (int)ws[ws_off[i]]
+                            : ((int *)ws)[ws_off[i]];
+                    const int id = od(i) * SD - padF + (index / KW) / KH;
+                    const int ih = oh(i) * SH - padT + (index / KW) % KH;
+                    const int iw = ow(i) * SW - padL + index % KW;
+                    valid[i] = id >= 0 && id < ID && ih >= 0 && ih < IH
+                            && iw >= 0 && iw < IW;
+                    vp.vp[0][i] = mb;
+                    vp.vp[1][i] = oc;
+                    if (ndims == 5) vp.vp[2][i] = valid[i] ? id : 0;
+                    if (ndims >= 4) vp.vp[ndims - 2][i] = valid[i] ? ih : 0;
+                    vp.vp[ndims - 1][i] = valid[i] ? iw : 0;
+                }
+                diff_src_d.vec_off_vtmp(vp, src_off, vl);
+                for (unsigned i = 0; i < vl; ++i)
+                    if (valid[i]) diff_src[src_off[i]] += diff_dst[dst_off[i]];
+            }
+        });
+        return;
+    }
+
     if (alg == alg_kind::pooling_max) {
         parallel_nd(MB, OC, [&](int mb, int oc) {
             ker_zero(mb, oc);
@@ -22,6 +22,7 @@
 #include "common/dnnl_thread.hpp"
 #include "common/math_utils.hpp"
 #include "common/type_helpers.hpp"
+#include "common/ve/memory_desc_wrapper_opt.hpp"
 
 #include "cpu/resampling_utils.hpp"
 
@@ -31,8 +32,9 @@ namespace dnnl {
 namespace impl {
 namespace cpu {
 
+template <typename mdw_t>
 static inline dim_t get_offset(
-        const memory_desc_wrapper &data_d, int n, int c, int d, int h, int w) {
+        const mdw_t &data_d, int n, int c, int d, int h, int w) {
     if (data_d.ndims() == 5)
         return data_d.off(n, c, d, h, w);
     else if (data_d.ndims() == 4)
@@ -51,8 +53,8 @@ void ref_resampling_fwd_t<data_type>::execute_forward(
     const auto src = CTX_IN_MEM(const data_t *, DNNL_ARG_SRC);
     auto dst = CTX_OUT_MEM(data_t *, DNNL_ARG_DST);
 
-    const memory_desc_wrapper src_d(pd()->src_md());
-    const memory_desc_wrapper dst_d(pd()->dst_md());
+    const memory_desc_wrapper_opt src_d(pd()->src_md());
+    const memory_desc_wrapper_opt dst_d(pd()->dst_md());
 
     const auto alg = pd()->desc()->alg_kind;
 
@@ -82,6 +84,86 @@ void ref_resampling_fwd_t<data_type>::execute_forward(
         return lin_interp(bilin_interp(c000, c010, c100, c110, w0, w1),
                 bilin_interp(c001, c011, c101, c111, w0, w1), w2);
     };
+    if (VecOffsetsFor::ok(src_d) && VecOffsetsFor::ok(dst_d)) {
+        // Batched offsets: dst coords come MVL at a time; src coords are
+        // derived per spatial dim k (d, h, w; coordinate ndims - 3 + k, absent
+        // dims stay at 0 as in get_offset) and mapped by vec_off_vtmp.
+        const int ndims = dst_d.ndims();
+        const float F[3] = {FD, FH, FW};
+        const dim_t I[3] = {ID, IH, IW};
+        parallel(0, [&](const int ithr, const int nthr) {
+            dim_t start = 0, end = 0;
+            balance211(dst_d.nelems(), nthr, ithr, start, end);
+            VecOffsetsFor::VecPos vp;
+            dim_t src_off[MVL];
+            for (VecOffsetsFor it(dst_d, start, end); it; ++it) {
+                const unsigned vl = it.get_vl();
+                const dim_t *dst_off = it.off();
+                auto set_nsp = [&]() { // batch and channel coords
+                    for (int c = 0; c < 2; ++c)
+                        for (unsigned i = 0; i < vl; ++i)
+                            vp.vp[c][i] = it.vp[c][i];
+                };
+                if (alg == alg_kind::resampling_nearest) {
+                    set_nsp();
+                    for (int c = 2; c < ndims; ++c) {
+                        const float f = F[c - ndims + 3];
+                        for (unsigned i = 0; i < vl; ++i)
+                            vp.vp[c][i] = nearest_idx(it.vp[c][i], f);
+                    }
+                    src_d.vec_off_vtmp(vp, src_off, vl);
+                    for (unsigned i = 0; i < vl; ++i)
+                        dst[dst_off[i]] = src[src_off[i]];
+                    continue;
+                }
+                // resampling_linear: same corners and interpolation order
+                // as the scalar path below
+                dim_t idx[3][2][MVL];
+                float wei[3][MVL];
+                for (int k = 0; k < 3; ++k) {
+                    const int c = ndims - 3 + k;
+                    for (unsigned i = 0; i < vl; ++i) {
+                        linear_coeffs_t lc(
+                                c >= 2 ? (dim_t)it.vp[c][i] : 0, F[k], I[k]);
+                        idx[k][0][i] = lc.idx[0];
+                        idx[k][1][i] = lc.idx[1];
+                        wei[k][i] = lc.wei[0];
+                    }
+                }
+                data_t src_l[8][MVL];
+                for (int corner = 0; corner < 8; ++corner) {
+                    const int ijk[3]
+                            = {corner >> 2, (corner >> 1) & 1, corner & 1};
+                    if (ijk[0] && ndims < 5) { // no d: same as i == 0
+                        for (unsigned i = 0; i < vl; ++i)
+                            src_l[corner][i] = src_l[corner - 4][i];
+                        continue;
+                    }
+                    if (ijk[1] && ndims < 4) { // no h: same as j == 0
+                        for (unsigned i = 0; i < vl; ++i)
+                            src_l[corner][i] = src_l[corner - 2][i];
+                        continue;
+                    }
+                    set_nsp();
+                    for (int c = 2; c < ndims; ++c) {
+                        const int k = c - ndims + 3;
+                        for (unsigned i = 0; i < vl; ++i)
+                            vp.vp[c][i] = idx[k][ijk[k]][i];
+                    }
+                    src_d.vec_off_vtmp(vp, src_off, vl);
+                    for (unsigned i = 0; i < vl; ++i)
+                        src_l[corner][i] = src[src_off[i]];
+                }
+                for (unsigned i = 0; i < vl; ++i)
+                    dst[dst_off[i]] = trilin_interp(src_l[0][i], src_l[1][i],
+                            src_l[2][i], src_l[3][i], src_l[4][i],
+                            src_l[5][i], src_l[6][i], src_l[7][i], wei[0][i],
+                            wei[1][i], wei[2][i]);
+            }
+        });
+        return;
+    }
+
     parallel_nd(MB, C, OD, OH, OW,
             [&](dim_t mb, dim_t ch, dim_t od, dim_t oh, dim_t ow) {
                 if (alg == alg_kind::resampling_nearest) {
@@ -130,8 +212,8 @@ void ref_resampling_bwd_t<data_type>::execute_backward(
     const auto diff_dst = CTX_IN_MEM(const data_t *, DNNL_ARG_DIFF_DST);
     auto diff_src = CTX_OUT_MEM(data_t *, DNNL_ARG_DIFF_SRC);
 
-    const memory_desc_wrapper diff_src_d(pd()->diff_src_md());
-    const memory_desc_wrapper diff_dst_d(pd()->diff_dst_md());
+    const memory_desc_wrapper_opt diff_src_d(pd()->diff_src_md());
+    const memory_desc_wrapper_opt diff_dst_d(pd()->diff_dst_md());
 
     const auto alg = pd()->desc()->alg_kind;
 
@@ -147,51 +229,74 @@ void ref_resampling_bwd_t<data_type>::execute_backward(
     const float FH = pd()->FH();
     const float FW = pd()->FW();
 
-    if (alg == alg_kind::resampling_nearest) {
-        parallel_nd(MB, C, ID, IH, IW,
-                [&](dim_t mb, dim_t ch, dim_t id, dim_t ih, dim_t iw) {
-                    const dim_t od_start = ceil_idx(id * FD - 0.5f);
-                    const dim_t oh_start = ceil_idx(ih * FH - 0.5f);
-                    const dim_t ow_start = ceil_idx(iw * FW - 0.5f);
-
-                    const dim_t od_end = ceil_idx((id + 1.f) * FD - 0.5f);
-                    const dim_t oh_end = ceil_idx((ih + 1.f) * FH - 0.5f);
-                    const dim_t ow_end = ceil_idx((iw + 1.f) * FW - 0.5f);
-
-                    float ds = 0;
-                    for_(dim_t od = od_start; od < od_end; od++)
-                    for_(dim_t oh = oh_start; oh < oh_end; oh++)
-                    for (dim_t ow = ow_start; ow < ow_end; ow++)
-                        ds += diff_dst[get_offset(
-                                diff_dst_d, mb, ch, od, oh, ow)];
-                    diff_src[get_offset(diff_src_d, mb, ch, id, ih, iw)] = ds;
-                });
+    auto ker_nearest = [&](dim_t mb, dim_t ch, dim_t id, dim_t ih, dim_t iw) {
+        const dim_t od_start = ceil_idx(id * FD - 0.5f);
+        const dim_t oh_start = ceil_idx(ih * FH - 0.5f);
+        const dim_t ow_start = ceil_idx(iw * FW - 0.5f);
+
+        const dim_t od_end = ceil_idx((id + 1.f) * FD - 0.5f);
+        const dim_t oh_end = ceil_idx((ih + 1.f) * FH - 0.5f);
+        const dim_t ow_end = ceil_idx((iw + 1.f) * FW - 0.5f);
+
+        float ds = 0;
+        for_(dim_t od = od_start; od < od_end; od++)
+        for_(dim_t oh = oh_start; oh < oh_end; oh++)
+        for (dim_t ow = ow_start; ow < ow_end; ow++)
+            ds += diff_dst[get_offset(diff_dst_d, mb, ch, od, oh, ow)];
+        return ds;
+    };
+
+    auto ker_linear = [&](dim_t mb, dim_t ch, dim_t id, dim_t ih, dim_t iw) {
+        bwd_linear_coeffs_t d(id, FD, ID, OD);
+        bwd_linear_coeffs_t h(ih, FH, IH, OH);
+        bwd_linear_coeffs_t w(iw, FW, IW, OW);
+
+        float ds = 0;
+        for_(int i = 0; i < 2; i++)
+        for_(int j = 0; j < 2; j++)
+        for_(int k = 0; k < 2; k++)
+        for_(dim_t od = d.start[i]; od < d.end[i]; od++)
+        for_(dim_t oh = h.start[j]; oh < h.end[j]; oh++)
+        for (dim_t ow = w.start[k]; ow < w.end[k]; ow++) {
+            const float weight_d = linear_weight(i, od, FD);
+            const float weight_h = linear_weight(j, oh, FH);
+            const float weight_w = linear_weight(k, ow, FW);
+
+            float dd = diff_dst[get_offset(diff_dst_d, mb, ch, od, oh, ow)];
+            ds += dd * weight_d * weight_h * weight_w;
+        }
+        return ds;
+    };
+
+    const bool nearest = alg == alg_kind::resampling_nearest;
+
+    if (VecOffsetsFor::ok(diff_src_d)) {
+        // diff_src offsets (and coords) MVL at a time
+        const int ndims = diff_src_d.ndims();
+        parallel(0, [&](const int ithr, const int nthr) {
+            dim_t start = 0, end = 0;
+            balance211(diff_src_d.nelems(), nthr, ithr, start, end);
+            for (VecOffsetsFor it(diff_src_d, start, end); it; ++it) {
+                const dim_t *off = it.off();
+                for (unsigned i = 0; i < it.get_vl(); ++i) {
+                    const dim_t mb = it.vp[0][i], ch = it.vp[1][i];
+                    const dim_t id = ndims == 5 ? it.vp[2][i] : 0;
+                    const dim_t ih = ndims >= 4 ? it.vp[ndims - 2][i] : 0;
+                    const dim_t iw = it.vp[ndims - 1][i];
+                    diff_src[off[i]] = nearest ? ker_nearest(mb, ch, id, ih, iw)
+                                               : ker_linear(mb, ch, id, ih, iw);
+                }
+            }
+        });
         return;
-    } else {
-        parallel_nd(MB, C, ID, IH, IW,
-                [&](dim_t mb, dim_t ch, dim_t id, dim_t ih, dim_t iw) {
-                    bwd_linear_coeffs_t d(id, FD, ID, OD);
-                    bwd_linear_coeffs_t h(ih, FH, IH, OH);
-                    bwd_linear_coeffs_t w(iw, FW, IW, OW);
-
-                    float ds = 0;
-                    for_(int i = 0; i < 2; i++)
-                    for_(int j = 0; j < 2; j++)
-                    for_(int k = 0; k < 2; k++)
-                    for_(dim_t od = d.start[i]; od < d.end[i]; od++)
-                    for_(dim_t oh = h.start[j]; oh < h.end[j]; oh++)
-                    for (dim_t ow = w.start[k]; ow < w.end[k]; ow++) {
-                        const float weight_d = linear_weight(i, od, FD);
-                        const float weight_h = linear_weight(j, oh, FH);
-                        const float weight_w = linear_weight(k, ow, FW);
-
-                        float dd = diff_dst[get_offset(
-                                diff_dst_d, mb, ch, od, oh, ow)];
-                        ds += dd * weight_d * weight_h * weight_w;
-                    }
-                    diff_src[get_offset(diff_src_d, mb, ch, id, ih, iw)] = ds;
-                });
     }
+
+    parallel_nd(MB, C, ID, IH, IW,
+            [&](dim_t mb, dim_t ch, dim_t id, dim_t ih, dim_t iw) {
+                diff_src[get_offset(diff_src_d, mb, ch, id, ih, iw)] = nearest
+                        ? ker_nearest(mb, ch, id, ih, iw)
+                        : ker_linear(mb, ch, id, ih, iw);
+            });
 }
 
 template struct ref_resampling_bwd_t<data_type::f32>;
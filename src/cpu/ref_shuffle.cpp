@@ -20,6 +20,7 @@
 #include "common/c_types_map.hpp"
 #include "common/dnnl_thread.hpp"
 #include "common/type_helpers.hpp"
+#include "common/ve/memory_desc_wrapper_opt.hpp"
 
 #include "cpu/ref_shuffle.hpp"
 
@@ -35,7 +36,7 @@ void ref_shuffle_t<data_type_size>::execute_(const exec_ctx_t &ctx) const {
     using namespace prop_kind;
     using namespace utils;
 
-    const memory_desc_wrapper data_d(pd()->data_md());
+    const memory_desc_wrapper_opt data_d(pd()->data_md());
 
     auto i_arg = pd()->is_fwd() ? DNNL_ARG_SRC : DNNL_ARG_DIFF_DST;
     auto o_arg = pd()->is_fwd() ? DNNL_ARG_DST : DNNL_ARG_DIFF_SRC;
@@ -112,6 +113,30 @@ void ref_shuffle_t<data_type_size>::execute_(const exec_ctx_t &ctx) const {
                 output[output_off + sp] = input[input_off + sp];
             }
         });
+    } else if (VecOffsetsFor::ok(data_d)) {
+        // output offsets come from the coordinates, input offsets from the
+        // same coordinates with the axis index shuffled
+        parallel(0, [&](const int ithr, const int nthr) {
+            dim_t start = 0, end = 0;
+            balance211(data_d.nelems(), nthr, ithr, start, end);
+            VecOffsetsFor::VecPos vp_in;
+            dim_t off_in[MVL];
+            for (VecOffsetsFor it(data_d, start, end); it; ++it) {
+                const unsigned vl = it.get_vl();
+                for (unsigned d = 0; d < it.get_dim(); ++d) {
+                    if (d == (unsigned)axis)
+                        for (unsigned i = 0; i < vl; ++i)
+                            vp_in.vp[d][i] = rev_transposed_[it.vp[d][i]];
+                    else
+                        for (unsigned i = 0; i < vl; ++i)
+                            vp_in.vp[d][i] = it.vp[d][i];
+                }
+                data_d.vec_off_vtmp(vp_in, off_in, vl);
+                const dim_t *off_out = it.off();
+                for (unsigned i = 0; i < vl; ++i)
+                    output[off_out[i]] = input[off_in[i]];
+            }
+        });
     } else {
         auto dims = pd()->desc()->data_desc.dims;
         auto ndims = pd()->desc()->data_desc.ndims;
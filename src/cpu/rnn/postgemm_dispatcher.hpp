@@ -19,6 +19,8 @@
 
 #include <memory>
 
+#include "common/dnnl_thread.hpp"
+#include "common/utils.hpp"
 #include "common/z_magic.hpp"
 
 #include "cpu/platform.hpp"
@@ -47,6 +49,32 @@ namespace cpu {
 template <alg_kind_t alg_kind, prop_kind_t prop_kind>
 float activation(float s, float alpha, float cliping);
 
+/* Longest run of columns a reference postgemm processes at once: the
+ * kernels keep intermediate rows of that length on the stack so that every
+ * loop is free of branches. 256 is a full vector register on VE. */
+constexpr int postgemm_block = 256;
+
+/* Runs f(i, jb, je) on the columns [jb, je) of the row i of the minibatch,
+ * with je - jb <= postgemm_block. When there are fewer blocks than threads,
+ * the rows are split further, in multiples of 16 columns, so that small
+ * batches keep all the threads busy. */
+template <typename F>
+void postgemm_parallel(const rnn_utils::rnn_conf_t &rnn, const F &f) {
+    const int nthr = dnnl_in_parallel() ? 1 : dnnl_get_max_threads();
+    int n_blk = utils::div_up(rnn.dhc, postgemm_block);
+    if (rnn.mb * n_blk < nthr)
+        n_blk = nstl::max(n_blk,
+                nstl::min(utils::div_up(nthr, rnn.mb),
+                        utils::div_up(rnn.dhc, 64)));
+    const int blk = utils::rnd_up(utils::div_up(rnn.dhc, n_blk), 16);
+    n_blk = utils::div_up(rnn.dhc, blk);
+
+    parallel_nd(rnn.mb, n_blk, [&](int i, int b) {
+        const int jb = b * blk;
+        f(i, jb, nstl::min(jb + blk, rnn.dhc));
+    });
+}
+
 template <prop_kind_t aprop, impl::data_type_t src_type,
         impl::data_type_t scratch_type, impl::data_type_t acc_type>
 struct rnn_postgemm_dispatcher {
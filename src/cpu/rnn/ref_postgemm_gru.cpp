@@ -51,23 +51,38 @@ void gru_fwd_part1_postgemm_template(T1 func1, T2 to_src, const float *scales,
     ws_states_iter_aoc<src_data_t> dst_iter(rnn, dst_iter_, dst_iter_ld);
     ws_states_iter_aoc<const src_data_t> src_iter(rnn, src_iter_, src_iter_ld);
 
-    parallel_nd(rnn.mb, [&](int i) {
+    postgemm_parallel(rnn, [&](int i, int jb, int je) {
+        float H[postgemm_block];
+
         PRAGMA_OMP_SIMD()
-        for (int j = 0; j < rnn.dhc; j++) {
-            auto G0 // default func1 is sigmoid
+        for (int j = jb; j < je; j++) {
+            const float G0 // default func1 is sigmoid
                     = func1(scales, scratch_gates(i, 0, j) + bias(0, j));
-            auto G1 // default func1 is sigmoid
+            const float G1 // default func1 is sigmoid
                     = func1(scales + 1, scratch_gates(i, 1, j) + bias(1, j));
             /* TODO: Can be optimized for fwd_training by using ws_gates instead of scratch_gates in p2 */
             scratch_gates(i, 0, j) = to_src(G0);
             scratch_gates(i, 1, j) = to_src(G1);
-            auto t = to_src(src_iter(i, j) * G1);
-            if (dst_layer_) dst_layer(i, j) = t;
-            if (dst_iter_) dst_iter(i, j) = t;
+            H[j - jb] = src_iter(i, j) * G1;
+        }
 
-            if (rnn.is_training) {
-                ws_gates(i, 0, j) = to_src(G0);
-                ws_gates(i, 1, j) = to_src(G1);
+        // the optional outputs get loops of their own to keep the loops
+        // free of branches
+        if (dst_layer_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_layer(i, j) = to_src(H[j - jb]);
+        }
+        if (dst_iter_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_iter(i, j) = to_src(H[j - jb]);
+        }
+        if (rnn.is_training) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++) {
+                ws_gates(i, 0, j) = to_src(scratch_gates(i, 0, j));
+                ws_gates(i, 1, j) = to_src(scratch_gates(i, 1, j));
             }
         }
     });
@@ -91,18 +106,32 @@ void gru_fwd_part2_postgemm_template(T1 func1, T2 to_src, const float *scales,
     ws_states_iter_aoc<src_data_t> dst_iter(rnn, dst_iter_, dst_iter_ld);
     ws_states_iter_aoc<const src_data_t> src_iter(rnn, src_iter_, src_iter_ld);
 
-    parallel_nd(rnn.mb, [&](int i) {
+    postgemm_parallel(rnn, [&](int i, int jb, int je) {
+        float G2[postgemm_block], H[postgemm_block];
+
         PRAGMA_OMP_SIMD()
-        for (int j = 0; j < rnn.dhc; j++) {
-            auto G0 = scratch_gates(i, 0, j);
-            auto G2 // default func1 is tanh
+        for (int j = jb; j < je; j++) {
+            const int k = j - jb;
+            const float G0 = scratch_gates(i, 0, j);
+            G2[k] // default func1 is tanh
                     = func1(scales + 2, scratch_gates(i, 2, j) + bias(2, j));
+            H[k] = src_iter(i, j) * G0 + (1.0f - G0) * G2[k];
+        }
 
-            auto tmp = to_src(src_iter(i, j) * G0 + (1.0f - G0) * G2);
-            if (dst_layer_ != nullptr) dst_layer(i, j) = tmp;
-            if (dst_iter_ != nullptr) dst_iter(i, j) = tmp;
-
-            if (rnn.is_training) { ws_gates(i, 2, j) = to_src(G2); }
+        if (dst_layer_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_layer(i, j) = to_src(H[j - jb]);
+        }
+        if (dst_iter_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_iter(i, j) = to_src(H[j - jb]);
+        }
+        if (rnn.is_training) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                ws_gates(i, 2, j) = to_src(G2[j - jb]);
         }
     });
 }
@@ -112,7 +141,7 @@ rnn_postgemm_sig(rnn_postgemm_fwd_f32_t::gru_part1_postgemm) {
     const float *scales = pd_->attr()->rnn_tparams_.scales_;
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto logistic_f = [](const float *scale, float a) {
-        return logistic_fwd<float>(a);
+        return fast_logistic_fwd(a);
     };
     auto to_src = [](float a) { return a; };
 
@@ -131,7 +160,7 @@ rnn_postgemm_sig(rnn_postgemm_fwd_f32_t::gru_part2_postgemm) {
     const float *scales = pd_->attr()->rnn_tparams_.scales_;
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto tanh_f
-            = [](const float *scale, float a) { return tanh_fwd<float>(a); };
+            = [](const float *scale, float a) { return fast_tanh_fwd(a); };
     auto to_src = [](float a) { return a; };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
@@ -150,7 +179,7 @@ rnn_postgemm_sig(rnn_postgemm_fwd_bf16_t::gru_part1_postgemm) {
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto to_src = [](float a) { return bfloat16_t(a); };
     auto logistic_f = [](const float *scale, float a) {
-        return logistic_fwd<float>(a);
+        return fast_logistic_fwd(a);
     };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
@@ -167,7 +196,7 @@ rnn_postgemm_sig(rnn_postgemm_fwd_bf16_t::gru_part2_postgemm) {
     const float *scales = pd_->attr()->rnn_tparams_.scales_;
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto tanh_f
-            = [](const float *scale, float a) { return tanh_fwd<float>(a); };
+            = [](const float *scale, float a) { return fast_tanh_fwd(a); };
     auto to_src = [](float a) { return bfloat16_t(a); };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
@@ -54,26 +54,45 @@ void gru_lbr_fwd_postgemm_template(T1 func1, T2 func2, T3 to_src,
     ws_gates_aoc<scratch_data_t> scratch_cell(rnn, scratch_cell_);
     AOC<src_data_t, 2> ws_Wh_b(ws_grid_, rnn.mb, rnn.dhc);
 
-    parallel_nd(rnn.mb, [&](int i) {
+    postgemm_parallel(rnn, [&](int i, int jb, int je) {
+        float G0[postgemm_block], G1[postgemm_block], G2[postgemm_block],
+                Wh_b[postgemm_block], H[postgemm_block];
+
         PRAGMA_OMP_SIMD()
-        for (int j = 0; j < rnn.dhc; j++) {
-            float Wh_b = scratch_cell(i, 2, j) + bias(3, j);
-            auto G0 = func1(scales, // default func1 is sigmoid
+        for (int j = jb; j < je; j++) {
+            const int k = j - jb;
+            Wh_b[k] = scratch_cell(i, 2, j) + bias(3, j);
+            G0[k] = func1(scales, // default func1 is sigmoid
                     scratch_gates(i, 0, j) + scratch_cell(i, 0, j)
                             + bias(0, j));
-            auto G1 = func1(scales + 1, // default func1 is sigmoid
+            G1[k] = func1(scales + 1, // default func1 is sigmoid
                     scratch_gates(i, 1, j) + scratch_cell(i, 1, j)
                             + bias(1, j));
-            auto G2 = func2(scales + 2, // default func2 is tanh
-                    scratch_gates(i, 2, j) + G1 * Wh_b + bias(2, j));
-            auto tmp = to_src(src_iter(i, j) * G0 + (1.0f - G0) * G2);
-            if (dst_layer_ != nullptr) dst_layer(i, j) = tmp;
-            if (dst_iter_ != nullptr) dst_iter(i, j) = tmp;
-            if (rnn.is_training) {
-                ws_gates(i, 0, j) = to_src(G0);
-                ws_gates(i, 1, j) = to_src(G1);
-                ws_gates(i, 2, j) = to_src(G2);
-                ws_Wh_b(i, j) = to_src(Wh_b);
+            G2[k] = func2(scales + 2, // default func2 is tanh
+                    scratch_gates(i, 2, j) + G1[k] * Wh_b[k] + bias(2, j));
+            H[k] = src_iter(i, j) * G0[k] + (1.0f - G0[k]) * G2[k];
+        }
+
+        // the optional outputs get loops of their own to keep the loops
+        // free of branches
+        if (dst_layer_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_layer(i, j) = to_src(H[j - jb]);
+        }
+        if (dst_iter_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_iter(i, j) = to_src(H[j - jb]);
+        }
+        if (rnn.is_training) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++) {
+                const int k = j - jb;
+                ws_gates(i, 0, j) = to_src(G0[k]);
+                ws_gates(i, 1, j) = to_src(G1[k]);
+                ws_gates(i, 2, j) = to_src(G2[k]);
+                ws_Wh_b(i, j) = to_src(Wh_b[k]);
             }
         }
     });
@@ -85,10 +104,10 @@ rnn_postgemm_sig(rnn_postgemm_fwd_f32_t::gru_lbr_postgemm) {
 
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto logistic_f = [](const float *scale, float a) {
-        return logistic_fwd<float>(a);
+        return fast_logistic_fwd(a);
     };
     auto tanh_f
-            = [](const float *scale, float a) { return tanh_fwd<float>(a); };
+            = [](const float *scale, float a) { return fast_tanh_fwd(a); };
     auto to_src = [](float a) { return a; };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
@@ -107,10 +126,10 @@ rnn_postgemm_sig(rnn_postgemm_fwd_bf16_t::gru_lbr_postgemm) {
 
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto logistic_f = [](const float *scale, float a) {
-        return logistic_fwd<float>(a);
+        return fast_logistic_fwd(a);
     };
     auto tanh_f
-            = [](const float *scale, float a) { return tanh_fwd<float>(a); };
+            = [](const float *scale, float a) { return fast_tanh_fwd(a); };
     auto to_src = [](float a) { return bfloat16_t(a); };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
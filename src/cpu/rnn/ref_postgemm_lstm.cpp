@@ -64,49 +64,72 @@ void lstm_fwd_postgemm_template(T1 func1, T2 func2, T3 to_src_dt, T4 to_float,
     ws_states_iter_c_aoc<const float> src_iter_c(
             rnn, src_iter_c_, src_iter_c_ld);
 
-    parallel_nd(rnn.mb, [&](int i) {
+    // The optional parts get loops of their own, so that the loops stay free
+    // of branches and vectorize; k = j - jb indexes the rows of the block.
+    postgemm_parallel(rnn, [&](int i, int jb, int je) {
+        float G0[postgemm_block], G1[postgemm_block], G2[postgemm_block],
+                G3[postgemm_block], C[postgemm_block], H[postgemm_block];
+
         PRAGMA_OMP_SIMD()
-        for (int j = 0; j < rnn.dhc; j++) {
-            float gate_i_arg
-                    = to_float(scratch_gates(i, 0, j), 0, j) + bias(0, j);
-            if (rnn.is_lstm_peephole)
-                gate_i_arg += weights_peephole(0, j) * src_iter_c(i, j);
-
-            float gate_f_arg
-                    = to_float(scratch_gates(i, 1, j), 1, j) + bias(1, j);
-            if (rnn.is_lstm_peephole)
-                gate_f_arg += weights_peephole(1, j) * src_iter_c(i, j);
-
-            float gate_c_arg
-                    = to_float(scratch_gates(i, 2, j), 2, j) + bias(2, j);
-
-            // default func1 is sigmoid, func2 is tanh
-
-            float gate_i = func1(scales + 0, gate_i_arg);
-            float gate_f = func1(scales + 1, gate_f_arg);
-            float gate_c = func2(scales + 2, gate_c_arg);
-
-            float c_state = gate_f * src_iter_c(i, j) + gate_i * gate_c;
-            dst_iter_c(i, j) = c_state;
-
-            float gate_o_arg
-                    = to_float(scratch_gates(i, 3, j), 3, j) + bias(3, j);
-            if (rnn.is_lstm_peephole)
-                gate_o_arg += weights_peephole(2, j) * c_state;
-
-            float gate_o = func1(scales + 3, gate_o_arg);
-
-            src_data_t ht = to_src_dt(gate_o * func2(cscale, c_state));
-            if (dst_layer_ != nullptr) dst_layer(i, j) = ht;
-            if (dst_iter_ != nullptr) dst_iter(i, j) = ht;
-
-            // write gates back to memory for training
-            // we to_src_dt them as as they are GEMM inputs in BWD
-            if (rnn.is_training) {
-                ws_gates(i, 0, j) = to_src_dt(gate_i);
-                ws_gates(i, 1, j) = to_src_dt(gate_f);
-                ws_gates(i, 2, j) = to_src_dt(gate_c);
-                ws_gates(i, 3, j) = to_src_dt(gate_o);
+        for (int j = jb; j < je; j++) {
+            const int k = j - jb;
+            G0[k] = to_float(scratch_gates(i, 0, j), 0, j) + bias(0, j);
+            G1[k] = to_float(scratch_gates(i, 1, j), 1, j) + bias(1, j);
+            G2[k] = to_float(scratch_gates(i, 2, j), 2, j) + bias(2, j);
+            G3[k] = to_float(scratch_gates(i, 3, j), 3, j) + bias(3, j);
+        }
+        if (rnn.is_lstm_peephole) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++) {
+                G0[j - jb] += weights_peephole(0, j) * src_iter_c(i, j);
+                G1[j - jb] += weights_peephole(1, j) * src_iter_c(i, j);
+            }
+        }
+
+        // default func1 is sigmoid, func2 is tanh
+        PRAGMA_OMP_SIMD()
+        for (int j = jb; j < je; j++) {
+            const int k = j - jb;
+            G0[k] = func1(scales + 0, G0[k]);
+            G1[k] = func1(scales + 1, G1[k]);
+            G2[k] = func2(scales + 2, G2[k]);
+            C[k] = G1[k] * src_iter_c(i, j) + G0[k] * G2[k];
+            dst_iter_c(i, j) = C[k];
+        }
+        if (rnn.is_lstm_peephole) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                G3[j - jb] += weights_peephole(2, j) * C[j - jb];
+        }
+
+        PRAGMA_OMP_SIMD()
+        for (int j = jb; j < je; j++) {
+            const int k = j - jb;
+            G3[k] = func1(scales + 3, G3[k]);
+            H[k] = G3[k] * func2(cscale, C[k]);
+        }
+
+        if (dst_layer_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_layer(i, j) = to_src_dt(H[j - jb]);
+        }
+        if (dst_iter_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_iter(i, j) = to_src_dt(H[j - jb]);
+        }
+
+        // write gates back to memory for training
+        // we to_src_dt them as as they are GEMM inputs in BWD
+        if (rnn.is_training) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++) {
+                const int k = j - jb;
+                ws_gates(i, 0, j) = to_src_dt(G0[k]);
+                ws_gates(i, 1, j) = to_src_dt(G1[k]);
+                ws_gates(i, 2, j) = to_src_dt(G2[k]);
+                ws_gates(i, 3, j) = to_src_dt(G3[k]);
             }
         }
     });
@@ -122,10 +145,10 @@ rnn_postgemm_sig(rnn_postgemm_fwd_f32_t::lstm_postgemm) {
 
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto logistic_f = [](const float *scale, float a) {
-        return logistic_fwd<float>(a);
+        return fast_logistic_fwd(a);
     };
     auto tanh_f
-            = [](const float *scale, float a) { return tanh_fwd<float>(a); };
+            = [](const float *scale, float a) { return fast_tanh_fwd(a); };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
         lstm_fwd_postgemm_template(logistic_f, tanh_f, q_id, deq_id, scales,
@@ -148,10 +171,10 @@ rnn_postgemm_sig(rnn_postgemm_fwd_bf16_t::lstm_postgemm) {
 
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto logistic_f = [](const float *scale, float a) {
-        return logistic_fwd<float>(a);
+        return fast_logistic_fwd(a);
     };
     auto tanh_f
-            = [](const float *scale, float a) { return tanh_fwd<float>(a); };
+            = [](const float *scale, float a) { return fast_tanh_fwd(a); };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
         lstm_fwd_postgemm_template(logistic_f, tanh_f, round_f32_bf16, deq_id,
@@ -191,10 +214,10 @@ rnn_postgemm_sig(rnn_postgemm_fwd_u8_t::lstm_postgemm) {
 
     auto linear_f = [](const float *scale, float a) { return *scale * a; };
     auto logistic_f = [](const float *scale, float a) {
-        return logistic_fwd<float>(a);
+        return fast_logistic_fwd(a);
     };
     auto tanh_f
-            = [](const float *scale, float a) { return tanh_fwd<float>(a); };
+            = [](const float *scale, float a) { return fast_tanh_fwd(a); };
 
     if (!pd_->attr()->rnn_tparams_.test_mode_)
         lstm_fwd_postgemm_template(logistic_f, tanh_f, quantize_f32_u8,
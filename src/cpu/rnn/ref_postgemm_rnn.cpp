@@ -46,7 +46,7 @@ float activation<alg_kind::eltwise_relu, prop_kind::backward>(
 template <>
 float activation<alg_kind::eltwise_tanh, prop_kind::forward>(
         float s, float alpha, float cliping) {
-    return tanh_fwd<float>(s);
+    return fast_tanh_fwd(s);
 }
 
 template <>
@@ -58,7 +58,7 @@ float activation<alg_kind::eltwise_tanh, prop_kind::backward>(
 template <>
 float activation<alg_kind::eltwise_logistic, prop_kind::forward>(
         float s, float alpha, float cliping) {
-    return logistic_fwd<float>(s);
+    return fast_logistic_fwd(s);
 }
 
 template <>
@@ -89,31 +89,87 @@ void rnn_fwd_postgemm_template(T func1, const float *scales, float alpha,
 
     if (scales != nullptr) alpha = scales[0];
 
-    parallel_nd(rnn.mb, [&](int i) {
-        for (int j = 0; j < rnn.dhc; j++) {
-            const float h
-                    = func1(scratch_gates(i, 0, j) + bias(0, j), alpha, 0);
-            if (dst_layer_ != nullptr) dst_layer(i, j) = h;
-            if (dst_iter_ != nullptr) dst_iter(i, j) = h;
-            if (rnn.is_training) ws_gates(i, 0, j) = h;
+    postgemm_parallel(rnn, [&](int i, int jb, int je) {
+        float H[postgemm_block];
+
+        PRAGMA_OMP_SIMD()
+        for (int j = jb; j < je; j++)
+            H[j - jb] = func1(scratch_gates(i, 0, j) + bias(0, j), alpha, 0);
+
+        // the optional outputs get loops of their own to keep the loops
+        // free of branches
+        if (dst_layer_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_layer(i, j) = H[j - jb];
+        }
+        if (dst_iter_ != nullptr) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                dst_iter(i, j) = H[j - jb];
+        }
+        if (rnn.is_training) {
+            PRAGMA_OMP_SIMD()
+            for (int j = jb; j < je; j++)
+                ws_gates(i, 0, j) = H[j - jb];
         }
     });
 }
 
+// The activation is picked once per call instead of through activation_func
+// for every element, so that it inlines into the simd loop
+template <typename T, typename src_data_t, typename scratch_data_t>
+void rnn_fwd_postgemm_act(T to_src, alg_kind_t activation_kind, float alpha,
+        const rnn_utils::rnn_conf_t &rnn,
+        rnn_utils::cell_position_t cell_position, src_data_t *ws_gates_,
+        scratch_data_t *scratch_gates_, src_data_t *dst_layer_,
+        src_data_t *dst_iter_, const src_data_t *src_iter_, float *bias_) {
+    auto relu_f = [&](float a, float alpha, float clipping) {
+        return to_src(activation<alg_kind::eltwise_relu, prop_kind::forward>(
+                a, alpha, clipping));
+    };
+    auto tanh_f = [&](float a, float alpha, float clipping) {
+        return to_src(activation<alg_kind::eltwise_tanh, prop_kind::forward>(
+                a, alpha, clipping));
+    };
+    auto logistic_f = [&](float a, float alpha, float clipping) {
+        return to_src(
+                activation<alg_kind::eltwise_logistic, prop_kind::forward>(
+                        a, alpha, clipping));
+    };
+
+    switch (activation_kind) {
+        case alg_kind::eltwise_relu:
+            rnn_fwd_postgemm_template(relu_f, nullptr, alpha, rnn,
+                    cell_position, ws_gates_, scratch_gates_, dst_layer_,
+                    dst_iter_, src_iter_, bias_);
+            break;
+        case alg_kind::eltwise_tanh:
+            rnn_fwd_postgemm_template(tanh_f, nullptr, alpha, rnn,
+                    cell_position, ws_gates_, scratch_gates_, dst_layer_,
+                    dst_iter_, src_iter_, bias_);
+            break;
+        case alg_kind::eltwise_logistic:
+            rnn_fwd_postgemm_template(logistic_f, nullptr, alpha, rnn,
+                    cell_position, ws_gates_, scratch_gates_, dst_layer_,
+                    dst_iter_, src_iter_, bias_);
+            break;
+        default: assert(!"Unsupported activation function"); break;
+    }
+}
+
 template <>
 rnn_postgemm_sig(rnn_postgemm_fwd_f32_t::rnn_postgemm) {
     const float *scales = pd_->attr()->rnn_tparams_.scales_;
-    auto act_f = [this](float a, float alpha, float clipping) {
-        return this->activation_func(a, alpha, clipping);
-    };
+    auto to_src = [](float a) { return a; };
     auto linear_f = [](float a, float alpha, float clipping) {
         return linear(a, alpha, clipping);
     };
     auto alpha = pd_->desc()->alpha;
     if (!pd_->attr()->rnn_tparams_.test_mode_)
-        rnn_fwd_postgemm_template(act_f, nullptr, alpha, rnn, cell_position,
-                ws_gates_, scratch_gates_, dst_layer_, dst_iter_, src_iter_,
-                bias_);
+        rnn_fwd_postgemm_act(to_src, pd_->activation_kind(), alpha, rnn,
+                cell_position, ws_gates_, scratch_gates_, dst_layer_,
+                dst_iter_, src_iter_, bias_);
     else
         rnn_fwd_postgemm_template(linear_f, scales, alpha, rnn, cell_position,
                 ws_gates_, scratch_gates_, dst_layer_, dst_iter_, src_iter_,
@@ -123,17 +179,15 @@ rnn_postgemm_sig(rnn_postgemm_fwd_f32_t::rnn_postgemm) {
 template <>
 rnn_postgemm_sig(rnn_postgemm_fwd_bf16_t::rnn_postgemm) {
     const float *scales = pd_->attr()->rnn_tparams_.scales_;
-    auto act_f = [this](float a, float alpha, float clipping) {
-        return bfloat16_t(this->activation_func(a, alpha, clipping));
-    };
+    auto to_src = [](float a) { return bfloat16_t(a); };
     auto linear_f = [](float a, float alpha, float clipping) {
         return bfloat16_t(linear(a, alpha, clipping));
     };
     auto alpha = pd_->desc()->alpha;
     if (!pd_->attr()->rnn_tparams_.test_mode_)
-        rnn_fwd_postgemm_template(act_f, nullptr, alpha, rnn, cell_position,
-                ws_gates_, scratch_gates_, dst_layer_, dst_iter_, src_iter_,
-                bias_);
+        rnn_fwd_postgemm_act(to_src, pd_->activation_kind(), alpha, rnn,
+                cell_position, ws_gates_, scratch_gates_, dst_layer_,
+                dst_iter_, src_iter_, bias_);
     else
         rnn_fwd_postgemm_template(linear_f, scales, alpha, rnn, cell_position,
                 ws_gates_, scratch_gates_, dst_layer_, dst_iter_, src_iter_,
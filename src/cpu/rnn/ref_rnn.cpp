@@ -154,13 +154,13 @@ template <prop_kind_t aprop, data_type_t src_type, data_type_t weights_type,
 rnn_grid_execution_sig((_ref_rnn_common_t<aprop, src_type, weights_type,
         acc_type>::linear_execution)) {
     AOC<src_layer_t, 4> ws_states_layer(ws_states_layer_, rnn.n_layer + 1,
-            rnn.n_dir, rnn.n_iter + 1,
+            rnn.n_dir, rnn.ws_states_n_iter,
             rnn.ws_states_layer_nld * rnn.ws_states_layer_ld);
     AOC<src_iter_t, 4> ws_states_iter(ws_states_iter_, rnn.n_layer + 1,
-            rnn.n_dir, rnn.n_iter + 1,
+            rnn.n_dir, rnn.ws_states_n_iter,
             rnn.ws_states_iter_nld * rnn.ws_states_iter_ld);
     AOC<float, 4> ws_states_iter_c(ws_states_iter_c_, rnn.n_layer + 1,
-            rnn.n_dir, rnn.n_iter + 1,
+            rnn.n_dir, rnn.ws_states_n_iter,
             rnn.ws_states_iter_c_nld * rnn.ws_states_iter_c_ld);
     AOC<gemm_acc_t, 4> ws_diff_states_layer(ws_diff_states_layer_,
             rnn.n_layer + 1, rnn.n_dir, rnn.n_iter + 1,
@@ -207,6 +207,161 @@ rnn_grid_execution_sig((_ref_rnn_common_t<aprop, src_type, weights_type,
     auto src_iter_c_mdw = memory_desc_wrapper(pd()->src_md(2));
     auto dst_iter_c_mdw = memory_desc_wrapper(pd()->dst_md(2));
 
+    // Cell (lay, iter) of direction dir, with the scratch gates and scratch
+    // cell of the given wavefront slot
+    auto execute_cell = [&](int dir, int lay, int iter, int slot) {
+        // We set the FWD parameters to the cell execution
+        // call
+
+        // dst_layer is equal to dst_iter. To avoid
+        // duplication of memory access we hence use only
+        // dst_layer and set dst_iter to nullptr, unless we
+        // cannot for one of the following condition:
+        // - in the last layer and last iteration, we need to
+        //   copy ht in two tensors (dst_layer and dst_iter)
+        const int ws_it = rnn.ws_states_it(iter);
+        const int ws_it_next = rnn.ws_states_it(iter + 1);
+        dst_layer_t *cell_dst_layer
+                = &(ws_states_layer(lay + 1, dir, ws_it_next, 0));
+        dst_iter_t *cell_dst_iter = nullptr;
+        const src_layer_t *cell_src_layer
+                = &(ws_states_layer(lay, dir, ws_it_next, 0));
+        const src_iter_t *cell_src_iter
+                = &(ws_states_iter(lay + 1, dir, ws_it, 0));
+
+        float *cell_dst_iter_c
+                = &(ws_states_iter_c(lay + 1, dir, ws_it_next, 0));
+        const float *cell_src_iter_c
+                = &(ws_states_iter_c(lay + 1, dir, ws_it, 0));
+
+        // the cell_position is used only when skip_data_copy is
+        // supported currently supported only for forward
+        cell_position_t cell_position = middle_cell;
+        if (iter == 0) cell_position |= first_iter;
+        if (lay == 0) cell_position |= first_layer;
+        if (iter == rnn.n_iter - 1) cell_position |= last_iter;
+        if (lay == rnn.n_layer - 1) cell_position |= last_layer;
+
+        // The dst_* paths should be before the src_* paths as
+        // the later will override cell_src_layer and
+        // cell_src_iter appropriatly for 1st layer and 1st
+        // iter.
+        bool last_iter_skip_copy = rnn.skip_dst_iter_copy()
+                && (cell_position & last_iter);
+        if (last_iter_skip_copy) {
+            cell_dst_layer
+                    = dst_iter_ + dst_iter_mdw.off(lay, dir, 0, 0);
+            cell_src_layer
+                    = dst_iter_ + dst_iter_mdw.off(lay - 1, dir, 0, 0);
+        }
+
+        if (rnn.skip_dst_layer_copy() && (cell_position & last_layer)) {
+            // Note: for last layer and last iter, the output is in dst_layer
+            // and still need to be copied to dst_iter
+            cell_dst_layer = dst_layer_ + dst_layer_mdw.off(iter, 0, 0);
+            cell_dst_iter = last_iter_skip_copy
+                    ? dst_iter_ + dst_iter_mdw.off(lay, dir, 0, 0)
+                    : nullptr;
+            cell_src_iter = (iter != 0)
+                    ? dst_layer_ + dst_layer_mdw.off(iter - 1, 0, 0)
+                    : cell_src_iter;
+        }
+        if (rnn.skip_src_iter_copy() && (cell_position & first_iter))
+            cell_src_iter
+                    = src_iter_ + src_iter_mdw.off(lay, dir, 0, 0);
+
+        if (rnn.skip_src_layer_copy() && (cell_position & first_layer))
+            cell_src_layer = src_layer_ + src_layer_mdw.off(iter, 0, 0);
+
+        // because the c state is always f32 and require no
+        // conversion, we can always skip to copy for the 1st
+        // and last iteration
+        if (iter == 0 && src_iter_c_) {
+            cell_src_iter_c
+                    = src_iter_c_ + src_iter_c_mdw.off(lay, dir, 0, 0);
+            cell_position |= c_state_first_iter;
+        }
+        if (iter == rnn.n_iter - 1 && dst_iter_c_) {
+            cell_dst_iter_c
+                    = dst_iter_c_ + dst_iter_c_mdw.off(lay, dir, 0, 0);
+            cell_position |= c_state_last_iter;
+        }
+
+        auto cell_scratch_gates = scratch_gates_
+                + (rnn.n_iter_scratch_gates == 1 ? slot : iter)
+                        * rnn.scratch_gates_nld * rnn.scratch_gates_ld;
+        auto cell_scratch_cell = scratch_cell_
+                + slot * rnn.scratch_cell_size / rnn.n_wave_slots
+                        / sizeof(scratch_t);
+
+        dst_iter_t *proj_ht = nullptr;
+        if (rnn.is_lstm_projection) {
+            if (rnn.is_training)
+                proj_ht = &(ws_ht(lay, dir, iter, 0));
+            else
+                proj_ht = scratch_ht_;
+        }
+
+        (this->*cell_func)(rnn, cell_position, cell_dst_layer,
+                cell_dst_iter_c,
+                &(ws_diff_states_layer(lay, dir, iter, 0)),
+                &(ws_diff_states_iter(lay, dir, iter, 0)),
+                &(ws_diff_states_iter_c(lay, dir, iter, 0)),
+                &(weights_layer(lay, dir, 0)),
+                &(weights_iter(lay, dir, 0)),
+                &(weights_projection(lay, dir)),
+                &(weights_peephole(lay, dir, 0)), &(bias(lay, dir, 0)),
+                cell_src_layer, cell_src_iter, cell_src_iter_c,
+                &(ws_diff_states_layer(lay + 1, dir, iter, 0)),
+                &(ws_diff_states_iter(lay, dir, iter + 1, 0)),
+                &(ws_diff_states_iter_c(lay, dir, iter + 1, 0)),
+                &(diff_weights_layer(lay, dir, 0)),
+                &(diff_weights_iter(lay, dir, 0)),
+                &(diff_weights_projection(lay, dir, 0)),
+                &(diff_weights_peephole(lay, dir, 0)),
+                &(diff_bias(lay, dir, 0)),
+                &(ws_gates(lay, dir, iter, 0)), cell_scratch_gates,
+                proj_ht, scratch_diff_ht_,
+                &(ws_grid(lay, dir, iter, 0)), cell_scratch_cell,
+                cell_dst_iter);
+    };
+
+    if (rnn.wavefront) {
+        assert(aprop == prop_kind::forward);
+        // The cells of wave w are (lay, w - lay) for lay in [lay_b, lay_e)
+        // in every direction. Waves of a single cell keep the whole thread
+        // team for the cell; otherwise every cell runs on one thread.
+        for (int w = 0; w < rnn.n_layer + rnn.n_iter - 1; w++) {
+            const int lay_b = nstl::max(0, w - rnn.n_iter + 1);
+            const int lay_e = nstl::min(rnn.n_layer, w + 1);
+            const int n_lay = lay_e - lay_b;
+            const int n_cells = rnn.n_dir * n_lay;
+            assert(n_cells <= rnn.n_wave_slots);
+            if (n_cells == 1) {
+                execute_cell(0, lay_b, w - lay_b, 0);
+                continue;
+            }
+            parallel(nstl::min(n_cells, dnnl_get_max_threads()),
+                    [&](int ithr, int nthr) {
+                        for (int c = ithr; c < n_cells; c += nthr) {
+                            const int lay = lay_b + c % n_lay;
+                            execute_cell(c / n_lay, lay, w - lay, c);
+                        }
+                    });
+        }
+        return;
+    }
+
+    if (rnn.streaming) {
+        assert(aprop == prop_kind::forward && rnn.n_dir == 1);
+        // Iteration by iteration, as the states of a layer are overwritten
+        // every other iteration
+        for (int iter = 0; iter < rnn.n_iter; iter++)
+            for (int lay = 0; lay < rnn.n_layer; lay++)
+                execute_cell(0, lay, iter, 0);
+        return;
+    }
+
     // We run the grid of computation
     for (int dir = 0; dir < rnn.n_dir; dir++) {
         for (int j = 0; j < rnn.n_layer; j++) {
@@ -241,118 +396,7 @@ rnn_grid_execution_sig((_ref_rnn_common_t<aprop, src_type, weights_type,
             for (int i = 0; i < rnn.n_iter; i++) {
                 int iter = (aprop == prop_kind::forward) ? i
                                                          : rnn.n_iter - i - 1;
-
-                // We set the FWD parameters to the cell execution
-                // call
-
-                // dst_layer is equal to dst_iter. To avoid
-                // duplication of memory access we hence use only
-                // dst_layer and set dst_iter to nullptr, unless we
-                // cannot for one of the following condition:
-                // - in the last layer and last iteration, we need to
-                //   copy ht in two tensors (dst_layer and dst_iter)
-                dst_layer_t *cell_dst_layer
-                        = &(ws_states_layer(lay + 1, dir, iter + 1, 0));
-                dst_iter_t *cell_dst_iter = nullptr;
-                const src_layer_t *cell_src_layer
-                        = &(ws_states_layer(lay, dir, iter + 1, 0));
-                const src_iter_t *cell_src_iter
-                        = &(ws_states_iter(lay + 1, dir, iter, 0));
-
-                float *cell_dst_iter_c
-                        = &(ws_states_iter_c(lay + 1, dir, iter + 1, 0));
-                const float *cell_src_iter_c
-                        = &(ws_states_iter_c(lay + 1, dir, iter, 0));
-
-                // the cell_position is used only when skip_data_copy is
-                // supported currently supported only for forward
-                cell_position_t cell_position = middle_cell;
-                if (iter == 0) cell_position |= first_iter;
-                if (lay == 0) cell_position |= first_layer;
-                if (iter == rnn.n_iter - 1) cell_position |= last_iter;
-                if (lay == rnn.n_layer - 1) cell_position |= last_layer;
-
-                // The dst_* paths should be before the src_* paths as
-                // the later will override cell_src_layer and
-                // cell_src_iter appropriatly for 1st layer and 1st
-                // iter.
-                bool last_iter_skip_copy = rnn.skip_dst_iter_copy()
-                        && (cell_position & last_iter);
-                if (last_iter_skip_copy) {
-                    cell_dst_layer
-                            = dst_iter_ + dst_iter_mdw.off(lay, dir, 0, 0);
-                    cell_src_layer
-                            = dst_iter_ + dst_iter_mdw.off(lay - 1, dir, 0, 0);
-                }
-
-                if (rnn.skip_dst_layer_copy() && (cell_position & last_layer)) {
-                    // Note: for last layer and last iter, the output is in dst_layer
-                    // and still need to be copied to dst_iter
-                    cell_dst_layer = dst_layer_ + dst_layer_mdw.off(iter, 0, 0);
-                    cell_dst_iter = last_iter_skip_copy
-                            ? dst_iter_ + dst_iter_mdw.off(lay, dir, 0, 0)
-                            : nullptr;
-                    cell_src_iter = (iter != 0)
-                            ? dst_layer_ + dst_layer_mdw.off(iter - 1, 0, 0)
-                            : cell_src_iter;
-                }
-                if (rnn.skip_src_iter_copy() && (cell_position & first_iter))
-                    cell_src_iter
-                            = src_iter_ + src_iter_mdw.off(lay, dir, 0, 0);
-
-                if (rnn.skip_src_layer_copy() && (cell_position & first_layer))
-                    cell_src_layer = src_layer_ + src_layer_mdw.off(iter, 0, 0);
-
-                // because the c state is always f32 and require no
-                // conversion, we can always skip to copy for the 1st
-                // and last iteration
-                if (iter == 0 && src_iter_c_) {
-                    cell_src_iter_c
-                            = src_iter_c_ + src_iter_c_mdw.off(lay, dir, 0, 0);
-                    cell_position |= c_state_first_iter;
-                }
-                if (iter == rnn.n_iter - 1 && dst_iter_c_) {
-                    cell_dst_iter_c
-                            = dst_iter_c_ + dst_iter_c_mdw.off(lay, dir, 0, 0);
-                    cell_position |= c_state_last_iter;
-                }
-
-                auto cell_scratch_gates = rnn.n_iter_scratch_gates == 1
-                        ? scratch_gates_
-                        : scratch_gates_
-                                + iter * rnn.scratch_gates_nld
-                                        * rnn.scratch_gates_ld;
-
-                dst_iter_t *proj_ht = nullptr;
-                if (rnn.is_lstm_projection) {
-                    if (rnn.is_training)
-                        proj_ht = &(ws_ht(lay, dir, iter, 0));
-                    else
-                        proj_ht = scratch_ht_;
-                }
-
-                (this->*cell_func)(rnn, cell_position, cell_dst_layer,
-                        cell_dst_iter_c,
-                        &(ws_diff_states_layer(lay, dir, iter, 0)),
-                        &(ws_diff_states_iter(lay, dir, iter, 0)),
-                        &(ws_diff_states_iter_c(lay, dir, iter, 0)),
-                        &(weights_layer(lay, dir, 0)),
-                        &(weights_iter(lay, dir, 0)),
-                        &(weights_projection(lay, dir)),
-                        &(weights_peephole(lay, dir, 0)), &(bias(lay, dir, 0)),
-                        cell_src_layer, cell_src_iter, cell_src_iter_c,
-                        &(ws_diff_states_layer(lay + 1, dir, iter, 0)),
-                        &(ws_diff_states_iter(lay, dir, iter + 1, 0)),
-                        &(ws_diff_states_iter_c(lay, dir, iter + 1, 0)),
-                        &(diff_weights_layer(lay, dir, 0)),
-                        &(diff_weights_iter(lay, dir, 0)),
-                        &(diff_weights_projection(lay, dir, 0)),
-                        &(diff_weights_peephole(lay, dir, 0)),
-                        &(diff_bias(lay, dir, 0)),
-                        &(ws_gates(lay, dir, iter, 0)), cell_scratch_gates,
-                        proj_ht, scratch_diff_ht_,
-                        &(ws_grid(lay, dir, iter, 0)), scratch_cell_,
-                        cell_dst_iter);
+                execute_cell(dir, lay, iter, 0);
             }
 
             if ((aprop == prop_kind::backward) && rnn.merge_gemm_layer) {
@@ -557,9 +601,9 @@ void copy_init_iter_fwd_template(const rnn_conf_t &rnn, const rnn_pd_t *pd,
         const float *__restrict src_iter_c_,
         const memory_desc_wrapper &src_iter_c_d) {
     AOC<src_data_t, 5> ws_states_iter(ws_states_iter_, rnn.n_layer + 1,
-            rnn.n_dir, rnn.n_iter + 1, rnn.mb, rnn.ws_states_iter_ld);
+            rnn.n_dir, rnn.ws_states_n_iter, rnn.mb, rnn.ws_states_iter_ld);
     AOC<float, 5> ws_states_iter_c(ws_states_iter_c_, rnn.n_layer + 1,
-            rnn.n_dir, rnn.n_iter + 1, rnn.mb, rnn.ws_states_iter_c_ld);
+            rnn.n_dir, rnn.ws_states_n_iter, rnn.mb, rnn.ws_states_iter_c_ld);
     float data_shift = pd->attr()->rnn_data_qparams_.shift_;
     float data_scale = pd->attr()->rnn_data_qparams_.scale_;
 
@@ -589,7 +633,7 @@ void copy_init_iter_fwd_template(const rnn_conf_t &rnn, const rnn_pd_t *pd,
                     for (int j = 0; j < rnn.sic; j++)
                         ws_states_iter(lay + 1, dir, 0, b, j) = (src_data_t)0;
                     for (int j = 0; j < rnn.dhc; j++)
-                        ws_states_iter_c(lay + 1, dir, 1, b, j) = 0.0f;
+                        ws_states_iter_c(lay + 1, dir, 0, b, j) = 0.0f;
                 });
     }
 }
@@ -847,9 +891,9 @@ void copy_res_iter_fwd_template(const rnn_conf_t &rnn, const rnn_pd_t *pd,
     if (dst_iter_ == nullptr) return;
 
     AOC<const src_data_t, 5> ws_states_iter(ws_states_iter_, rnn.n_layer + 1,
-            rnn.n_dir, rnn.n_iter + 1, rnn.mb, rnn.ws_states_iter_ld);
+            rnn.n_dir, rnn.ws_states_n_iter, rnn.mb, rnn.ws_states_iter_ld);
     AOC<const float, 5> ws_states_iter_c(ws_states_iter_c_, rnn.n_layer + 1,
-            rnn.n_dir, rnn.n_iter + 1, rnn.mb, rnn.ws_states_iter_c_ld);
+            rnn.n_dir, rnn.ws_states_n_iter, rnn.mb, rnn.ws_states_iter_c_ld);
 
     float data_shift = pd->attr()->rnn_data_qparams_.shift_;
     float data_scale = pd->attr()->rnn_data_qparams_.scale_;
@@ -873,7 +917,8 @@ void copy_res_iter_fwd_template(const rnn_conf_t &rnn, const rnn_pd_t *pd,
     auto n_layer_in_ws = rnn.n_layer - rnn.skip_dst_layer_copy();
 
     parallel_nd(n_layer_in_ws, rnn.n_dir, rnn.mb, [&](int lay, int dir, int b) {
-        const auto *ss = &ws_states_iter(lay + 1, dir, rnn.n_iter, b, 0);
+        const auto *ss = &ws_states_iter(
+                lay + 1, dir, rnn.ws_states_it(rnn.n_iter), b, 0);
         auto *dd = dst_iter_ + dst_iter_d.blk_off(lay, dir, b, 0);
         copy_vec(dd, ss);
     });
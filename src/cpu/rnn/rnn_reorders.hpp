@@ -24,6 +24,7 @@
 #include "common/primitive.hpp"
 #include "common/type_helpers.hpp"
 #include "common/utils.hpp"
+#include "common/ve/memory_desc_wrapper_opt.hpp"
 
 #include "cpu/cpu_reorder_pd.hpp"
 #include "cpu/platform.hpp"
@@ -99,27 +100,44 @@ private:
         assert(type_i == data_type::f32);
         assert(type_o == data_type::u8);
 
-        const memory_desc_wrapper &input_d = pd()->src_md();
-        const memory_desc_wrapper &output_d = pd()->dst_md();
-        const dim_t outer_dim
-                = utils::array_product(input_d.dims(), input_d.ndims() - 1);
-        const dim_t inner_dim = input_d.dims()[input_d.ndims() - 1];
+        const memory_desc_wrapper_opt input_d(pd()->src_md());
+        const memory_desc_wrapper_opt output_d(pd()->dst_md());
+        const int ndims = input_d.ndims();
+        const dim_t outer_dim = utils::array_product(input_d.dims(), ndims - 1);
+        const dim_t inner_dim = input_d.dims()[ndims - 1];
+
+        auto ker = [&](dim_t off_in, dim_t off_out) {
+            const in_data_t *__restrict i_ = input + off_in;
+            out_data_t *__restrict o_ = output + off_out;
+            PRAGMA_OMP_SIMD()
+            for (int j = 0; j < inner_dim; ++j) {
+                const float in = (float)i_[j] * scale + shift;
+                const float out_l = nstl::max(in, 0.0f);
+                const float out = nstl::min(out_l, 255.0f);
+                o_[j] = (out_data_t)(nearbyintf(out));
+            }
+        };
 
         parallel(0, [&](const int ithr, const int nthr) {
             dim_t start {0}, end {0};
             balance211(outer_dim, nthr, ithr, start, end);
-            for (int i = start; i < end; ++i) {
-                const dim_t off_in = input_d.off_l(i * inner_dim);
-                const dim_t off_out = output_d.off_l(i * inner_dim);
-                const in_data_t *__restrict i_ = input + off_in;
-                out_data_t *__restrict o_ = output + off_out;
-                PRAGMA_OMP_SIMD()
-                for (int j = 0; j < inner_dim; ++j) {
-                    const float in = (float)i_[j] * scale + shift;
-                    const float out_l = nstl::max(in, 0.0f);
-                    const float out = nstl::min(out_l, 255.0f);
-                    o_[j] = (out_data_t)(nearbyintf(out));
-                }
+            if (!VecOffsetsFor::ok(input_d) || !VecOffsetsFor::ok(output_d)) {
+                for (dim_t i = start; i < end; ++i)
+                    ker(input_d.off_l(i * inner_dim),
+                            output_d.off_l(i * inner_dim));
+                return;
+            }
+            // row offsets, MVL rows at a time: iterate the outer dims with
+            // the (dense) innermost coordinate held at 0
+            memory_desc_t rows_md = *pd()->src_md();
+            rows_md.dims[ndims - 1] = 1;
+            const memory_desc_wrapper_opt rows_d(rows_md);
+            dim_t off_out[MVL];
+            for (VecOffsetsFor it(rows_d, start, end); it; ++it) {
+                const dim_t *off_in = it.off();
+                it.off_of(output_d, off_out);
+                for (unsigned i = 0; i < it.get_vl(); ++i)
+                    ker(off_in[i], off_out[i]);
             }
         });
         return status::success;
@@ -130,13 +148,30 @@ private:
         assert(type_i == data_type::f32);
         assert(type_o == data_type::u8);
 
-        const memory_desc_wrapper &input_d = pd()->src_md();
-        const memory_desc_wrapper &output_d = pd()->dst_md();
+        const memory_desc_wrapper_opt input_d(pd()->src_md());
+        const memory_desc_wrapper_opt output_d(pd()->dst_md());
         const size_t nelems = input_d.nelems();
-        parallel_nd(nelems, [&](size_t i) {
-            float in = (float)input[input_d.off_l(i)] * scale + shift;
+        auto ker = [&](dim_t off_in, dim_t off_out) {
+            float in = (float)input[off_in] * scale + shift;
             float out = nstl::max(nstl::min(in, 255.0f), 0.0f);
-            output[output_d.off_l(i)] = (out_data_t)(nearbyintf(out));
+            output[off_out] = (out_data_t)(nearbyintf(out));
+        };
+        if (!VecOffsetsFor::ok(input_d) || !VecOffsetsFor::ok(output_d)) {
+            parallel_nd(nelems, [&](size_t i) {
+                ker(input_d.off_l(i), output_d.off_l(i));
+            });
+            return status::success;
+        }
+        parallel(0, [&](const int ithr, const int nthr) {
+            size_t start {0}, end {0};
+            balance211(nelems, nthr, ithr, start, end);
+            dim_t off_out[MVL];
+            for (VecOffsetsFor it(input_d, start, end); it; ++it) {
+                const dim_t *off_in = it.off();
+                it.off_of(output_d, off_out);
+                for (unsigned i = 0; i < it.get_vl(); ++i)
+                    ker(off_in[i], off_out[i]);
+            }
         });
         return status::success;
     }
@@ -14,6 +14,7 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <atomic>
 #include <initializer_list>
 
 #include "common/c_types_map.hpp"
@@ -242,6 +243,34 @@ status_t rnn_utils::set_expected_desc(rnn_conf_t &rnn,
     return status::success;
 }
 
+namespace {
+std::atomic<int> &wavefront_override() {
+    static std::atomic<int> value {getenv_int("DNNL_RNN_WAVEFRONT", -1)};
+    return value;
+}
+
+std::atomic<int> &streaming_override() {
+    static std::atomic<int> value {getenv_int("DNNL_RNN_STREAMING", -1)};
+    return value;
+}
+} // namespace
+
+int rnn_utils::get_wavefront_override() {
+    return wavefront_override();
+}
+
+int rnn_utils::get_streaming_override() {
+    return streaming_override();
+}
+
+status_t set_rnn_schedule_overrides(int wavefront, int streaming) {
+    if (!one_of(wavefront, -1, 0, 1) || !one_of(streaming, -1, 0, 1))
+        return status::invalid_arguments;
+    wavefront_override() = wavefront;
+    streaming_override() = streaming;
+    return status::success;
+}
+
 } // namespace cpu
 } // namespace impl
 } // namespace dnnl
@@ -20,6 +20,7 @@
 #include <type_traits>
 
 #include "common/c_types_map.hpp"
+#include "common/dnnl_thread.hpp"
 #include "common/memory_desc_wrapper.hpp"
 #include "common/utils.hpp"
 
@@ -230,6 +231,19 @@ struct rnn_conf_t {
     bool merge_gemm_iter, merge_gemm_layer, force_nocopy, use_layer_packed_gemm,
             use_iter_packed_gemm, use_projection_packed_gemm;
     int n_iter_scratch_gates;
+    // Forward cells on the same wavefront (same layer + iter) run
+    // concurrently, each with its own slot of scratch gates and scratch cell
+    bool wavefront;
+    int n_wave_slots;
+    // Forward inference keeping the states of two iterations per layer
+    // instead of all of them, see ws_states_it()
+    bool streaming;
+    int ws_states_n_iter;
+
+    // Index in the workspace of the states after iteration it - 1, it in
+    // [0, n_iter]. Streaming alternates between two slots: cell (l, t)
+    // reads slot t % 2 of its layer and writes slot (t + 1) % 2.
+    inline int ws_states_it(int it) const { return streaming ? it % 2 : it; }
 
     inline bool is_int8() const {
         return utils::one_of(
@@ -334,6 +348,13 @@ bool is_ldoi(const memory_desc_wrapper &md);
 
 int get_good_ld(int dim, int sizeof_dt);
 
+/** Overrides of the wavefront and streaming schedules: -1 lets init_conf()
+ * decide, 0 disables and 1 forces the schedule wherever it applies. They
+ * start from DNNL_RNN_WAVEFRONT and DNNL_RNN_STREAMING and apply to the
+ * primitive descriptors created after a change. */
+int get_wavefront_override();
+int get_streaming_override();
+
 template <typename T>
 bool init_conf(rnn_conf_t &rnn, const rnn_desc_t &rd,
         const memory_desc_wrapper &src_layer_d,
@@ -512,6 +533,49 @@ bool init_conf(rnn_conf_t &rnn, const rnn_desc_t &rd,
             && (((rnn.is_fwd && rnn.mb < 128) || !rnn.is_fwd) || rnn.is_int8());
     rnn.merge_gemm_iter
             = dst_layer_is_trivial_stride && !(rnn.is_fwd || is_gru);
+
+    /* Decide to run the cells of a wavefront concurrently. Cell (l, t) only
+     * depends on (l - 1, t) and (l, t - 1) of its direction, so the cells
+     * with l + t = w of all the directions are independent. It pays off when
+     * a cell is too small to keep the threads busy (small mb) and the widest
+     * waves have a cell per thread: a cell of a multi-cell wave runs on a
+     * single thread, so with fewer cells than threads part of the team would
+     * idle while each cell lost its own threading. A wavefront needs a layer
+     * GEMM per cell, hence no merging across iterations.
+     * DNNL_RNN_WAVEFRONT=0|1 overrides. */
+    const int n_wave_cells = rnn.n_dir * nstl::min(rnn.n_layer, rnn.n_iter);
+    const int wavefront_env = get_wavefront_override();
+    rnn.wavefront = rnn.is_fwd && !rnn.is_lstm_projection && !rnn.is_int8()
+            && n_wave_cells > 1
+            && (wavefront_env == 1
+                    || (wavefront_env < 0 && rnn.mb <= 16
+                            && n_wave_cells >= dnnl_get_max_threads()));
+    rnn.n_wave_slots = rnn.wavefront ? n_wave_cells : 1;
+    if (rnn.wavefront) rnn.merge_gemm_layer = false;
+
+    /* Decide to stream forward inference: the cells run iteration by
+     * iteration (or by wavefronts), so each layer only needs the states of
+     * the previous and the current iterations, and the memory no longer
+     * grows with the sequence. It rules out the layer GEMM merged across
+     * iterations, and needs the input and output sequences to be read and
+     * written in place by the cells, which l2r RNNs without projection do.
+     * It is used when there is no merged GEMM to lose or when the states
+     * of all the iterations would take more than 64 MB. Like the wavefront,
+     * it is not used for int8, which always merges the layer GEMM.
+     * DNNL_RNN_STREAMING=0|1 overrides. */
+    const int streaming_env = get_streaming_override();
+    const size_t ws_states_seq_size = (size_t)(rnn.n_layer + 1) * rnn.n_dir
+            * (rnn.n_iter + 1) * rnn.mb * rnn.ws_states_layer_ld
+            * sizeof(typename T::src_layer_t);
+    rnn.streaming = is_inference && !rnn.is_int8()
+            && rnn.skip_src_layer_copy() && rnn.skip_dst_layer_copy()
+            && rnn.n_iter > 1
+            && (streaming_env == 1
+                    || (streaming_env < 0
+                            && (!rnn.merge_gemm_layer
+                                    || ws_states_seq_size > (64 << 20))));
+    rnn.ws_states_n_iter = rnn.streaming ? 2 : rnn.n_iter + 1;
+    if (rnn.streaming) rnn.merge_gemm_layer = false;
     rnn.force_nocopy = false;
 #if DNNL_X64
     rnn.force_nocopy = !x64::mayiuse(x64::avx512_mic) && x64::mayiuse(x64::avx)
@@ -526,14 +590,12 @@ bool init_conf(rnn_conf_t &rnn, const rnn_desc_t &rd,
             = utils::one_of(weights_layer_d.format_kind(), format_kind::any,
                       format_kind::rnn_packed)
             && is_inference
-            && ((is_f32 && pack_sgemm_supported() && rnn.n_iter == 1)
-                    || rnn.is_int8() || is_bf16);
+            && ((is_f32 && rnn.n_iter == 1) || rnn.is_int8() || is_bf16);
     rnn.use_iter_packed_gemm
             = utils::one_of(weights_iter_d.format_kind(), format_kind::any,
                       format_kind::rnn_packed)
             && is_inference
-            && ((is_f32 && pack_sgemm_supported() && rnn.mb >= 16)
-                    || rnn.is_int8() || is_bf16);
+            && ((is_f32 && rnn.mb >= 16) || rnn.is_int8() || is_bf16);
     rnn.use_projection_packed_gemm = false;
 
     /* Set packed gemm sizes */
@@ -667,18 +729,16 @@ void set_conf(rnn_conf_t &rnn, const rnn_desc_t &rd,
     assert(sizeof(typename T::src_iter_t) == sizeof(typename T::dst_iter_t));
 
     rnn.use_workspace = rnn.is_training;
-    // TODO: for inference, we can make ws_states_* smaller, but
-    // dependant of the grid execution though
     rnn.ws_states_layer_size = (size_t)(rnn.n_layer + 1) * rnn.n_dir
-            * (rnn.n_iter + 1) * rnn.mb * rnn.ws_states_layer_ld
+            * rnn.ws_states_n_iter * rnn.mb * rnn.ws_states_layer_ld
             * sizeof(typename T::src_layer_t);
     rnn.ws_states_iter_size = (size_t)(rnn.n_layer + 1) * rnn.n_dir
-            * (rnn.n_iter + 1) * rnn.mb * rnn.ws_states_iter_ld
+            * rnn.ws_states_n_iter * rnn.mb * rnn.ws_states_iter_ld
             * sizeof(typename T::src_iter_t);
     bool is_lstm = rd.cell_kind == dnnl_vanilla_lstm;
     rnn.ws_states_iter_c_size = is_lstm
-            ? (size_t)(rnn.n_layer + 1) * rnn.n_dir * (rnn.n_iter + 1) * rnn.mb
-                    * rnn.ws_states_iter_c_ld * sizeof(float)
+            ? (size_t)(rnn.n_layer + 1) * rnn.n_dir * rnn.ws_states_n_iter
+                    * rnn.mb * rnn.ws_states_iter_c_ld * sizeof(float)
             : 0;
 
     rnn.ws_diff_states_layer_size = rnn.is_training
@@ -707,8 +767,9 @@ void set_conf(rnn_conf_t &rnn, const rnn_desc_t &rd,
             : (size_t)0;
     rnn.n_iter_scratch_gates
             = (rnn.merge_gemm_layer || rnn.merge_gemm_iter) ? rnn.n_iter : 1;
-    rnn.scratch_gates_size = rnn.n_iter_scratch_gates * rnn.scratch_gates_nld
-            * rnn.scratch_gates_ld * sizeof(typename T::scratch_t);
+    rnn.scratch_gates_size = rnn.n_iter_scratch_gates * rnn.n_wave_slots
+            * rnn.scratch_gates_nld * rnn.scratch_gates_ld
+            * sizeof(typename T::scratch_t);
     rnn.scratch_ht_size
             = rnn.scratch_ht_nld * rnn.scratch_ht_ld * sizeof(typename T::ht_t);
     rnn.scratch_diff_ht_size = rnn.is_training ? rnn.scratch_diff_ht_nld
@@ -725,6 +786,7 @@ void set_conf(rnn_conf_t &rnn, const rnn_desc_t &rd,
                                     * rnn.ws_states_layer_ld
                                     * sizeof(typename T::gemm_acc_t)
                             : 0);
+    rnn.scratch_cell_size *= rnn.n_wave_slots;
     /// workspace needed for lbr GRU
     rnn.ws_per_cell = (size_t)rnn.is_lbr * rnn.mb * rnn.dhc
             * sizeof(typename T::gemm_acc_t);
@@ -909,6 +971,11 @@ private:
 };
 
 } // namespace rnn_utils
+
+// undocumented API, for testing only: sets the schedule overrides of
+// rnn_utils, the primitive cache may still return primitives made before
+status_t DNNL_API set_rnn_schedule_overrides(int wavefront, int streaming);
+
 } // namespace cpu
 } // namespace impl
 } // namespace dnnl
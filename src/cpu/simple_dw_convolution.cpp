@@ -0,0 +1,495 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <assert.h>
+
+#include "common/c_types_map.hpp"
+#include "common/dnnl_thread.hpp"
+#include "common/type_helpers.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/platform.hpp"
+#include "cpu/simple_dw_convolution.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+using namespace format_tag;
+using namespace memory_tracking::names;
+
+namespace {
+// widest channel block (Goihw16g)
+constexpr dim_t max_ch_blk = 16;
+
+// Output positions o in [lo, hi) whose input position o * S + koff lies in
+// [0, I), as [s, e). Empty ranges come back with s == e.
+inline void valid_range(dim_t koff, dim_t S, dim_t I, dim_t lo, dim_t hi,
+        dim_t &s, dim_t &e) {
+    s = nstl::max(lo, koff < 0 ? utils::div_up(-koff, S) : (dim_t)0);
+    e = nstl::min(hi, I - 1 - koff < 0 ? (dim_t)0 : (I - 1 - koff) / S + 1);
+    if (e < s) e = s;
+}
+
+// Output position o with o * S + koff == i, or -1 when there is none in
+// [0, O).
+inline dim_t out_pos(dim_t i, dim_t koff, dim_t S, dim_t O) {
+    const dim_t n = i - koff;
+    if (n < 0 || n % S) return -1;
+    const dim_t o = n / S;
+    return o < O ? o : -1;
+}
+} // namespace
+
+namespace simple_dw_convolution_utils {
+
+format_tag_t dat_tag(
+        int ndims, const memory_desc_t &src_md, const memory_desc_t &dst_md) {
+    if (!utils::one_of(ndims, 3, 4)) return undef;
+    const memory_desc_t &md
+            = src_md.format_kind == format_kind::any ? dst_md : src_md;
+    if (md.format_kind == format_kind::any) return ndims == 3 ? ncw : nchw;
+    return ndims == 3
+            ? memory_desc_matches_one_of_tag(md, ncw, nwc, nCw8c, nCw16c)
+            : memory_desc_matches_one_of_tag(md, nchw, nhwc, nChw8c, nChw16c);
+}
+
+format_tag_t wei_tag(int ndims, format_tag_t dat_tag) {
+    const bool is_1d = ndims == 3;
+    switch (dat_tag) {
+        case ncw:
+        case nchw: return is_1d ? goiw : goihw;
+        case nCw8c:
+        case nChw8c: return is_1d ? Goiw8g : Goihw8g;
+        case nwc:
+        case nhwc:
+        case nCw16c:
+        case nChw16c: return is_1d ? Goiw16g : Goihw16g;
+        default: return undef;
+    }
+}
+
+bool is_dw_ok(const convolution_pd_t *pd) {
+    return pd->with_groups() && utils::one_of(pd->ndims(), 3, 4)
+            && pd->G() == pd->IC() && pd->G() == pd->OC();
+}
+
+status_t init_conf(simple_dw_conf_t &c, const convolution_pd_t *pd,
+        const memory_desc_t &src_md, const memory_desc_t &wei_md,
+        const memory_desc_t &dst_md) {
+    const memory_desc_wrapper src_d(src_md), wei_d(wei_md), dst_d(dst_md);
+    const int ndims = pd->ndims();
+    const bool is_1d = ndims == 3;
+
+    c.ch_vec = !src_d.matches_one_of_tag(ncw, nchw);
+    c.zero_pad = c.ch_vec && src_d.blocking_desc().inner_nblks > 0;
+    c.ch_blk = c.ch_vec ? wei_d.blocking_desc().inner_blks[0] : 1;
+    if (c.ch_blk > max_ch_blk) return status::unimplemented;
+
+    c.MB = pd->MB();
+    c.C = pd->G();
+    c.nb_ch = utils::div_up(c.C, c.ch_blk);
+    c.IH = pd->IH();
+    c.IW = pd->IW();
+    c.OH = pd->OH();
+    c.OW = pd->OW();
+    c.KH = pd->KH();
+    c.KW = pd->KW();
+    c.SH = pd->KSH();
+    c.SW = pd->KSW();
+    c.DH = pd->KDH() + 1;
+    c.DW = pd->KDW() + 1;
+    c.padT = pd->padT();
+    c.padL = pd->padL();
+
+    auto data_strides = [&](const memory_desc_wrapper &d) {
+        const auto &bd = d.blocking_desc();
+        simple_dw_conf_t::strides_t s;
+        s.off0 = d.offset0();
+        s.n = bd.strides[0];
+        // nspc: a channel block is ch_blk channels of stride 1
+        s.cb = c.ch_vec && !c.zero_pad ? c.ch_blk * bd.strides[1]
+                                       : bd.strides[1];
+        s.h = is_1d ? 0 : bd.strides[2];
+        s.w = bd.strides[ndims - 1];
+        return s;
+    };
+    c.src = data_strides(src_d);
+    c.dst = data_strides(dst_d);
+
+    // G x 1 x 1 x [KH x] KW
+    const auto &wbd = wei_d.blocking_desc();
+    c.wei.off0 = wei_d.offset0();
+    c.wei.n = 0;
+    c.wei.cb = wbd.strides[0];
+    c.wei.h = is_1d ? 0 : wbd.strides[3];
+    c.wei.w = wbd.strides[ndims];
+
+    c.nthr_sp = 1;
+
+    // width kernels run over dense rows
+    if (!c.ch_vec && (c.src.w != 1 || c.dst.w != 1))
+        return status::unimplemented;
+    return status::success;
+}
+
+void init_bwd_weights_reduction(simple_dw_conf_t &c,
+        memory_tracking::registrar_t &scratchpad, bool with_bias,
+        int max_threads) {
+    const dim_t slices = c.nb_ch * c.KH;
+    c.nthr_sp = slices >= max_threads
+            ? 1
+            : nstl::min(c.MB * c.OH, (dim_t)max_threads / slices);
+    if (c.nthr_sp == 1) return;
+
+    // the partial sums mirror the layout of diff_weights and diff_bias
+    scratchpad.book<float>(
+            key_conv_wei_reduction, (c.nthr_sp - 1) * c.nb_ch * c.wei.cb);
+    if (with_bias)
+        scratchpad.book<float>(key_conv_bia_reduction,
+                (c.nthr_sp - 1) * c.nb_ch * c.ch_blk);
+}
+
+} // namespace simple_dw_convolution_utils
+
+void simple_dw_convolution_fwd_t::post_ops(
+        data_t *acc, const data_t *dst, dim_t len) const {
+    if (with_sum()) {
+        PRAGMA_OMP_SIMD()
+        for (dim_t i = 0; i < len; ++i)
+            acc[i] += sum_scale_ * dst[i];
+    }
+    if (eltwise_) eltwise_->compute_vec_reg(acc, acc, (int)len);
+}
+
+void simple_dw_convolution_fwd_t::execute_forward(
+        const exec_ctx_t &ctx) const {
+    auto src = CTX_IN_MEM(const data_t *, DNNL_ARG_SRC);
+    auto weights = CTX_IN_MEM(const data_t *, DNNL_ARG_WEIGHTS);
+    auto bias = CTX_IN_MEM(const data_t *, DNNL_ARG_BIAS);
+    auto dst = CTX_OUT_MEM(data_t *, DNNL_ARG_DST);
+
+    const simple_dw_conf_t &c = pd()->conf_;
+    src += c.src.off0;
+    weights += c.wei.off0;
+    dst += c.dst.off0;
+
+    if (c.ch_vec) {
+        parallel_nd(c.MB, c.nb_ch, c.OH, [&](dim_t mb, dim_t chb, dim_t oh) {
+            const dim_t ch0 = chb * c.ch_blk;
+            const dim_t clen = nstl::min(c.ch_blk, c.C - ch0);
+            const data_t *s0 = src + mb * c.src.n + chb * c.src.cb;
+            const data_t *w0 = weights + chb * c.wei.cb;
+            data_t *d0 = dst + mb * c.dst.n + chb * c.dst.cb + oh * c.dst.h;
+
+            data_t acc[max_ch_blk];
+            for (dim_t ow = 0; ow < c.OW; ++ow) {
+                PRAGMA_OMP_SIMD()
+                for (dim_t ch = 0; ch < clen; ++ch)
+                    acc[ch] = bias ? bias[ch0 + ch] : 0.f;
+                for (dim_t kh = 0; kh < c.KH; ++kh) {
+                    const dim_t ih = oh * c.SH - c.padT + kh * c.DH;
+                    if (ih < 0 || ih >= c.IH) continue;
+                    for (dim_t kw = 0; kw < c.KW; ++kw) {
+                        const dim_t iw = ow * c.SW - c.padL + kw * c.DW;
+                        if (iw < 0 || iw >= c.IW) continue;
+                        const data_t *s = s0 + ih * c.src.h + iw * c.src.w;
+                        const data_t *w = w0 + kh * c.wei.h + kw * c.wei.w;
+                        PRAGMA_OMP_SIMD()
+                        for (dim_t ch = 0; ch < clen; ++ch)
+                            acc[ch] += s[ch] * w[ch];
+                    }
+                }
+                data_t *d = d0 + ow * c.dst.w;
+                post_ops(acc, d, clen);
+                PRAGMA_OMP_SIMD()
+                for (dim_t ch = 0; ch < clen; ++ch)
+                    d[ch] = acc[ch];
+                if (c.zero_pad)
+                    for (dim_t ch = clen; ch < c.ch_blk; ++ch)
+                        d[ch] = 0.f;
+            }
+        });
+        return;
+    }
+
+    parallel_nd(c.MB, c.C, c.OH, [&](dim_t mb, dim_t ch, dim_t oh) {
+        const data_t *s0 = src + mb * c.src.n + ch * c.src.cb;
+        const data_t *w0 = weights + ch * c.wei.cb;
+        data_t *d0 = dst + mb * c.dst.n + ch * c.dst.cb + oh * c.dst.h;
+        const data_t b = bias ? bias[ch] : 0.f;
+
+        constexpr dim_t vlen = platform::get_max_vector_length();
+        data_t acc[vlen];
+        for (dim_t ow0 = 0; ow0 < c.OW; ow0 += vlen) {
+            const dim_t vl = nstl::min(vlen, c.OW - ow0);
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < vl; ++i)
+                acc[i] = b;
+            for (dim_t kh = 0; kh < c.KH; ++kh) {
+                const dim_t ih = oh * c.SH - c.padT + kh * c.DH;
+                if (ih < 0 || ih >= c.IH) continue;
+                const data_t *srow = s0 + ih * c.src.h;
+                for (dim_t kw = 0; kw < c.KW; ++kw) {
+                    const data_t w = w0[kh * c.wei.h + kw * c.wei.w];
+                    const dim_t koff = kw * c.DW - c.padL;
+                    dim_t ow_s, ow_e;
+                    valid_range(koff, c.SW, c.IW, ow0, ow0 + vl, ow_s, ow_e);
+                    PRAGMA_OMP_SIMD()
+                    for (dim_t ow = ow_s; ow < ow_e; ++ow)
+                        acc[ow - ow0] += w * srow[ow * c.SW + koff];
+                }
+            }
+            data_t *d = d0 + ow0;
+            post_ops(acc, d, vl);
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < vl; ++i)
+                d[i] = acc[i];
+        }
+    });
+}
+
+void simple_dw_convolution_bwd_data_t::execute_backward_data(
+        const exec_ctx_t &ctx) const {
+    auto diff_dst = CTX_IN_MEM(const data_t *, DNNL_ARG_DIFF_DST);
+    auto weights = CTX_IN_MEM(const data_t *, DNNL_ARG_WEIGHTS);
+    auto diff_src = CTX_OUT_MEM(data_t *, DNNL_ARG_DIFF_SRC);
+
+    const simple_dw_conf_t &c = pd()->conf_;
+    diff_dst += c.dst.off0;
+    weights += c.wei.off0;
+    diff_src += c.src.off0;
+
+    if (c.ch_vec) {
+        parallel_nd(c.MB, c.nb_ch, c.IH, [&](dim_t mb, dim_t chb, dim_t ih) {
+            const dim_t clen = nstl::min(c.ch_blk, c.C - chb * c.ch_blk);
+            const data_t *dd0 = diff_dst + mb * c.dst.n + chb * c.dst.cb;
+            const data_t *w0 = weights + chb * c.wei.cb;
+            data_t *ds0 = diff_src + mb * c.src.n + chb * c.src.cb
+                    + ih * c.src.h;
+
+            data_t acc[max_ch_blk];
+            for (dim_t iw = 0; iw < c.IW; ++iw) {
+                PRAGMA_OMP_SIMD()
+                for (dim_t ch = 0; ch < clen; ++ch)
+                    acc[ch] = 0.f;
+                for (dim_t kh = 0; kh < c.KH; ++kh) {
+                    const dim_t oh
+                            = out_pos(ih, kh * c.DH - c.padT, c.SH, c.OH);
+                    if (oh < 0) continue;
+                    for (dim_t kw = 0; kw < c.KW; ++kw) {
+                        const dim_t ow
+                                = out_pos(iw, kw * c.DW - c.padL, c.SW, c.OW);
+                        if (ow < 0) continue;
+                        const data_t *dd = dd0 + oh * c.dst.h + ow * c.dst.w;
+                        const data_t *w = w0 + kh * c.wei.h + kw * c.wei.w;
+                        PRAGMA_OMP_SIMD()
+                        for (dim_t ch = 0; ch < clen; ++ch)
+                            acc[ch] += dd[ch] * w[ch];
+                    }
+                }
+                data_t *ds = ds0 + iw * c.src.w;
+                PRAGMA_OMP_SIMD()
+                for (dim_t ch = 0; ch < clen; ++ch)
+                    ds[ch] = acc[ch];
+                if (c.zero_pad)
+                    for (dim_t ch = clen; ch < c.ch_blk; ++ch)
+                        ds[ch] = 0.f;
+            }
+        });
+        return;
+    }
+
+    // Scatter each diff_dst row into the diff_src row: for a fixed kw the
+    // targets ow * SW + koff are distinct, so the ow loop vectorizes.
+    parallel_nd(c.MB, c.C, c.IH, [&](dim_t mb, dim_t ch, dim_t ih) {
+        const data_t *dd0 = diff_dst + mb * c.dst.n + ch * c.dst.cb;
+        const data_t *w0 = weights + ch * c.wei.cb;
+        data_t *ds = diff_src + mb * c.src.n + ch * c.src.cb + ih * c.src.h;
+
+        PRAGMA_OMP_SIMD()
+        for (dim_t iw = 0; iw < c.IW; ++iw)
+            ds[iw] = 0.f;
+        for (dim_t kh = 0; kh < c.KH; ++kh) {
+            const dim_t oh = out_pos(ih, kh * c.DH - c.padT, c.SH, c.OH);
+            if (oh < 0) continue;
+            const data_t *ddrow = dd0 + oh * c.dst.h;
+            for (dim_t kw = 0; kw < c.KW; ++kw) {
+                const data_t w = w0[kh * c.wei.h + kw * c.wei.w];
+                const dim_t koff = kw * c.DW - c.padL;
+                dim_t ow_s, ow_e;
+                valid_range(koff, c.SW, c.IW, 0, c.OW, ow_s, ow_e);
+                PRAGMA_OMP_SIMD()
+                for (dim_t ow = ow_s; ow < ow_e; ++ow)
+                    ds[ow * c.SW + koff] += w * ddrow[ow];
+            }
+        }
+    });
+}
+
+void simple_dw_convolution_bwd_weights_t::execute_backward_weights(
+        const exec_ctx_t &ctx) const {
+    auto diff_dst = CTX_IN_MEM(const data_t *, DNNL_ARG_DIFF_DST);
+    auto src = CTX_IN_MEM(const data_t *, DNNL_ARG_SRC);
+    auto diff_weights = CTX_OUT_MEM(data_t *, DNNL_ARG_DIFF_WEIGHTS);
+    auto diff_bias = CTX_OUT_MEM(data_t *, DNNL_ARG_DIFF_BIAS);
+
+    const simple_dw_conf_t &c = pd()->conf_;
+    diff_dst += c.dst.off0;
+    src += c.src.off0;
+    diff_weights += c.wei.off0;
+
+    // Each (part of MB x OH, channel block, kh) owns its slice of the
+    // partial sums of diff_weights and reduces over its part of MB x OH and
+    // OW itself; the kh == 0 ones also do diff_bias. Part 0 sums into
+    // diff_weights and diff_bias directly, the others into the scratchpad,
+    // and they are added up at the end.
+    const dim_t wei_sz = c.nb_ch * c.wei.cb, bia_sz = c.nb_ch * c.ch_blk;
+    auto scratchpad = ctx.get_scratchpad_grantor();
+    data_t *wei_red = c.nthr_sp > 1
+            ? scratchpad.get<data_t>(key_conv_wei_reduction)
+            : nullptr;
+    data_t *bia_red = c.nthr_sp > 1 && diff_bias
+            ? scratchpad.get<data_t>(key_conv_bia_reduction)
+            : nullptr;
+    auto wei_part = [&](dim_t sp) {
+        return sp == 0 ? diff_weights : wei_red + (sp - 1) * wei_sz;
+    };
+    auto bia_part = [&](dim_t sp) {
+        return sp == 0 ? diff_bias : bia_red + (sp - 1) * bia_sz;
+    };
+
+    if (c.ch_vec) {
+        parallel_nd(c.nthr_sp, c.nb_ch, c.KH,
+                [&](dim_t sp, dim_t chb, dim_t kh) {
+                    const dim_t ch0 = chb * c.ch_blk;
+                    const dim_t clen = nstl::min(c.ch_blk, c.C - ch0);
+                    const bool do_bias = diff_bias && kh == 0;
+                    data_t *dw0 = wei_part(sp) + chb * c.wei.cb + kh * c.wei.h;
+
+                    // padded channels of the G-blocked weights stay 0
+                    for (dim_t kw = 0; kw < c.KW; ++kw) {
+                        PRAGMA_OMP_SIMD()
+                        for (dim_t ch = 0; ch < c.ch_blk; ++ch)
+                            dw0[kw * c.wei.w + ch] = 0.f;
+                    }
+                    data_t db[max_ch_blk] = {0};
+
+                    dim_t start {0}, end {0};
+                    balance211(c.MB * c.OH, c.nthr_sp, sp, start, end);
+                    for (dim_t mb_oh = start; mb_oh < end; ++mb_oh) {
+                        const dim_t mb = mb_oh / c.OH, oh = mb_oh % c.OH;
+                        const dim_t ih = oh * c.SH - c.padT + kh * c.DH;
+                        const bool ih_ok = ih >= 0 && ih < c.IH;
+                        if (!ih_ok && !do_bias) continue;
+                        const data_t *dd0 = diff_dst + mb * c.dst.n
+                                + chb * c.dst.cb + oh * c.dst.h;
+                        const data_t *s0 = ih_ok ? src + mb * c.src.n
+                                        + chb * c.src.cb + ih * c.src.h
+                                                 : nullptr;
+                        for (dim_t ow = 0; ow < c.OW; ++ow) {
+                            const data_t *dd = dd0 + ow * c.dst.w;
+                            if (do_bias) {
+                                PRAGMA_OMP_SIMD()
+                                for (dim_t ch = 0; ch < clen; ++ch)
+                                    db[ch] += dd[ch];
+                            }
+                            if (!ih_ok) continue;
+                            for (dim_t kw = 0; kw < c.KW; ++kw) {
+                                const dim_t iw
+                                        = ow * c.SW - c.padL + kw * c.DW;
+                                if (iw < 0 || iw >= c.IW) continue;
+                                const data_t *s = s0 + iw * c.src.w;
+                                data_t *dw = dw0 + kw * c.wei.w;
+                                PRAGMA_OMP_SIMD()
+                                for (dim_t ch = 0; ch < clen; ++ch)
+                                    dw[ch] += dd[ch] * s[ch];
+                            }
+                        }
+                    }
+
+                    if (do_bias) {
+                        data_t *b = bia_part(sp) + ch0;
+                        for (dim_t ch = 0; ch < clen; ++ch)
+                            b[ch] = db[ch];
+                    }
+                });
+    } else {
+        parallel_nd(c.nthr_sp, c.C, c.KH, [&](dim_t sp, dim_t ch, dim_t kh) {
+            const data_t *dd0 = diff_dst + ch * c.dst.cb;
+            const data_t *s0 = src + ch * c.src.cb;
+            dim_t start {0}, end {0};
+            balance211(c.MB * c.OH, c.nthr_sp, sp, start, end);
+
+            for (dim_t kw = 0; kw < c.KW; ++kw) {
+                const dim_t koff = kw * c.DW - c.padL;
+                dim_t ow_s, ow_e;
+                valid_range(koff, c.SW, c.IW, 0, c.OW, ow_s, ow_e);
+                data_t acc = 0.f;
+                for (dim_t mb_oh = start; mb_oh < end; ++mb_oh) {
+                    const dim_t mb = mb_oh / c.OH, oh = mb_oh % c.OH;
+                    const dim_t ih = oh * c.SH - c.padT + kh * c.DH;
+                    if (ih < 0 || ih >= c.IH) continue;
+                    const data_t *ddrow = dd0 + mb * c.dst.n + oh * c.dst.h;
+                    const data_t *srow = s0 + mb * c.src.n + ih * c.src.h;
+                    PRAGMA_OMP_SIMD(reduction(+ : acc))
+                    for (dim_t ow = ow_s; ow < ow_e; ++ow)
+                        acc += ddrow[ow] * srow[ow * c.SW + koff];
+                }
+                wei_part(sp)[ch * c.wei.cb + kh * c.wei.h + kw * c.wei.w]
+                        = acc;
+            }
+
+            if (diff_bias && kh == 0) {
+                data_t db = 0.f;
+                for (dim_t mb_oh = start; mb_oh < end; ++mb_oh) {
+                    const dim_t mb = mb_oh / c.OH, oh = mb_oh % c.OH;
+                    const data_t *ddrow = dd0 + mb * c.dst.n + oh * c.dst.h;
+                    PRAGMA_OMP_SIMD(reduction(+ : db))
+                    for (dim_t ow = 0; ow < c.OW; ++ow)
+                        db += ddrow[ow];
+                }
+                bia_part(sp)[ch] = db;
+            }
+        });
+    }
+
+    if (c.nthr_sp == 1) return;
+
+    parallel_nd(c.nb_ch, [&](dim_t chb) {
+        data_t *dw = diff_weights + chb * c.wei.cb;
+        for (dim_t sp = 1; sp < c.nthr_sp; ++sp) {
+            const data_t *p = wei_part(sp) + chb * c.wei.cb;
+            PRAGMA_OMP_SIMD()
+            for (dim_t i = 0; i < c.wei.cb; ++i)
+                dw[i] += p[i];
+        }
+        if (!diff_bias) return;
+        const dim_t ch0 = chb * c.ch_blk;
+        const dim_t clen = nstl::min(c.ch_blk, c.C - ch0);
+        for (dim_t sp = 1; sp < c.nthr_sp; ++sp) {
+            const data_t *p = bia_part(sp) + ch0;
+            for (dim_t ch = 0; ch < clen; ++ch)
+                diff_bias[ch0 + ch] += p[ch];
+        }
+    });
+}
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
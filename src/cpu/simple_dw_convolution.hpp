@@ -0,0 +1,264 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_SIMPLE_DW_CONVOLUTION_HPP
+#define CPU_SIMPLE_DW_CONVOLUTION_HPP
+
+#include "common/c_types_map.hpp"
+#include "common/dnnl_thread.hpp"
+#include "common/memory_tracking.hpp"
+#include "common/primitive.hpp"
+#include "common/type_helpers.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/cpu_convolution_pd.hpp"
+#include "cpu/ref_eltwise.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+/** Depthwise (G == IC == OC) f32 direct convolution, 1D and 2D.
+ *
+ * Two kernel shapes, picked by the data layout:
+ * - nspc and nC*{8,16}c data with G-blocked weights: the innermost loop runs
+ *   over a block of channels, contiguous in data and weights alike;
+ * - ncsp data with plain weights: the innermost loop runs over a row of
+ *   output (or input) width, so it stays long for small channel counts.
+ */
+struct simple_dw_conf_t {
+    struct strides_t {
+        dim_t off0, n, cb, h, w; // cb: one channel block (ncsp: one channel)
+    };
+
+    bool ch_vec; // channel-block kernels (else width kernels)
+    bool zero_pad; // data is C-blocked: padded channels are written as 0
+    dim_t ch_blk, nb_ch;
+    dim_t MB, C, IH, IW, OH, OW, KH, KW;
+    dim_t SH, SW, DH, DW, padT, padL;
+    strides_t src, dst, wei;
+    dim_t nthr_sp; // bwd_weights: parts the MB x OH reduction is split in
+};
+
+namespace simple_dw_convolution_utils {
+
+/** data tag for the layout of \c src_md, or of \c dst_md when the former
+ * is \c any (ncsp when both are), or undef */
+format_tag_t dat_tag(
+        int ndims, const memory_desc_t &src_md, const memory_desc_t &dst_md);
+/** matching weights tag for \c dat_tag */
+format_tag_t wei_tag(int ndims, format_tag_t dat_tag);
+/** whether \c pd is a depthwise convolution this implementation covers */
+bool is_dw_ok(const convolution_pd_t *pd);
+
+/** \c src_md and \c dst_md are the (diff_)src and (diff_)dst descriptors,
+ * all formats set */
+status_t init_conf(simple_dw_conf_t &conf, const convolution_pd_t *pd,
+        const memory_desc_t &src_md, const memory_desc_t &wei_md,
+        const memory_desc_t &dst_md);
+
+/** sets \c conf.nthr_sp for bwd_weights: with fewer (channel block, kh)
+ * slices of the weights than threads, the MB x OH reduction is split as
+ * well, and the partial sums of all but the first part are booked */
+void init_bwd_weights_reduction(simple_dw_conf_t &conf,
+        memory_tracking::registrar_t &scratchpad, bool with_bias,
+        int max_threads);
+
+} // namespace simple_dw_convolution_utils
+
+struct simple_dw_convolution_fwd_t : public primitive_t {
+    struct pd_t : public cpu_convolution_fwd_pd_t {
+        using cpu_convolution_fwd_pd_t::cpu_convolution_fwd_pd_t;
+
+        DECLARE_COMMON_PD_T("simple_dw:any", simple_dw_convolution_fwd_t);
+
+        status_t init(engine_t *engine) {
+            using namespace simple_dw_convolution_utils;
+            const format_tag_t d_tag = dat_tag(ndims(), src_md_, dst_md_);
+            const format_tag_t w_tag = wei_tag(ndims(), d_tag);
+            bool ok = true && is_fwd()
+                    && set_default_alg_kind(alg_kind::convolution_direct)
+                    && expect_data_types(data_type::f32, data_type::f32,
+                            data_type::f32, data_type::f32, data_type::f32)
+                    && !has_zero_dim_memory() && is_dw_ok(this)
+                    && d_tag != format_tag::undef
+                    && set_default_formats_common(d_tag, w_tag, d_tag)
+                    && attr()->has_default_values(
+                            primitive_attr_t::skip_mask_t::post_ops)
+                    && post_ops_ok()
+                    && memory_desc_matches_tag(*src_md(), d_tag)
+                    && memory_desc_matches_tag(*dst_md(), d_tag)
+                    && memory_desc_matches_tag(*weights_md(), w_tag);
+            if (!ok) return status::unimplemented;
+
+            return init_conf(conf_, this, *src_md(), *weights_md(), *dst_md());
+        }
+
+        simple_dw_conf_t conf_;
+
+    protected:
+        bool post_ops_ok() const {
+            auto const &po = attr()->post_ops_;
+            auto is_eltwise
+                    = [&](int idx) { return po.entry_[idx].is_eltwise(); };
+            auto is_sum = [&](int idx) { return po.entry_[idx].is_sum(); };
+
+            switch (po.len_) {
+                case 0: return true; // no post_ops
+                case 1: return is_eltwise(0) || is_sum(0); // sum OR eltwise
+                case 2: return is_sum(0) && is_eltwise(1); // sum -> eltwise
+                default: return false;
+            }
+            return false;
+        }
+    };
+
+    simple_dw_convolution_fwd_t(const pd_t *apd)
+        : primitive_t(apd), sum_scale_(0.f), eltwise_(nullptr) {
+        const auto &post_ops = pd()->attr()->post_ops_;
+        const int sum_idx = post_ops.find(primitive_kind::sum);
+        if (sum_idx != -1) sum_scale_ = post_ops.entry_[sum_idx].sum.scale;
+
+        const int entry_idx = post_ops.find(primitive_kind::eltwise);
+        if (entry_idx != -1)
+            eltwise_ = new ref_eltwise_scalar_fwd_t(
+                    post_ops.entry_[entry_idx].eltwise);
+    }
+
+    ~simple_dw_convolution_fwd_t() { delete eltwise_; }
+
+    typedef typename prec_traits<data_type::f32>::type data_t;
+
+    virtual status_t execute(const exec_ctx_t &ctx) const override {
+        execute_forward(ctx);
+        return status::success;
+    }
+
+private:
+    void execute_forward(const exec_ctx_t &ctx) const;
+    void post_ops(data_t *acc, const data_t *dst, dim_t len) const;
+    const pd_t *pd() const { return (const pd_t *)primitive_t::pd().get(); }
+
+    bool with_sum() const { return sum_scale_ != 0.f; }
+
+    float sum_scale_;
+    ref_eltwise_scalar_fwd_t *eltwise_;
+};
+
+struct simple_dw_convolution_bwd_data_t : public primitive_t {
+    struct pd_t : public cpu_convolution_bwd_data_pd_t {
+        using cpu_convolution_bwd_data_pd_t::cpu_convolution_bwd_data_pd_t;
+
+        DECLARE_COMMON_PD_T(
+                "simple_dw:any", simple_dw_convolution_bwd_data_t);
+
+        status_t init(engine_t *engine) {
+            using namespace simple_dw_convolution_utils;
+            const format_tag_t d_tag
+                    = dat_tag(ndims(), diff_src_md_, diff_dst_md_);
+            const format_tag_t w_tag = wei_tag(ndims(), d_tag);
+            bool ok = true && desc()->prop_kind == prop_kind::backward_data
+                    && set_default_alg_kind(alg_kind::convolution_direct)
+                    && expect_data_types(data_type::f32, data_type::f32,
+                            data_type::undef, data_type::f32, data_type::f32)
+                    && !has_zero_dim_memory() && is_dw_ok(this)
+                    && d_tag != format_tag::undef
+                    && set_default_formats_common(d_tag, w_tag, d_tag)
+                    && attr()->has_default_values()
+                    && memory_desc_matches_tag(*diff_src_md(), d_tag)
+                    && memory_desc_matches_tag(*diff_dst_md(), d_tag)
+                    && memory_desc_matches_tag(*weights_md(), w_tag);
+            if (!ok) return status::unimplemented;
+
+            return init_conf(
+                    conf_, this, *diff_src_md(), *weights_md(), *diff_dst_md());
+        }
+
+        simple_dw_conf_t conf_;
+    };
+
+    simple_dw_convolution_bwd_data_t(const pd_t *apd) : primitive_t(apd) {}
+
+    typedef typename prec_traits<data_type::f32>::type data_t;
+
+    virtual status_t execute(const exec_ctx_t &ctx) const override {
+        execute_backward_data(ctx);
+        return status::success;
+    }
+
+private:
+    void execute_backward_data(const exec_ctx_t &ctx) const;
+    const pd_t *pd() const { return (const pd_t *)primitive_t::pd().get(); }
+};
+
+struct simple_dw_convolution_bwd_weights_t : public primitive_t {
+    struct pd_t : public cpu_convolution_bwd_weights_pd_t {
+        using cpu_convolution_bwd_weights_pd_t::
+                cpu_convolution_bwd_weights_pd_t;
+
+        DECLARE_COMMON_PD_T(
+                "simple_dw:any", simple_dw_convolution_bwd_weights_t);
+
+        status_t init(engine_t *engine) {
+            using namespace simple_dw_convolution_utils;
+            const format_tag_t d_tag
+                    = dat_tag(ndims(), src_md_, diff_dst_md_);
+            const format_tag_t w_tag = wei_tag(ndims(), d_tag);
+            bool ok = true && desc()->prop_kind == prop_kind::backward_weights
+                    && set_default_alg_kind(alg_kind::convolution_direct)
+                    && expect_data_types(data_type::f32, data_type::f32,
+                            data_type::f32, data_type::f32, data_type::f32)
+                    && !has_zero_dim_memory() && is_dw_ok(this)
+                    && d_tag != format_tag::undef
+                    && set_default_formats_common(d_tag, w_tag, d_tag)
+                    && attr()->has_default_values()
+                    && memory_desc_matches_tag(*src_md(), d_tag)
+                    && memory_desc_matches_tag(*diff_dst_md(), d_tag)
+                    && memory_desc_matches_tag(*diff_weights_md(), w_tag);
+            if (!ok) return status::unimplemented;
+
+            CHECK(init_conf(conf_, this, *src_md(), *diff_weights_md(),
+                    *diff_dst_md()));
+            auto scratchpad = scratchpad_registry().registrar();
+            init_bwd_weights_reduction(
+                    conf_, scratchpad, with_bias(), dnnl_get_max_threads());
+            return status::success;
+        }
+
+        simple_dw_conf_t conf_;
+    };
+
+    simple_dw_convolution_bwd_weights_t(const pd_t *apd) : primitive_t(apd) {}
+
+    typedef typename prec_traits<data_type::f32>::type data_t;
+
+    virtual status_t execute(const exec_ctx_t &ctx) const override {
+        execute_backward_weights(ctx);
+        return status::success;
+    }
+
+private:
+    void execute_backward_weights(const exec_ctx_t &ctx) const;
+    const pd_t *pd() const { return (const pd_t *)primitive_t::pd().get(); }
+};
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
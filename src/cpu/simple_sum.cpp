@@ -56,21 +56,15 @@ status_t simple_sum_t<src_data_type, dst_data_type>::execute(
         acc_data_t *my_ws = &wspace[ithr * bf16_p.ws_elements_per_thread_];
 
         for (dim_t b = start; b < end; b += bf16_p.acc_loop_step_) {
-            acc_data_t *my_acc = is_dst_bf16
-                    ? &my_ws[bf16_p.ws_cvt_elements_per_thread_]
-                    : (acc_data_t *)&output[b];
+            acc_data_t *my_acc
+                    = is_dst_bf16 ? my_ws : (acc_data_t *)&output[b];
             dim_t current_block = nstl::min(bf16_p.acc_loop_step_, end - b);
-            cvt_bfloat16_to_float(
-                    my_ws, (bfloat16_t *)&input_ptrs[0][b], current_block);
-            for (dim_t e = 0; e < current_block; e++)
-                my_acc[e] = scales[0] * my_ws[e];
-
-            for (int a = 1; a < num_arrs; a++) {
-                cvt_bfloat16_to_float(
-                        my_ws, (bfloat16_t *)&input_ptrs[a][b], current_block);
-                for (dim_t e = 0; e < current_block; e++)
-                    my_acc[e] += scales[a] * my_ws[e];
-            }
+            cvt_bfloat16_and_scale_to_float(my_acc,
+                    (bfloat16_t *)&input_ptrs[0][b], scales[0], current_block);
+            for (int a = 1; a < num_arrs; a++)
+                cvt_bfloat16_scale_and_accumulate_to_float(my_acc,
+                        (bfloat16_t *)&input_ptrs[a][b], scales[a],
+                        current_block);
             if (is_dst_bf16)
                 cvt_float_to_bfloat16(
                         (bfloat16_t *)&output[b], my_acc, current_block);
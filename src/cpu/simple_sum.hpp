@@ -30,9 +30,7 @@ namespace cpu {
 
 namespace {
 struct sum_bf16_params_t {
-    dim_t ws_cvt_elements_per_thread_;
-    dim_t ws_acc_elements_per_thread_;
-    dim_t ws_elements_per_thread_;
+    dim_t ws_elements_per_thread_; // f32 accumulator, bf16 dst only
     dim_t acc_loop_step_;
 };
 } // namespace
@@ -104,22 +102,13 @@ struct simple_sum_t : public primitive_t {
 
         void init_scratchpad() {
             if (src_data_type == data_type::bf16) {
+                // sources are converted, scaled and accumulated in one pass
+                // (cvt_bfloat16_scale_and_accumulate_to_float), straight
+                // into an f32 dst or into a block-sized f32 accumulator
                 bool is_dst_bf16_ = dst_data_type == data_type::bf16;
-                bf16_p_.ws_cvt_elements_per_thread_
-                        = platform::get_cache_line_size()
-                        / (int)sizeof(acc_data_t);
-
-                bf16_p_.ws_acc_elements_per_thread_ = is_dst_bf16_
-                        ? bf16_p_.ws_cvt_elements_per_thread_
-                        : 0;
-
-                bf16_p_.acc_loop_step_ = is_dst_bf16_
-                        ? bf16_p_.ws_cvt_elements_per_thread_
-                        : 1;
-
+                bf16_p_.acc_loop_step_ = block_size_;
                 bf16_p_.ws_elements_per_thread_
-                        = bf16_p_.ws_cvt_elements_per_thread_
-                        + bf16_p_.ws_acc_elements_per_thread_;
+                        = is_dst_bf16_ ? bf16_p_.acc_loop_step_ : 0;
                 dim_t bf16cvt_buf_sz_ = bf16_p_.ws_elements_per_thread_
                         * dnnl_get_max_threads();
                 auto scratchpad = scratchpad_registry().registrar();
@@ -0,0 +1,323 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <assert.h>
+
+#include "common/c_types_map.hpp"
+#include "common/dnnl_thread.hpp"
+#include "common/type_helpers.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/gemm/gemm.hpp"
+#include "cpu/platform.hpp"
+#include "cpu/simple_wino_convolution.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+using namespace memory_tracking::names;
+using namespace simple_wino_convolution_utils;
+
+namespace {
+/* F(4x4, 3x3): Y = A^T [(G g G^T) .* (B^T d B)] A with interpolation points
+ * 0, +-1, +-2 (Lavin & Gray). The B^T and A^T products run over n-vectors
+ * (one element per tile): in_k = in + k * in_s, out_i = out + i * out_s. */
+
+void apply_BT(const float *in, dim_t in_s, float *out, dim_t out_s, dim_t n) {
+    const float *i0 = in, *i1 = in + in_s, *i2 = in + 2 * in_s,
+                *i3 = in + 3 * in_s, *i4 = in + 4 * in_s, *i5 = in + 5 * in_s;
+    float *o0 = out, *o1 = out + out_s, *o2 = out + 2 * out_s,
+          *o3 = out + 3 * out_s, *o4 = out + 4 * out_s, *o5 = out + 5 * out_s;
+    PRAGMA_OMP_SIMD()
+    for (dim_t t = 0; t < n; ++t) {
+        const float d0 = i0[t], d1 = i1[t], d2 = i2[t], d3 = i3[t],
+                    d4 = i4[t], d5 = i5[t];
+        o0[t] = 4.f * d0 - 5.f * d2 + d4;
+        o1[t] = -4.f * (d1 + d2) + d3 + d4;
+        o2[t] = 4.f * (d1 - d2) - d3 + d4;
+        o3[t] = 2.f * (d3 - d1) - d2 + d4;
+        o4[t] = 2.f * (d1 - d3) - d2 + d4;
+        o5[t] = 4.f * d1 - 5.f * d3 + d5;
+    }
+}
+
+void apply_AT(const float *in, dim_t in_s, float *out, dim_t out_s, dim_t n) {
+    const float *i0 = in, *i1 = in + in_s, *i2 = in + 2 * in_s,
+                *i3 = in + 3 * in_s, *i4 = in + 4 * in_s, *i5 = in + 5 * in_s;
+    float *o0 = out, *o1 = out + out_s, *o2 = out + 2 * out_s,
+          *o3 = out + 3 * out_s;
+    PRAGMA_OMP_SIMD()
+    for (dim_t t = 0; t < n; ++t) {
+        const float m0 = i0[t], m1 = i1[t], m2 = i2[t], m3 = i3[t],
+                    m4 = i4[t], m5 = i5[t];
+        const float p12 = m1 + m2, m12 = m1 - m2;
+        const float p34 = m3 + m4, m34 = m3 - m4;
+        o0[t] = m0 + p12 + p34;
+        o1[t] = m12 + 2.f * m34;
+        o2[t] = p12 + 4.f * p34;
+        o3[t] = m12 + 8.f * m34 + m5;
+    }
+}
+
+inline void apply_G(const float g[3], float u[alpha]) {
+    u[0] = g[0] / 4.f;
+    u[1] = -(g[0] + g[1] + g[2]) / 6.f;
+    u[2] = -(g[0] - g[1] + g[2]) / 6.f;
+    u[3] = g[0] / 24.f + g[1] / 12.f + g[2] / 6.f;
+    u[4] = g[0] / 24.f - g[1] / 12.f + g[2] / 6.f;
+    u[5] = g[2];
+}
+} // namespace
+
+namespace simple_wino_convolution_utils {
+
+status_t init_conf(simple_wino_conf_t &c,
+        memory_tracking::registrar_t &scratchpad, const convolution_pd_t *pd,
+        int max_threads) {
+    const bool shape_ok = pd->KH() == 3 && pd->KW() == 3 && pd->KSH() == 1
+            && pd->KSW() == 1 && pd->KDH() == 0 && pd->KDW() == 0;
+    if (!shape_ok) return status::unimplemented;
+
+    c.MB = pd->MB();
+    c.IC = pd->IC();
+    c.OC = pd->OC();
+    c.IH = pd->IH();
+    c.IW = pd->IW();
+    c.OH = pd->OH();
+    c.OW = pd->OW();
+    c.padT = pd->padT();
+    c.padL = pd->padL();
+    c.tiles_h = utils::div_up(c.OH, tile);
+    c.tiles_w = utils::div_up(c.OW, tile);
+    c.ntiles = c.MB * c.tiles_h * c.tiles_w;
+
+    // V, M and the transform workspace of a tile block should stay in L2,
+    // but keep the GEMMs at least 16 wide and give every thread a block.
+    const dim_t a2 = alpha * alpha;
+    const size_t tile_bytes = sizeof(float) * a2 * (c.IC + c.OC + 2);
+    dim_t tb = (dim_t)(platform::get_per_core_cache_size(2) / tile_bytes);
+    tb = nstl::min(max_tile_blk, nstl::max((dim_t)16, tb));
+    tb = nstl::min(
+            tb, nstl::max((dim_t)16, utils::div_up(c.ntiles, max_threads)));
+    c.tile_blk = nstl::min(tb, c.ntiles);
+    c.nb_tile_blks = utils::div_up(c.ntiles, c.tile_blk);
+    c.nthr = (int)nstl::min((dim_t)max_threads, c.nb_tile_blks);
+    c.wei_transformed = is_wino_weights_md(*pd->weights_md(), c.OC, c.IC);
+
+    scratchpad.book<float>(
+            key_wino_V, (size_t)c.nthr * (a2 * c.IC + 2 * a2) * c.tile_blk);
+    scratchpad.book<float>(
+            key_wino_M, (size_t)c.nthr * a2 * c.OC * c.tile_blk);
+    if (!c.wei_transformed)
+        scratchpad.book<float>(key_wino_U, a2 * c.OC * c.IC);
+    return status::success;
+}
+
+void init_wino_weights_md(memory_desc_t &md, dim_t OC, dim_t IC) {
+    md.format_kind = format_kind::wino;
+    md.data_type = data_type::f32;
+    wino_desc_t &wd = md.format_desc.wino_desc;
+    wd = wino_desc_t();
+    wd.wino_format = dnnl_wino_wei_aaOI;
+    wd.r = 3;
+    wd.alpha = (int)alpha;
+    wd.ic = (int)IC;
+    wd.oc = (int)OC;
+    wd.ic_block = wd.ic2_block = 1;
+    wd.oc_block = wd.oc2_block = 1;
+    wd.adj_scale = 1.f;
+    wd.size = sizeof(float) * alpha * alpha * OC * IC;
+}
+
+bool is_wino_weights_md(const memory_desc_t &md, dim_t OC, dim_t IC) {
+    if (md.format_kind != format_kind::wino) return false;
+    memory_desc_t expect = md;
+    init_wino_weights_md(expect, OC, IC);
+    return md == expect;
+}
+
+void transform_weights(const float *weights, float *U, dim_t OC, dim_t IC) {
+    const dim_t U_s = OC * IC;
+    parallel_nd(OC, IC, [&](dim_t oc, dim_t ic) {
+        const float *g = weights + (oc * IC + ic) * 9;
+        float Gg[alpha][3], u[alpha];
+        for (int j = 0; j < 3; ++j) {
+            const float col[3] = {g[j], g[3 + j], g[6 + j]};
+            apply_G(col, u);
+            for (int i = 0; i < alpha; ++i)
+                Gg[i][j] = u[i];
+        }
+        for (int i = 0; i < alpha; ++i) {
+            apply_G(Gg[i], u);
+            for (int j = 0; j < alpha; ++j)
+                U[(i * alpha + j) * U_s + oc * IC + ic] = u[j];
+        }
+    });
+}
+
+} // namespace simple_wino_convolution_utils
+
+void simple_wino_convolution_fwd_t::transform_src(const data_t *src,
+        data_t *V, data_t *wsp, dim_t t0, dim_t n) const {
+    const auto &c = pd()->conf_;
+    dim_t src_off[max_tile_blk], ih0[max_tile_blk], iw0[max_tile_blk];
+    for (dim_t t = 0; t < n; ++t) {
+        const dim_t tt = t0 + t;
+        const dim_t tw = tt % c.tiles_w;
+        const dim_t th = (tt / c.tiles_w) % c.tiles_h;
+        const dim_t mb = tt / (c.tiles_w * c.tiles_h);
+        src_off[t] = mb * c.IC * c.IH * c.IW;
+        ih0[t] = th * tile - c.padT;
+        iw0[t] = tw * tile - c.padL;
+    }
+
+    data_t *d = wsp, *tmp = wsp + alpha * alpha * n;
+    const dim_t V_s = c.IC * n;
+    for (dim_t ic = 0; ic < c.IC; ++ic) {
+        const data_t *s = src + ic * c.IH * c.IW;
+        for (dim_t r = 0; r < alpha; ++r)
+            for (dim_t col = 0; col < alpha; ++col) {
+                data_t *dv = d + (r * alpha + col) * n;
+                PRAGMA_OMP_SIMD()
+                for (dim_t t = 0; t < n; ++t) {
+                    const dim_t ih = ih0[t] + r, iw = iw0[t] + col;
+                    const bool ok = ih >= 0 && ih < c.IH && iw >= 0
+                            && iw < c.IW;
+                    const dim_t off = ok ? src_off[t] + ih * c.IW + iw : 0;
+                    dv[t] = ok ? s[off] : 0.f;
+                }
+            }
+        for (dim_t col = 0; col < alpha; ++col)
+            apply_BT(d + col * n, alpha * n, tmp + col * n, alpha * n, n);
+        for (dim_t i = 0; i < alpha; ++i)
+            apply_BT(tmp + i * alpha * n, n, V + i * alpha * V_s + ic * n, V_s,
+                    n);
+    }
+}
+
+void simple_wino_convolution_fwd_t::transform_dst(const data_t *M,
+        const data_t *bias, data_t *dst, data_t *wsp, dim_t t0,
+        dim_t n) const {
+    const auto &c = pd()->conf_;
+    dim_t dst_off[max_tile_blk], oh0[max_tile_blk], ow0[max_tile_blk];
+    for (dim_t t = 0; t < n; ++t) {
+        const dim_t tt = t0 + t;
+        const dim_t tw = tt % c.tiles_w;
+        const dim_t th = (tt / c.tiles_w) % c.tiles_h;
+        const dim_t mb = tt / (c.tiles_w * c.tiles_h);
+        oh0[t] = th * tile;
+        ow0[t] = tw * tile;
+        dst_off[t] = mb * c.OC * c.OH * c.OW + oh0[t] * c.OW + ow0[t];
+    }
+
+    constexpr dim_t vlen = platform::get_max_vector_length();
+    data_t *tmp = wsp, *y = wsp + tile * alpha * n;
+    const dim_t M_s = c.OC * n;
+    for (dim_t oc = 0; oc < c.OC; ++oc) {
+        const data_t *m = M + oc * n;
+        for (dim_t col = 0; col < alpha; ++col)
+            apply_AT(m + col * M_s, alpha * M_s, tmp + col * n, alpha * n, n);
+        for (dim_t i = 0; i < tile; ++i)
+            apply_AT(tmp + i * alpha * n, n, y + i * tile * n, n, n);
+
+        const data_t b = bias ? bias[oc] : 0.f;
+        data_t *d = dst + oc * c.OH * c.OW;
+        for (dim_t i = 0; i < tile; ++i)
+            for (dim_t j = 0; j < tile; ++j) {
+                data_t *yv = y + (i * tile + j) * n;
+                const dim_t ij_off = i * c.OW + j;
+                PRAGMA_OMP_SIMD()
+                for (dim_t t = 0; t < n; ++t)
+                    yv[t] += b;
+                if (with_sum()) {
+                    PRAGMA_OMP_SIMD()
+                    for (dim_t t = 0; t < n; ++t) {
+                        const bool ok = oh0[t] + i < c.OH && ow0[t] + j < c.OW;
+                        const dim_t off = ok ? dst_off[t] + ij_off : 0;
+                        yv[t] += ok ? sum_scale_ * d[off] : 0.f;
+                    }
+                }
+                if (eltwise_)
+                    for (dim_t v0 = 0; v0 < n; v0 += vlen)
+                        eltwise_->compute_vec_reg(yv + v0, yv + v0,
+                                (int)nstl::min(vlen, n - v0));
+                for (dim_t t = 0; t < n; ++t)
+                    if (oh0[t] + i < c.OH && ow0[t] + j < c.OW)
+                        d[dst_off[t] + ij_off] = yv[t];
+            }
+    }
+}
+
+void simple_wino_convolution_fwd_t::execute_forward(
+        const exec_ctx_t &ctx) const {
+    auto src = CTX_IN_MEM(const data_t *, DNNL_ARG_SRC);
+    auto weights = CTX_IN_MEM(const data_t *, DNNL_ARG_WEIGHTS);
+    auto bias = CTX_IN_MEM(const data_t *, DNNL_ARG_BIAS);
+    auto dst = CTX_OUT_MEM(data_t *, DNNL_ARG_DST);
+
+    const memory_desc_wrapper src_d(pd()->src_md());
+    const memory_desc_wrapper weights_d(pd()->weights_md(0));
+    const memory_desc_wrapper dst_d(pd()->dst_md());
+    src += src_d.offset0();
+    weights += weights_d.offset0();
+    dst += dst_d.offset0();
+
+    const auto &c = pd()->conf_;
+    auto scratchpad = ctx.get_scratchpad_grantor();
+
+    const data_t *U = weights;
+    if (!c.wei_transformed) {
+        data_t *U_tr = scratchpad.get<data_t>(key_wino_U);
+        transform_weights(weights, U_tr, c.OC, c.IC);
+        U = U_tr;
+    }
+
+    const dim_t a2 = alpha * alpha;
+    data_t *V_base = scratchpad.get<data_t>(key_wino_V);
+    data_t *M_base = scratchpad.get<data_t>(key_wino_M);
+    const dim_t V_size = (a2 * c.IC + 2 * a2) * c.tile_blk;
+    const dim_t M_size = a2 * c.OC * c.tile_blk;
+
+    parallel(c.nthr, [&](const int ithr, const int nthr) {
+        data_t *V = V_base + ithr * V_size;
+        data_t *wsp = V + a2 * c.IC * c.tile_blk;
+        data_t *M = M_base + ithr * M_size;
+
+        dim_t start {0}, end {0};
+        balance211(c.nb_tile_blks, nthr, ithr, start, end);
+        for (dim_t tb = start; tb < end; ++tb) {
+            const dim_t t0 = tb * c.tile_blk;
+            const dim_t n = nstl::min(c.tile_blk, c.ntiles - t0);
+            transform_src(src, V, wsp, t0, n);
+
+            // M[xi] (OC x n) = U[xi] (OC x IC) * V[xi] (IC x n), row-major
+            const data_t zero = 0.0, one = 1.0;
+            for (dim_t xi = 0; xi < a2; ++xi)
+                extended_sgemm("N", "N", &n, &c.OC, &c.IC, &one,
+                        V + xi * c.IC * n, &n, U + xi * c.OC * c.IC, &c.IC,
+                        &zero, M + xi * c.OC * n, &n);
+
+            transform_dst(M, bias, dst, wsp, t0, n);
+        }
+    });
+}
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
@@ -0,0 +1,190 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_SIMPLE_WINO_CONVOLUTION_HPP
+#define CPU_SIMPLE_WINO_CONVOLUTION_HPP
+
+#include "common/c_types_map.hpp"
+#include "common/dnnl_thread.hpp"
+#include "common/memory_tracking.hpp"
+#include "common/primitive.hpp"
+#include "common/type_helpers.hpp"
+#include "common/utils.hpp"
+
+#include "cpu/cpu_convolution_pd.hpp"
+#include "cpu/ref_eltwise.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+/** Winograd F(4x4, 3x3) forward convolution, f32 nchw / oihw.
+ *
+ * Output is cut into 4x4 tiles (6x6 input tiles). A thread takes a block of
+ * tile_blk tiles at a time: it transforms the input into V[36][IC][tile_blk],
+ * does the 36 products M[xi] = V[xi] * U[xi] with extended_sgemm and
+ * transforms M back into dst, fusing bias and post-ops. The tile index is
+ * innermost in V and M, so every transform is a vector loop over tiles.
+ *
+ * The transformed weights are U[36][OC][IC]. For forward_inference with
+ * weights left to the primitive (\c any) the weights are expected in that
+ * layout, as the wino_wei_aaOI format the user reorders into once, like the
+ * x64 Winograd formats. Otherwise (oihw weights, forward_training) U is
+ * computed into the scratchpad by every execution: U costs 1 / ntiles of the
+ * GEMMs.
+ */
+struct simple_wino_conf_t {
+    dim_t MB, IC, OC, IH, IW, OH, OW, padT, padL;
+    dim_t tiles_h, tiles_w, ntiles;
+    dim_t tile_blk, nb_tile_blks;
+    int nthr;
+    // the weights are given as U (wino_wei_aaOI)
+    bool wei_transformed;
+};
+
+namespace simple_wino_convolution_utils {
+/** tile size */
+constexpr dim_t tile = 4;
+/** transformed tile size */
+constexpr dim_t alpha = 6;
+constexpr dim_t max_tile_blk = 256;
+
+status_t init_conf(simple_wino_conf_t &conf,
+        memory_tracking::registrar_t &scratchpad, const convolution_pd_t *pd,
+        int max_threads);
+
+/** The wino_wei_aaOI descriptor of \c OC x \c IC x 3 x 3 weights. */
+void init_wino_weights_md(memory_desc_t &md, dim_t OC, dim_t IC);
+bool is_wino_weights_md(const memory_desc_t &md, dim_t OC, dim_t IC);
+
+/** U[36][OC][IC] of oihw weights, shared with the reorder into
+ * wino_wei_aaOI. */
+void transform_weights(const float *weights, float *U, dim_t OC, dim_t IC);
+} // namespace simple_wino_convolution_utils
+
+struct simple_wino_convolution_fwd_t : public primitive_t {
+    struct pd_t : public cpu_convolution_fwd_pd_t {
+        using cpu_convolution_fwd_pd_t::cpu_convolution_fwd_pd_t;
+
+        DECLARE_COMMON_PD_T("simple_wino:any", simple_wino_convolution_fwd_t);
+
+        status_t init(engine_t *engine) {
+            using namespace format_tag;
+            using namespace simple_wino_convolution_utils;
+            // inference takes the weights transformed once by a reorder
+            if (desc()->prop_kind == prop_kind::forward_inference
+                    && weights_md_.format_kind == format_kind::any
+                    && ndims() == 4 && !with_groups())
+                init_wino_weights_md(weights_md_, OC(), IC());
+            bool ok = true && is_fwd()
+                    && utils::one_of(desc()->alg_kind,
+                            alg_kind::convolution_auto,
+                            alg_kind::convolution_winograd)
+                    && expect_data_types(data_type::f32, data_type::f32,
+                            data_type::f32, data_type::f32, data_type::f32)
+                    && !has_zero_dim_memory() && ndims() == 4
+                    && !with_groups()
+                    && set_default_formats_common(nchw, oihw, nchw)
+                    && attr()->has_default_values(
+                            primitive_attr_t::skip_mask_t::post_ops)
+                    && post_ops_ok() && memory_desc_matches_tag(*src_md(), nchw)
+                    && memory_desc_matches_tag(*dst_md(), nchw)
+                    && (memory_desc_matches_tag(*weights_md(), oihw)
+                            || is_wino_weights_md(*weights_md(), OC(), IC()));
+            if (!ok) return status::unimplemented;
+
+            auto scratchpad = scratchpad_registry().registrar();
+            CHECK(init_conf(conf_, scratchpad, this, dnnl_get_max_threads()));
+            if (desc()->alg_kind == alg_kind::convolution_auto
+                    && !is_winograd_sensible())
+                return status::unimplemented;
+            set_default_alg_kind(alg_kind::convolution_winograd);
+            return status::success;
+        }
+
+        simple_wino_conf_t conf_;
+
+    protected:
+        /* A 4x4 output tile costs 36 IC x OC multiply-adds in the GEMMs
+         * against 144 for direct convolution, plus transforms that grow as
+         * IC + OC: with few channels the transforms dominate, with small
+         * planes the partial edge tiles do. */
+        bool is_winograd_sensible() const {
+            using simple_wino_convolution_utils::tile;
+            return IC() >= 16 && OC() >= 16 && OH() >= 2 * tile
+                    && OW() >= 2 * tile;
+        }
+
+        bool post_ops_ok() const {
+            auto const &po = attr()->post_ops_;
+            auto is_eltwise
+                    = [&](int idx) { return po.entry_[idx].is_eltwise(); };
+            auto is_sum = [&](int idx) { return po.entry_[idx].is_sum(); };
+
+            switch (po.len_) {
+                case 0: return true; // no post_ops
+                case 1: return is_eltwise(0) || is_sum(0); // sum OR eltwise
+                case 2: return is_sum(0) && is_eltwise(1); // sum -> eltwise
+                default: return false;
+            }
+            return false;
+        }
+    };
+
+    simple_wino_convolution_fwd_t(const pd_t *apd)
+        : primitive_t(apd)
+        , sum_scale_(0.f)
+        , eltwise_(nullptr) {
+        const auto &post_ops = pd()->attr()->post_ops_;
+        const int sum_idx = post_ops.find(primitive_kind::sum);
+        if (sum_idx != -1) sum_scale_ = post_ops.entry_[sum_idx].sum.scale;
+
+        const int entry_idx = post_ops.find(primitive_kind::eltwise);
+        if (entry_idx != -1)
+            eltwise_ = new ref_eltwise_scalar_fwd_t(
+                    post_ops.entry_[entry_idx].eltwise);
+    }
+
+    ~simple_wino_convolution_fwd_t() { delete eltwise_; }
+
+    typedef typename prec_traits<data_type::f32>::type data_t;
+
+    virtual status_t execute(const exec_ctx_t &ctx) const override {
+        execute_forward(ctx);
+        return status::success;
+    }
+
+private:
+    void execute_forward(const exec_ctx_t &ctx) const;
+    void transform_src(const data_t *src, data_t *V, data_t *wsp, dim_t t0,
+            dim_t n) const;
+    void transform_dst(const data_t *M, const data_t *bias, data_t *dst,
+            data_t *wsp, dim_t t0, dim_t n) const;
+    const pd_t *pd() const { return (const pd_t *)primitive_t::pd().get(); }
+
+    bool with_sum() const { return sum_scale_ != 0.f; }
+
+    float sum_scale_;
+    ref_eltwise_scalar_fwd_t *eltwise_;
+};
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
@@ -0,0 +1,100 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#ifndef CPU_SIMPLE_WINO_REORDER_HPP
+#define CPU_SIMPLE_WINO_REORDER_HPP
+
+#include "common/primitive.hpp"
+#include "common/primitive_desc.hpp"
+#include "common/type_helpers.hpp"
+
+#include "cpu/cpu_reorder_pd.hpp"
+#include "cpu/simple_wino_convolution.hpp"
+
+namespace dnnl {
+namespace impl {
+namespace cpu {
+
+/** f32 oihw weights into the wino_wei_aaOI format of
+ * simple_wino_convolution_fwd_t: the Winograd transform the convolution
+ * otherwise redoes on every execution. */
+struct simple_wino_reorder_t : public primitive_t {
+    struct pd_t : public cpu_reorder_pd_t {
+        using cpu_reorder_pd_t::cpu_reorder_pd_t;
+
+        DECLARE_COMMON_PD_T("simple_wino_reorder", simple_wino_reorder_t);
+
+        static status_t create(reorder_pd_t **reorder_pd, engine_t *engine,
+                const primitive_attr_t *attr, engine_t *src_engine,
+                const memory_desc_t *src_md, engine_t *dst_engine,
+                const memory_desc_t *dst_md) {
+            using namespace simple_wino_convolution_utils;
+            const memory_desc_wrapper id(src_md), od(dst_md);
+            bool args_ok = true && id.data_type() == data_type::f32
+                    && od.data_type() == data_type::f32
+                    && od.format_kind() == format_kind::wino
+                    && od.wino_desc().wino_format == dnnl_wino_wei_aaOI
+                    && id.ndims() == 4 && id.matches_tag(format_tag::oihw)
+                    && id.dims()[2] == 3 && id.dims()[3] == 3
+                    && is_wino_weights_md(
+                            *dst_md, id.dims()[0], id.dims()[1]);
+            if (!args_ok) return status::invalid_arguments;
+
+            auto _pd = new pd_t(attr, src_engine->kind(), src_md,
+                    dst_engine->kind(), dst_md);
+            if (_pd == nullptr) return status::out_of_memory;
+            if (_pd->init(engine, src_engine, dst_engine) != status::success) {
+                delete _pd;
+                return status::unimplemented;
+            }
+            _pd->init_scratchpad_md();
+            return safe_ptr_assign<reorder_pd_t>(*reorder_pd, _pd);
+        }
+
+        status_t init(
+                engine_t *engine, engine_t *src_engine, engine_t *dst_engine) {
+            status_t status
+                    = cpu_reorder_pd_t::init(engine, src_engine, dst_engine);
+            if (status != status::success) return status;
+
+            return attr()->has_default_values() ? status::success
+                                                : status::unimplemented;
+        }
+    };
+
+    simple_wino_reorder_t(const pd_t *apd) : primitive_t(apd) {}
+
+    virtual status_t execute(const exec_ctx_t &ctx) const override {
+        auto input = CTX_IN_MEM(const float *, DNNL_ARG_FROM);
+        auto output = CTX_OUT_MEM(float *, DNNL_ARG_TO);
+
+        const memory_desc_wrapper id(pd()->src_md());
+        simple_wino_convolution_utils::transform_weights(
+                input + id.offset0(), output, id.dims()[0], id.dims()[1]);
+        return status::success;
+    }
+
+private:
+    const pd_t *pd() const { return (const pd_t *)primitive_t::pd().get(); }
+};
+
+} // namespace cpu
+} // namespace impl
+} // namespace dnnl
+
+#endif
+
+// vim: et ts=4 sw=4 cindent cino+=l0,\:4,N-s
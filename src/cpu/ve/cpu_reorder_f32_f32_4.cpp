@@ -14,6 +14,7 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include "cpu/simple_wino_reorder.hpp"
 #include "cpu/ve/cpu_reorder_split.hpp"
 
 namespace dnnl {
@@ -27,6 +28,7 @@ namespace reorder {
 const std::vector<rpd_create_f>& f32_f32_4() {
     static const std::vector<rpd_create_f> v = {
         DNNL_X64_ONLY(x64::wino_reorder_t<f32, f32>::pd_t::create,)
+        simple_wino_reorder_t::pd_t::create,
 
         REG_FAST_DIRECT_COPY_F32_F32_COMMA
 
@@ -90,7 +90,7 @@ void gemm_convolution_fwd_t::execute_forward(const exec_ctx_t &ctx) const {
             bool do_im2col = curr.do_im2col(prev);
             prev = curr;
 
-            if (jcp.im2col_sz && do_im2col) {
+            if (jcp.im2col_sz && do_im2col && !jcp.implicit_im2col) {
                 if (!is_problem_3d)
                     jit_gemm_convolution_utils::im2col<float>(jcp, _src, _col,
                             curr.sp, step.sp, curr.ic, step.ic);
@@ -118,8 +118,14 @@ void gemm_convolution_fwd_t::execute_forward(const exec_ctx_t &ctx) const {
             const data_t *_weights = weights + curr.g * weights_g_size
                     + curr.oc * weights_oc_size + curr.ic * jcp.ks;
 
-            extended_sgemm("N", "N", &m, &N, &K, &one, _source, &LDA, _weights,
-                    &LDB, &beta, _dst, &M);
+            if (jcp.implicit_im2col) {
+                const jit_gemm_convolution_utils::im2col_a_source_t a_src(
+                        jcp, _src, curr.sp, curr.ic);
+                implicit_sgemm("N", &m, &N, &K, &one, &a_src, _weights, &LDB,
+                        &beta, _dst, &M);
+            } else
+                extended_sgemm("N", "N", &m, &N, &K, &one, _source, &LDA,
+                        _weights, &LDB, &beta, _dst, &M);
             if (curr.ic == jcp.ic - step.ic) {
                 // TODO: for "outer threading" we have parallel section within
                 // outermost "parallel". It is not good. Consider to use
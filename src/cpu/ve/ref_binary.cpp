@@ -284,13 +284,18 @@ void ref_binary_t<src0_type, src1_type, dst_type>::execute_ref(
     params_t params {alg, do_sum, sum_scale, eltwise_ker_, scales,
             do_scale_src0, do_scale_src1};
 
+    const dims_fast_div_t &div_A = pd()->src0_dims_div();
     auto map_idx_B = [&](dim_t off) {
         dims_t dims;
-        for (int d = ndims - 1; d >= 0; --d) {
-            dims[d] = off % dims_A[d];
-            off /= dims_A[d];
+        if (div_A.ok()) {
+            div_A.coords(off, dims);
+        } else {
+            for (int d = ndims - 1; d >= 0; --d) {
+                dims[d] = off % dims_A[d];
+                off /= dims_A[d];
+            }
+            assert(off == 0);
         }
-        assert(off == 0);
 
         for (int d = 0; d < ndims; ++d) {
             dims[d] *= (!dims_bcast[d]);
@@ -306,7 +311,8 @@ void ref_binary_t<src0_type, src1_type, dst_type>::execute_ref(
         perform_op(&dst[off_A], src0[off_A], src1[off_B], params);
     });
 #elif 1 // vectorize the offset calculations
-    parallel(0, [&](const int ithr, const int nthr) {
+    parallel(nthr_for_cost(0, nelems_A, elementwise_item_cost),
+            [&](const int ithr, const int nthr) {
         dim_t start = 0, end = 0;
         balance211(nelems_A, nthr, ithr, start, end);
         if (start == end) return;
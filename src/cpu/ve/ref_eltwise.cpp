@@ -1626,7 +1626,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
 
 #define CASE2(ALG,EXPR) case eltwise_##ALG: { \
                 /*asm("### eltwise fwd dense " #ALG);*/ \
-                parallel_nd(nelems, [&](ptrdiff_t e) { \
+                parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) { \
                     data_t s = src[e]; \
                     data_t &d = dst[e]; \
                     EXPR; \
@@ -1636,7 +1636,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
 
     // a simpler alt to CASE_XY and CASE_XY_NO_RS, with simpler parallelization
 #define CASE_YX_FLT(ALG,EXPR) case eltwise_##ALG: { \
-                parallel_nd(nelems, [&](ptrdiff_t e) { \
+                parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) { \
                     float x = src[e]; \
                     data_t &y = dst[e]; \
                     EXPR; \
@@ -1647,7 +1647,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
         // eval EXPR as float, then round and saturate (if nec) to data_type
 #define CASE2_CVT_RS(ALG,EXPR) case eltwise_##ALG: { \
                 /*asm("### eltwise fwd dense " #ALG);*/ \
-                parallel_nd(nelems, [&](ptrdiff_t e) { \
+                parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) { \
                     const float s = (float)src[e]; \
                     EXPR; \
                 }); \
@@ -1657,7 +1657,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
         /** y=fn(x), where y and x \b may be aliased */
 #define CASE_YX(ALG,...) /* ... can be simply y = expr(x) */ \
         case eltwise_##ALG: \
-            parallel_nd(utils::div_up(nelems, blksz), [&](dim_t const blk) { \
+            parallel_nd_cost(blksz * elementwise_item_cost, utils::div_up(nelems, blksz), [&](dim_t const blk) { \
                 dim_t const start = blk * blksz; \
                 dim_t const end   = (start + blksz > nelems? nelems: start + blksz); \
                 if (is_vectorizable<data_t>::value) { /* f32, s32 */ \
@@ -1684,7 +1684,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
             break
 #define CASE_YX_NO_RS(ALG,...) /* ... can be simply y = expr(x) */ \
         case eltwise_##ALG: \
-            parallel_nd(utils::div_up(nelems, blksz), [&](dim_t const blk) { \
+            parallel_nd_cost(blksz * elementwise_item_cost, utils::div_up(nelems, blksz), [&](dim_t const blk) { \
                 dim_t const start = blk * blksz; \
                 dim_t const end   = (start + blksz > nelems? nelems: start + blksz); \
                 if (is_vectorizable<data_t>::value) { /* f32, s32 */ \
@@ -1711,7 +1711,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
     // a fast path for relu as the most popular activation
     if (alg_kind == eltwise_relu) {
         // 1.372 1.452 0.0720 0.0688
-        parallel_nd( nelems, [&](ptrdiff_t e) { dst[e] = relu_fwd(src[e], alpha); });
+        parallel_nd_cost(1, nelems, [&](ptrdiff_t e) { dst[e] = relu_fwd(src[e], alpha); });
         // 0.0693, 0.0690 // XXX retry with bf16 on x86 XXX
         //parallel_nd( nelems, [&](ptrdiff_t e) { float fs = src[e];
         //             dst[e] = (data_t)(fs > 0.f? fs: alpha * fs);});
@@ -1719,7 +1719,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
     }
 
 #if ELT_FWD_DEN_VEC==0 // original: nc++ does not vectorize this (some unvectorizable func calls)
-    parallel_nd(nelems, [&](ptrdiff_t e) {
+    parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) {
         const data_t s = src[e];
 #if 0
         dst[e] = compute_eltwise_scalar_fwd(alg_kind, s, alpha, beta);
@@ -1748,7 +1748,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
     }
     if (pfn) {
         // 10.66 10.67 10.08 0.249,0.250
-        parallel_nd(utils::div_up(nelems, blksz), [&](dim_t const blk) {
+        parallel_nd_cost(blksz * elementwise_item_cost, utils::div_up(nelems, blksz), [&](dim_t const blk) {
             dim_t const start = blk * blksz;
             dim_t const end   = (start + blksz < nelems? start + blksz: nelems);
             int const sz = end - start;
@@ -1759,7 +1759,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
     // else continue with compute_eltwise_vector_fwd
 #endif
 #undef SWITCH_OUTSIDE
-    parallel_nd(utils::div_up(nelems, blksz), [&](dim_t const blk) {
+    parallel_nd_cost(blksz * elementwise_item_cost, utils::div_up(nelems, blksz), [&](dim_t const blk) {
         dim_t const start = blk * blksz;
         int const sz = (nelems - start < blksz? nelems - start: blksz);
         // strangely, for dense, this code performs way less well than the
@@ -1839,7 +1839,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
         // vet_ALG_fwd approach *SLOWER* by a little.
 #define CASE_VET(ALG) /* ... can be simply y = expr(x) */ \
         case eltwise_##ALG: { \
-            parallel_nd(utils::div_up(nelems, blksz), [&](dim_t const blk) { \
+            parallel_nd_cost(blksz * elementwise_item_cost, utils::div_up(nelems, blksz), [&](dim_t const blk) { \
                 dim_t const start = blk * blksz; \
                 int const sz = (nelems - start < blksz? nelems - start: blksz); \
                 vet_##ALG##_fwd(&src[start], &dst[start], sz, alpha, beta); \
@@ -1959,7 +1959,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
         CASE(pow, s, alpha, beta); // for completeness
 #define SUBCASE2(ALG,WHICH,EXPR) case eltwise_##ALG + WHICH: { \
     /*asm("### eltwise fwd dense " #ALG);*/ \
-    parallel_nd(nelems, [&](ptrdiff_t e) { \
+    parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) { \
                 const data_t s = src[e]; \
                 data_t &d = dst[e]; \
                 EXPR; \
@@ -1986,7 +1986,7 @@ void ref_eltwise_fwd_t<data_type>::execute_forward_dense(
         default:
         printf(" Error: TBD eltwis ref:dense DEN_VEC 2 for %s\n", dnnl_alg_kind2str(alg_kind));
         assert(!"unknown eltwise alg_kind");
-        parallel_nd(nelems, [&](ptrdiff_t e) {
+        parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) {
                 dst[e] = 0.f;
                 });
     }
@@ -2263,7 +2263,7 @@ void ref_eltwise_bwd_t<data_type>::execute_backward_dense(
     diff_src += diff_data_d.offset0();
 
 #if 0 // orig: nc++ did not vectorize if some 'switch' cases have func calls
-    parallel(0, [&](const int ithr, const int nthr) {
+    parallel(nthr_for_cost(0, nelems, elementwise_item_cost), [&](const int ithr, const int nthr) {
         dim_t start = 0, end = 0;
         balance211(nelems, nthr, ithr, start, end);
         if (start == end) return;
@@ -2278,7 +2278,7 @@ void ref_eltwise_bwd_t<data_type>::execute_backward_dense(
         // TODO comparing ovhd (small size src), I guess it might be good
         //      to compare with the non-balancing version of CASE in FWD code
 #define CASE2(ALG,EXPR) case eltwise_##ALG: { \
-    parallel(0, [&](const int ithr, const int nthr) { \
+    parallel(nthr_for_cost(0, nelems, elementwise_item_cost), [&](const int ithr, const int nthr) { \
             dim_t start = 0, end = 0; \
             balance211(nelems, nthr, ithr, start, end); \
             if (start == end) return; \
@@ -2296,7 +2296,7 @@ void ref_eltwise_bwd_t<data_type>::execute_backward_dense(
         CASE(relu, dd, s, alpha);
 #else // original longhand equivalent (for looking at asm code)
         case eltwise_relu: {
-            parallel(0, [&](const int ithr, const int nthr) {
+            parallel(nthr_for_cost(0, nelems, elementwise_item_cost), [&](const int ithr, const int nthr) {
                 dim_t start = 0, end = 0;
                 balance211(nelems, nthr, ithr, start, end);
                 if (start != end) {
@@ -2320,7 +2320,7 @@ void ref_eltwise_bwd_t<data_type>::execute_backward_dense(
         // ovflw cases: CASE(exp, dd, s);
         case eltwise_exp: {
             float const float_inf = HUGE_VALF;
-            parallel_nd(nelems, [&](ptrdiff_t e) {
+            parallel_nd_cost(elementwise_item_cost, nelems, [&](ptrdiff_t e) {
                 auto const s = src[e];
                 auto const dd = diff_dst[e];
                 data_t &ds = diff_src[e];
@@ -2376,7 +2376,7 @@ void ref_eltwise_bwd_t<data_type::bf16>::execute_backward_dense(
     diff_dst += diff_data_d.offset0();
     diff_src += diff_data_d.offset0();
 
-    parallel(0, [&](const int ithr, const int nthr) {
+    parallel(nthr_for_cost(0, nelems, elementwise_item_cost), [&](const int ithr, const int nthr) {
         dim_t start = 0, end = 0;
         balance211(nelems, nthr, ithr, start, end);
         if (start == end) return;
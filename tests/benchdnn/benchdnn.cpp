@@ -57,6 +57,10 @@ const char *driver_name = "";
 double max_ms_per_prb {3e3};
 int min_times_per_prb {5};
 int fix_times_per_prb {0};
+double peak_bw {0};
+std::string perf_baseline;
+std::string perf_save;
+double perf_tolerance {5};
 
 bool fast_ref_gpu {true};
 
@@ -126,6 +130,10 @@ int main(int argc, char **argv) {
         printf("total perf: min(ms):%g avg(ms):%g\n",
                 benchdnn_stat.ms[benchdnn_timer_t::min],
                 benchdnn_stat.ms[benchdnn_timer_t::avg]);
+        if (!perf_baseline.empty())
+            printf("perf baseline: compared:%d regressed:%d improved:%d\n",
+                    benchdnn_stat.perf_compared, benchdnn_stat.perf_regressed,
+                    benchdnn_stat.perf_improved);
     }
 
     return !!benchdnn_stat.failed;
@@ -213,7 +213,7 @@ int doit(const prb_t *p, res_t *r) {
         SAFE(compare(p, dst_fp, dst, r), WARN);
     }
 
-    measure_perf(r->timer, engine_tgt, b, args);
+    measure_perf(r, engine_tgt, b, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(b));
 
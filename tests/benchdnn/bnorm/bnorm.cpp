@@ -789,7 +789,7 @@ int doit(const prb_t *p, res_t *r) {
         }
     }
 
-    measure_perf(r->timer, engine_tgt, b, args);
+    measure_perf(r, engine_tgt, b, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(b));
 
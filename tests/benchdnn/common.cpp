@@ -20,6 +20,7 @@
 
 #include <fstream>
 #include <functional>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -231,6 +232,45 @@ void parse_result(res_t &res, bool &want_perf_report, bool allow_unimpl,
     }
 }
 
+/* perf baseline */
+bool perf_baseline_find(const std::string &key, double &min_ms) {
+    static std::map<std::string, double> baseline;
+    static bool loaded = false;
+    if (!loaded) {
+        loaded = true;
+        std::ifstream f(perf_baseline);
+        if (!f.is_open()) {
+            fprintf(stderr, "cannot open file %s\n", perf_baseline.c_str());
+            exit(2);
+        }
+        std::string line;
+        while (std::getline(f, line)) {
+            const size_t p0 = line.find(',');
+            const size_t p1 = line.find(',', p0 + 1);
+            if (p0 == std::string::npos || p1 == std::string::npos) continue;
+            baseline[line.substr(p1 + 1)] = atof(line.c_str());
+        }
+    }
+    auto it = baseline.find(key);
+    if (it == baseline.end()) return false;
+    min_ms = it->second;
+    return true;
+}
+
+void perf_baseline_save(const std::string &key, const benchdnn_timer_t &t) {
+    static FILE *f = nullptr;
+    if (!f) {
+        f = fopen(perf_save.c_str(), "w");
+        if (!f) {
+            fprintf(stderr, "cannot open file %s\n", perf_save.c_str());
+            exit(2);
+        }
+    }
+    fprintf(f, "%g,%g,%s\n", t.ms(benchdnn_timer_t::min),
+            t.ms(benchdnn_timer_t::avg), key.c_str());
+    fflush(f);
+}
+
 /* misc */
 
 #ifdef BENCHDNN_MEMORY_CHECK
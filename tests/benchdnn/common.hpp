@@ -130,6 +130,10 @@ extern const char *driver_name;
 extern double max_ms_per_prb; /** maximum time spends per prb in ms */
 extern int min_times_per_prb; /** minimal amount of runs per prb */
 extern int fix_times_per_prb; /** if non-zero run prb that many times */
+extern double peak_bw; /** peak memory bandwidth in GB/s, 0 means measure */
+extern std::string perf_baseline; /** file with timings to compare against */
+extern std::string perf_save; /** file to save timings into */
+extern double perf_tolerance; /** time ratio (%) not flagged as a change */
 
 extern bool fast_ref_gpu;
 
@@ -178,6 +182,9 @@ struct stat_t {
     int unimplemented;
     int listed;
     double ms[benchdnn_timer_t::mode_t::n_modes];
+    int perf_compared; /** problems found in the perf baseline */
+    int perf_regressed;
+    int perf_improved;
 };
 extern stat_t benchdnn_stat;
 
@@ -198,11 +205,16 @@ struct res_t {
     size_t errors, total;
     benchdnn_timer_t timer;
     std::string impl_name;
+    size_t ibytes, obytes; /** bytes read and written by one execution */
 };
 
 void parse_result(res_t &res, bool &want_perf_report, bool allow_unimpl,
         int status, const char *pstr);
 
+/* perf baseline: "min_ms,avg_ms,key" lines, the key being the repro line */
+bool perf_baseline_find(const std::string &key, double &min_ms);
+void perf_baseline_save(const std::string &key, const benchdnn_timer_t &t);
+
 /* misc */
 void init_fp_mode();
 
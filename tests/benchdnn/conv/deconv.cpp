@@ -295,7 +295,7 @@ int doit(const prb_t *p, res_t *r) {
         SAFE(FAIL, CRIT);
     }
 
-    measure_perf(r->timer, engine_tgt, d, args);
+    measure_perf(r, engine_tgt, d, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(d));
 
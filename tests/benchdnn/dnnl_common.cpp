@@ -20,6 +20,8 @@
 #include "dnnl_common.hpp"
 #include "dnnl_memory.hpp"
 
+#include "src/common/dnnl_thread.hpp"
+
 #if DNNL_CPU_THREADING_RUNTIME == DNNL_RUNTIME_THREADPOOL
 #include "../testing_threadpool.hpp"
 #endif
@@ -146,13 +148,32 @@ inline int measure_perf_aggregate(benchdnn_timer_t &t, dnnl_stream_t stream,
     return OK;
 }
 
-int measure_perf(benchdnn_timer_t &t, dnnl_engine_t engine,
-        dnnl_primitive_t prim, args_t &args) {
+// Compulsory traffic: every argument is read or written once. Workspace
+// and statistics count as inputs, and dst is not counted as read by a sum
+// post-op.
+static void count_bytes(res_t *r, const args_t &args) {
+    r->ibytes = r->obytes = 0;
+    for (int i = 0; i < args.size(); ++i) {
+        const int arg = args.arg(i);
+        if (arg == DNNL_ARG_SCRATCHPAD) continue;
+        const bool is_output = (arg >= DNNL_ARG_DST && arg <= DNNL_ARG_DST_2)
+                || (arg >= DNNL_ARG_DIFF_SRC && arg <= DNNL_ARG_DIFF_SRC_2)
+                || (arg >= DNNL_ARG_DIFF_WEIGHTS && arg <= DNNL_ARG_DIFF_BIAS)
+                || (arg >= DNNL_ARG_MULTIPLE_DST
+                        && arg < DNNL_ARG_ATTR_ZERO_POINTS);
+        (is_output ? r->obytes : r->ibytes) += args.dnn_mem(i).size();
+    }
+}
+
+int measure_perf(
+        res_t *r, dnnl_engine_t engine, dnnl_primitive_t prim, args_t &args) {
     dnnl_engine_kind_t engine_kind;
     DNN_SAFE(dnnl_engine_get_kind(engine, &engine_kind), CRIT);
 
     int ret = OK;
     if (bench_mode & PERF) {
+        benchdnn_timer_t &t = r->timer;
+        count_bytes(r, args);
         stream_t stream(engine);
         std::vector<dnnl_exec_arg_t> dnnl_args;
         execute_unmap_args(args, dnnl_args);
@@ -169,6 +190,39 @@ int measure_perf(benchdnn_timer_t &t, dnnl_engine_t engine,
     return ret;
 }
 
+double get_peak_bw() {
+    static double peak = -1;
+    if (peak >= 0) return peak;
+
+    peak = peak_bw * 1e9;
+    if (peak > 0 || engine_tgt_kind != dnnl_cpu) return peak;
+
+    // STREAM triad a = b + s * c on arrays far beyond the last level cache,
+    // first touched by the threads that use them
+    const int64_t n = 16 * 1024 * 1024;
+    float *a = (float *)zmalloc(3 * n * sizeof(float), 64);
+    if (!a) return peak = 0;
+    float *b = a + n, *c = b + n;
+    dnnl::impl::parallel_nd(n, [&](int64_t i) {
+        a[i] = 0.f;
+        b[i] = 1.f;
+        c[i] = 2.f;
+    });
+
+    benchdnn_timer_t t;
+    for (int rep = 0; rep < 10; ++rep) {
+        t.start();
+        dnnl::impl::parallel_nd(
+                n, [&](int64_t i) { a[i] = b[i] + 3.f * c[i]; });
+        t.stop();
+    }
+    zfree(a);
+
+    peak = t.sec() ? 3 * n * sizeof(float) / t.sec() : 0;
+    BENCHDNN_PRINT(0, "Peak bandwidth (triad): %g GB/s\n", peak / 1e9);
+    return peak;
+}
+
 void maybe_prepare_runtime_scales(dnn_mem_t &scales_m, const attr_t &attr,
         int64_t scale_cnt, const float *scales, dnnl_engine_t engine) {
     if (!attr.oscale.runtime) return;
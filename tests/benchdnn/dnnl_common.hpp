@@ -256,8 +256,12 @@ int init_prim(dnnl_primitive_t *prim, const func_t &init_pd_func,
 dnnl_status_t execute_and_wait(
         dnnl_primitive_t prim, dnnl_engine_t engine, const args_t &args);
 
-int measure_perf(benchdnn_timer_t &t, dnnl_engine_t engine,
-        dnnl_primitive_t prim, args_t &args);
+int measure_perf(
+        res_t *r, dnnl_engine_t engine, dnnl_primitive_t prim, args_t &args);
+
+/** Peak memory bandwidth in bytes per second: --peak-bw if given, else
+ * measured once with a STREAM triad on CPU; 0 if unknown. */
+double get_peak_bw();
 
 void maybe_prepare_runtime_scales(dnn_mem_t &scales_m, const attr_t &attr,
         int64_t scale_cnt, const float *scales, dnnl_engine_t engine_tgt);
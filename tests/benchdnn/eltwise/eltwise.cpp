@@ -432,7 +432,7 @@ int doit(const prb_t *p, res_t *r) {
         }
     }
 
-    measure_perf(r->timer, engine_tgt, e, args);
+    measure_perf(r, engine_tgt, e, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(e));
 
@@ -391,7 +391,7 @@ int doit(const prb_t *p, res_t *r) {
         }
     }
 
-    measure_perf(r->timer, engine_tgt, ip, args);
+    measure_perf(r, engine_tgt, ip, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(ip));
 
@@ -608,7 +608,7 @@ int doit(const prb_t *p, res_t *r) {
         }
     }
 
-    measure_perf(r->timer, engine_tgt, l, args);
+    measure_perf(r, engine_tgt, l, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(l));
 
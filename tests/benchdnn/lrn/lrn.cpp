@@ -298,7 +298,7 @@ int doit(const prb_t *p, res_t *r) {
     }
     const auto &engine_tgt
             = p->dir & FLAG_BWD ? engine_tgt_bwd : engine_tgt_fwd;
-    measure_perf(r->timer, engine_tgt, l, args);
+    measure_perf(r, engine_tgt, l, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(l));
 
@@ -222,6 +222,32 @@ static bool parse_fix_times_per_prb(
     return false;
 }
 
+static bool parse_peak_bw(
+        const char *str, const std::string &option_name = "peak-bw") {
+    return parse_single_value_option(peak_bw, atof, str, option_name);
+}
+
+static bool parse_perf_baseline(
+        const char *str, const std::string &option_name = "perf-baseline") {
+    const std::string pattern = get_pattern(option_name);
+    if (pattern.find(str, 0, pattern.size()) == eol) return false;
+    perf_baseline = std::string(str + pattern.size());
+    return true;
+}
+
+static bool parse_perf_save(
+        const char *str, const std::string &option_name = "perf-save") {
+    const std::string pattern = get_pattern(option_name);
+    if (pattern.find(str, 0, pattern.size()) == eol) return false;
+    perf_save = std::string(str + pattern.size());
+    return true;
+}
+
+static bool parse_perf_tolerance(
+        const char *str, const std::string &option_name = "perf-tolerance") {
+    return parse_single_value_option(perf_tolerance, atof, str, option_name);
+}
+
 static bool parse_verbose(
         const char *str, const std::string &option_name = "verbose") {
     const std::string pattern("-v"); // check short option first
@@ -266,7 +292,9 @@ bool parse_bench_settings(const char *str) {
     last_parsed_is_problem = false; // if start parsing, expect an option
 
     return parse_bench_mode(str) || parse_max_ms_per_prb(str)
-            || parse_fix_times_per_prb(str) || parse_verbose(str)
+            || parse_fix_times_per_prb(str) || parse_peak_bw(str)
+            || parse_perf_baseline(str) || parse_perf_save(str)
+            || parse_perf_tolerance(str) || parse_verbose(str)
             || parse_engine_kind(str) || parse_fast_ref_gpu(str)
             || parse_canonical(str) || parse_mem_check(str)
             || parse_scratchpad_mode(str) || parse_skip_impl(str);
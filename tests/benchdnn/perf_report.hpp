@@ -25,6 +25,7 @@
 #include <sstream>
 
 #include "dnnl.h"
+#include "dnnl_common.hpp"
 #include "dnnl_memory.hpp"
 
 // Please update doc/knobs_perf_report.md in case of any changes!
@@ -63,7 +64,26 @@ struct base_perf_report_t {
             return ops() / t.sec(mode) / unit;
         };
 
-        auto get_bw = [&]() -> double { return get_flops(); };
+        auto get_bw = [&]() -> double {
+            if (!t.sec(mode)) return 0;
+            return (r->ibytes + r->obytes) / t.sec(mode) / unit;
+        };
+
+        // achieved bandwidth in percent of the peak
+        auto get_bw_eff = [&]() -> double {
+            const double peak = get_peak_bw();
+            if (!peak || !t.sec(mode)) return 0;
+            return 100. * (r->ibytes + r->obytes) / t.sec(mode) / peak;
+        };
+
+        // baseline time over time, both min
+        auto get_speedup = [&]() -> double {
+            double base_ms = 0;
+            if (perf_baseline.empty() || !t.ms()
+                    || !perf_baseline_find(perf_key(prb_str), base_ms))
+                return 0;
+            return base_ms / t.ms();
+        };
 
         auto get_freq = [&]() -> double {
             if (!t.sec(mode)) return 0;
@@ -93,6 +113,11 @@ struct base_perf_report_t {
         HANDLE("stat_tag", if (stat_tag()) s << *stat_tag());
 
         HANDLE("bw", s << get_bw());
+        HANDLE("bw_eff", s << get_bw_eff());
+        HANDLE("ibytes", s << r->ibytes / unit);
+        HANDLE("obytes", s << r->obytes / unit);
+        HANDLE("iobytes", s << (r->ibytes + r->obytes) / unit);
+        HANDLE("speedup", s << get_speedup());
         HANDLE("flops", s << get_flops());
         HANDLE("clocks", s << t.ticks(mode) / unit);
         HANDLE("prb", s << prb_str);
@@ -124,6 +149,10 @@ struct base_perf_report_t {
 
         std::string str = ss.str();
         BENCHDNN_PRINT(0, "%s\n", str.c_str());
+
+        if (!perf_save.empty())
+            perf_baseline_save(perf_key(prb_str), r->timer);
+        if (!perf_baseline.empty()) compare_to_baseline(r, prb_str);
     };
 
     /* truly common types */
@@ -162,6 +191,33 @@ private:
         }
     }
 
+    static std::string perf_key(const char *prb_str) {
+        return std::string("--") + driver_name + " " + prb_str;
+    }
+
+    // flags problems whose min time moved by more than perf_tolerance
+    static void compare_to_baseline(const res_t *r, const char *prb_str) {
+        double base_ms = 0;
+        const double ms = r->timer.ms();
+        if (!ms || !perf_baseline_find(perf_key(prb_str), base_ms)) return;
+
+        auto &bs = benchdnn_stat;
+        bs.perf_compared++;
+        const double tol = 1. + perf_tolerance / 100.;
+        const char *verdict = nullptr;
+        if (ms > base_ms * tol) {
+            verdict = "regressed";
+            bs.perf_regressed++;
+        } else if (ms * tol < base_ms) {
+            verdict = "improved";
+            bs.perf_improved++;
+        }
+        if (verdict)
+            BENCHDNN_PRINT(0, "perf %s: x%g (%g ms -> %g ms) __REPRO: %s\n",
+                    verdict, base_ms / ms, base_ms, ms,
+                    perf_key(prb_str).c_str());
+    }
+
     static benchdnn_timer_t::mode_t modifier2mode(char c) {
         if (c == '-') return benchdnn_timer_t::min;
         if (c == '0') return benchdnn_timer_t::avg;
@@ -416,7 +416,7 @@ int doit(const prb_t *p, res_t *r) {
     }
 
     /* Step 7: performance measurement */
-    measure_perf(r->timer, engine_tgt, rp, args);
+    measure_perf(r, engine_tgt, rp, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(rp));
 
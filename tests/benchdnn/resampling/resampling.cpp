@@ -276,7 +276,7 @@ int doit(const prb_t *p, res_t *r) {
         }
     }
 
-    measure_perf(r->timer, engine_tgt, rp, args);
+    measure_perf(r, engine_tgt, rp, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(rp));
 
@@ -948,7 +948,7 @@ int doit(const prb_t &p, res_t *r) {
 
     const auto &engine_tgt
             = p.prop == dnnl_backward ? engine_tgt_bwd : engine_tgt_fwd;
-    measure_perf(r->timer, engine_tgt, c, args);
+    measure_perf(r, engine_tgt, c, args);
     cleanup();
 
     return OK;
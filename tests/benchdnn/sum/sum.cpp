@@ -186,7 +186,7 @@ int doit(const prb_t *p, res_t *r) {
         SAFE(compare(p, dst_data_type, dst_fp, dst, r), WARN);
     }
 
-    measure_perf(r->timer, engine_tgt, s, args);
+    measure_perf(r, engine_tgt, s, args);
 
     DNN_SAFE_V(dnnl_primitive_destroy(s));
 
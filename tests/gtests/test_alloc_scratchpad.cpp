@@ -21,6 +21,8 @@
 #include "dnnl_test_common.hpp"
 #include "gtest/gtest.h"
 
+#include "src/common/scratchpad.hpp"
+
 namespace dnnl {
 
 using dt = memory::data_type;
@@ -83,4 +85,35 @@ TEST_F(scratchpad_alloc_test, ScratchpadAllocTest) {
     strm.wait();
 }
 
+TEST_F(scratchpad_alloc_test, ScratchpadRetentionTest) {
+    const memory::dim N = 3, IC = 3, IH = 73, IW = 73, OC = 4;
+    auto src_md = memory::desc({N, IC, IH, IW}, dt::s8, tag::nchw);
+    auto wei_md = memory::desc({OC, IC, IH, IW}, dt::s8, tag::oihw);
+    auto dst_md = memory::desc({N, OC}, dt::s8, tag::nc);
+    auto op_desc = inner_product_forward::desc(
+            prop_kind::forward_inference, src_md, wei_md, dst_md);
+    auto pd = inner_product_forward::primitive_desc(op_desc, eng);
+    // the primitive has to use a scratchpad for the test to check anything
+    ASSERT_GT(pd.query_s64(query::memory_consumption_s64), 0);
+
+    const size_t old_retention = impl::get_scratchpad_retention();
+    impl::set_scratchpad_retention((size_t)1 << 30);
+    impl::reset_scratchpad_stats();
+    impl::scratchpad_stats_t stats;
+
+    { auto p = inner_product_forward(pd); }
+    impl::get_scratchpad_stats(&stats);
+    const size_t allocations = stats.allocations;
+    EXPECT_GT(stats.retained_bytes, 0u);
+    EXPECT_GE(stats.peak_bytes, stats.retained_bytes);
+
+    // the retained buffer serves the next primitive
+    { auto p = inner_product_forward(pd); }
+    impl::get_scratchpad_stats(&stats);
+    EXPECT_EQ(stats.allocations, allocations);
+    EXPECT_GE(stats.reuses, 1u);
+
+    impl::set_scratchpad_retention(old_retention);
+}
+
 } // namespace dnnl
@@ -0,0 +1,345 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+
+// The simple_dw depthwise convolutions, picked over the implementations that
+// come before them in the list, checked against a direct computation for all
+// the layouts they take, forward also with the sum and eltwise post-ops.
+// ctest runs this with more threads than some of the weights have slices, so
+// that the backward by weights splits its reduction.
+
+namespace dnnl {
+
+class dw_convolution_test : public ::testing::Test {
+protected:
+    using dim = memory::dim;
+    using tag = memory::format_tag;
+    using dt = memory::data_type;
+
+    struct shape_t {
+        dim mb, c, ih, iw, kh, kw, sh, sw, ph, pw, dh, dw; // dh, dw: 0 dense
+        bool is_1d; // ih == kh == 1, and the h dimension is dropped
+        dim oh() const { return out_size(ih, kh, sh, ph, dh); }
+        dim ow() const { return out_size(iw, kw, sw, pw, dw); }
+    };
+
+    struct layout_t {
+        tag dat, wei;
+    };
+
+    static dim out_size(dim i, dim k, dim s, dim p, dim d) {
+        return (i + 2 * p - ((k - 1) * (d + 1) + 1)) / s + 1;
+    }
+
+    static std::vector<shape_t> shapes() {
+        return {
+                {2, 16, 9, 11, 3, 3, 1, 1, 1, 1, 0, 0, false},
+                {2, 20, 10, 10, 3, 3, 2, 2, 1, 1, 0, 0, false},
+                {1, 5, 12, 13, 3, 5, 2, 3, 2, 1, 1, 1, false},
+                {3, 8, 7, 7, 5, 5, 1, 1, 0, 0, 0, 0, false},
+                {2, 3, 15, 17, 3, 3, 1, 2, 2, 2, 1, 0, false},
+                {2, 20, 1, 50, 1, 3, 1, 2, 0, 1, 0, 1, true},
+                {1, 6, 1, 33, 1, 5, 1, 1, 0, 4, 0, 1, true},
+        };
+    }
+
+    static std::vector<layout_t> layouts(bool is_1d) {
+        if (is_1d)
+            return {{tag::ncw, tag::goiw}, {tag::nwc, tag::Goiw16g},
+                    {tag::nCw8c, tag::Goiw8g}, {tag::nCw16c, tag::Goiw16g}};
+        return {{tag::nchw, tag::goihw}, {tag::nhwc, tag::Goihw16g},
+                {tag::nChw8c, tag::Goihw8g}, {tag::nChw16c, tag::Goihw16g}};
+    }
+
+    static memory::dims src_dims(const shape_t &s) {
+        if (s.is_1d) return {s.mb, s.c, s.iw};
+        return {s.mb, s.c, s.ih, s.iw};
+    }
+    static memory::dims dst_dims(const shape_t &s) {
+        if (s.is_1d) return {s.mb, s.c, s.ow()};
+        return {s.mb, s.c, s.oh(), s.ow()};
+    }
+    static memory::dims wei_dims(const shape_t &s) {
+        if (s.is_1d) return {s.c, 1, 1, s.kw};
+        return {s.c, 1, 1, s.kh, s.kw};
+    }
+    static memory::dims strides(const shape_t &s) {
+        if (s.is_1d) return {s.sw};
+        return {s.sh, s.sw};
+    }
+    static memory::dims dilates(const shape_t &s) {
+        if (s.is_1d) return {s.dw};
+        return {s.dh, s.dw};
+    }
+    static memory::dims padding(const shape_t &s) {
+        if (s.is_1d) return {s.pw};
+        return {s.ph, s.pw};
+    }
+    static tag plain_dat(const shape_t &s) {
+        return s.is_1d ? tag::ncw : tag::nchw;
+    }
+    static tag plain_wei(const shape_t &s) {
+        return s.is_1d ? tag::goiw : tag::goihw;
+    }
+
+    // multiples of 1/8, so that the sums below are exact in f32
+    static std::vector<float> pattern(dim n, int seed) {
+        std::vector<float> v(n);
+        for (dim i = 0; i < n; ++i)
+            v[i] = (float)((i * 7 + seed) % 17 - 8) / 8.f;
+        return v;
+    }
+
+    // calls f(src offset, weights offset, dst offset) for every tap that
+    // falls inside the source, on the plain layouts
+    template <typename F>
+    static void for_each_tap(const shape_t &s, F f) {
+        const dim oh = s.oh(), ow = s.ow();
+        for (dim nc = 0; nc < s.mb * s.c; ++nc)
+            for (dim y = 0; y < oh; ++y)
+                for (dim x = 0; x < ow; ++x)
+                    for (dim ky = 0; ky < s.kh; ++ky)
+                        for (dim kx = 0; kx < s.kw; ++kx) {
+                            const dim iy = y * s.sh - s.ph + ky * (s.dh + 1);
+                            const dim ix = x * s.sw - s.pw + kx * (s.dw + 1);
+                            if (iy < 0 || iy >= s.ih || ix < 0 || ix >= s.iw)
+                                continue;
+                            f((nc * s.ih + iy) * s.iw + ix,
+                                    ((nc % s.c) * s.kh + ky) * s.kw + kx,
+                                    (nc * oh + y) * ow + x);
+                        }
+    }
+
+    // the primitive descriptor of the simple_dw implementation, which may
+    // come after others in the list
+    template <typename pd_t>
+    static bool find_simple_dw(pd_t &pd) {
+        do {
+            if (std::string(pd.impl_info_str()).find("simple_dw") == 0)
+                return true;
+        } while (pd.next_impl());
+        return false;
+    }
+
+    memory to_impl(const memory::desc &md, const memory::dims &dims, tag t,
+            std::vector<float> &v) {
+        memory user({dims, dt::f32, t}, eng, v.data());
+        memory m(md, eng);
+        reorder(user, m).execute(strm, user, m);
+        strm.wait();
+        return m;
+    }
+
+    std::vector<float> from_impl(
+            memory &m, const memory::dims &dims, tag t, dim n) {
+        std::vector<float> v(n);
+        memory user({dims, dt::f32, t}, eng, v.data());
+        reorder(m, user).execute(strm, m, user);
+        strm.wait();
+        return v;
+    }
+
+    static void compare(
+            const std::vector<float> &ref, const std::vector<float> &got) {
+        ASSERT_EQ(ref.size(), got.size());
+        for (size_t i = 0; i < ref.size(); ++i) {
+            const float tol = 1e-5f * std::max(1.f, std::fabs(ref[i]));
+            ASSERT_NEAR(got[i], ref[i], tol) << "at " << i;
+        }
+    }
+
+    convolution_forward::desc fwd_desc(const shape_t &s, const layout_t &l) {
+        return {prop_kind::forward_training, algorithm::convolution_direct,
+                {src_dims(s), dt::f32, l.dat}, {wei_dims(s), dt::f32, l.wei},
+                {{s.c}, dt::f32, tag::x}, {dst_dims(s), dt::f32, l.dat},
+                strides(s), dilates(s), padding(s), padding(s)};
+    }
+
+    // the post-op chains simple_dw takes
+    enum post_ops_kind_t { po_none, po_sum, po_eltwise, po_sum_eltwise };
+
+    // the sum takes a scale of 1 only; a power of 2 keeps the relu exact
+    static constexpr float sum_scale = 1.f, relu_alpha = 0.25f;
+
+    static primitive_attr make_attr(post_ops_kind_t po_kind) {
+        post_ops po;
+        if (po_kind == po_sum || po_kind == po_sum_eltwise)
+            po.append_sum(sum_scale);
+        if (po_kind == po_eltwise || po_kind == po_sum_eltwise)
+            po.append_eltwise(1.f, algorithm::eltwise_relu, relu_alpha, 0.f);
+        primitive_attr attr;
+        attr.set_post_ops(po);
+        return attr;
+    }
+
+    void test_fwd(const shape_t &s, const layout_t &l,
+            post_ops_kind_t po_kind = po_none) {
+        const dim src_n = s.mb * s.c * s.ih * s.iw;
+        const dim dst_n = s.mb * s.c * s.oh() * s.ow();
+        auto src_v = pattern(src_n, 1);
+        auto wei_v = pattern(s.c * s.kh * s.kw, 2);
+        auto bia_v = pattern(s.c, 3);
+        auto dst_v = pattern(dst_n, 8); // what the sum adds to
+        const bool with_sum = po_kind == po_sum || po_kind == po_sum_eltwise;
+        const bool with_eltwise
+                = po_kind == po_eltwise || po_kind == po_sum_eltwise;
+
+        std::vector<float> ref(dst_n);
+        for (dim i = 0; i < dst_n; ++i)
+            ref[i] = bia_v[i / (s.oh() * s.ow()) % s.c];
+        for_each_tap(s, [&](dim si, dim wi, dim di) {
+            ref[di] += src_v[si] * wei_v[wi];
+        });
+        for (dim i = 0; i < dst_n; ++i) {
+            if (with_sum) ref[i] += sum_scale * dst_v[i];
+            if (with_eltwise && ref[i] < 0) ref[i] *= relu_alpha;
+        }
+
+        // the iterator behind next_impl() points into the op descriptor
+        const auto desc = fwd_desc(s, l);
+        const auto attr = make_attr(po_kind);
+        convolution_forward::primitive_desc pd(desc, attr, eng);
+        ASSERT_TRUE(find_simple_dw(pd));
+        memory src = to_impl(pd.src_desc(), src_dims(s), plain_dat(s), src_v);
+        memory wei = to_impl(
+                pd.weights_desc(), wei_dims(s), plain_wei(s), wei_v);
+        memory bia = to_impl(pd.bias_desc(), {s.c}, tag::x, bia_v);
+        memory dst = to_impl(pd.dst_desc(), dst_dims(s), plain_dat(s), dst_v);
+        convolution_forward(pd).execute(strm,
+                {{DNNL_ARG_SRC, src}, {DNNL_ARG_WEIGHTS, wei},
+                        {DNNL_ARG_BIAS, bia}, {DNNL_ARG_DST, dst}});
+        strm.wait();
+        compare(ref, from_impl(dst, dst_dims(s), plain_dat(s), dst_n));
+    }
+
+    void test_bwd_data(const shape_t &s, const layout_t &l) {
+        const dim src_n = s.mb * s.c * s.ih * s.iw;
+        const dim dst_n = s.mb * s.c * s.oh() * s.ow();
+        auto ddst_v = pattern(dst_n, 4);
+        auto wei_v = pattern(s.c * s.kh * s.kw, 5);
+
+        std::vector<float> ref(src_n, 0.f);
+        for_each_tap(s, [&](dim si, dim wi, dim di) {
+            ref[si] += ddst_v[di] * wei_v[wi];
+        });
+
+        convolution_forward::primitive_desc fwd_pd(fwd_desc(s, l), eng);
+        const convolution_backward_data::desc desc(
+                algorithm::convolution_direct, {src_dims(s), dt::f32, l.dat},
+                {wei_dims(s), dt::f32, l.wei}, {dst_dims(s), dt::f32, l.dat},
+                strides(s), dilates(s), padding(s), padding(s));
+        convolution_backward_data::primitive_desc pd(desc, eng, fwd_pd);
+        ASSERT_TRUE(find_simple_dw(pd));
+        memory ddst = to_impl(
+                pd.diff_dst_desc(), dst_dims(s), plain_dat(s), ddst_v);
+        memory wei = to_impl(
+                pd.weights_desc(), wei_dims(s), plain_wei(s), wei_v);
+        memory dsrc(pd.diff_src_desc(), eng);
+        convolution_backward_data(pd).execute(strm,
+                {{DNNL_ARG_DIFF_DST, ddst}, {DNNL_ARG_WEIGHTS, wei},
+                        {DNNL_ARG_DIFF_SRC, dsrc}});
+        strm.wait();
+        compare(ref, from_impl(dsrc, src_dims(s), plain_dat(s), src_n));
+    }
+
+    void test_bwd_weights(const shape_t &s, const layout_t &l) {
+        const dim src_n = s.mb * s.c * s.ih * s.iw;
+        const dim dst_n = s.mb * s.c * s.oh() * s.ow();
+        const dim wei_n = s.c * s.kh * s.kw;
+        auto src_v = pattern(src_n, 6);
+        auto ddst_v = pattern(dst_n, 7);
+
+        std::vector<float> ref_w(wei_n, 0.f), ref_b(s.c, 0.f);
+        for_each_tap(s, [&](dim si, dim wi, dim di) {
+            ref_w[wi] += ddst_v[di] * src_v[si];
+        });
+        for (dim i = 0; i < dst_n; ++i)
+            ref_b[i / (s.oh() * s.ow()) % s.c] += ddst_v[i];
+
+        convolution_forward::primitive_desc fwd_pd(fwd_desc(s, l), eng);
+        const convolution_backward_weights::desc desc(
+                algorithm::convolution_direct, {src_dims(s), dt::f32, l.dat},
+                {wei_dims(s), dt::f32, l.wei}, {{s.c}, dt::f32, tag::x},
+                {dst_dims(s), dt::f32, l.dat}, strides(s), dilates(s),
+                padding(s), padding(s));
+        convolution_backward_weights::primitive_desc pd(desc, eng, fwd_pd);
+        ASSERT_TRUE(find_simple_dw(pd));
+        memory src = to_impl(pd.src_desc(), src_dims(s), plain_dat(s), src_v);
+        memory ddst = to_impl(
+                pd.diff_dst_desc(), dst_dims(s), plain_dat(s), ddst_v);
+        memory dwei(pd.diff_weights_desc(), eng);
+        memory dbia(pd.diff_bias_desc(), eng);
+        convolution_backward_weights(pd).execute(strm,
+                {{DNNL_ARG_SRC, src}, {DNNL_ARG_DIFF_DST, ddst},
+                        {DNNL_ARG_DIFF_WEIGHTS, dwei},
+                        {DNNL_ARG_DIFF_BIAS, dbia}});
+        strm.wait();
+        compare(ref_w, from_impl(dwei, wei_dims(s), plain_wei(s), wei_n));
+        compare(ref_b, from_impl(dbia, {s.c}, tag::x, s.c));
+    }
+
+    template <typename F>
+    void for_all(F f) {
+        for (const auto &s : shapes())
+            for (const auto &l : layouts(s.is_1d)) {
+                SCOPED_TRACE(::testing::Message()
+                        << "mb" << s.mb << "c" << s.c << "ih" << s.ih << "iw"
+                        << s.iw << "kh" << s.kh << "kw" << s.kw << "sh"
+                        << s.sh << "sw" << s.sw << "ph" << s.ph << "pw"
+                        << s.pw << "dh" << s.dh << "dw" << s.dw
+                        << " layout " << (int)l.dat);
+                f(s, l);
+                if (::testing::Test::HasFatalFailure()) return;
+            }
+    }
+
+    engine eng {engine::kind::cpu, 0};
+    stream strm {eng};
+};
+
+TEST_F(dw_convolution_test, TestForward) {
+    for_all([&](const shape_t &s, const layout_t &l) { test_fwd(s, l); });
+}
+
+TEST_F(dw_convolution_test, TestForwardPostOps) {
+    for (auto po_kind : {po_sum, po_eltwise, po_sum_eltwise}) {
+        SCOPED_TRACE(::testing::Message() << "post-ops " << (int)po_kind);
+        for_all([&](const shape_t &s, const layout_t &l) {
+            test_fwd(s, l, po_kind);
+        });
+        if (HasFatalFailure()) return;
+    }
+}
+
+TEST_F(dw_convolution_test, TestBackwardData) {
+    for_all([&](const shape_t &s, const layout_t &l) { test_bwd_data(s, l); });
+}
+
+TEST_F(dw_convolution_test, TestBackwardWeights) {
+    for_all([&](const shape_t &s, const layout_t &l) {
+        test_bwd_weights(s, l);
+    });
+}
+
+} // namespace dnnl
@@ -0,0 +1,208 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+
+// The generic Winograd F(4x4, 3x3) forward convolution (simple_wino) against
+// the reference convolution, on planes that end in partial tiles, with the
+// post-ops it takes, and with the weights reordered once into its Winograd
+// format for inference.
+
+namespace dnnl {
+
+class winograd_convolution_test : public ::testing::Test {
+protected:
+    using dim = memory::dim;
+    using tag = memory::format_tag;
+    using dt = memory::data_type;
+
+    struct shape_t {
+        dim mb, ic, oc, ih, iw, p; // 3x3, stride 1, padding p
+        dim oh() const { return ih + 2 * p - 2; }
+        dim ow() const { return iw + 2 * p - 2; }
+    };
+
+    enum post_ops_kind_t { po_none, po_sum, po_eltwise, po_sum_eltwise };
+
+    struct config_t {
+        prop_kind pk;
+        bool with_bias;
+        post_ops_kind_t po_kind;
+    };
+
+    static primitive_attr make_attr(post_ops_kind_t po_kind) {
+        post_ops po;
+        if (po_kind == po_sum || po_kind == po_sum_eltwise) po.append_sum();
+        if (po_kind == po_eltwise || po_kind == po_sum_eltwise)
+            po.append_eltwise(1.f, algorithm::eltwise_relu, 0.25f, 0.f);
+        primitive_attr attr;
+        attr.set_post_ops(po);
+        return attr;
+    }
+
+    static void fill(std::vector<float> &v, int seed) {
+        for (size_t i = 0; i < v.size(); ++i)
+            v[i] = (float)((int)((i * 7919 + seed) % 97) - 48) / 48.f;
+    }
+
+    static convolution_forward::desc desc(const shape_t &s, prop_kind pk,
+            algorithm alg, bool with_bias, tag wei_tag) {
+        const memory::desc src_md({s.mb, s.ic, s.ih, s.iw}, dt::f32, tag::nchw);
+        const memory::desc wei_md({s.oc, s.ic, 3, 3}, dt::f32, wei_tag);
+        const memory::desc bia_md({s.oc}, dt::f32, tag::x);
+        const memory::desc dst_md(
+                {s.mb, s.oc, s.oh(), s.ow()}, dt::f32, tag::nchw);
+        if (with_bias)
+            return {pk, alg, src_md, wei_md, bia_md, dst_md, {1, 1}, {s.p, s.p},
+                    {s.p, s.p}};
+        return {pk, alg, src_md, wei_md, dst_md, {1, 1}, {s.p, s.p},
+                {s.p, s.p}};
+    }
+
+    // moves pd to the implementation named impl, false if there is none
+    static bool find_impl(
+            convolution_forward::primitive_desc &pd, const char *impl) {
+        do {
+            if (std::string(pd.impl_info_str()).find(impl) == 0) return true;
+        } while (pd.next_impl());
+        return false;
+    }
+
+    std::vector<float> run(const shape_t &s, const config_t &c,
+            algorithm alg, const char *impl) {
+        std::vector<float> src(s.mb * s.ic * s.ih * s.iw),
+                wei(s.oc * s.ic * 9), bia(s.oc),
+                dst(s.mb * s.oc * s.oh() * s.ow());
+        fill(src, 1);
+        fill(wei, 2);
+        fill(bia, 3);
+        fill(dst, 4); // what the sum adds to
+
+        // inference lets the primitive pick the weights format
+        const bool wei_any = c.pk == prop_kind::forward_inference;
+        // the iterator behind next_impl() points into the op descriptor
+        const auto d = desc(s, c.pk, alg, c.with_bias,
+                wei_any ? tag::any : tag::oihw);
+        const auto attr = make_attr(c.po_kind);
+        convolution_forward::primitive_desc pd(d, attr, eng);
+        EXPECT_TRUE(find_impl(pd, impl)) << impl;
+        if (::testing::Test::HasFailure()) return {};
+
+        const memory::desc user_wei_md({s.oc, s.ic, 3, 3}, dt::f32, tag::oihw);
+        memory src_m(pd.src_desc(), eng, src.data());
+        memory user_wei_m(user_wei_md, eng, wei.data());
+        memory wei_m = user_wei_m;
+        if (pd.weights_desc() != user_wei_md) {
+            wei_m = memory(pd.weights_desc(), eng);
+            reorder(user_wei_m, wei_m).execute(strm, user_wei_m, wei_m);
+        }
+        memory bia_m({{s.oc}, dt::f32, tag::x}, eng, bia.data());
+        memory dst_m(pd.dst_desc(), eng, dst.data());
+        convolution_forward(pd).execute(strm,
+                {{DNNL_ARG_SRC, src_m}, {DNNL_ARG_WEIGHTS, wei_m},
+                        {DNNL_ARG_BIAS, bia_m}, {DNNL_ARG_DST, dst_m}});
+        strm.wait();
+        return dst;
+    }
+
+    // Winograd changes the summation and rounds the transforms: the error
+    // grows with the number of products summed
+    static void compare(const shape_t &s, const std::vector<float> &ref,
+            const std::vector<float> &got) {
+        ASSERT_EQ(ref.size(), got.size());
+        const float tol = 2e-6f * s.ic * 9;
+        for (size_t i = 0; i < ref.size(); ++i)
+            ASSERT_NEAR(got[i], ref[i], tol * std::max(1.f, std::fabs(ref[i])))
+                    << "at " << i;
+    }
+
+    void test(const shape_t &s, const config_t &c, algorithm alg) {
+        SCOPED_TRACE(::testing::Message()
+                << "mb" << s.mb << "ic" << s.ic << "oc" << s.oc << "ih"
+                << s.ih << "iw" << s.iw << "p" << s.p << " prop "
+                << (int)c.pk << " bias " << c.with_bias << " post-ops "
+                << (int)c.po_kind);
+        const auto ref
+                = run(s, c, algorithm::convolution_direct, "ref:any");
+        const auto got = run(s, c, alg, "simple_wino");
+        if (HasFailure()) return;
+        compare(s, ref, got);
+    }
+
+    engine eng {engine::kind::cpu, 0};
+    stream strm {eng};
+};
+
+TEST_F(winograd_convolution_test, TestPartialTiles) {
+    const std::vector<shape_t> shapes = {
+            // output planes that are not a multiple of the 4x4 tile
+            {1, 3, 5, 7, 7, 0},
+            {2, 8, 6, 9, 11, 1},
+            {1, 16, 16, 14, 13, 1},
+            {3, 17, 19, 10, 6, 0},
+            {1, 4, 4, 3, 3, 1}, // a single partial tile
+            {2, 32, 24, 30, 29, 1}, // more tiles than a block
+    };
+    for (const auto &s : shapes)
+        for (auto pk : {prop_kind::forward_training,
+                     prop_kind::forward_inference}) {
+            test(s, {pk, true, po_none}, algorithm::convolution_winograd);
+            if (HasFatalFailure()) return;
+        }
+}
+
+TEST_F(winograd_convolution_test, TestPostOps) {
+    const std::vector<shape_t> shapes
+            = {{2, 8, 6, 9, 11, 1}, {1, 16, 16, 14, 13, 0}};
+    for (const auto &s : shapes)
+        for (auto pk : {prop_kind::forward_training,
+                     prop_kind::forward_inference})
+            for (bool with_bias : {true, false})
+                for (auto po_kind : {po_sum, po_eltwise, po_sum_eltwise}) {
+                    test(s, {pk, with_bias, po_kind},
+                            algorithm::convolution_winograd);
+                    if (HasFatalFailure()) return;
+                }
+}
+
+// convolution_auto takes Winograd only where is_winograd_sensible()
+TEST_F(winograd_convolution_test, TestAuto) {
+    auto has_wino = [&](const shape_t &s) {
+        const auto d = desc(s, prop_kind::forward_inference,
+                algorithm::convolution_auto, true, tag::oihw);
+        convolution_forward::primitive_desc pd(d, eng);
+        return find_impl(pd, "simple_wino");
+    };
+
+    const shape_t sensible {2, 16, 16, 14, 13, 1};
+    EXPECT_TRUE(has_wino(sensible));
+    test(sensible, {prop_kind::forward_inference, true, po_eltwise},
+            algorithm::convolution_auto);
+
+    EXPECT_FALSE(has_wino({2, 8, 16, 14, 13, 1})); // few input channels
+    EXPECT_FALSE(has_wino({2, 16, 8, 14, 13, 1})); // few output channels
+    EXPECT_FALSE(has_wino({2, 16, 16, 7, 14, 0})); // short plane
+}
+
+} // namespace dnnl
@@ -0,0 +1,107 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+
+#include "src/cpu/cpu_memory_allocator.hpp"
+
+namespace dnnl {
+
+using namespace impl::cpu;
+
+class cpu_memory_allocator_test : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        e = get_test_engine();
+        ASSERT_EQ(get_cpu_alloc_policy(&old_policy), impl::status::success);
+    }
+
+    virtual void TearDown() {
+        ASSERT_EQ(set_cpu_alloc_policy(&old_policy), impl::status::success);
+    }
+
+    static cpu_alloc_stats_t stats() {
+        cpu_alloc_stats_t s;
+        get_cpu_alloc_stats(&s);
+        return s;
+    }
+
+    // writes every element, so that the pages are actually touched
+    static void fill(const memory &m) {
+        float *ptr = (float *)m.get_data_handle();
+        const size_t n = m.get_desc().get_size() / sizeof(float);
+        for (size_t i = 0; i < n; ++i)
+            ptr[i] = (float)i;
+    }
+
+    engine e;
+    cpu_alloc_policy_t old_policy;
+};
+
+TEST_F(cpu_memory_allocator_test, TestMappedMemoryPool) {
+    SKIP_IF(e.get_kind() != engine::kind::cpu,
+            "CPU allocation policy does not apply to GPU engines");
+
+    cpu_alloc_policy_t policy = old_policy;
+    policy.huge_pages = cpu_alloc_policy_t::huge_pages_transparent;
+    policy.threshold = (size_t)1 << 20;
+    policy.pool_limit = (size_t)64 << 20;
+    ASSERT_EQ(set_cpu_alloc_policy(&policy), impl::status::success);
+
+    const cpu_alloc_stats_t before = stats();
+
+    // 4 MB, above the threshold
+    memory::desc md(
+            {1024, 1024}, memory::data_type::f32, memory::format_tag::ab);
+    {
+        memory m(md, e);
+        fill(m);
+#if !defined(__linux__)
+        // mapping is Linux only, the policy is ignored elsewhere
+        EXPECT_EQ(stats().allocations, before.allocations);
+        return;
+#endif
+        EXPECT_EQ(stats().allocations, before.allocations + 1);
+        EXPECT_GE(stats().mapped_bytes, before.mapped_bytes + md.get_size());
+    }
+
+    cpu_alloc_stats_t after = stats();
+    // the freed buffer serves the next memory object of the same size
+    EXPECT_GE(after.pooled_bytes, md.get_size());
+    {
+        memory m(md, e);
+        fill(m);
+    }
+    after = stats();
+    EXPECT_EQ(after.allocations, before.allocations + 1);
+    EXPECT_EQ(after.reuses, before.reuses + 1);
+
+    // a buffer below the threshold is not mapped
+    memory::desc small_md(
+            {256, 256}, memory::data_type::f32, memory::format_tag::ab);
+    { memory m(small_md, e); }
+    EXPECT_EQ(stats().allocations, after.allocations);
+    EXPECT_EQ(stats().reuses, after.reuses);
+
+    // a new policy releases the pool
+    ASSERT_EQ(set_cpu_alloc_policy(&old_policy), impl::status::success);
+    EXPECT_EQ(stats().pooled_bytes, 0u);
+}
+
+} // namespace dnnl
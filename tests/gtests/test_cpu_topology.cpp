@@ -0,0 +1,61 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "src/common/utils.hpp"
+#include "src/cpu/platform.hpp"
+
+namespace dnnl {
+
+TEST(cpu_topology_test, TestParseSize) {
+    using impl::parse_size;
+    EXPECT_EQ(parse_size("0"), 0u);
+    EXPECT_EQ(parse_size("4096"), 4096u);
+    EXPECT_EQ(parse_size("48K"), 48u * 1024);
+    EXPECT_EQ(parse_size("48k"), 48u * 1024);
+    EXPECT_EQ(parse_size("1280K,1536K"), 1280u * 1024);
+    EXPECT_EQ(parse_size("30M"), 30u * 1024 * 1024);
+    EXPECT_EQ(parse_size("2G"), (size_t)2 << 30);
+    // a unit the parser does not know is ignored
+    EXPECT_EQ(parse_size("12X"), 12u);
+    EXPECT_EQ(parse_size(""), 0u);
+    EXPECT_EQ(parse_size("K"), 0u);
+    EXPECT_EQ(parse_size(",48K"), 0u);
+}
+
+TEST(cpu_topology_test, TestCpuList) {
+    using impl::cpu::platform::cpulist_count;
+    EXPECT_EQ(cpulist_count(""), 0u);
+    EXPECT_EQ(cpulist_count("0"), 1u);
+    EXPECT_EQ(cpulist_count("0-3"), 4u);
+    EXPECT_EQ(cpulist_count("0,28"), 2u);
+    EXPECT_EQ(cpulist_count("0-3,8-11"), 8u);
+    EXPECT_EQ(cpulist_count("0-1,4,6-7"), 5u);
+    // parsing stops at a malformed entry, a reversed range is empty
+    EXPECT_EQ(cpulist_count("0-1,x,4"), 2u);
+    EXPECT_EQ(cpulist_count("3-1"), 0u);
+
+    std::vector<long> cpus;
+    impl::cpu::platform::for_each_cpulist_entry(
+            "2-4,9", [&](long c) { cpus.push_back(c); });
+    EXPECT_EQ(cpus, std::vector<long>({2, 3, 4, 9}));
+}
+
+} // namespace dnnl
@@ -20,6 +20,8 @@
 #include "dnnl_test_common.hpp"
 #include "gtest/gtest.h"
 
+#include "src/common/fast_div.hpp"
+
 #define DEBUG 0
 
 namespace dnnl {
@@ -414,5 +416,140 @@ CPU_INSTANTIATE_TEST_SUITE_P(Case, test_parallel_nd,
                 np_t {{4, 1, 4, 5, 2}}, np_t {{4, 3, 0, 3, 0, 1}},
                 np_t {{2, 1, 3, 1, 2, 1}}, np_t {{4, 1, 4, 3, 2, 2}}));
 
+class test_parallel_nd_vec : public test_nd {
+protected:
+    // checks one batch of coordinates and marks the points it covers
+    void emit_batch(const ptrdiff_t *const *v, int vl) {
+        ASSERT_TRUE(0 < vl && vl <= (int)impl::nd_vec_len);
+        const int ndims = (int)p.dims.size();
+        for (int i = 0; i < vl; ++i) {
+            ptrdiff_t idx = 0;
+            for (int d = 0; d < ndims; ++d) {
+                ASSERT_TRUE(0 <= v[d][i] && v[d][i] < p.dims[d]);
+                idx = idx * p.dims[d] + v[d][i];
+            }
+            data[idx] = idx;
+        }
+    }
+
+    void emit_parallel_nd_vec() {
+        switch ((int)p.dims.size()) {
+            case 1:
+                impl::parallel_nd_vec(p.dims[0], [&](ptrdiff_t *v0, int vl) {
+                    const ptrdiff_t *v[] = {v0};
+                    emit_batch(v, vl);
+                });
+                break;
+            case 2:
+                impl::parallel_nd_vec(p.dims[0], p.dims[1],
+                        [&](ptrdiff_t *v0, ptrdiff_t *v1, int vl) {
+                            const ptrdiff_t *v[] = {v0, v1};
+                            emit_batch(v, vl);
+                        });
+                break;
+            case 3:
+                impl::parallel_nd_vec(p.dims[0], p.dims[1], p.dims[2],
+                        [&](ptrdiff_t *v0, ptrdiff_t *v1, ptrdiff_t *v2,
+                                int vl) {
+                            const ptrdiff_t *v[] = {v0, v1, v2};
+                            emit_batch(v, vl);
+                        });
+                break;
+            case 4:
+                impl::parallel_nd_vec(p.dims[0], p.dims[1], p.dims[2],
+                        p.dims[3],
+                        [&](ptrdiff_t *v0, ptrdiff_t *v1, ptrdiff_t *v2,
+                                ptrdiff_t *v3, int vl) {
+                            const ptrdiff_t *v[] = {v0, v1, v2, v3};
+                            emit_batch(v, vl);
+                        });
+                break;
+            case 5:
+                impl::parallel_nd_vec(p.dims[0], p.dims[1], p.dims[2],
+                        p.dims[3], p.dims[4],
+                        [&](ptrdiff_t *v0, ptrdiff_t *v1, ptrdiff_t *v2,
+                                ptrdiff_t *v3, ptrdiff_t *v4, int vl) {
+                            const ptrdiff_t *v[] = {v0, v1, v2, v3, v4};
+                            emit_batch(v, vl);
+                        });
+                break;
+            case 6:
+                impl::parallel_nd_vec(p.dims[0], p.dims[1], p.dims[2],
+                        p.dims[3], p.dims[4], p.dims[5],
+                        [&](ptrdiff_t *v0, ptrdiff_t *v1, ptrdiff_t *v2,
+                                ptrdiff_t *v3, ptrdiff_t *v4, ptrdiff_t *v5,
+                                int vl) {
+                            const ptrdiff_t *v[] = {v0, v1, v2, v3, v4, v5};
+                            emit_batch(v, vl);
+                        });
+                break;
+            default: ASSERT_TRUE(false);
+        }
+    }
+};
+
+TEST_P(test_parallel_nd_vec, Test) {
+    emit_parallel_nd_vec();
+    CheckID();
+}
+
+CPU_INSTANTIATE_TEST_SUITE_P(Case, test_parallel_nd_vec,
+        ::testing::Values(np_t {{0}}, np_t {{1}}, np_t {{100}},
+                np_t {{1000}}, np_t {{0, 0}}, np_t {{1, 2}},
+                np_t {{10, 10}}, np_t {{7, 300}}, np_t {{0, 1, 0}},
+                np_t {{1, 2, 1}}, np_t {{4, 4, 10}}, np_t {{3, 7, 50}},
+                np_t {{0, 3, 0, 1}}, np_t {{4, 4, 5, 2}},
+                np_t {{3, 0, 3, 0, 1}}, np_t {{4, 1, 4, 5, 2}},
+                np_t {{4, 3, 0, 3, 0, 1}}, np_t {{4, 1, 4, 3, 2, 2}},
+                np_t {{2, 3, 2, 3, 2, 37}}));
+
+TEST(test_fast_div, Test) {
+    for (uint64_t d = 1; d < 3000; ++d) {
+        const impl::fast_div_t fd((impl::dim_t)d);
+        for (uint64_t n : {uint64_t(0), d - 1, d, 7 * d + 3, uint64_t(65537),
+                     uint64_t(UINT32_MAX / 3), uint64_t(UINT32_MAX)}) {
+            ASSERT_EQ(fd.div(n), n / d);
+            ASSERT_EQ(fd.mod(n), n % d);
+        }
+    }
+
+    // drop-in divisors for the nd_iterator utilities
+    const impl::dims_t dims = {3, 7, 1, 5};
+    const impl::dims_fast_div_t fdims(4, dims);
+    ASSERT_TRUE(fdims.ok());
+    const size_t work = 3 * 7 * 1 * 5;
+    for (size_t start = 0; start < work; ++start) {
+        int x[4], y[4];
+        impl::utils::nd_iterator_init(start, x[0], dims[0], x[1], dims[1],
+                x[2], dims[2], x[3], dims[3]);
+        impl::utils::nd_iterator_init(start, y[0], fdims[0], y[1], fdims[1],
+                y[2], fdims[2], y[3], fdims[3]);
+        impl::dim_t pos[4];
+        fdims.coords(start, pos);
+        for (int d = 0; d < 4; ++d) {
+            ASSERT_EQ(x[d], y[d]);
+            ASSERT_EQ(x[d], pos[d]);
+        }
+        impl::utils::nd_iterator_step(x[0], dims[0], x[1], dims[1], x[2],
+                dims[2], x[3], dims[3]);
+        impl::utils::nd_iterator_step(y[0], fdims[0], y[1], fdims[1], y[2],
+                fdims[2], y[3], fdims[3]);
+        for (int d = 0; d < 4; ++d)
+            ASSERT_EQ(x[d], y[d]);
+    }
+
+    // in place: l[] becomes the outermost coordinate
+    std::vector<impl::dim_t> l(work), p1(work), p2(work), p3(work);
+    for (size_t i = 0; i < work; ++i)
+        l[i] = (impl::dim_t)i;
+    impl::dim_t *pos[4] = {l.data(), p1.data(), p2.data(), p3.data()};
+    fdims.vec_coords(l.data(), (int)work, pos);
+    for (size_t i = 0; i < work; ++i)
+        ASSERT_EQ((size_t)(((l[i] * 7 + p1[i]) * 1 + p2[i]) * 5 + p3[i]), i);
+
+    const impl::dims_t huge = {1 << 20, 1 << 20};
+    ASSERT_FALSE(impl::dims_fast_div_t(2, huge).ok());
+}
+
 } // namespace dnnl
 // vim: et ts=4 sw=4 cindent cino=+2s,^=l0,\:0,N-s
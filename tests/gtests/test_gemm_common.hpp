@@ -1153,8 +1153,10 @@ protected:
         bool pack = (p.pack_params.pack_a || p.pack_params.pack_b);
         SKIP_IF(get_test_engine_kind() == engine::kind::gpu && pack,
                 "GPU does not support packed GEMM.");
-        SKIP_IF(!DNNL_X64 && pack,
-                "Packed GEMM does not support non-x64 CPUs.");
+        SKIP_IF(!DNNL_X64 && pack
+                        && data_traits<c_dt>::data_type
+                                == memory::data_type::s32,
+                "Packed integer GEMM does not support non-x64 CPUs.");
         SKIP_IF((p.alpha != 1.f || p.igemm_params.oa() != 0
                         || p.igemm_params.ob() != 0)
                         && pack,
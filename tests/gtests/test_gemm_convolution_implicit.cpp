@@ -0,0 +1,158 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+#include "src/cpu/gemm_convolution_utils.hpp"
+
+// The f32 gemm convolution forward with the im2col panels generated inside
+// the GEMM (implicit_sgemm) against the same convolution with a stored im2col
+// matrix, on every build: the override picks the path either way.
+
+namespace dnnl {
+
+class gemm_convolution_implicit_test : public ::testing::Test {
+protected:
+    using dim = memory::dim;
+    using tag = memory::format_tag;
+    using dt = memory::data_type;
+
+    struct shape_t {
+        dim mb, g, ic, oc, ih, iw, kh, kw, sh, sw, ph, pw, dh, dw;
+        dim oh() const { return out_size(ih, kh, sh, ph, dh); }
+        dim ow() const { return out_size(iw, kw, sw, pw, dw); }
+    };
+
+    virtual void SetUp() {
+        // the cache would hand out primitives of the other path
+        set_primitive_cache_capacity(0);
+    }
+
+    virtual void TearDown() {
+        impl::cpu::set_gemm_conv_implicit_override(-1);
+        set_primitive_cache_capacity(1024);
+    }
+
+    static dim out_size(dim i, dim k, dim s, dim p, dim d) {
+        return (i + 2 * p - ((k - 1) * (d + 1) + 1)) / s + 1;
+    }
+
+    static void fill(memory &m, int seed) {
+        float *p = (float *)m.get_data_handle();
+        const size_t n = m.get_desc().get_size() / sizeof(float);
+        for (size_t i = 0; i < n; ++i)
+            p[i] = (float)((int)((i * 7919 + seed) % 97) - 48) / 48.f;
+    }
+
+    // dst and the size of the scratchpad, which holds the im2col matrix
+    // only on the explicit path
+    std::vector<float> run(const shape_t &s, bool implicit,
+            size_t &scratchpad_size) {
+        EXPECT_EQ(impl::cpu::set_gemm_conv_implicit_override(implicit),
+                impl::status::success);
+
+        const bool with_groups = s.g > 1;
+        memory::desc src_md({s.mb, s.g * s.ic, s.ih, s.iw}, dt::f32, tag::nchw);
+        memory::desc wei_md = with_groups
+                ? memory::desc({s.g, s.oc, s.ic, s.kh, s.kw}, dt::f32,
+                        tag::goihw)
+                : memory::desc({s.oc, s.ic, s.kh, s.kw}, dt::f32, tag::oihw);
+        memory::desc bia_md({s.g * s.oc}, dt::f32, tag::x);
+        memory::desc dst_md(
+                {s.mb, s.g * s.oc, s.oh(), s.ow()}, dt::f32, tag::nchw);
+
+        primitive_attr attr;
+        attr.set_scratchpad_mode(scratchpad_mode::user);
+        // the iterator behind next_impl() points into the op descriptor
+        const convolution_forward::desc desc(prop_kind::forward_inference,
+                algorithm::convolution_direct, src_md, wei_md, bia_md, dst_md,
+                {s.sh, s.sw}, {s.dh, s.dw}, {s.ph, s.pw}, {s.ph, s.pw});
+        convolution_forward::primitive_desc pd(desc, attr, eng);
+        bool found = false;
+        do {
+            found = std::string(pd.impl_info_str()).find("gemm:") == 0;
+        } while (!found && pd.next_impl());
+        EXPECT_TRUE(found);
+        if (!found) return {};
+        scratchpad_size = pd.scratchpad_desc().get_size();
+
+        memory src(src_md, eng), wei(wei_md, eng), bia(bia_md, eng),
+                dst(dst_md, eng), scratchpad(pd.scratchpad_desc(), eng);
+        fill(src, 1);
+        fill(wei, 2);
+        fill(bia, 3);
+        convolution_forward(pd).execute(strm,
+                {{DNNL_ARG_SRC, src}, {DNNL_ARG_WEIGHTS, wei},
+                        {DNNL_ARG_BIAS, bia}, {DNNL_ARG_DST, dst},
+                        {DNNL_ARG_SCRATCHPAD, scratchpad}});
+        strm.wait();
+
+        const float *d = (const float *)dst.get_data_handle();
+        return std::vector<float>(d, d + dst_md.get_size() / sizeof(float));
+    }
+
+    // The two paths run different GEMM kernels, hence summation orders: the
+    // error grows with the number of products summed
+    static void compare(const shape_t &s, const std::vector<float> &ref,
+            const std::vector<float> &got) {
+        ASSERT_EQ(ref.size(), got.size());
+        const float tol = 2e-7f * s.ic * s.kh * s.kw;
+        for (size_t i = 0; i < ref.size(); ++i)
+            ASSERT_NEAR(got[i], ref[i], tol * std::max(1.f, std::fabs(ref[i])))
+                    << "at " << i;
+    }
+
+    engine eng {engine::kind::cpu, 0};
+    stream strm {eng};
+};
+
+TEST_F(gemm_convolution_implicit_test, TestForward) {
+    const std::vector<shape_t> shapes = {
+            // mb g ic oc ih iw kh kw sh sw ph pw dh dw
+            {2, 1, 3, 16, 13, 13, 3, 3, 1, 1, 0, 0, 0, 0},
+            {2, 1, 8, 16, 14, 15, 3, 3, 1, 1, 1, 1, 0, 0}, // padded
+            {1, 1, 16, 24, 17, 19, 3, 3, 2, 2, 1, 1, 0, 0}, // strided
+            {2, 1, 5, 8, 20, 18, 3, 5, 1, 2, 2, 2, 1, 2}, // dilated
+            {1, 1, 4, 12, 23, 21, 7, 7, 3, 2, 3, 3, 0, 0},
+            {2, 2, 6, 10, 12, 12, 3, 3, 2, 1, 1, 0, 1, 0}, // grouped
+            {3, 1, 7, 9, 1, 40, 1, 5, 1, 3, 0, 2, 0, 1}, // 1D
+            {1, 1, 64, 32, 9, 9, 3, 3, 1, 1, 1, 1, 0, 0}, // many columns
+    };
+    for (const auto &s : shapes) {
+        SCOPED_TRACE(::testing::Message()
+                << "mb" << s.mb << "g" << s.g << "ic" << s.ic << "oc" << s.oc
+                << "ih" << s.ih << "iw" << s.iw << "kh" << s.kh << "kw"
+                << s.kw << "sh" << s.sh << "sw" << s.sw << "ph" << s.ph
+                << "pw" << s.pw << "dh" << s.dh << "dw" << s.dw);
+        size_t explicit_scratchpad = 0, implicit_scratchpad = 0;
+        const auto ref = run(s, false, explicit_scratchpad);
+        const auto got = run(s, true, implicit_scratchpad);
+        if (HasFatalFailure() || HasNonfatalFailure()) return;
+        // the override took effect: no im2col matrix is booked
+        EXPECT_LT(implicit_scratchpad, explicit_scratchpad);
+        compare(s, ref, got);
+        if (HasFatalFailure()) return;
+    }
+}
+
+} // namespace dnnl
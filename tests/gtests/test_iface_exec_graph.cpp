@@ -0,0 +1,221 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <algorithm>
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+
+#include "src/common/exec_graph.hpp"
+
+namespace dnnl {
+
+class exec_graph_test : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        eng = get_test_engine();
+        graph = exec_graph(eng);
+    }
+
+    static memory::desc md() {
+        return memory::desc({2, 16, 4, 4}, memory::data_type::f32,
+                memory::format_tag::nchw);
+    }
+    static size_t nelems() { return md().get_size() / sizeof(float); }
+
+    // dst = alpha * src + beta
+    eltwise_forward linear(float alpha, float beta) {
+        return eltwise_forward({{prop_kind::forward_inference,
+                                        algorithm::eltwise_linear, md(),
+                                        alpha, beta},
+                eng});
+    }
+
+    impl::exec_graph_info_t info() {
+        impl::exec_graph_info_t info;
+        EXPECT_EQ(impl::exec_graph_get_info(graph.get(), &info),
+                impl::status::success);
+        return info;
+    }
+
+    engine eng;
+    exec_graph graph;
+};
+
+TEST_F(exec_graph_test, TestReplayWithBindings) {
+    SKIP_IF(get_test_engine_kind() != engine::kind::cpu,
+            "Replayed buffers are checked on CPU only");
+    stream strm(eng);
+    memory src(md(), eng), mid(md(), eng), dst(md(), eng);
+    auto scale = linear(2.f, 0.f);
+    auto shift = linear(1.f, 3.f);
+
+    graph.append(scale, {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, mid}});
+    graph.append(shift, {{DNNL_ARG_SRC, mid}, {DNNL_ARG_DST, dst}});
+    graph.finalize();
+    EXPECT_THROW(
+            graph.append(scale, {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, mid}}),
+            error);
+
+    EXPECT_EQ(info().n_steps, 2u);
+    EXPECT_EQ(info().n_memories, 3u);
+
+    // captured buffers
+    float *s = (float *)src.get_data_handle();
+    for (size_t i = 0; i < nelems(); ++i)
+        s[i] = (float)i;
+    graph.replay(strm);
+    strm.wait();
+    const float *d = (const float *)dst.get_data_handle();
+    for (size_t i = 0; i < nelems(); ++i)
+        ASSERT_EQ(d[i], 2.f * i + 3.f);
+
+    // new input and output buffers, the memory objects stay as they were
+    std::vector<float> in(nelems()), out(nelems(), 0.f);
+    for (size_t i = 0; i < nelems(); ++i)
+        in[i] = -(float)i;
+    graph.replay(strm, {{src, in.data()}, {dst, out.data()}});
+    strm.wait();
+    for (size_t i = 0; i < nelems(); ++i) {
+        ASSERT_EQ(out[i], -2.f * i + 3.f);
+        ASSERT_EQ(d[i], 2.f * i + 3.f);
+    }
+    EXPECT_EQ(src.get_data_handle(), (void *)s);
+
+    memory other(md(), eng);
+    EXPECT_THROW(graph.replay(strm, {{other, in.data()}}), error);
+}
+
+// The graph keeps the handles of capture time: a handle set on a captured
+// memory object afterwards is not seen by the graph, a binding is
+TEST_F(exec_graph_test, TestHandleSetAfterCapture) {
+    SKIP_IF(get_test_engine_kind() != engine::kind::cpu,
+            "Replayed buffers are checked on CPU only");
+    stream strm(eng);
+    std::vector<float> captured(nelems(), 1.f), later(nelems(), 2.f),
+            out(nelems(), 0.f);
+    memory src(md(), eng, captured.data()), dst(md(), eng, out.data());
+    auto copy = linear(1.f, 0.f);
+    graph.append(copy, {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, dst}});
+    graph.finalize();
+
+    src.set_data_handle(later.data());
+    graph.replay(strm);
+    strm.wait();
+    for (size_t i = 0; i < nelems(); ++i)
+        ASSERT_EQ(out[i], 1.f);
+
+    graph.replay(strm, {{src, src.get_data_handle()}});
+    strm.wait();
+    for (size_t i = 0; i < nelems(); ++i)
+        ASSERT_EQ(out[i], 2.f);
+}
+
+// The steps have library-managed scratchpads, planned into one buffer of the
+// graph of the size of the largest
+TEST_F(exec_graph_test, TestReplayWithScratchpad) {
+    SKIP_IF(get_test_engine_kind() != engine::kind::cpu,
+            "Replayed buffers are checked on CPU only");
+    stream strm(eng);
+
+    using dt = memory::data_type;
+    using tag = memory::format_tag;
+    const memory::dim N = 4, IC = 32, OC = 16;
+    memory::desc src_md({N, IC}, dt::u8, tag::nc);
+    memory::desc wei_md({OC, IC}, dt::s8, tag::oi);
+    memory::desc dst_md({N, OC}, dt::s8, tag::nc);
+    memory::desc dst2_md({N, OC / 2}, dt::s8, tag::nc);
+    memory::desc wei2_md({OC / 2, OC}, dt::s8, tag::oi);
+    auto pd = inner_product_forward::primitive_desc(
+            {prop_kind::forward_inference, src_md, wei_md, dst_md}, eng);
+    auto pd2 = inner_product_forward::primitive_desc(
+            {prop_kind::forward_inference, dst_md, wei2_md, dst2_md}, eng);
+    ASSERT_GT(pd.query_s64(query::memory_consumption_s64), 0);
+    auto ip = inner_product_forward(pd);
+    auto ip2 = inner_product_forward(pd2);
+
+    // the sizes of the scratchpads, from primitives that take them from the
+    // application
+    auto scratchpad_size = [&](const memory::desc &s, const memory::desc &w,
+                                   const memory::desc &d) {
+        primitive_attr attr;
+        attr.set_scratchpad_mode(scratchpad_mode::user);
+        auto user_pd = inner_product_forward::primitive_desc(
+                {prop_kind::forward_inference, s, w, d}, attr, eng);
+        return user_pd.scratchpad_desc().get_size();
+    };
+    const size_t largest
+            = std::max(scratchpad_size(src_md, wei_md, dst_md),
+                    scratchpad_size(dst_md, wei2_md, dst2_md));
+
+    memory src(src_md, eng), wei(wei_md, eng), dst(dst_md, eng);
+    memory wei2(wei2_md, eng), dst2(dst2_md, eng);
+    uint8_t *s = (uint8_t *)src.get_data_handle();
+    int8_t *w = (int8_t *)wei.get_data_handle();
+    int8_t *w2 = (int8_t *)wei2.get_data_handle();
+    for (memory::dim i = 0; i < OC * IC; ++i)
+        w[i] = (int8_t)(i % 3 - 1);
+    for (memory::dim i = 0; i < OC / 2 * OC; ++i)
+        w2[i] = (int8_t)(i % 2);
+
+    graph.append(ip,
+            {{DNNL_ARG_SRC, src}, {DNNL_ARG_WEIGHTS, wei},
+                    {DNNL_ARG_DST, dst}});
+    graph.append(ip2,
+            {{DNNL_ARG_SRC, dst}, {DNNL_ARG_WEIGHTS, wei2},
+                    {DNNL_ARG_DST, dst2}});
+    graph.finalize();
+    EXPECT_EQ(info().scratchpad_size, largest);
+
+    for (int round = 0; round < 3; ++round) {
+        for (memory::dim i = 0; i < N * IC; ++i)
+            s[i] = (uint8_t)((i + round) % 3);
+        graph.replay(strm);
+        strm.wait();
+
+        const int8_t *d = (const int8_t *)dst.get_data_handle();
+        const int8_t *d2 = (const int8_t *)dst2.get_data_handle();
+        for (memory::dim n = 0; n < N; ++n) {
+            for (memory::dim oc = 0; oc < OC; ++oc) {
+                int acc = 0;
+                for (memory::dim ic = 0; ic < IC; ++ic)
+                    acc += s[n * IC + ic] * w[oc * IC + ic];
+                ASSERT_EQ(d[n * OC + oc], acc);
+            }
+            for (memory::dim oc = 0; oc < OC / 2; ++oc) {
+                int acc = 0;
+                for (memory::dim ic = 0; ic < OC; ++ic)
+                    acc += d[n * OC + ic] * w2[oc * OC + ic];
+                // s8 dst saturates
+                ASSERT_EQ(d2[n * OC / 2 + oc],
+                        std::min(127, std::max(-128, acc)));
+            }
+        }
+    }
+}
+
+TEST_F(exec_graph_test, TestReplayBeforeFinalize) {
+    stream strm(eng);
+    memory src(md(), eng), dst(md(), eng);
+    auto copy = linear(1.f, 0.f);
+    graph.append(copy, {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, dst}});
+    EXPECT_THROW(graph.replay(strm), error);
+}
+
+} // namespace dnnl
@@ -14,6 +14,10 @@
 * limitations under the License.
 *******************************************************************************/
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "dnnl_test_common.hpp"
 #include "gtest/gtest.h"
 
@@ -27,21 +31,31 @@ int get_primitive_cache_size() {
     return result;
 }
 
+dnnl::impl::primitive_cache_stats_t get_primitive_cache_stats() {
+    dnnl::impl::primitive_cache_stats_t stats {};
+    dnnl::impl::get_primitive_cache_stats(&stats);
+    return stats;
+}
+
 namespace dnnl {
 
-void fill_primitive_cache(int n) {
+// a primitive of its own for every i
+void create_relu(const engine &eng, int i) {
     using tag = memory::format_tag;
     using dt = memory::data_type;
 
+    auto relu_d = eltwise_forward::desc(prop_kind::forward_inference,
+            algorithm::eltwise_relu, {{i, 1, 1, 1}, dt::f32, tag::nchw}, 0.f,
+            0.f);
+    auto relu_pd = eltwise_forward::primitive_desc(relu_d, eng);
+    auto relu = eltwise_forward(relu_pd);
+}
+
+void fill_primitive_cache(int n) {
     engine eng(get_test_engine_kind(), 0);
-    for (int i = 0; i < n; i++) {
-        // fill primitive cache with n primitives
-        auto relu_d = eltwise_forward::desc(prop_kind::forward_inference,
-                algorithm::eltwise_relu, {{i, 1, 1, 1}, dt::f32, tag::nchw},
-                0.f, 0.f);
-        auto relu_pd = eltwise_forward::primitive_desc(relu_d, eng);
-        auto relu = eltwise_forward(relu_pd);
-    }
+    // fill primitive cache with n primitives
+    for (int i = 0; i < n; i++)
+        create_relu(eng, i);
 }
 
 TEST(primitive_cache_test, TestDefaultCapacity) {
@@ -103,4 +117,83 @@ TEST(primitive_cache_test, TestCacheHit) {
     ASSERT_EQ(get_primitive_cache_size(), 1);
 }
 
+TEST(primitive_cache_test, TestStats) {
+    set_primitive_cache_capacity(0);
+    set_primitive_cache_capacity(4);
+    dnnl::impl::reset_primitive_cache_stats();
+    fill_primitive_cache(6);
+#ifdef DNNL_ENABLE_PRIMITIVE_CACHE
+    auto stats = get_primitive_cache_stats();
+    ASSERT_EQ(stats.hits, 0u);
+    ASSERT_EQ(stats.misses, 6u);
+    ASSERT_EQ(stats.creations, 6u);
+    ASSERT_EQ(stats.evictions, 2u);
+    ASSERT_GE(stats.creation_ms, 0.);
+#endif
+
+    set_primitive_cache_capacity(0);
+    set_primitive_cache_capacity(2);
+    dnnl::impl::reset_primitive_cache_stats();
+    fill_primitive_cache(1);
+    fill_primitive_cache(1);
+#ifdef DNNL_ENABLE_PRIMITIVE_CACHE
+    stats = get_primitive_cache_stats();
+    ASSERT_EQ(stats.hits, 1u);
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.creations, 1u);
+    ASSERT_EQ(stats.evictions, 0u);
+#endif
+}
+
+TEST(primitive_cache_test, TestEvictionOrder) {
+    engine eng(get_test_engine_kind(), 0);
+    set_primitive_cache_capacity(0);
+    set_primitive_cache_capacity(3);
+    create_relu(eng, 1);
+    create_relu(eng, 2);
+    create_relu(eng, 3);
+    create_relu(eng, 1);
+    // 2 is the least recently used of the whole cache
+    create_relu(eng, 4);
+
+    dnnl::impl::reset_primitive_cache_stats();
+    create_relu(eng, 1);
+    create_relu(eng, 3);
+    create_relu(eng, 4);
+    create_relu(eng, 2);
+#ifdef DNNL_ENABLE_PRIMITIVE_CACHE
+    auto stats = get_primitive_cache_stats();
+    ASSERT_EQ(stats.hits, 3u);
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.evictions, 1u);
+#endif
+}
+
+// Threads asking for the same primitive at the same time create it once
+TEST(primitive_cache_test, TestConcurrentCreation) {
+    engine eng(get_test_engine_kind(), 0);
+    set_primitive_cache_capacity(0);
+    set_primitive_cache_capacity(4);
+    dnnl::impl::reset_primitive_cache_stats();
+
+    const int nthr = 8;
+    std::atomic<int> ready(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nthr; ++t)
+        threads.emplace_back([&]() {
+            ++ready;
+            while (ready < nthr)
+                std::this_thread::yield();
+            create_relu(eng, 7);
+        });
+    for (auto &t : threads)
+        t.join();
+#ifdef DNNL_ENABLE_PRIMITIVE_CACHE
+    auto stats = get_primitive_cache_stats();
+    ASSERT_EQ(stats.creations, 1u);
+    ASSERT_EQ(stats.misses, 1u);
+    ASSERT_EQ(stats.hits, (size_t)nthr - 1);
+#endif
+}
+
 } // namespace dnnl
@@ -0,0 +1,88 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <stdio.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+
+#include "src/common/profiler.hpp"
+
+namespace dnnl {
+
+class profiler_test : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        was_profiling = impl::get_profiling();
+        impl::set_profiling(true);
+        impl::reset_profile();
+    }
+    virtual void TearDown() { impl::set_profiling(was_profiling); }
+
+    static std::string dump(impl::profile_format_t format) {
+        const char *path = "test_iface_profiler.out";
+        EXPECT_EQ(impl::dump_profile(format, path), impl::status::success);
+        std::ifstream f(path);
+        std::stringstream ss;
+        ss << f.rdbuf();
+        remove(path);
+        return ss.str();
+    }
+
+    bool was_profiling;
+};
+
+TEST_F(profiler_test, TestEntriesAndEvents) {
+    engine eng = get_test_engine();
+    stream strm(eng);
+    memory::desc md({2, 16, 4, 4}, memory::data_type::f32,
+            memory::format_tag::nchw);
+    memory src(md, eng), dst(md, eng);
+    auto pd = eltwise_forward::primitive_desc(
+            {prop_kind::forward_inference, algorithm::eltwise_relu, md, 0.f},
+            eng);
+    auto p = eltwise_forward(pd);
+    for (int i = 0; i < 3; ++i)
+        p.execute(strm, {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, dst}});
+    strm.wait();
+
+    const std::string csv = dump(impl::profile_csv);
+    const std::string impl_name = pd.impl_info_str();
+    const size_t line = csv.find("\neltwise," + impl_name + ",");
+    ASSERT_NE(line, std::string::npos);
+    // count follows the quoted problem description
+    const size_t count = csv.find("\",", line);
+    ASSERT_NE(count, std::string::npos);
+    EXPECT_EQ(atoi(csv.c_str() + count + 2), 3);
+
+    const std::string trace = dump(impl::profile_chrome_trace);
+    size_t n_events = 0;
+    for (size_t pos = trace.find("\"ph\":\"X\""); pos != std::string::npos;
+            pos = trace.find("\"ph\":\"X\"", pos + 1))
+        ++n_events;
+    EXPECT_EQ(n_events, 3u);
+
+    impl::reset_profile();
+    EXPECT_EQ(dump(impl::profile_json), "[\n]\n");
+}
+
+} // namespace dnnl
@@ -0,0 +1,150 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+
+namespace dnnl {
+
+class stream_out_of_order_test : public ::testing::Test {
+protected:
+    static memory::desc md() {
+        return memory::desc({2, 16, 8, 8}, memory::data_type::f32,
+                memory::format_tag::nchw);
+    }
+
+    // dst = alpha * src + beta
+    static eltwise_forward linear(const engine &eng, float alpha, float beta) {
+        return eltwise_forward({{prop_kind::forward_inference,
+                                        algorithm::eltwise_linear, md(),
+                                        alpha, beta},
+                eng});
+    }
+
+    static void fill(memory &m, float v) {
+        float *p = (float *)m.get_data_handle();
+        for (size_t i = 0; i < md().get_size() / sizeof(float); ++i)
+            p[i] = v;
+    }
+
+    static void check(const memory &m, float v) {
+        const float *p = (const float *)m.get_data_handle();
+        for (size_t i = 0; i < md().get_size() / sizeof(float); ++i)
+            ASSERT_EQ(p[i], v);
+    }
+};
+
+TEST_F(stream_out_of_order_test, TestDependencies) {
+    SKIP_IF(get_test_engine_kind() != engine::kind::cpu,
+            "Out-of-order execution is tested on CPU only");
+    engine eng = get_test_engine();
+    stream strm(eng, stream::flags::out_of_order);
+
+    memory a(md(), eng), b(md(), eng), c(md(), eng);
+    fill(a, 0.f);
+    fill(b, 0.f);
+    fill(c, -1.f);
+
+    // two independent in-place chains and a reader of the first one
+    auto inc = linear(eng, 1.f, 1.f);
+    auto dec = linear(eng, 1.f, -1.f);
+    auto twice = linear(eng, 2.f, 0.f);
+    const int n = 10;
+    for (int i = 0; i < n; ++i) {
+        inc.execute(strm, {{DNNL_ARG_SRC, a}, {DNNL_ARG_DST, a}});
+        dec.execute(strm, {{DNNL_ARG_SRC, b}, {DNNL_ARG_DST, b}});
+    }
+    twice.execute(strm, {{DNNL_ARG_SRC, a}, {DNNL_ARG_DST, c}});
+    // write after read: c has to be computed from a before this one
+    inc.execute(strm, {{DNNL_ARG_SRC, b}, {DNNL_ARG_DST, a}});
+    strm.wait();
+
+    check(a, 1.f - n);
+    check(b, -(float)n);
+    check(c, 2.f * n);
+}
+
+TEST_F(stream_out_of_order_test, TestReuseAfterWait) {
+    SKIP_IF(get_test_engine_kind() != engine::kind::cpu,
+            "Out-of-order execution is tested on CPU only");
+    engine eng = get_test_engine();
+    stream strm(eng, stream::flags::out_of_order);
+
+    memory a(md(), eng);
+    auto inc = linear(eng, 1.f, 1.f);
+    for (int round = 1; round <= 3; ++round) {
+        fill(a, 0.f);
+        for (int i = 0; i < round; ++i)
+            inc.execute(strm, {{DNNL_ARG_SRC, a}, {DNNL_ARG_DST, a}});
+        strm.wait();
+        check(a, (float)round);
+    }
+}
+
+// The primitive has a library-managed scratchpad, which by default is the
+// global one of the submitting thread, and the executions are independent
+TEST_F(stream_out_of_order_test, TestScratchpad) {
+    SKIP_IF(get_test_engine_kind() != engine::kind::cpu,
+            "Out-of-order execution is tested on CPU only");
+    engine eng = get_test_engine();
+    stream strm(eng, stream::flags::out_of_order);
+
+    using dt = memory::data_type;
+    using tag = memory::format_tag;
+    const memory::dim N = 4, IC = 32, OC = 16;
+    memory::desc src_md({N, IC}, dt::u8, tag::nc);
+    memory::desc wei_md({OC, IC}, dt::s8, tag::oi);
+    memory::desc dst_md({N, OC}, dt::s8, tag::nc);
+    auto pd = inner_product_forward::primitive_desc(
+            {prop_kind::forward_inference, src_md, wei_md, dst_md}, eng);
+    ASSERT_GT(pd.query_s64(query::memory_consumption_s64), 0);
+    auto ip = inner_product_forward(pd);
+
+    memory src(src_md, eng), wei(wei_md, eng);
+    uint8_t *s = (uint8_t *)src.get_data_handle();
+    int8_t *w = (int8_t *)wei.get_data_handle();
+    for (memory::dim i = 0; i < N * IC; ++i)
+        s[i] = (uint8_t)(i % 3);
+    for (memory::dim i = 0; i < OC * IC; ++i)
+        w[i] = (int8_t)(i % 3 - 1);
+
+    const int n_dst = 4;
+    std::vector<memory> dst;
+    for (int d = 0; d < n_dst; ++d) {
+        dst.emplace_back(dst_md, eng);
+        ip.execute(strm,
+                {{DNNL_ARG_SRC, src}, {DNNL_ARG_WEIGHTS, wei},
+                        {DNNL_ARG_DST, dst.back()}});
+    }
+    strm.wait();
+
+    for (int d = 0; d < n_dst; ++d) {
+        const int8_t *p = (const int8_t *)dst[d].get_data_handle();
+        for (memory::dim n = 0; n < N; ++n)
+            for (memory::dim oc = 0; oc < OC; ++oc) {
+                int acc = 0;
+                for (memory::dim ic = 0; ic < IC; ++ic)
+                    acc += s[n * IC + ic] * w[oc * IC + ic];
+                ASSERT_EQ(p[n * OC + oc], acc);
+            }
+    }
+}
+
+} // namespace dnnl
@@ -0,0 +1,121 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <cmath>
+#include <limits>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "src/common/math_utils.hpp"
+
+namespace dnnl {
+
+// The polynomial exp, logistic and tanh the reference RNN forward kernels use
+// instead of libm. They are checked against double precision for the bounds
+// the math_utils comment gives and against expf and tanhf for the 1e-6 the
+// RNN documentation gives.
+class fast_math_test : public ::testing::Test {
+protected:
+    static double rel_err(double v, double ref) {
+        return std::fabs(v - ref) / std::fabs(ref);
+    }
+
+    // calls f for n + 1 points evenly spread over [lo, hi]
+    template <typename F>
+    static void sweep(float lo, float hi, int n, F f) {
+        for (int i = 0; i <= n; ++i)
+            f(i == n ? hi : (float)(lo + (double)(hi - lo) * i / n));
+    }
+
+    static constexpr float exp_lo = -87.3365f, exp_hi = 88.3762f;
+};
+
+TEST_F(fast_math_test, TestExp) {
+    using impl::math::fast_exp_fwd;
+    sweep(exp_lo, exp_hi, 1 << 18, [](float s) {
+        const float v = fast_exp_fwd(s);
+        ASSERT_LT(rel_err(v, std::exp((double)s)), 3e-7) << "s = " << s;
+        ASSERT_LT(rel_err(v, ::expf(s)), 1e-6) << "s = " << s;
+    });
+
+    // around 0, where r is the whole argument
+    sweep(-1.f, 1.f, 1 << 16, [](float s) {
+        ASSERT_LT(rel_err(fast_exp_fwd(s), std::exp((double)s)), 3e-7)
+                << "s = " << s;
+    });
+
+    // past the clamps the result stays that of the bound, which is finite
+    // and normal
+    const float at_lo = fast_exp_fwd(exp_lo), at_hi = fast_exp_fwd(exp_hi);
+    EXPECT_GE(at_lo, std::numeric_limits<float>::min());
+    EXPECT_LE(at_hi, std::numeric_limits<float>::max());
+    for (float s : {-88.f, -100.f, -1e30f,
+                 -std::numeric_limits<float>::infinity()})
+        EXPECT_EQ(fast_exp_fwd(s), at_lo) << "s = " << s;
+    for (float s : {89.f, 100.f, 1e30f, std::numeric_limits<float>::infinity()})
+        EXPECT_EQ(fast_exp_fwd(s), at_hi) << "s = " << s;
+
+    EXPECT_TRUE(std::isnan(fast_exp_fwd(NAN)));
+    EXPECT_TRUE(std::isnan(fast_exp_fwd(-NAN)));
+}
+
+TEST_F(fast_math_test, TestTanh) {
+    using impl::math::fast_tanh_fwd;
+    auto check = [](float s) {
+        if (s == 0.f) return; // checked exactly below
+        const float v = fast_tanh_fwd(s);
+        ASSERT_LT(rel_err(v, std::tanh((double)s)), 1e-6) << "s = " << s;
+        ASSERT_LT(rel_err(v, ::tanhf(s)), 1e-6) << "s = " << s;
+    };
+    sweep(-20.f, 20.f, 1 << 18, check);
+    // densely around the switch from the Taylor polynomial to the exp form
+    // at |s| = 0.125, where the latter cancels the most
+    sweep(-0.5f, 0.5f, 1 << 18, check);
+    for (float s : {0.125f, -0.125f}) {
+        check(s);
+        check(std::nextafter(s, 0.f));
+        check(std::nextafter(s, 2 * s));
+    }
+    for (float s : {1e-3f, 1e-10f, 1e-30f, 1e-40f})
+        check(s);
+
+    EXPECT_EQ(fast_tanh_fwd(0.f), 0.f);
+    EXPECT_EQ(fast_tanh_fwd(100.f), 1.f);
+    EXPECT_EQ(fast_tanh_fwd(-100.f), -1.f);
+    EXPECT_EQ(fast_tanh_fwd(std::numeric_limits<float>::infinity()), 1.f);
+    EXPECT_EQ(fast_tanh_fwd(-std::numeric_limits<float>::infinity()), -1.f);
+    EXPECT_TRUE(std::isnan(fast_tanh_fwd(NAN)));
+}
+
+TEST_F(fast_math_test, TestLogistic) {
+    using impl::math::fast_logistic_fwd;
+    sweep(-exp_hi, -exp_lo, 1 << 18, [](float s) {
+        const float v = fast_logistic_fwd(s);
+        const double ref = 1. / (1. + std::exp(-(double)s));
+        ASSERT_LT(rel_err(v, ref), 1e-6) << "s = " << s;
+        ASSERT_LT(rel_err(v, 1.f / (1.f + ::expf(-s))), 1e-6) << "s = " << s;
+    });
+
+    EXPECT_EQ(fast_logistic_fwd(0.f), 0.5f);
+    EXPECT_EQ(fast_logistic_fwd(std::numeric_limits<float>::infinity()), 1.f);
+    EXPECT_GE(fast_logistic_fwd(-std::numeric_limits<float>::infinity()), 0.f);
+    EXPECT_LT(fast_logistic_fwd(-std::numeric_limits<float>::infinity()),
+            std::numeric_limits<float>::min());
+    EXPECT_TRUE(std::isnan(fast_logistic_fwd(NAN)));
+}
+
+} // namespace dnnl
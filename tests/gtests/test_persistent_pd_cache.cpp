@@ -0,0 +1,134 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+#include "src/common/persistent_pd_cache.hpp"
+
+// ctest runs this with DNNL_PD_CACHE_FILE set
+
+namespace dnnl {
+
+class persistent_pd_cache_test : public ::testing::Test {
+protected:
+    using tag = memory::format_tag;
+    using dt = memory::data_type;
+
+    // Only dnnl_primitive_desc_create() goes through the cache; the C++
+    // constructors iterate. The primitive descriptors it returns are wrapped
+    // for the queries.
+    template <typename pd_t, typename desc_t>
+    pd_t create_pd(const desc_t &desc) {
+        dnnl_primitive_desc_t c_pd;
+        error::wrap_c_api(dnnl_primitive_desc_create(&c_pd, &desc.data,
+                                  nullptr, eng.get(), nullptr),
+                "could not create a primitive descriptor");
+        return pd_t(c_pd);
+    }
+
+    // implementations chosen for a few problems, formats left to them
+    std::vector<std::string> create_pds() {
+        std::vector<std::string> names;
+        memory::desc src({2, 16, 14, 14}, dt::f32, tag::any);
+        memory::desc wei({32, 16, 3, 3}, dt::f32, tag::any);
+        memory::desc dst({2, 32, 14, 14}, dt::f32, tag::any);
+        auto conv_pd = create_pd<convolution_forward::primitive_desc>(
+                convolution_forward::desc(prop_kind::forward_inference,
+                        algorithm::convolution_direct, src, wei, dst, {1, 1},
+                        {1, 1}, {1, 1}));
+        names.push_back(conv_pd.impl_info_str());
+
+        memory::desc ip_wei({10, 32, 14, 14}, dt::f32, tag::any);
+        memory::desc ip_dst({2, 10}, dt::f32, tag::any);
+        auto ip_pd = create_pd<inner_product_forward::primitive_desc>(
+                inner_product_forward::desc(prop_kind::forward_inference,
+                        conv_pd.dst_desc(), ip_wei, ip_dst));
+        names.push_back(ip_pd.impl_info_str());
+
+        memory::desc md({2, 16, 14, 14}, dt::f32, tag::nchw);
+        auto relu_pd = create_pd<eltwise_forward::primitive_desc>(
+                eltwise_forward::desc(prop_kind::forward_inference,
+                        algorithm::eltwise_relu, md, 0.f));
+        names.push_back(relu_pd.impl_info_str());
+        return names;
+    }
+
+    static int count_lines(const char *path) {
+        FILE *f = fopen(path, "r");
+        if (!f) return 0;
+        int n = 0;
+        for (int c = fgetc(f); c != EOF; c = fgetc(f))
+            n += c == '\n';
+        fclose(f);
+        return n;
+    }
+
+    static int replays() {
+        int n = -1;
+        impl::get_persistent_pd_cache_replays(&n);
+        return n;
+    }
+
+    engine eng {engine::kind::cpu, 0};
+};
+
+TEST_F(persistent_pd_cache_test, TestRecordReplay) {
+    const char *path = getenv("DNNL_PD_CACHE_FILE");
+    ASSERT_NE(path, nullptr);
+    // nothing has read the file before the first primitive descriptor
+    std::remove(path);
+
+    const auto recorded = create_pds();
+    const int n = (int)recorded.size();
+    ASSERT_EQ(count_lines(path), n);
+    ASSERT_EQ(replays(), 0);
+
+    // as a new process would: read the file back and replay every record
+    impl::reload_persistent_pd_cache();
+    EXPECT_EQ(create_pds(), recorded);
+    EXPECT_EQ(replays(), n);
+    EXPECT_EQ(count_lines(path), n);
+
+    // a record naming another implementation is not replayed, and the
+    // search records the right one again
+    FILE *f = fopen(path, "r");
+    ASSERT_NE(f, nullptr);
+    std::string text;
+    for (int c = fgetc(f); c != EOF; c = fgetc(f))
+        text += (char)c;
+    fclose(f);
+    const size_t eol = text.find('\n');
+    const size_t name = text.rfind(' ', eol) + 1;
+    text.replace(name, eol - name, "bogus:any");
+    f = fopen(path, "w");
+    ASSERT_NE(f, nullptr);
+    fputs(text.c_str(), f);
+    fclose(f);
+
+    impl::reload_persistent_pd_cache();
+    EXPECT_EQ(create_pds(), recorded);
+    EXPECT_EQ(replays(), 2 * n - 1);
+    EXPECT_EQ(count_lines(path), n + 1);
+}
+
+} // namespace dnnl
@@ -0,0 +1,176 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+#include "src/cpu/rnn/rnn_utils.hpp"
+
+// The wavefront and streaming schedules of the CPU RNN against running the
+// cells one by one over the whole sequence
+
+namespace dnnl {
+
+class rnn_schedule_test : public ::testing::Test {
+protected:
+    using dim = memory::dim;
+    using tag = memory::format_tag;
+    using dt = memory::data_type;
+
+    struct problem_t {
+        algorithm cell;
+        rnn_direction dir;
+        dim mb;
+        bool with_src_iter;
+    };
+
+    virtual void SetUp() {
+        // the cache would hand out primitives of the other schedule
+        set_primitive_cache_capacity(0);
+    }
+
+    virtual void TearDown() {
+        impl::cpu::set_rnn_schedule_overrides(-1, -1);
+        set_primitive_cache_capacity(1024);
+    }
+
+    static void fill(memory &m, float scale, int seed) {
+        float *p = (float *)m.get_data_handle();
+        const size_t n = m.get_desc().get_size() / sizeof(float);
+        for (size_t i = 0; i < n; ++i)
+            p[i] = scale * (float)((int)((i * 7919 + seed) % 97) - 48) / 48.f;
+    }
+
+    static void append(std::vector<float> &v, const memory &m) {
+        const float *p = (const float *)m.get_data_handle();
+        v.insert(v.end(), p, p + m.get_desc().get_size() / sizeof(float));
+    }
+
+    // dst_layer, dst_iter and dst_iter_c of a forward inference
+    std::vector<float> run(const problem_t &p, int wavefront, int streaming) {
+        EXPECT_EQ(impl::cpu::set_rnn_schedule_overrides(wavefront, streaming),
+                impl::status::success);
+
+        const dim L = 3, T = 5, C = 16;
+        const bool is_lstm = p.cell == algorithm::vanilla_lstm;
+        const dim G = is_lstm ? 4 : 3;
+        const dim B = p.cell == algorithm::lbr_gru ? G + 1 : G;
+        const dim D = p.dir == rnn_direction::unidirectional_left2right ? 1 : 2;
+        const dim dst_C = p.dir == rnn_direction::bidirectional_concat ? 2 * C
+                                                                       : C;
+        memory::desc src_layer_md({T, p.mb, C}, dt::f32, tag::tnc);
+        memory::desc iter_md({L, D, p.mb, C}, dt::f32, tag::ldnc);
+        memory::desc src_iter_md = p.with_src_iter ? iter_md : memory::desc();
+        memory::desc weights_md({L, D, C, G, C}, dt::f32, tag::ldigo);
+        memory::desc bias_md({L, D, B, C}, dt::f32, tag::ldgo);
+        memory::desc dst_layer_md({T, p.mb, dst_C}, dt::f32, tag::tnc);
+
+        memory src_layer(src_layer_md, eng), src_iter(iter_md, eng),
+                src_iter_c(iter_md, eng), weights_layer(weights_md, eng),
+                weights_iter(weights_md, eng), bias(bias_md, eng),
+                dst_layer(dst_layer_md, eng), dst_iter(iter_md, eng),
+                dst_iter_c(iter_md, eng);
+        fill(src_layer, 1.f, 0);
+        fill(src_iter, 0.5f, 1);
+        fill(src_iter_c, 0.3f, 2);
+        fill(weights_layer, 0.2f, 3);
+        fill(weights_iter, 0.15f, 4);
+        fill(bias, 0.1f, 5);
+
+        std::unordered_map<int, memory> args = {
+                {DNNL_ARG_SRC_LAYER, src_layer},
+                {DNNL_ARG_WEIGHTS_LAYER, weights_layer},
+                {DNNL_ARG_WEIGHTS_ITER, weights_iter}, {DNNL_ARG_BIAS, bias},
+                {DNNL_ARG_DST_LAYER, dst_layer}, {DNNL_ARG_DST_ITER, dst_iter}};
+        if (p.with_src_iter) args.insert({DNNL_ARG_SRC_ITER, src_iter});
+
+        const auto pk = prop_kind::forward_inference;
+        primitive prim;
+        if (is_lstm) {
+            prim = lstm_forward({{pk, p.dir, src_layer_md, src_iter_md,
+                                         src_iter_md, weights_md, weights_md,
+                                         bias_md, dst_layer_md, iter_md,
+                                         iter_md},
+                    eng});
+            if (p.with_src_iter) args.insert({DNNL_ARG_SRC_ITER_C, src_iter_c});
+            args.insert({DNNL_ARG_DST_ITER_C, dst_iter_c});
+        } else if (p.cell == algorithm::vanilla_gru) {
+            prim = gru_forward({{pk, p.dir, src_layer_md, src_iter_md,
+                                        weights_md, weights_md, bias_md,
+                                        dst_layer_md, iter_md},
+                    eng});
+        } else {
+            prim = lbr_gru_forward({{pk, p.dir, src_layer_md, src_iter_md,
+                                            weights_md, weights_md, bias_md,
+                                            dst_layer_md, iter_md},
+                    eng});
+        }
+        prim.execute(strm, args);
+        strm.wait();
+
+        std::vector<float> out;
+        append(out, dst_layer);
+        append(out, dst_iter);
+        if (is_lstm) append(out, dst_iter_c);
+        return out;
+    }
+
+    // The schedules change the GEMM shapes, hence the summation order
+    static void compare(
+            const std::vector<float> &ref, const std::vector<float> &got) {
+        ASSERT_EQ(ref.size(), got.size());
+        for (size_t i = 0; i < ref.size(); ++i) {
+            const float tol = 1e-5f * std::max(1.f, std::fabs(ref[i]));
+            ASSERT_NEAR(got[i], ref[i], tol) << "at " << i;
+        }
+    }
+
+    engine eng {engine::kind::cpu, 0};
+    stream strm {eng};
+};
+
+TEST_F(rnn_schedule_test, TestWavefront) {
+    for (auto cell : {algorithm::vanilla_lstm, algorithm::vanilla_gru,
+                 algorithm::lbr_gru})
+        for (auto dir : {rnn_direction::unidirectional_left2right,
+                     rnn_direction::bidirectional_concat})
+            for (dim mb : {1, 2, 5, 8}) {
+                const problem_t p {cell, dir, mb, true};
+                compare(run(p, 0, 0), run(p, 1, 0));
+            }
+}
+
+TEST_F(rnn_schedule_test, TestStreaming) {
+    for (auto cell : {algorithm::vanilla_lstm, algorithm::vanilla_gru,
+                 algorithm::lbr_gru})
+        for (bool with_src_iter : {true, false})
+            for (dim mb : {1, 8}) {
+                const problem_t p {cell,
+                        rnn_direction::unidirectional_left2right, mb,
+                        with_src_iter};
+                const auto ref = run(p, 0, 0);
+                compare(ref, run(p, 0, 1));
+                compare(ref, run(p, 1, 1));
+            }
+}
+
+} // namespace dnnl
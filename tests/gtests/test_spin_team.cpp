@@ -0,0 +1,138 @@
+/*******************************************************************************
+* Copyright 2020 NEC Labs America LLC
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*     http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*******************************************************************************/
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "dnnl_test_common.hpp"
+#include "gtest/gtest.h"
+
+#include "dnnl.hpp"
+
+// ctest runs this with DNNL_SPIN_TEAM set, so the parallel sections of the
+// library small enough for the team run on it. Run without, it checks the
+// OMP path the same way.
+
+namespace dnnl {
+
+class spin_team_test : public ::testing::Test {
+protected:
+    using dim = memory::dim;
+    using tag = memory::format_tag;
+    using dt = memory::data_type;
+
+    static void fill(memory &m, float scale) {
+        float *p = (float *)m.get_data_handle();
+        const size_t n = m.get_desc().get_size() / sizeof(float);
+        for (size_t i = 0; i < n; ++i)
+            p[i] = scale * (float)(i % 113);
+    }
+
+    // dst = 2 * src + 1 over n elements, which the library runs on one
+    // thread or on many depending on n
+    static void run_linear(const engine &eng, stream &strm, dim n) {
+        memory::desc md({n}, dt::f32, tag::a);
+        memory src(md, eng), dst(md, eng);
+        fill(src, 1.f);
+        eltwise_forward(
+                {{prop_kind::forward_inference, algorithm::eltwise_linear, md,
+                         2.f, 1.f},
+                        eng})
+                .execute(strm, {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, dst}});
+        strm.wait();
+        const float *d = (const float *)dst.get_data_handle();
+        for (dim i = 0; i < n; ++i)
+            ASSERT_EQ(d[i], 2.f * (float)(i % 113) + 1.f);
+    }
+
+    engine eng {engine::kind::cpu, 0};
+};
+
+TEST_F(spin_team_test, TestElementwise) {
+    stream strm(eng);
+    for (dim n : {1, 100, 10000, 1000000})
+        run_linear(eng, strm, n);
+
+    memory::desc md({2, 16, 10, 10}, dt::f32, tag::nchw);
+    memory a(md, eng), b(md, eng), c(md, eng);
+    fill(a, 1.f);
+    fill(b, -0.5f);
+    binary({{algorithm::binary_add, md, md, md}, eng})
+            .execute(strm,
+                    {{DNNL_ARG_SRC_0, a}, {DNNL_ARG_SRC_1, b},
+                            {DNNL_ARG_DST, c}});
+    strm.wait();
+    const float *pc = (const float *)c.get_data_handle();
+    for (dim i = 0; i < (dim)md.get_size() / 4; ++i)
+        ASSERT_EQ(pc[i], 0.5f * (float)(i % 113));
+}
+
+// Batch normalization over nchw synchronizes its threads with
+// dnnl_thr_barrier() between the statistics and the normalization
+TEST_F(spin_team_test, TestBarrier) {
+    stream strm(eng);
+    const dim N = 4, C = 8, H = 7, W = 9;
+    memory::desc md({N, C, H, W}, dt::f32, tag::nchw);
+    memory src(md, eng), dst(md, eng);
+    fill(src, 0.25f);
+    batch_normalization_forward::primitive_desc pd(
+            {prop_kind::forward_training, md, 1e-3f,
+                    normalization_flags::none},
+            eng);
+    memory mean(pd.mean_desc(), eng), var(pd.variance_desc(), eng);
+    batch_normalization_forward(pd).execute(strm,
+            {{DNNL_ARG_SRC, src}, {DNNL_ARG_DST, dst}, {DNNL_ARG_MEAN, mean},
+                    {DNNL_ARG_VARIANCE, var}});
+    strm.wait();
+
+    const float *s = (const float *)src.get_data_handle();
+    const float *d = (const float *)dst.get_data_handle();
+    for (dim c = 0; c < C; ++c) {
+        double sum = 0, sum2 = 0;
+        for (dim n = 0; n < N; ++n)
+            for (dim sp = 0; sp < H * W; ++sp) {
+                const double v = s[(n * C + c) * H * W + sp];
+                sum += v;
+                sum2 += v * v;
+            }
+        const double m = sum / (N * H * W);
+        const double v = sum2 / (N * H * W) - m * m;
+        ASSERT_NEAR(((const float *)mean.get_data_handle())[c], m, 1e-4);
+        ASSERT_NEAR(((const float *)var.get_data_handle())[c], v, 1e-3);
+        for (dim n = 0; n < N; ++n)
+            for (dim sp = 0; sp < H * W; ++sp) {
+                const dim off = (n * C + c) * H * W + sp;
+                ASSERT_NEAR(d[off], (s[off] - m) / std::sqrt(v + 1e-3), 1e-4);
+            }
+    }
+}
+
+// Only one application thread at a time gets the team, the others run
+// their parallel sections on OMP
+TEST_F(spin_team_test, TestConcurrentCallers) {
+    std::vector<std::thread> callers;
+    for (int t = 0; t < 3; ++t)
+        callers.emplace_back([&]() {
+            stream strm(eng);
+            for (int i = 0; i < 20; ++i)
+                run_linear(eng, strm, 100000);
+        });
+    for (auto &t : callers)
+        t.join();
+}
+
+} // namespace dnnl